@@ -3,7 +3,7 @@ bitwise_operators.c
 Taken from Geeks for Geeks, edited by gopeterjun@naver.com
 
 Created on: Sat 07 Jun 2025
-Last Updated: Sun 08 Jun 2025
+Last Updated: Sun 18 Oct 2026
 
 Examples for using bitwise operators in C
 */
@@ -11,49 +11,8 @@ Examples for using bitwise operators in C
 #include <assert.h>
 #include <stdio.h>
 #include <stdint.h>  // for fixed-width int types
-#include <stdlib.h>
-#include <string.h>
-
-// convert unsigned int to its binary representation as char array
-/*@null@*/ char* uint_to_binary(uint8_t n, uint8_t width) {
-    // allocate memory for string 'binary_str'
-    char* binary_str = (char*)malloc(width+1);
-    if (binary_str == NULL) {
-        return NULL;
-    }
-
-    // start from the end of the array (MSB of binary representation)
-    // i.e. left-most digit of binary number
-    for (int i = width - 1; i >= 0; i--) {
-        // current bit & 1 (bitwise AND)
-        binary_str[i] = (n&1) ? '1' : '0';
-        // bitwise right-shift 'n' by 1 place
-        n >>= 1;
-    }
-    binary_str[width] = '\0';  // add NULL terminator to end of char array
-    return binary_str;
-}
 
-// convert signed int to its binary representation as char array
-// this will be used for 'bitwise complement' which sometimes can
-// return negative values
-
-/*@null@*/ char* int_to_binary(int8_t n, uint8_t width) {
-    char* binary_str = (char*)malloc(width+1);
-    if (binary_str == NULL) {
-        return NULL;
-    }
-    // start from the end of the array (MSB of binary representation)
-    // i.e. left-most digit of binary number
-    for (int i = width - 1; i >= 0; i--) {
-        // current bit & 1 (bitwise AND)
-        binary_str[i] = (n&1) ? '1' : '0';
-        // bitwise right-shift 'n' by 1 place
-        n >>= 1;
-    }
-    binary_str[width] = '\0';  // add NULL terminator to end of char array
-    return binary_str;
-}
+#include "libbwt.h"  // bwt_to_binary
 
 int main() {
     // a = 5 (00000101 in 8-bit binary)
@@ -68,37 +27,35 @@ int main() {
     // declare 'b' as unsigned int (always positive)
     uint8_t b = 9;
     uint8_t width = 8;
-    char* binary_a = int_to_binary(a, width);
-    char* binary_b = uint_to_binary(b, width);
-    char* binary_c = int_to_binary(c, width);
-
-    if (binary_a != NULL) {
-        printf("a=%i base 10 in base 2 is %s\n", a, binary_a);
-    } else {
-        printf("creating char array failed");
-    }
-
-    if (binary_b != NULL) {
-        printf("b=%u base 10 in base 2 is %s\n", b, binary_b);
-    } else {
-        printf("creating char array failed");
-    }
-
-    if (binary_c != NULL) {
-        printf("c=%i base 10 in base 2 is %s\n", c, binary_c);
-    } else {
-        printf("creating char array failed");
-    }
-
-    char* binary_a_and_b = uint_to_binary(a&b, width);
-    char* binary_a_or_b = uint_to_binary(a|b, width);
-    char* binary_a_xor_b = uint_to_binary(a^b, width);
+    // binary strings are written into buffers on the stack by libbwt;
+    // signed values keep their two's complement bits when cast to uint32_t
+    char binary_a[BWT_BINARY_SIZE];
+    char binary_b[BWT_BINARY_SIZE];
+    char binary_c[BWT_BINARY_SIZE];
+    bwt_to_binary(binary_a, (uint32_t)a, width);
+    bwt_to_binary(binary_b, b, width);
+    bwt_to_binary(binary_c, (uint32_t)c, width);
+
+    printf("a=%i base 10 in base 2 is %s\n", a, binary_a);
+    printf("b=%u base 10 in base 2 is %s\n", b, binary_b);
+    printf("c=%i base 10 in base 2 is %s\n", c, binary_c);
+
+    char binary_a_and_b[BWT_BINARY_SIZE];
+    char binary_a_or_b[BWT_BINARY_SIZE];
+    char binary_a_xor_b[BWT_BINARY_SIZE];
+    char binary_not_a[BWT_BINARY_SIZE];
+    char binary_not_c[BWT_BINARY_SIZE];
+    char binary_b_left[BWT_BINARY_SIZE];
+    char binary_b_right[BWT_BINARY_SIZE];
     int8_t not_a = ~a;
     int8_t not_c = ~c;
-    char* binary_not_a = int_to_binary(not_a, width);
-    char* binary_not_c = int_to_binary(not_c, width);
-    char* binary_b_left = uint_to_binary(b<<1, width);
-    char* binary_b_right = uint_to_binary(b>>1, width);
+    bwt_to_binary(binary_a_and_b, (uint32_t)(a&b), width);
+    bwt_to_binary(binary_a_or_b, (uint32_t)(a|b), width);
+    bwt_to_binary(binary_a_xor_b, (uint32_t)(a^b), width);
+    bwt_to_binary(binary_not_a, (uint32_t)not_a, width);
+    bwt_to_binary(binary_not_c, (uint32_t)not_c, width);
+    bwt_to_binary(binary_b_left, (uint32_t)(b<<1), width);
+    bwt_to_binary(binary_b_right, (uint32_t)(b>>1), width);
 
     // Add assert statements to check correctness
     assert((a & b) == 1);      // 5 & 9 == 1
@@ -142,16 +99,5 @@ int main() {
     printf("b>>1 = %u base-10\n", b >> 1);
     printf("b>>1 = %s binary\n", binary_b_right);
 
-    // Memory allocated to char arrays above is freed below:
-    free(binary_a);
-    free(binary_b);
-    free(binary_c);
-    free(binary_a_and_b);
-    free(binary_a_or_b);
-    free(binary_a_xor_b);
-    free(binary_not_a);
-    free(binary_not_c);
-    free(binary_b_left);
-    free(binary_b_right);
     return 0;
 }
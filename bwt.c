@@ -1,7 +1,7 @@
 /*
  * bwt.c - Bitwise Tutor
  * Created on: Mon 09 Jun 2025
- * Last Updated: Sun 29 Jun 2025
+ * Last Updated: Sun 18 Oct 2026
  * Author: Various LLM's and gopeterjun@naver.com
  *
  * This is the Proof of Concept (Alpha) implementation of the bitwise-tutor
@@ -9,6 +9,8 @@
  * in the C programming language.
  */
 
+#define _POSIX_C_SOURCE 200809L  // clock_gettime
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
@@ -16,16 +18,68 @@
 #include <stdbool.h>
 #include <time.h>
 #include <assert.h>
+#include <unistd.h>
+
+#include "libbwt.h"
+#include "bwt_question.h"
+#include "bwt_sched.h"
+#include "bwt_dist.h"
+#include "bwt_store.h"
+#include "bwt_report.h"
+#include "bwt_feedback.h"
+#include "bwt_broadcast.h"
+#include "bwt_serve.h"
+#include "bwt_scoreboard.h"
+#include "bwt_metrics.h"
+#include "bwt_mux.h"
+#include "bwt_proto.h"
+#include "bwt_tui.h"
+#include "bwt_catalog.h"
+#include "bwt_replay.h"
+#include "bwt_kernels.h"
+#include "bwt_coverage.h"
+#include "bwt_probe.h"
+#include "bwt_settings.h"
+#include "bwt_exam.h"
+#include "bwt_choice.h"
+
+#define ADAPTIVE_ROUND_LENGTH 10  // questions per round of adaptive practice
+#define ADAPTIVE_HISTORY_WINDOW 20  // recent questions the round summary covers
+#define DEFAULT_SETTINGS_FILE "bwt.conf"
+
+// Scheduler state and operand coverage of a learner, their id and session,
+// and the menu quiz question they are answering
+struct learner {
+    struct bwt_sched sched;
+    struct bwt_coverage coverage;
+    uint32_t id;
+    bool anonymous;         // a --serve-menu connection, with no history of its own
+    uint32_t session_id;
+    struct bwt_rng rng;
+    const struct bwt_settings* settings;  // snapshot the quizzes draw from, moved on between quizzes
+    struct bwt_question question;
+    struct bwt_record asking;
+    uint64_t asked_at;
+    uint32_t attempts;
+};
+
+// The learner at this terminal, or the one whose turn it is with --serve-menu
+static struct learner terminal_learner;
+static struct learner* learner = &terminal_learner;
+
+// Results file given with --results, not recording while fd < 0; earlier
+// results in it seed the learner's answer history
+static struct bwt_appender results = { .fd = -1 };
+static const char* history_path;
+
+// Watch on the settings file, reloaded between quizzes; -1 when replaying
+static int settings_watch = -1;
+
+// --choices: adaptive practice and exams ask multiple-choice questions
+static bool multiple_choice;
 
 // Function prototypes
-/*@null@*/ char* uint8_to_binary(uint8_t n);
-/*@null@*/ char* uint16_to_binary(uint16_t n);
-/*@null@*/ char* uint32_to_binary(uint32_t n);
-/*@null@*/ char* int8_to_binary(int8_t n);
-/*@null@*/ char* int16_to_binary(int16_t n);
-/*@null@*/ char* int32_to_binary(int32_t n);
 bool validate_binary_input(const char* input, uint8_t width);
-void free_if_not_null(char* ptr);
 void clear_input_buffer(void);
 void run_bitwise_and_quiz(void);
 void run_bitwise_or_quiz(void);
@@ -33,222 +87,308 @@ void run_bitwise_xor_quiz(void);
 void run_bitwise_not_quiz(void);
 void run_shift_quiz(void);
 void run_binary_decimal_conversion_quiz(void);
+void run_adaptive_quiz(void);
+uint32_t run_exam(uint64_t seed, uint32_t student, uint32_t questions, FILE* answers);
+void run_menu(void);
+void run_session(uint32_t seed);
+void* create_learner(uint32_t id);
+void enter_learner(void* state);
+void destroy_learner(void* state);
+uint64_t questions_asked(void);
+void load_history(void);
+void refresh_settings(void);
+uint64_t clock_us(clockid_t clock);
+struct bwt_record record_question(const struct bwt_question* q);
+void write_record(struct bwt_record* rec, uint64_t asked_at, uint32_t attempts);
+void flush_results(void);
+void quiz_ask(const struct bwt_question* q, enum bwt_format format);
+bool quiz_answer(bool correct, uint32_t answer);
+void print_answer_form(void);
+void print_usage(const char* prog);
+long parse_port(const char* arg);
+bool read_answer_line(char* buffer, size_t buffer_size);
 bool get_binary_input(char* buffer, size_t buffer_size, uint8_t expected_width);
+bool grade_binary_answer(const struct bwt_question* q, const char* input);
+void print_feedback(const struct bwt_question* q, uint32_t answer);
+enum bwt_verdict grade_answer(const struct bwt_question* q, const struct bwt_choices* choices,
+                              const char* input, uint32_t* answer);
+void describe_answer(const struct bwt_question* q, bool choice, char* buf, size_t size);
 int binary_to_int(const char* binary_str);
 
 /**
- * Convert 8-bit unsigned integer to binary representation
+ * Validate binary input from user
  *
- * @param n The unsigned 8-bit integer to convert
- * @return A dynamically allocated string with binary representation (caller must free)
+ * @param input The string to validate
+ * @param width The expected width of the binary string
+ * @return true if input is valid binary representation, false otherwise
  */
-char* uint8_to_binary(uint8_t n) {
-    const uint8_t width = 8;
-    char* binary_str = (char*)malloc(width + 1);
-    if (binary_str == NULL) {
-        return NULL;
+bool validate_binary_input(const char* input, uint8_t width) {
+    if (input == NULL) {
+        return false;
     }
 
-    // Start from the end of the array (MSB of binary representation)
-    for (int i = width - 1; i >= 0; i--) {
-        // Check if bit is set using bitwise AND with 1
-        binary_str[width - 1 - i] = (n & (1 << i)) ? '1' : '0';
+    // Check if length matches expected width
+    if (strlen(input) != width) {
+        return false;
     }
-    binary_str[width] = '\0';  // Add NULL terminator to end of char array
-    return binary_str;
+
+    // Check if all characters are '0' or '1'
+    uint32_t bits;
+    return bwt_parse_binary(input, width, &bits);
 }
 
 /**
- * Convert 16-bit unsigned integer to binary representation
+ * Clear input buffer to prevent issues with scanf
+ */
+void clear_input_buffer(void) {
+    int c;
+    while ((c = getchar()) != '\n' && c != EOF);
+}
+
+/**
+ * Get binary input from user with validation
  *
- * @param n The unsigned 16-bit integer to convert
- * @return A dynamically allocated string with binary representation (caller must free)
+ * @param buffer Buffer to store input
+ * @param buffer_size Size of buffer
+ * @param expected_width Expected width of binary string
+ * @return true if input is valid, false otherwise
  */
-char* uint16_to_binary(uint16_t n) {
-    const uint8_t width = 16;
-    char* binary_str = (char*)malloc(width + 1);
-    if (binary_str == NULL) {
-        return NULL;
+bool get_binary_input(char* buffer, size_t buffer_size, uint8_t expected_width) {
+    printf(">>> ");
+    if (fgets(buffer, buffer_size, stdin) == NULL) {
+        return false;
+    }
+
+    // Remove newline character if present
+    size_t len = strlen(buffer);
+    if (len > 0 && buffer[len - 1] == '\n') {
+        buffer[len - 1] = '\0';
+        len--;
+    }
+
+    // Check if input contains only digits
+    for (size_t i = 0; i < len; i++) {
+        if (buffer[i] != '0' && buffer[i] != '1') {
+            fputs(bwt_msg_text(MSG_QUIZ_DIGITS_ONLY), stdout);
+            return false;
+        }
     }
 
-    // Start from the end of the array (MSB of binary representation)
-    for (int i = width - 1; i >= 0; i--) {
-        // Check if bit is set using bitwise AND with 1
-        binary_str[width - 1 - i] = (n & (1 << i)) ? '1' : '0';
+    // Check if input has correct length
+    if (len != expected_width) {
+        return false;
     }
-    binary_str[width] = '\0';  // Add NULL terminator to end of char array
-    return binary_str;
+
+    return true;
 }
 
 /**
- * Convert 32-bit unsigned integer to binary representation
+ * Print what is wrong with an answer, without giving the answer away
  *
- * @param n The unsigned 32-bit integer to convert
- * @return A dynamically allocated string with binary representation (caller must free)
+ * @param q The question
+ * @param answer The wrong answer as a bit pattern
  */
-char* uint32_to_binary(uint32_t n) {
-    const uint8_t width = 32;
-    char* binary_str = (char*)malloc(width + 1);
-    if (binary_str == NULL) {
-        return NULL;
-    }
+void print_feedback(const struct bwt_question* q, uint32_t answer) {
+    char text[BWT_FEEDBACK_SIZE];
+    struct bwt_feedback fb;
 
-    // Start from the end of the array (MSB of binary representation)
-    for (int i = width - 1; i >= 0; i--) {
-        // Check if bit is set using bitwise AND with 1
-        binary_str[width - 1 - i] = (n & (1UL << i)) ? '1' : '0';
-    }
-    binary_str[width] = '\0';  // Add NULL terminator to end of char array
-    return binary_str;
+    bwt_feedback_analyze(q, answer, &fb);
+    bwt_feedback_render(q, answer, &fb, text, sizeof(text));
+    fputs(text, stdout);
 }
 
 /**
- * Convert 8-bit signed integer to binary representation
+ * Grade an answer typed in, or the letter of an option
  *
- * @param n The signed 8-bit integer to convert
- * @return A dynamically allocated string with binary representation (caller must free)
+ * @param q The question
+ * @param choices Its options if it is asked as multiple choice, or NULL
+ * @param input What the student entered
+ * @param answer Set to the answer, or the picked option, as a bit pattern
+ * @return The verdict
  */
-char* int8_to_binary(int8_t n) {
-    const uint8_t width = 8;
-    char* binary_str = (char*)malloc(width + 1);
-    if (binary_str == NULL) {
-        return NULL;
+enum bwt_verdict grade_answer(const struct bwt_question* q, const struct bwt_choices* choices,
+                              const char* input, uint32_t* answer) {
+    if (choices == NULL) {
+        return bwt_question_grade(q, input, answer);
     }
-
-    // Start from the end of the array (MSB of binary representation)
-    for (int i = width - 1; i >= 0; i--) {
-        // Check if bit is set using bitwise AND with 1
-        binary_str[width - 1 - i] = (n & (1 << i)) ? '1' : '0';
+    uint8_t picked;
+    enum bwt_verdict verdict = bwt_choices_grade(choices, input, &picked);
+    if (verdict != BWT_VERDICT_INVALID) {
+        *answer = choices->option[picked].bits;
     }
-    binary_str[width] = '\0';  // Add NULL terminator to end of char array
-    return binary_str;
+    return verdict;
 }
 
 /**
- * Convert 16-bit signed integer to binary representation
- *
- * @param n The signed 16-bit integer to convert
- * @return A dynamically allocated string with binary representation (caller must free)
+ * Describe the answer a question takes, for invalid-input messages
  */
-char* int16_to_binary(int16_t n) {
-    const uint8_t width = 16;
-    char* binary_str = (char*)malloc(width + 1);
-    if (binary_str == NULL) {
-        return NULL;
+void describe_answer(const struct bwt_question* q, bool choice, char* buf, size_t size) {
+    if (choice) {
+        char last[2] = { 'a' + BWT_CHOICES - 1, '\0' };
+        BWT_MSG(buf, size, MSG_ANSWER_CHOICE, last);
+    } else {
+        bwt_question_describe_answer(q, buf, size);
     }
+}
 
-    // Start from the end of the array (MSB of binary representation)
-    for (int i = width - 1; i >= 0; i--) {
-        // Check if bit is set using bitwise AND with 1
-        binary_str[width - 1 - i] = (n & (1 << i)) ? '1' : '0';
-    }
-    binary_str[width] = '\0';  // Add NULL terminator to end of char array
-    return binary_str;
+/**
+ * Tell the learner what form the answer to the menu quiz question takes
+ */
+void print_answer_form(void) {
+    char form[64];
+    describe_answer(&learner->question, false, form, sizeof(form));
+    BWT_MSG_PRINT(MSG_RESULT_INVALID, form);
+    printf("\n");
 }
 
 /**
- * Convert 32-bit signed integer to binary representation
+ * Grade a binary answer already validated by get_binary_input
  *
- * @param n The signed 32-bit integer to convert
- * @return A dynamically allocated string with binary representation (caller must free)
+ * The answer is compared with the expected value as an integer and, when
+ * it is wrong, the wrong bits and the likely mistake are printed.
+ *
+ * @param q The question being answered
+ * @param input The answer as `q->width` binary digits
+ * @return true if the answer is correct
  */
-char* int32_to_binary(int32_t n) {
-    const uint8_t width = 32;
-    char* binary_str = (char*)malloc(width + 1);
-    if (binary_str == NULL) {
-        return NULL;
-    }
+bool grade_binary_answer(const struct bwt_question* q, const char* input) {
+    uint32_t answer;
+    enum bwt_verdict verdict = bwt_question_grade(q, input, &answer);
 
-    // Start from the end of the array (MSB of binary representation)
-    for (int i = width - 1; i >= 0; i--) {
-        // Check if bit is set using bitwise AND with 1
-        binary_str[width - 1 - i] = (n & (1L << i)) ? '1' : '0';
+    if (verdict != BWT_VERDICT_INVALID && quiz_answer(verdict == BWT_VERDICT_CORRECT, answer)) {
+        return true;
     }
-    binary_str[width] = '\0';  // Add NULL terminator to end of char array
-    return binary_str;
+    bwt_metric_inc(BWT_METRIC_WRONG);
+    fputs(bwt_msg_text(MSG_RESULT_WRONG), stdout);
+    if (verdict == BWT_VERDICT_WRONG) {
+        print_feedback(q, answer);
+    }
+    printf("\n");
+    return false;
 }
 
 /**
- * Validate binary input from user
+ * Read one line of an answer from the user
  *
- * @param input The string to validate
- * @param width The expected width of the binary string
- * @return true if input is valid binary representation, false otherwise
+ * @param buffer Buffer to store input, without the trailing newline
+ * @param buffer_size Size of buffer
+ * @return true if a line was read, false on end of input
  */
-bool validate_binary_input(const char* input, uint8_t width) {
-    if (input == NULL) {
-        return false;
-    }
-
-    // Check if length matches expected width
-    if (strlen(input) != width) {
+bool read_answer_line(char* buffer, size_t buffer_size) {
+    printf(">>> ");
+    if (fgets(buffer, buffer_size, stdin) == NULL) {
         return false;
     }
 
-    // Check if all characters are '0' or '1'
-    for (size_t i = 0; i < width; i++) {
-        if (input[i] != '0' && input[i] != '1') {
-            return false;
-        }
+    // Remove newline (and carriage return from Windows terminals) if present
+    size_t len = strlen(buffer);
+    BWT_PROBE2(input, 0, len);
+    while (len > 0 && (buffer[len - 1] == '\n' || buffer[len - 1] == '\r')) {
+        buffer[--len] = '\0';
     }
-
     return true;
 }
 
 /**
- * Free memory if pointer is not NULL
+ * Read a clock in microseconds
  *
- * @param ptr Pointer to free
+ * @param clock CLOCK_REALTIME for timestamps, CLOCK_MONOTONIC for durations
+ * @return Microseconds since the clock's epoch
  */
-void free_if_not_null(char* ptr) {
-    if (ptr != NULL) {
-        free(ptr);
-    }
+uint64_t clock_us(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
 }
 
 /**
- * Clear input buffer to prevent issues with scanf
+ * Start the results record of a question being asked now
+ *
+ * @param q The question
+ * @return The record, without latency, attempts or first answer
  */
-void clear_input_buffer(void) {
-    int c;
-    while ((c = getchar()) != '\n' && c != EOF);
+struct bwt_record record_question(const struct bwt_question* q) {
+    return (struct bwt_record){
+        .timestamp_us = clock_us(CLOCK_REALTIME),
+        .learner = learner->id,
+        .session = learner->session_id,
+        .a = q->a,
+        .b = q->b,
+        .expected = q->expected,
+        .topic = q->topic,
+        .width = q->width,
+        .flags = (q->is_signed ? BWT_RECORD_SIGNED : 0) | BWT_RECORD_FORMAT(q->format),
+    };
 }
 
 /**
- * Get binary input from user with validation
+ * Append a finished question to the results file, if there is one
  *
- * @param buffer Buffer to store input
- * @param buffer_size Size of buffer
- * @param expected_width Expected width of binary string
- * @return true if input is valid, false otherwise
+ * The record stays buffered until flush_results, between quizzes.
+ *
+ * @param rec The record from record_question
+ * @param asked_at CLOCK_MONOTONIC microseconds when the question was shown
+ * @param attempts Well-formed answers given
  */
-bool get_binary_input(char* buffer, size_t buffer_size, uint8_t expected_width) {
-    printf(">>> ");
-    if (fgets(buffer, buffer_size, stdin) == NULL) {
-        return false;
+void write_record(struct bwt_record* rec, uint64_t asked_at, uint32_t attempts) {
+    if (results.fd < 0) {
+        return;
     }
-
-    // Remove newline character if present
-    size_t len = strlen(buffer);
-    if (len > 0 && buffer[len - 1] == '\n') {
-        buffer[len - 1] = '\0';
-        len--;
+    uint64_t latency = clock_us(CLOCK_MONOTONIC) - asked_at;
+    rec->latency_us = latency < UINT32_MAX ? (uint32_t)latency : UINT32_MAX;
+    rec->attempts = attempts < UINT8_MAX ? (uint8_t)attempts : UINT8_MAX;
+    if (bwt_appender_append(&results, rec) < 0) {
+        perror("Could not write results");
     }
+}
 
-    // Check if input contains only digits
-    for (size_t i = 0; i < len; i++) {
-        if (buffer[i] != '0' && buffer[i] != '1') {
-            printf("Please enter digits only.\n");
-            return false;
-        }
+/**
+ * Write out the records buffered so far, between quizzes and at the end of
+ * a session, so Ctrl-C loses at most the quiz in progress; records that
+ * could not be written stay buffered for the next try
+ */
+void flush_results(void) {
+    if (results.fd >= 0 && bwt_appender_flush(&results) < 0) {
+        perror("Could not write results");
     }
+}
 
-    // Check if input has correct length
-    if (len != expected_width) {
-        return false;
-    }
+/**
+ * Count a menu quiz question and start its results record
+ *
+ * @param q The question
+ * @param format How it is asked (enum bwt_format), as in bwt_question.format
+ */
+void quiz_ask(const struct bwt_question* q, enum bwt_format format) {
+    struct bwt_question asked = *q;
+    asked.format = format;
+    bwt_metric_inc(BWT_METRIC_QUESTIONS);
+    learner->question = asked;
+    learner->asking = record_question(&asked);
+    learner->asked_at = clock_us(CLOCK_MONOTONIC);
+    learner->attempts = 0;
+}
 
-    return true;
+/**
+ * Note a well-formed answer to the menu quiz question being asked
+ *
+ * The question is written to the results file once it is answered
+ * correctly; a question left at end of input is not.
+ *
+ * @param correct Whether the answer is correct
+ * @param answer The answer as a bit pattern, masked to the width here
+ * @return correct
+ */
+bool quiz_answer(bool correct, uint32_t answer) {
+    struct bwt_record* rec = &learner->asking;
+    if (learner->attempts++ == 0) {
+        rec->first_answer = answer & bwt_width_mask(rec->width);
+    }
+    if (correct) {
+        rec->flags |= BWT_RECORD_CORRECT;
+        write_record(rec, learner->asked_at, learner->attempts);
+    }
+    return correct;
 }
 
 /**
@@ -275,75 +415,93 @@ int binary_to_int(const char* binary_str) {
  * Run a quiz on bitwise AND operation
  */
 void run_bitwise_and_quiz(void) {
-    // Generate two random 8-bit integers
-    //int8_t a = rand() % 16;  // Small values for easier understanding
-    //int8_t b = rand() % 16;
-    int8_t a = rand();
-    int8_t b = rand();
+    // Draw two 8-bit integers from the configured operand distribution, avoiding repeats
+    uint32_t a_bits, b_bits;
+    bwt_coverage_pair(&learner->coverage, BWT_DIST_AND, BWT_TOPIC_AND, 8, true, &a_bits, &b_bits);
+    int8_t a = (int8_t)a_bits;
+    int8_t b = (int8_t)b_bits;
 
-    char* a_bin = int8_to_binary(a);
-    char* b_bin = int8_to_binary(b);
-    char* result_bin = int8_to_binary(a & b);
+    struct bwt_question q_a = bwt_question_make(BWT_TOPIC_DEC2BIN, 8, true, (uint8_t)a, 0);
+    struct bwt_question q_b = bwt_question_make(BWT_TOPIC_DEC2BIN, 8, true, (uint8_t)b, 0);
+    struct bwt_question q_result = bwt_question_make(BWT_TOPIC_AND, 8, true, (uint8_t)a, (uint8_t)b);
 
     // Quiz: Decimal to Binary
-    printf("\nThe following questions are about signed 8-bit integers *a* and *b*.\n");
-    printf("Given `a=%d` and `b=%d`,\n\n", a, b);
+    char a_dec[BWT_MSG_INT_SIZE], b_dec[BWT_MSG_INT_SIZE];
+    bwt_msg_int(a_dec, a);
+    bwt_msg_int(b_dec, b);
+    BWT_MSG_PRINT(MSG_QUIZ_DECIMAL_AB, a_dec, b_dec);
 
     // Question 1: Binary representation of a
-    printf("Q1: What is the binary representation of `%d`?\n", a);
+    quiz_ask(&q_a, BWT_FORMAT_BINARY);
+    BWT_MSG_PRINT(MSG_QUIZ_BINARY_OF, "1", a_dec);
 
     char user_input[100];
     bool correct = false;
 
     while (!correct) {
         if (get_binary_input(user_input, sizeof(user_input), 8)) {
-            if (strcmp(user_input, a_bin) == 0) {
-                printf("Correct!\n\n");
+            if (grade_binary_answer(&q_a, user_input)) {
+                bwt_metric_inc(BWT_METRIC_CORRECT);
+                fputs(bwt_msg_text(MSG_RESULT_CORRECT), stdout);
+                printf("\n");
                 correct = true;
-            } else {
-                printf("Sorry, that is incorrect! Please try again\n\n");
             }
         } else {
-            printf("Invalid input. Please enter an 8-bit binary number.\n\n");
+            if (feof(stdin)) {
+                return;  // end of input
+            }
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            print_answer_form();
         }
     }
 
     // Question 2: Binary representation of b
-    printf("Q2: What is the binary representation of `%d`?\n", b);
+    quiz_ask(&q_b, BWT_FORMAT_BINARY);
+    BWT_MSG_PRINT(MSG_QUIZ_BINARY_OF, "2", b_dec);
 
     correct = false;
     while (!correct) {
         if (get_binary_input(user_input, sizeof(user_input), 8)) {
-            if (strcmp(user_input, b_bin) == 0) {
-                printf("Correct!\n\n");
+            if (grade_binary_answer(&q_b, user_input)) {
+                bwt_metric_inc(BWT_METRIC_CORRECT);
+                fputs(bwt_msg_text(MSG_RESULT_CORRECT), stdout);
+                printf("\n");
                 correct = true;
-            } else {
-                printf("Sorry, that is incorrect! Please try again\n\n");
             }
         } else {
-            printf("Invalid input. Please enter an 8-bit binary number.\n\n");
+            if (feof(stdin)) {
+                return;  // end of input
+            }
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            print_answer_form();
         }
     }
 
     // Question 3: Result of a&b in binary
-    printf("Q3: What is the result of `a&b` in binary?\n");
+    quiz_ask(&q_result, BWT_FORMAT_BINARY);
+    BWT_MSG_PRINT(MSG_QUIZ_RESULT, "3", "&", bwt_msg_text(MSG_FORMAT_BINARY));
 
     correct = false;
     while (!correct) {
         if (get_binary_input(user_input, sizeof(user_input), 8)) {
-            if (strcmp(user_input, result_bin) == 0) {
-                printf("Correct!\n\n");
+            if (grade_binary_answer(&q_result, user_input)) {
+                bwt_metric_inc(BWT_METRIC_CORRECT);
+                fputs(bwt_msg_text(MSG_RESULT_CORRECT), stdout);
+                printf("\n");
                 correct = true;
-            } else {
-                printf("Sorry, that is incorrect! Please try again\n\n");
             }
         } else {
-            printf("Invalid input. Please enter an 8-bit binary number.\n\n");
+            if (feof(stdin)) {
+                return;  // end of input
+            }
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            print_answer_form();
         }
     }
 
     // Question 4: Result of a&b in decimal
-    printf("Q4: What is the result of `a&b` in decimal?\n");
+    quiz_ask(&q_result, BWT_FORMAT_DECIMAL);
+    BWT_MSG_PRINT(MSG_QUIZ_RESULT, "4", "&", bwt_msg_text(MSG_FORMAT_DECIMAL));
 
     int result_dec = a & b;
     int user_dec;
@@ -352,95 +510,119 @@ void run_bitwise_and_quiz(void) {
     while (!correct) {
         printf(">>> ");
         if (scanf("%d", &user_dec) == 1) {
-            if (user_dec == result_dec) {
-                printf("Correct!\n\n");
+            if (quiz_answer(user_dec == result_dec, (uint32_t)user_dec)) {
+                bwt_metric_inc(BWT_METRIC_CORRECT);
+                fputs(bwt_msg_text(MSG_RESULT_CORRECT), stdout);
+                printf("\n");
                 correct = true;
             } else {
-                printf("Sorry, that is incorrect! Please try again\n\n");
+                bwt_metric_inc(BWT_METRIC_WRONG);
+                fputs(bwt_msg_text(MSG_RESULT_WRONG), stdout);
+                printf("\n");
             }
         } else {
-            printf("Invalid input. Please enter a decimal number.\n\n");
+            if (feof(stdin)) {
+                return;  // end of input
+            }
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            print_answer_form();
             clear_input_buffer();
         }
     }
 
-    // Clean up
-    free_if_not_null(a_bin);
-    free_if_not_null(b_bin);
-    free_if_not_null(result_bin);
     clear_input_buffer();
 }
 /**
  * Run a quiz on bitwise XOR operation
  */
 void run_bitwise_xor_quiz(void) {
-    // Generate two random 8-bit integers
-    int8_t a = rand();
-    int8_t b = rand();
+    // Draw two 8-bit integers from the configured operand distribution, avoiding repeats
+    uint32_t a_bits, b_bits;
+    bwt_coverage_pair(&learner->coverage, BWT_DIST_XOR, BWT_TOPIC_XOR, 8, true, &a_bits, &b_bits);
+    int8_t a = (int8_t)a_bits;
+    int8_t b = (int8_t)b_bits;
 
-    char* a_bin = int8_to_binary(a);
-    char* b_bin = int8_to_binary(b);
-    char* result_bin = int8_to_binary(a ^ b);
+    struct bwt_question q_a = bwt_question_make(BWT_TOPIC_DEC2BIN, 8, true, (uint8_t)a, 0);
+    struct bwt_question q_b = bwt_question_make(BWT_TOPIC_DEC2BIN, 8, true, (uint8_t)b, 0);
+    struct bwt_question q_result = bwt_question_make(BWT_TOPIC_XOR, 8, true, (uint8_t)a, (uint8_t)b);
 
     // Quiz: Decimal to Binary
-    printf("\nThe following questions are about signed 8-bit integers *a* and *b*.\n");
-    printf("Given `a=%d` and `b=%d`,\n\n", a, b);
+    char a_dec[BWT_MSG_INT_SIZE], b_dec[BWT_MSG_INT_SIZE];
+    bwt_msg_int(a_dec, a);
+    bwt_msg_int(b_dec, b);
+    BWT_MSG_PRINT(MSG_QUIZ_DECIMAL_AB, a_dec, b_dec);
 
     // Question 1: Binary representation of a
-    printf("Q1: What is the binary representation of `%d`?\n", a);
+    quiz_ask(&q_a, BWT_FORMAT_BINARY);
+    BWT_MSG_PRINT(MSG_QUIZ_BINARY_OF, "1", a_dec);
 
     char user_input[100];
     bool correct = false;
 
     while (!correct) {
         if (get_binary_input(user_input, sizeof(user_input), 8)) {
-            if (strcmp(user_input, a_bin) == 0) {
-                printf("Correct!\n\n");
+            if (grade_binary_answer(&q_a, user_input)) {
+                bwt_metric_inc(BWT_METRIC_CORRECT);
+                fputs(bwt_msg_text(MSG_RESULT_CORRECT), stdout);
+                printf("\n");
                 correct = true;
-            } else {
-                printf("Sorry, that is incorrect! Please try again\n\n");
             }
         } else {
-            printf("Invalid input. Please enter an 8-bit binary number.\n\n");
+            if (feof(stdin)) {
+                return;  // end of input
+            }
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            print_answer_form();
         }
     }
 
     // Question 2: Binary representation of b
-    printf("Q2: What is the binary representation of `%d`?\n", b);
+    quiz_ask(&q_b, BWT_FORMAT_BINARY);
+    BWT_MSG_PRINT(MSG_QUIZ_BINARY_OF, "2", b_dec);
 
     correct = false;
     while (!correct) {
         if (get_binary_input(user_input, sizeof(user_input), 8)) {
-            if (strcmp(user_input, b_bin) == 0) {
-                printf("Correct!\n\n");
+            if (grade_binary_answer(&q_b, user_input)) {
+                bwt_metric_inc(BWT_METRIC_CORRECT);
+                fputs(bwt_msg_text(MSG_RESULT_CORRECT), stdout);
+                printf("\n");
                 correct = true;
-            } else {
-                printf("Sorry, that is incorrect! Please try again\n\n");
             }
         } else {
-            printf("Invalid input. Please enter an 8-bit binary number.\n\n");
+            if (feof(stdin)) {
+                return;  // end of input
+            }
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            print_answer_form();
         }
     }
 
     // Question 3: Result of a^b in binary
-    printf("Q3: What is the result of `a^b` in binary?\n");
+    quiz_ask(&q_result, BWT_FORMAT_BINARY);
+    BWT_MSG_PRINT(MSG_QUIZ_RESULT, "3", "^", bwt_msg_text(MSG_FORMAT_BINARY));
 
     correct = false;
     while (!correct) {
         if (get_binary_input(user_input, sizeof(user_input), 8)) {
-            if (strcmp(user_input, result_bin) == 0) {
-                printf("Correct!\n\n");
+            if (grade_binary_answer(&q_result, user_input)) {
+                bwt_metric_inc(BWT_METRIC_CORRECT);
+                fputs(bwt_msg_text(MSG_RESULT_CORRECT), stdout);
+                printf("\n");
                 correct = true;
-            } else {
-                printf("Sorry, that is incorrect! Please try again\n\n");
             }
         } else {
-            printf("Invalid input. Please enter an 8-bit binary number.\n\n");
+            if (feof(stdin)) {
+                return;  // end of input
+            }
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            print_answer_form();
         }
     }
 
     // Question 4: Result of a^b in decimal
-    printf("Q4: What is the result of `a^b` in decimal?\n");
+    quiz_ask(&q_result, BWT_FORMAT_DECIMAL);
+    BWT_MSG_PRINT(MSG_QUIZ_RESULT, "4", "^", bwt_msg_text(MSG_FORMAT_DECIMAL));
 
     int result_dec = a ^ b;
     int user_dec;
@@ -449,95 +631,119 @@ void run_bitwise_xor_quiz(void) {
     while (!correct) {
         printf(">>> ");
         if (scanf("%d", &user_dec) == 1) {
-            if (user_dec == result_dec) {
-                printf("Correct!\n\n");
+            if (quiz_answer(user_dec == result_dec, (uint32_t)user_dec)) {
+                bwt_metric_inc(BWT_METRIC_CORRECT);
+                fputs(bwt_msg_text(MSG_RESULT_CORRECT), stdout);
+                printf("\n");
                 correct = true;
             } else {
-                printf("Sorry, that is incorrect! Please try again\n\n");
+                bwt_metric_inc(BWT_METRIC_WRONG);
+                fputs(bwt_msg_text(MSG_RESULT_WRONG), stdout);
+                printf("\n");
             }
         } else {
-            printf("Invalid input. Please enter a decimal number.\n\n");
+            if (feof(stdin)) {
+                return;  // end of input
+            }
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            print_answer_form();
             clear_input_buffer();
         }
     }
 
-    // Clean up
-    free_if_not_null(a_bin);
-    free_if_not_null(b_bin);
-    free_if_not_null(result_bin);
     clear_input_buffer();
 }
 /**
  * Run a quiz on bitwise OR operation
  */
 void run_bitwise_or_quiz(void) {
-    // Generate two random 8-bit integers
-    int8_t a = rand();
-    int8_t b = rand();
+    // Draw two 8-bit integers from the configured operand distribution, avoiding repeats
+    uint32_t a_bits, b_bits;
+    bwt_coverage_pair(&learner->coverage, BWT_DIST_OR, BWT_TOPIC_OR, 8, true, &a_bits, &b_bits);
+    int8_t a = (int8_t)a_bits;
+    int8_t b = (int8_t)b_bits;
 
-    char* a_bin = int8_to_binary(a);
-    char* b_bin = int8_to_binary(b);
-    char* result_bin = int8_to_binary(a | b);
+    struct bwt_question q_a = bwt_question_make(BWT_TOPIC_DEC2BIN, 8, true, (uint8_t)a, 0);
+    struct bwt_question q_b = bwt_question_make(BWT_TOPIC_DEC2BIN, 8, true, (uint8_t)b, 0);
+    struct bwt_question q_result = bwt_question_make(BWT_TOPIC_OR, 8, true, (uint8_t)a, (uint8_t)b);
 
     // Quiz: Decimal to Binary
-    printf("\nThe following questions are about signed 8-bit integers *a* and *b*.\n");
-    printf("Given `a=%d` and `b=%d`,\n\n", a, b);
+    char a_dec[BWT_MSG_INT_SIZE], b_dec[BWT_MSG_INT_SIZE];
+    bwt_msg_int(a_dec, a);
+    bwt_msg_int(b_dec, b);
+    BWT_MSG_PRINT(MSG_QUIZ_DECIMAL_AB, a_dec, b_dec);
 
     // Question 1: Binary representation of a
-    printf("Q1: What is the binary representation of `%d`?\n", a);
+    quiz_ask(&q_a, BWT_FORMAT_BINARY);
+    BWT_MSG_PRINT(MSG_QUIZ_BINARY_OF, "1", a_dec);
 
     char user_input[100];
     bool correct = false;
 
     while (!correct) {
         if (get_binary_input(user_input, sizeof(user_input), 8)) {
-            if (strcmp(user_input, a_bin) == 0) {
-                printf("Correct!\n\n");
+            if (grade_binary_answer(&q_a, user_input)) {
+                bwt_metric_inc(BWT_METRIC_CORRECT);
+                fputs(bwt_msg_text(MSG_RESULT_CORRECT), stdout);
+                printf("\n");
                 correct = true;
-            } else {
-                printf("Sorry, that is incorrect! Please try again\n\n");
             }
         } else {
-            printf("Invalid input. Please enter an 8-bit binary number.\n\n");
+            if (feof(stdin)) {
+                return;  // end of input
+            }
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            print_answer_form();
         }
     }
 
     // Question 2: Binary representation of b
-    printf("Q2: What is the binary representation of `%d`?\n", b);
+    quiz_ask(&q_b, BWT_FORMAT_BINARY);
+    BWT_MSG_PRINT(MSG_QUIZ_BINARY_OF, "2", b_dec);
 
     correct = false;
     while (!correct) {
         if (get_binary_input(user_input, sizeof(user_input), 8)) {
-            if (strcmp(user_input, b_bin) == 0) {
-                printf("Correct!\n\n");
+            if (grade_binary_answer(&q_b, user_input)) {
+                bwt_metric_inc(BWT_METRIC_CORRECT);
+                fputs(bwt_msg_text(MSG_RESULT_CORRECT), stdout);
+                printf("\n");
                 correct = true;
-            } else {
-                printf("Sorry, that is incorrect! Please try again\n\n");
             }
         } else {
-            printf("Invalid input. Please enter an 8-bit binary number.\n\n");
+            if (feof(stdin)) {
+                return;  // end of input
+            }
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            print_answer_form();
         }
     }
 
     // Question 3: Result of a|b in binary
-    printf("Q3: What is the result of `a|b` in binary?\n");
+    quiz_ask(&q_result, BWT_FORMAT_BINARY);
+    BWT_MSG_PRINT(MSG_QUIZ_RESULT, "3", "|", bwt_msg_text(MSG_FORMAT_BINARY));
 
     correct = false;
     while (!correct) {
         if (get_binary_input(user_input, sizeof(user_input), 8)) {
-            if (strcmp(user_input, result_bin) == 0) {
-                printf("Correct!\n\n");
+            if (grade_binary_answer(&q_result, user_input)) {
+                bwt_metric_inc(BWT_METRIC_CORRECT);
+                fputs(bwt_msg_text(MSG_RESULT_CORRECT), stdout);
+                printf("\n");
                 correct = true;
-            } else {
-                printf("Sorry, that is incorrect! Please try again\n\n");
             }
         } else {
-            printf("Invalid input. Please enter an 8-bit binary number.\n\n");
+            if (feof(stdin)) {
+                return;  // end of input
+            }
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            print_answer_form();
         }
     }
 
     // Question 4: Result of a|b in decimal
-    printf("Q4: What is the result of `a|b` in decimal?\n");
+    quiz_ask(&q_result, BWT_FORMAT_DECIMAL);
+    BWT_MSG_PRINT(MSG_QUIZ_RESULT, "4", "|", bwt_msg_text(MSG_FORMAT_DECIMAL));
 
     int result_dec = a | b;
     int user_dec;
@@ -546,22 +752,26 @@ void run_bitwise_or_quiz(void) {
     while (!correct) {
         printf(">>> ");
         if (scanf("%d", &user_dec) == 1) {
-            if (user_dec == result_dec) {
-                printf("Correct!\n\n");
+            if (quiz_answer(user_dec == result_dec, (uint32_t)user_dec)) {
+                bwt_metric_inc(BWT_METRIC_CORRECT);
+                fputs(bwt_msg_text(MSG_RESULT_CORRECT), stdout);
+                printf("\n");
                 correct = true;
             } else {
-                printf("Sorry, that is incorrect! Please try again\n\n");
+                bwt_metric_inc(BWT_METRIC_WRONG);
+                fputs(bwt_msg_text(MSG_RESULT_WRONG), stdout);
+                printf("\n");
             }
         } else {
-            printf("Invalid input. Please enter a decimal number.\n\n");
+            if (feof(stdin)) {
+                return;  // end of input
+            }
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            print_answer_form();
             clear_input_buffer();
         }
     }
 
-    // Clean up
-    free_if_not_null(a_bin);
-    free_if_not_null(b_bin);
-    free_if_not_null(result_bin);
     clear_input_buffer();
 }
 
@@ -575,13 +785,16 @@ void run_binary_first_quiz(void) {
 
     int a_dec = binary_to_int(a_bin);
     int b_dec = binary_to_int(b_bin);
-    char* result_bin = int8_to_binary(a_dec & b_dec);
+    struct bwt_question q_result = bwt_question_make(BWT_TOPIC_AND, 8, true,
+                                                     (uint32_t)a_dec, (uint32_t)b_dec);
+    struct bwt_question q_a_dec = bwt_question_make(BWT_TOPIC_BIN2DEC, 8, true, (uint32_t)a_dec, 0);
+    struct bwt_question q_b_dec = bwt_question_make(BWT_TOPIC_BIN2DEC, 8, true, (uint32_t)b_dec, 0);
 
-    printf("\nThe following questions are about signed 8-bit integers *a* and *b*.\n");
-    printf("Given `a=%s` and `b=%s` in binary,\n\n", a_bin, b_bin);
+    BWT_MSG_PRINT(MSG_QUIZ_BINARY_AB, a_bin, b_bin);
 
     // Question 1: a&b in binary
-    printf("Q1: What is `a&b` in binary?\n");
+    quiz_ask(&q_result, BWT_FORMAT_BINARY);
+    BWT_MSG_PRINT(MSG_QUIZ_VALUE, "1", "a&b", bwt_msg_text(MSG_FORMAT_BINARY));
 
     char user_input[100];
     bool correct = false;
@@ -602,7 +815,9 @@ void run_binary_first_quiz(void) {
             } else {
                 for (size_t i = 0; i < len; i++) {
                     if (user_input[i] != '0' && user_input[i] != '1') {
-                        printf("Please enter digits only.\n\n");
+                        bwt_metric_inc(BWT_METRIC_INVALID);
+                        fputs(bwt_msg_text(MSG_QUIZ_DIGITS_ONLY), stdout);
+                        printf("\n");
                         valid_input = false;
                         break;
                     }
@@ -610,18 +825,21 @@ void run_binary_first_quiz(void) {
             }
 
             if (valid_input) {
-                if (strcmp(user_input, result_bin) == 0) {
-                    printf("Correct!\n\n");
+                if (grade_binary_answer(&q_result, user_input)) {
+                    bwt_metric_inc(BWT_METRIC_CORRECT);
+                    fputs(bwt_msg_text(MSG_RESULT_CORRECT), stdout);
+                    printf("\n");
                     correct = true;
-                } else {
-                    printf("Sorry, that is incorrect! Please try again\n\n");
                 }
             }
+        } else {
+            return;  // end of input
         }
     }
 
     // Question 2: a in decimal
-    printf("Q2: What is `a` in decimal?\n");
+    quiz_ask(&q_a_dec, BWT_FORMAT_BINARY);
+    BWT_MSG_PRINT(MSG_QUIZ_VALUE, "2", "a", bwt_msg_text(MSG_FORMAT_DECIMAL));
 
     int user_dec;
     correct = false;
@@ -629,40 +847,55 @@ void run_binary_first_quiz(void) {
     while (!correct) {
         printf(">>> ");
         if (scanf("%d", &user_dec) == 1) {
-            if (user_dec == a_dec) {
-                printf("Correct!\n\n");
+            if (quiz_answer(user_dec == a_dec, (uint32_t)user_dec)) {
+                bwt_metric_inc(BWT_METRIC_CORRECT);
+                fputs(bwt_msg_text(MSG_RESULT_CORRECT), stdout);
+                printf("\n");
                 correct = true;
             } else {
-                printf("Sorry, that is incorrect! Please try again\n\n");
+                bwt_metric_inc(BWT_METRIC_WRONG);
+                fputs(bwt_msg_text(MSG_RESULT_WRONG), stdout);
+                printf("\n");
             }
         } else {
-            printf("Invalid input. Please enter a decimal number.\n\n");
+            if (feof(stdin)) {
+                return;  // end of input
+            }
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            print_answer_form();
             clear_input_buffer();
         }
     }
 
     // Question 3: b in decimal
-    printf("Q3: What is `b` in decimal?\n");
+    quiz_ask(&q_b_dec, BWT_FORMAT_BINARY);
+    BWT_MSG_PRINT(MSG_QUIZ_VALUE, "3", "b", bwt_msg_text(MSG_FORMAT_DECIMAL));
 
     correct = false;
 
     while (!correct) {
         printf(">>> ");
         if (scanf("%d", &user_dec) == 1) {
-            if (user_dec == b_dec) {
-                printf("Correct!\n\n");
+            if (quiz_answer(user_dec == b_dec, (uint32_t)user_dec)) {
+                bwt_metric_inc(BWT_METRIC_CORRECT);
+                fputs(bwt_msg_text(MSG_RESULT_CORRECT), stdout);
+                printf("\n");
                 correct = true;
             } else {
-                printf("Sorry, that is incorrect! Please try again\n\n");
+                bwt_metric_inc(BWT_METRIC_WRONG);
+                fputs(bwt_msg_text(MSG_RESULT_WRONG), stdout);
+                printf("\n");
             }
         } else {
-            printf("Invalid input. Please enter a decimal number.\n\n");
+            if (feof(stdin)) {
+                return;  // end of input
+            }
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            print_answer_form();
             clear_input_buffer();
         }
     }
 
-    // Clean up
-    free_if_not_null(result_bin);
     clear_input_buffer();
 }
 
@@ -696,43 +929,55 @@ void run_bitwise_not_quiz(void) {
     assert(signed_not == -3);       // ~2 == -3 (int8_t signed_not)
     assert(unsigned_not == 253);    // ~2 == 253 (uint8_t unsigned_not)
 
-    char* signed_bin = int8_to_binary(signed_val);
-    char* unsigned_bin = uint8_to_binary(unsigned_val);
-    char* signed_not_bin = int8_to_binary(signed_not);
-    char* unsigned_not_bin = uint8_to_binary(unsigned_not);
+    char signed_bin[BWT_BINARY_SIZE];
+    char unsigned_bin[BWT_BINARY_SIZE];
+    char signed_not_bin[BWT_BINARY_SIZE];
+    bwt_to_binary(signed_bin, (uint32_t)signed_val, 8);
+    bwt_to_binary(unsigned_bin, unsigned_val, 8);
+    bwt_to_binary(signed_not_bin, (uint32_t)signed_not, 8);
+    struct bwt_question q_signed_not = bwt_question_make(BWT_TOPIC_NOT, 8, true, (uint8_t)signed_val, 0);
+    struct bwt_question q_unsigned_not = bwt_question_make(BWT_TOPIC_NOT, 8, false, unsigned_val, 0);
 
     // Double-check that our binary conversion is correct
-    char expected_signed_not_bin[9] = "11111101";  // Correct binary representation of -3
+    [[maybe_unused]] char expected_signed_not_bin[9] = "11111101";  // Correct binary representation of -3
     assert(strcmp(signed_not_bin, expected_signed_not_bin) == 0);
 
-    printf("\nThe following questions are about the bitwise NOT operator with different integer types.\n");
-    printf("Given signed int `a=%d` and unsigned int `b=%u`,\n\n", signed_val, unsigned_val);
+    char a_dec[BWT_MSG_INT_SIZE], b_dec[BWT_MSG_INT_SIZE], not_a_dec[BWT_MSG_INT_SIZE], not_b_dec[BWT_MSG_INT_SIZE];
+    bwt_msg_int(a_dec, signed_val);
+    bwt_msg_int(b_dec, unsigned_val);
+    bwt_msg_int(not_a_dec, signed_not);
+    bwt_msg_int(not_b_dec, unsigned_not);
 
     // Show binary representations
-    printf("a (signed) in binary: %s\n", signed_bin);
-    printf("b (unsigned) in binary: %s\n\n", unsigned_bin);
+    BWT_MSG_PRINT(MSG_QUIZ_NOT_INTRO, a_dec, b_dec, signed_bin, unsigned_bin);
 
     // Question 1: ~a (signed) in binary
-    printf("Q1: What is `~a` in binary? (a is signed)\n");
+    quiz_ask(&q_signed_not, BWT_FORMAT_BINARY);
+    BWT_MSG_PRINT(MSG_QUIZ_NOT, "1", "a", bwt_msg_text(MSG_FORMAT_BINARY), bwt_msg_text(MSG_KIND_SIGNED));
 
     char user_input[100];
     bool correct = false;
 
     while (!correct) {
         if (get_binary_input(user_input, sizeof(user_input), 8)) {
-            if (strcmp(user_input, signed_not_bin) == 0) {
-                printf("Correct!\n\n");
+            if (grade_binary_answer(&q_signed_not, user_input)) {
+                bwt_metric_inc(BWT_METRIC_CORRECT);
+                fputs(bwt_msg_text(MSG_RESULT_CORRECT), stdout);
+                printf("\n");
                 correct = true;
-            } else {
-                printf("Sorry, that is incorrect! Please try again\n\n");
             }
         } else {
-            printf("Invalid input. Please enter an 8-bit binary number.\n\n");
+            if (feof(stdin)) {
+                goto done;  // end of input
+            }
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            print_answer_form();
         }
     }
 
     // Question 2: ~a (signed) in decimal
-    printf("Q2: What is `~a` in decimal? (a is signed)\n");
+    quiz_ask(&q_signed_not, BWT_FORMAT_DECIMAL);
+    BWT_MSG_PRINT(MSG_QUIZ_NOT, "2", "a", bwt_msg_text(MSG_FORMAT_DECIMAL), bwt_msg_text(MSG_KIND_SIGNED));
 
     int user_dec;
     correct = false;
@@ -740,39 +985,53 @@ void run_bitwise_not_quiz(void) {
     while (!correct) {
         printf(">>> ");
         if (scanf("%d", &user_dec) == 1) {
-            if (user_dec == signed_not) {
-                printf("Correct!\n\n");
+            if (quiz_answer(user_dec == signed_not, (uint32_t)user_dec)) {
+                bwt_metric_inc(BWT_METRIC_CORRECT);
+                fputs(bwt_msg_text(MSG_RESULT_CORRECT), stdout);
+                printf("\n");
                 correct = true;
             } else {
-                printf("Sorry, that is incorrect! Please try again\n\n");
+                bwt_metric_inc(BWT_METRIC_WRONG);
+                fputs(bwt_msg_text(MSG_RESULT_WRONG), stdout);
+                printf("\n");
             }
         } else {
-            printf("Invalid input. Please enter a decimal number.\n\n");
+            if (feof(stdin)) {
+                goto done;  // end of input
+            }
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            print_answer_form();
             clear_input_buffer();
         }
     }
 
     // Question 3: ~b (unsigned) in binary
-    printf("Q3: What is `~b` in binary? (b is unsigned)\n");
+    quiz_ask(&q_unsigned_not, BWT_FORMAT_BINARY);
+    BWT_MSG_PRINT(MSG_QUIZ_NOT, "3", "b", bwt_msg_text(MSG_FORMAT_BINARY), bwt_msg_text(MSG_KIND_UNSIGNED));
 
     clear_input_buffer();
     correct = false;
 
     while (!correct) {
         if (get_binary_input(user_input, sizeof(user_input), 8)) {
-            if (strcmp(user_input, unsigned_not_bin) == 0) {
-                printf("Correct!\n\n");
+            if (grade_binary_answer(&q_unsigned_not, user_input)) {
+                bwt_metric_inc(BWT_METRIC_CORRECT);
+                fputs(bwt_msg_text(MSG_RESULT_CORRECT), stdout);
+                printf("\n");
                 correct = true;
-            } else {
-                printf("Sorry, that is incorrect! Please try again\n\n");
             }
         } else {
-            printf("Invalid input. Please enter an 8-bit binary number.\n\n");
+            if (feof(stdin)) {
+                goto done;  // end of input
+            }
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            print_answer_form();
         }
     }
 
     // Question 4: ~b (unsigned) in decimal
-    printf("Q4: What is `~b` in decimal? (b is unsigned)\n");
+    quiz_ask(&q_unsigned_not, BWT_FORMAT_DECIMAL);
+    BWT_MSG_PRINT(MSG_QUIZ_NOT, "4", "b", bwt_msg_text(MSG_FORMAT_DECIMAL), bwt_msg_text(MSG_KIND_UNSIGNED));
 
     unsigned user_udec;
     correct = false;
@@ -780,37 +1039,30 @@ void run_bitwise_not_quiz(void) {
     while (!correct) {
         printf(">>> ");
         if (scanf("%u", &user_udec) == 1) {
-            if (user_udec == unsigned_not) {
-                printf("Correct!\n\n");
+            if (quiz_answer(user_udec == unsigned_not, user_udec)) {
+                bwt_metric_inc(BWT_METRIC_CORRECT);
+                fputs(bwt_msg_text(MSG_RESULT_CORRECT), stdout);
+                printf("\n");
                 correct = true;
             } else {
-                printf("Sorry, that is incorrect! Please try again\n\n");
+                bwt_metric_inc(BWT_METRIC_WRONG);
+                fputs(bwt_msg_text(MSG_RESULT_WRONG), stdout);
+                printf("\n");
             }
         } else {
-            printf("Invalid input. Please enter a decimal number.\n\n");
+            if (feof(stdin)) {
+                goto done;  // end of input
+            }
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            print_answer_form();
             clear_input_buffer();
         }
     }
 
     // Explanation of two's complement
-    printf("Did you notice the difference?\n");
-    printf("~%d (signed) = %d, while ~%u (unsigned) = %u\n", signed_val, signed_not, unsigned_val, unsigned_not);
-    printf("This is because negative numbers are stored using two's complement.\n");
-    printf("For bitwise NOT (~) operation:\n");
-    printf("1. When we apply ~ to a number, we simply flip all the bits.\n");
-    printf("2. For unsigned integers, this just gives us the bitwise complement.\n");
-    printf("3. For signed integers, the result is interpreted as a two's complement representation\n");
-    printf("   of a negative number if the most significant bit is 1.\n");
-    printf("\nTo verify: The binary representation of %d is %s\n", signed_val, signed_bin);
-    printf("Applying ~ gives us %s (which is %d in decimal)\n", signed_not_bin, signed_not);
-    printf("This matches our expectation since ~%d = %d for signed 8-bit integers.\n",
-           signed_val, signed_not);
-
-    // Clean up
-    free_if_not_null(signed_bin);
-    free_if_not_null(unsigned_bin);
-    free_if_not_null(signed_not_bin);
-    free_if_not_null(unsigned_not_bin);
+    BWT_MSG_PRINT(MSG_QUIZ_NOT_EXPLAIN, a_dec, not_a_dec, b_dec, not_b_dec, signed_bin, signed_not_bin);
+
+done:
     clear_input_buffer();
 }
 
@@ -819,20 +1071,11 @@ void run_bitwise_not_quiz(void) {
  * highlighting the differences between signed and unsigned integers
  */
 void run_binary_decimal_conversion_quiz(void) {
-    printf("\n=== Binary <--> Decimal Conversion Quiz ===\n");
-    printf("This quiz will help you understand how the same binary pattern\n");
-    printf("can represent different values as signed or unsigned integers.\n\n");
-
     int sub_choice;
 
-    printf("Choose a sub-topic:\n");
-    printf("1. Decimal to Binary conversions\n");
-    printf("2. Binary to Decimal conversions\n");
-    printf("3. Same binary, different interpretations\n");
-    printf("Enter your choice (1-3): ");
-
+    fputs(bwt_msg_text(MSG_CONVERT_MENU), stdout);
     if (scanf("%d", &sub_choice) != 1) {
-        printf("Invalid input. Please enter a number.\n");
+        fputs(bwt_msg_text(MSG_MENU_INVALID), stdout);
         clear_input_buffer();
         return;
     }
@@ -843,54 +1086,76 @@ void run_binary_decimal_conversion_quiz(void) {
         case 1:
             // Decimal to Binary conversions
             {
-                // Generate a random number for the quiz
-                int8_t signed_val = rand() % 100 - 50;  // Range: -50 to 49
-                uint8_t unsigned_val = (uint8_t)abs(signed_val);
-
-                printf("\n=== Decimal to Binary Conversion ===\n");
+                // Draw a width and a value from the configured distributions
+                uint8_t width = bwt_sample_width();
+                uint32_t bits;
+                bwt_coverage_pair(&learner->coverage, BWT_DIST_CONVERT, BWT_TOPIC_DEC2BIN, width, true, &bits, NULL);
+                int64_t signed_val = bwt_value(bits, width, true);
+                // The magnitude always fits, even for the minimum e.g. |-128| = 128
+                uint32_t unsigned_val = (uint32_t)(signed_val < 0 ? -signed_val : signed_val);
+
+                struct bwt_question q_signed = bwt_question_make(BWT_TOPIC_DEC2BIN, width, true,
+                                                                 (uint32_t)signed_val, 0);
+                struct bwt_question q_unsigned = bwt_question_make(BWT_TOPIC_DEC2BIN, width, false,
+                                                                   unsigned_val, 0);
+
+                char signed_dec[BWT_MSG_INT_SIZE], unsigned_dec[BWT_MSG_INT_SIZE], width_dec[BWT_MSG_INT_SIZE];
+                bwt_msg_int(signed_dec, signed_val);
+                bwt_msg_int(unsigned_dec, unsigned_val);
+                bwt_msg_int(width_dec, width);
+
+                fputs(bwt_msg_text(MSG_CONVERT_DEC2BIN_TITLE), stdout);
 
                 // Signed integer conversion
-                printf("Q1: Convert the signed decimal %d to 8-bit binary representation.\n", signed_val);
+                quiz_ask(&q_signed, BWT_FORMAT_BINARY);
+                BWT_MSG_PRINT(MSG_QUESTION_DEC2BIN, "1", bwt_msg_text(MSG_KIND_SIGNED), signed_dec, width_dec,
+                              bwt_msg_text(MSG_FORMAT_BINARY));
 
-                char* signed_bin = int8_to_binary(signed_val);
+                char signed_bin[BWT_MAX_WIDTH + 1];
+                bwt_format_binary(signed_bin, (uint32_t)signed_val, width);
                 char user_input[100];
                 bool correct = false;
 
                 while (!correct) {
-                    if (get_binary_input(user_input, sizeof(user_input), 8)) {
-                        if (strcmp(user_input, signed_bin) == 0) {
-                            printf("Correct! %d in binary is %s\n\n", signed_val, signed_bin);
+                    if (get_binary_input(user_input, sizeof(user_input), width)) {
+                        if (grade_binary_answer(&q_signed, user_input)) {
+                            bwt_metric_inc(BWT_METRIC_CORRECT);
+                            BWT_MSG_PRINT(MSG_CONVERT_DEC2BIN_CORRECT, signed_dec, signed_bin);
                             correct = true;
-                        } else {
-                            printf("Sorry, that is incorrect! Please try again\n\n");
                         }
                     } else {
-                        printf("Invalid input. Please enter an 8-bit binary number.\n\n");
+                        if (feof(stdin)) {
+                            return;  // end of input
+                        }
+                        bwt_metric_inc(BWT_METRIC_INVALID);
+                        print_answer_form();
                     }
                 }
 
                 // Unsigned integer conversion
-                printf("Q2: Convert the unsigned decimal %u to 8-bit binary representation.\n", unsigned_val);
+                quiz_ask(&q_unsigned, BWT_FORMAT_BINARY);
+                BWT_MSG_PRINT(MSG_QUESTION_DEC2BIN, "2", bwt_msg_text(MSG_KIND_UNSIGNED), unsigned_dec, width_dec,
+                              bwt_msg_text(MSG_FORMAT_BINARY));
 
-                char* unsigned_bin = uint8_to_binary(unsigned_val);
+                char unsigned_bin[BWT_MAX_WIDTH + 1];
+                bwt_format_binary(unsigned_bin, unsigned_val, width);
                 correct = false;
 
                 while (!correct) {
-                    if (get_binary_input(user_input, sizeof(user_input), 8)) {
-                        if (strcmp(user_input, unsigned_bin) == 0) {
-                            printf("Correct! %u in binary is %s\n\n", unsigned_val, unsigned_bin);
+                    if (get_binary_input(user_input, sizeof(user_input), width)) {
+                        if (grade_binary_answer(&q_unsigned, user_input)) {
+                            bwt_metric_inc(BWT_METRIC_CORRECT);
+                            BWT_MSG_PRINT(MSG_CONVERT_DEC2BIN_CORRECT, unsigned_dec, unsigned_bin);
                             correct = true;
-                        } else {
-                            printf("Sorry, that is incorrect! Please try again\n\n");
                         }
                     } else {
-                        printf("Invalid input. Please enter an 8-bit binary number.\n\n");
+                        if (feof(stdin)) {
+                            return;  // end of input
+                        }
+                        bwt_metric_inc(BWT_METRIC_INVALID);
+                        print_answer_form();
                     }
                 }
-
-                // Clean up
-                free_if_not_null(signed_bin);
-                free_if_not_null(unsigned_bin);
             }
             break;
 
@@ -901,8 +1166,7 @@ void run_binary_decimal_conversion_quiz(void) {
                 // Start with a binary number that has a 1 in the most significant bit
                 const char* binary_val = "10101010";  // 170 unsigned, -86 signed
 
-                printf("\n=== Binary to Decimal Conversion ===\n");
-                printf("Given the binary number: %s\n\n", binary_val);
+                BWT_MSG_PRINT(MSG_CONVERT_BIN2DEC_TITLE, binary_val);
 
                 // Convert to unsigned
                 uint8_t unsigned_val = 0;
@@ -915,9 +1179,15 @@ void run_binary_decimal_conversion_quiz(void) {
                 for (int i = 0; i < 8; i++) {
                     signed_val = (signed_val << 1) | (binary_val[i] - '0');
                 }
+                struct bwt_question q_unsigned = bwt_question_make(BWT_TOPIC_BIN2DEC, 8, false, unsigned_val, 0);
+                struct bwt_question q_signed = bwt_question_make(BWT_TOPIC_BIN2DEC, 8, true, unsigned_val, 0);
+                char unsigned_dec[BWT_MSG_INT_SIZE], signed_dec[BWT_MSG_INT_SIZE];
+                bwt_msg_int(unsigned_dec, unsigned_val);
+                bwt_msg_int(signed_dec, signed_val);
 
                 // Question for unsigned
-                printf("Q1: What is the decimal value of %s when interpreted as an unsigned 8-bit integer?\n", binary_val);
+                quiz_ask(&q_unsigned, BWT_FORMAT_BINARY);
+                BWT_MSG_PRINT(MSG_QUESTION_BIN2DEC, "1", binary_val, "an", bwt_msg_text(MSG_KIND_UNSIGNED), "8");
 
                 unsigned int user_unsigned;
                 bool correct = false;
@@ -925,20 +1195,29 @@ void run_binary_decimal_conversion_quiz(void) {
                 while (!correct) {
                     printf(">>> ");
                     if (scanf("%u", &user_unsigned) == 1) {
-                        if (user_unsigned == unsigned_val) {
-                            printf("Correct! %s as an unsigned integer is %u\n\n", binary_val, unsigned_val);
+                        if (quiz_answer(user_unsigned == unsigned_val, user_unsigned)) {
+                            bwt_metric_inc(BWT_METRIC_CORRECT);
+                            BWT_MSG_PRINT(MSG_CONVERT_BIN2DEC_CORRECT, binary_val, "an", bwt_msg_text(MSG_KIND_UNSIGNED),
+                                          unsigned_dec);
                             correct = true;
                         } else {
-                            printf("Sorry, that is incorrect! Please try again\n\n");
+                            bwt_metric_inc(BWT_METRIC_WRONG);
+                            fputs(bwt_msg_text(MSG_RESULT_WRONG), stdout);
+                            printf("\n");
                         }
                     } else {
-                        printf("Invalid input. Please enter a decimal number.\n\n");
+                        if (feof(stdin)) {
+                            return;  // end of input
+                        }
+                        bwt_metric_inc(BWT_METRIC_INVALID);
+                        print_answer_form();
                         clear_input_buffer();
                     }
                 }
 
                 // Question for signed
-                printf("Q2: What is the decimal value of %s when interpreted as a signed 8-bit integer?\n", binary_val);
+                quiz_ask(&q_signed, BWT_FORMAT_BINARY);
+                BWT_MSG_PRINT(MSG_QUESTION_BIN2DEC, "2", binary_val, "a", bwt_msg_text(MSG_KIND_SIGNED), "8");
 
                 int user_signed;
                 correct = false;
@@ -948,14 +1227,22 @@ void run_binary_decimal_conversion_quiz(void) {
                 while (!correct) {
                     printf(">>> ");
                     if (scanf("%d", &user_signed) == 1) {
-                        if (user_signed == signed_val) {
-                            printf("Correct! %s as a signed integer is %d\n\n", binary_val, signed_val);
+                        if (quiz_answer(user_signed == signed_val, (uint32_t)user_signed)) {
+                            bwt_metric_inc(BWT_METRIC_CORRECT);
+                            BWT_MSG_PRINT(MSG_CONVERT_BIN2DEC_CORRECT, binary_val, "a", bwt_msg_text(MSG_KIND_SIGNED),
+                                          signed_dec);
                             correct = true;
                         } else {
-                            printf("Sorry, that is incorrect! Please try again\n\n");
+                            bwt_metric_inc(BWT_METRIC_WRONG);
+                            fputs(bwt_msg_text(MSG_RESULT_WRONG), stdout);
+                            printf("\n");
                         }
                     } else {
-                        printf("Invalid input. Please enter a decimal number.\n\n");
+                        if (feof(stdin)) {
+                            return;  // end of input
+                        }
+                        bwt_metric_inc(BWT_METRIC_INVALID);
+                        print_answer_form();
                         clear_input_buffer();
                     }
                 }
@@ -967,9 +1254,7 @@ void run_binary_decimal_conversion_quiz(void) {
         case 3:
             // Same binary, different interpretations
             {
-                printf("\n=== Same Binary, Different Interpretations ===\n");
-                printf("This quiz demonstrates how the same binary pattern can represent\n");
-                printf("different values depending on whether it's interpreted as signed or unsigned.\n\n");
+                fputs(bwt_msg_text(MSG_CONVERT_PATTERNS_INTRO), stdout);
 
                 // Use a few interesting binary patterns
                 const char* binary_patterns[] = {
@@ -996,35 +1281,40 @@ void run_binary_decimal_conversion_quiz(void) {
                         signed_val = (signed_val << 1) | (binary[j] - '0');
                     }
 
-                    printf("Binary pattern: %s\n", binary);
-                    printf("As unsigned 8-bit integer: %u\n", unsigned_val);
-                    printf("As signed 8-bit integer: %d\n\n", signed_val);
+                    char unsigned_dec[BWT_MSG_INT_SIZE], signed_dec[BWT_MSG_INT_SIZE];
+                    BWT_MSG_PRINT(MSG_CONVERT_PATTERN, binary, bwt_msg_int(unsigned_dec, unsigned_val),
+                                  bwt_msg_int(signed_dec, signed_val));
 
                     // Only ask questions for the first two patterns
                     if (i < 2) {
                         // Question: Explain why the same binary can have different values
-                        printf("Q%d: Why does the binary pattern %s represent different values?\n", i+1, binary);
-                        printf("1. Because binary numbers are always ambiguous\n");
-                        printf("2. Because the most significant bit is interpreted as the sign bit for signed integers\n");
-                        printf("3. Because unsigned integers can only be positive\n");
-                        printf("4. Because signed integers use a different counting system\n");
+                        // Not about a bit pattern, so counted but not in the results file
+                        bwt_metric_inc(BWT_METRIC_QUESTIONS);
+                        char number[BWT_MSG_INT_SIZE];
+                        BWT_MSG_PRINT(MSG_CONVERT_WHY, bwt_msg_int(number, i + 1), binary);
 
                         int answer;
                         bool correct = false;
 
                         while (!correct) {
-                            printf("Enter your answer (1-4): ");
+                            fputs(bwt_msg_text(MSG_CONVERT_WHY_PROMPT), stdout);
                             if (scanf("%d", &answer) == 1) {
                                 if (answer == 2) {
-                                    printf("Correct! In signed integers, the most significant bit (leftmost) is the sign bit.\n");
-                                    printf("If it's 1, the number is negative and uses two's complement representation.\n");
-                                    printf("In unsigned integers, all bits (including the most significant) represent magnitude.\n\n");
+                                    bwt_metric_inc(BWT_METRIC_CORRECT);
+                                    fputs(bwt_msg_text(MSG_CONVERT_WHY_CORRECT), stdout);
                                     correct = true;
                                 } else {
-                                    printf("Sorry, that is incorrect! Please try again\n\n");
+                                    bwt_metric_inc(BWT_METRIC_WRONG);
+                                    fputs(bwt_msg_text(MSG_RESULT_WRONG), stdout);
+                                    printf("\n");
                                 }
                             } else {
-                                printf("Invalid input. Please enter a number.\n\n");
+                                if (feof(stdin)) {
+                                    return;  // end of input
+                                }
+                                bwt_metric_inc(BWT_METRIC_INVALID);
+                                fputs(bwt_msg_text(MSG_MENU_INVALID), stdout);
+                                printf("\n");
                                 clear_input_buffer();
                             }
                         }
@@ -1034,25 +1324,12 @@ void run_binary_decimal_conversion_quiz(void) {
                 }
 
                 // Final explanation
-                printf("=== Key Insights ===\n");
-                printf("1. The same binary pattern can have different decimal values depending on interpretation.\n");
-                printf("2. For signed integers (using two's complement):\n");
-                printf("   - If the most significant bit is 0, the number is positive.\n");
-                printf("   - If the most significant bit is 1, the number is negative.\n");
-                printf("3. For unsigned integers, all bits contribute to the magnitude.\n");
-                printf("4. To convert a negative number to two's complement:\n");
-                printf("   - Take the absolute value in binary\n");
-                printf("   - Invert all bits (one's complement)\n");
-                printf("   - Add 1 to the result\n");
-                printf("5. Example: -5 in two's complement 8-bit binary:\n");
-                printf("   - 5 in binary: 00000101\n");
-                printf("   - Invert bits: 11111010\n");
-                printf("   - Add 1:      11111011\n");
+                fputs(bwt_msg_text(MSG_CONVERT_INSIGHTS), stdout);
             }
             break;
 
         default:
-            printf("Invalid choice. Returning to main menu.\n");
+            fputs(bwt_msg_text(MSG_QUIZ_UNKNOWN_CHOICE), stdout);
     }
 }
 
@@ -1060,187 +1337,342 @@ void run_binary_decimal_conversion_quiz(void) {
  * Run a quiz on bitwise shift operations (left-shift << and right-shift >>)
  */
 void run_shift_quiz(void) {
-    // Generate a small random unsigned 8-bit integer
-    uint8_t a = rand() % 128; // keep it in 7 bits for easy observation
-    uint8_t left_amt = 1 + rand() % 3; // left shift by 1, 2 or 3
-    uint8_t right_amt = 1 + rand() % 3; // right shift by 1, 2 or 3
+    // Draw an unsigned 8-bit integer from the configured operand distribution, avoiding repeats
+    uint32_t a_bits;
+    bwt_coverage_pair(&learner->coverage, BWT_DIST_SHIFT, BWT_TOPIC_SHL, 8, false, &a_bits, NULL);
+    uint8_t a = (uint8_t)a_bits;
+    uint8_t left_amt = 1 + bwt_rand32() % 3; // left shift by 1, 2 or 3
+    uint8_t right_amt = 1 + bwt_rand32() % 3; // right shift by 1, 2 or 3
 
-    char* a_bin = uint8_to_binary(a);
+    struct bwt_question q_a = bwt_question_make(BWT_TOPIC_DEC2BIN, 8, false, a, 0);
 
-    printf("\nThe following questions are about shifting unsigned 8-bit integer a bitwise.\n");
-    printf("Given a = %u\n", a);
+    char a_dec[BWT_MSG_INT_SIZE], left_dec[BWT_MSG_INT_SIZE], right_dec[BWT_MSG_INT_SIZE];
+    bwt_msg_int(a_dec, a);
+    bwt_msg_int(left_dec, left_amt);
+    bwt_msg_int(right_dec, right_amt);
+    BWT_MSG_PRINT(MSG_QUIZ_SHIFT_INTRO, a_dec);
 
     // Q1: What is the binary representation of a?
-    printf("Q1: What is the binary representation of %u?\n", a);
+    quiz_ask(&q_a, BWT_FORMAT_BINARY);
+    BWT_MSG_PRINT(MSG_QUIZ_SHIFT_BINARY_OF, "1", a_dec);
     char user_input[100];
     bool correct = false;
     while (!correct) {
         if (get_binary_input(user_input, sizeof(user_input), 8)) {
-            if (strcmp(user_input, a_bin) == 0) {
-                printf("Correct!\n\n");
+            if (grade_binary_answer(&q_a, user_input)) {
+                bwt_metric_inc(BWT_METRIC_CORRECT);
+                fputs(bwt_msg_text(MSG_RESULT_CORRECT), stdout);
+                printf("\n");
                 correct = true;
-            } else {
-                printf("Sorry, that is incorrect! Please try again\n\n");
             }
         } else {
-            printf("Invalid input. Please enter an 8-bit binary number.\n\n");
+            if (feof(stdin)) {
+                return;  // end of input
+            }
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            print_answer_form();
         }
     }
 
     // Q2: What is the result of a << left_amt in binary?
     uint8_t left_val = a << left_amt;
-    char* left_bin = uint8_to_binary(left_val);
-    printf("Q2: What is the binary result of a << %u?\n", left_amt);
+    struct bwt_question q_left = bwt_question_make(BWT_TOPIC_SHL, 8, false, a, left_amt);
+    quiz_ask(&q_left, BWT_FORMAT_BINARY);
+    BWT_MSG_PRINT(MSG_QUIZ_SHIFT, "2", bwt_msg_text(MSG_FORMAT_BINARY), "<<", left_dec);
     correct = false;
     while (!correct) {
         if (get_binary_input(user_input, sizeof(user_input), 8)) {
-            if (strcmp(user_input, left_bin) == 0) {
-                printf("Correct!\n\n");
+            if (grade_binary_answer(&q_left, user_input)) {
+                bwt_metric_inc(BWT_METRIC_CORRECT);
+                fputs(bwt_msg_text(MSG_RESULT_CORRECT), stdout);
+                printf("\n");
                 correct = true;
-            } else {
-                printf("Sorry, that is incorrect! Please try again\n\n");
             }
         } else {
-            printf("Invalid input. Please enter an 8-bit binary number.\n\n");
+            if (feof(stdin)) {
+                return;  // end of input
+            }
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            print_answer_form();
         }
     }
 
     // Q3: What is the decimal result of a << left_amt?
-    printf("Q3: What is the decimal result of a << %u?\n", left_amt);
+    quiz_ask(&q_left, BWT_FORMAT_DECIMAL);
+    BWT_MSG_PRINT(MSG_QUIZ_SHIFT, "3", bwt_msg_text(MSG_FORMAT_DECIMAL), "<<", left_dec);
     int user_dec;
     correct = false;
     while (!correct) {
         printf(">>> ");
         if (scanf("%d", &user_dec) == 1) {
-            if ((uint8_t)user_dec == left_val) {
-                printf("Correct!\n\n");
+            if (quiz_answer((uint8_t)user_dec == left_val, (uint32_t)user_dec)) {
+                bwt_metric_inc(BWT_METRIC_CORRECT);
+                fputs(bwt_msg_text(MSG_RESULT_CORRECT), stdout);
+                printf("\n");
                 correct = true;
             } else {
-                printf("Sorry, that is incorrect! Please try again\n\n");
+                bwt_metric_inc(BWT_METRIC_WRONG);
+                fputs(bwt_msg_text(MSG_RESULT_WRONG), stdout);
+                printf("\n");
             }
         } else {
-            printf("Invalid input. Please enter a decimal number.\n\n");
+            if (feof(stdin)) {
+                return;  // end of input
+            }
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            print_answer_form();
             clear_input_buffer();
         }
     }
 
     // Q4: What is the result of a >> right_amt in binary?
     uint8_t right_val = a >> right_amt;
-    char* right_bin = uint8_to_binary(right_val);
-    printf("Q4: What is the binary result of a >> %u?\n", right_amt);
+    struct bwt_question q_right = bwt_question_make(BWT_TOPIC_SHR, 8, false, a, right_amt);
+    quiz_ask(&q_right, BWT_FORMAT_BINARY);
+    BWT_MSG_PRINT(MSG_QUIZ_SHIFT, "4", bwt_msg_text(MSG_FORMAT_BINARY), ">>", right_dec);
     clear_input_buffer();
     correct = false;
     while (!correct) {
         if (get_binary_input(user_input, sizeof(user_input), 8)) {
-            if (strcmp(user_input, right_bin) == 0) {
-                printf("Correct!\n\n");
+            if (grade_binary_answer(&q_right, user_input)) {
+                bwt_metric_inc(BWT_METRIC_CORRECT);
+                fputs(bwt_msg_text(MSG_RESULT_CORRECT), stdout);
+                printf("\n");
                 correct = true;
-            } else {
-                printf("Sorry, that is incorrect! Please try again\n\n");
             }
         } else {
-            printf("Invalid input. Please enter an 8-bit binary number.\n\n");
+            if (feof(stdin)) {
+                return;  // end of input
+            }
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            print_answer_form();
         }
     }
 
     // Q5: What is the decimal result of a >> right_amt?
-    printf("Q5: What is the decimal result of a >> %u?\n", right_amt);
+    quiz_ask(&q_right, BWT_FORMAT_DECIMAL);
+    BWT_MSG_PRINT(MSG_QUIZ_SHIFT, "5", bwt_msg_text(MSG_FORMAT_DECIMAL), ">>", right_dec);
     correct = false;
     while (!correct) {
         printf(">>> ");
         if (scanf("%d", &user_dec) == 1) {
-            if ((uint8_t)user_dec == right_val) {
-                printf("Correct!\n\n");
+            if (quiz_answer((uint8_t)user_dec == right_val, (uint32_t)user_dec)) {
+                bwt_metric_inc(BWT_METRIC_CORRECT);
+                fputs(bwt_msg_text(MSG_RESULT_CORRECT), stdout);
+                printf("\n");
                 correct = true;
             } else {
-                printf("Sorry, that is incorrect! Please try again\n\n");
+                bwt_metric_inc(BWT_METRIC_WRONG);
+                fputs(bwt_msg_text(MSG_RESULT_WRONG), stdout);
+                printf("\n");
             }
         } else {
-            printf("Invalid input. Please enter a decimal number.\n\n");
+            if (feof(stdin)) {
+                return;  // end of input
+            }
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            print_answer_form();
             clear_input_buffer();
         }
     }
 
-    free_if_not_null(a_bin);
-    free_if_not_null(left_bin);
-    free_if_not_null(right_bin);
     clear_input_buffer();
 }
 
+/**
+ * Run a round of adaptive practice where bwt picks the questions
+ *
+ * Each question comes from the (topic, width, signedness, operand pattern)
+ * bucket the scheduler currently ranks weakest, so areas the student keeps
+ * getting wrong, such as `~` on signed integers or `>>` on negative values,
+ * come back until they are mastered.
+ */
+void run_adaptive_quiz(void) {
+    char prompt[BWT_PROMPT_SIZE];
+    char expected_str[BWT_ANSWER_SIZE];
+    char expected_form[64];
+    char user_input[100];
+
+    bool practiced[BWT_TOPIC_COUNT][BWT_WIDTH_COUNT] = { 0 };
+
+    fputs(bwt_msg_text(MSG_ADAPTIVE_INTRO), stdout);
+
+    for (int number = 1; number <= ADAPTIVE_ROUND_LENGTH; number++) {
+        uint8_t topic, width, pattern;
+        bool is_signed;
+        refresh_settings();
+        uint16_t bucket = bwt_sched_select(&learner->sched);
+        bwt_sched_decode(bucket, &topic, &width, &is_signed, &pattern);
+        practiced[topic][bwt_width_index(width)] = true;
+
+        struct bwt_question q;
+        struct bwt_choices choices;
+        bwt_coverage_generate(&learner->coverage, &q, topic, width, is_signed, pattern);
+        BWT_PROBE4(question, topic, width, pattern, number);
+        bwt_question_render(&q, number, prompt, sizeof(prompt));
+        printf("%s", prompt);
+        if (multiple_choice) {
+            bwt_choices_make(&q, bwt_rand32(), &choices);
+            bwt_choices_render(&q, &choices, prompt, sizeof(prompt));
+            printf("%s", prompt);
+        }
+        bwt_metric_inc(BWT_METRIC_QUESTIONS);
+
+        bwt_question_format_answer(&q, q.expected, expected_str, sizeof(expected_str));
+
+        struct bwt_record rec = record_question(&q);
+        uint64_t asked_at = clock_us(CLOCK_MONOTONIC);
+        uint32_t attempts = 0;
+        bool correct = false;
+
+        while (!correct) {
+            if (!read_answer_line(user_input, sizeof(user_input))
+                || strcmp(user_input, "q") == 0) {
+                return;
+            }
+            if (strcmp(user_input, "?") == 0) {
+                bwt_metric_inc(BWT_METRIC_GAVE_UP);
+                BWT_MSG_PRINT(MSG_RESULT_ANSWER, expected_str);
+                printf("\n");
+                rec.flags |= BWT_RECORD_GAVE_UP;
+                break;
+            }
+
+            uint32_t answer;
+            enum bwt_verdict verdict = grade_answer(&q, multiple_choice ? &choices : NULL, user_input, &answer);
+            if (verdict != BWT_VERDICT_INVALID && attempts++ == 0) {
+                rec.first_answer = answer;
+            }
+            uint64_t latency_us = clock_us(CLOCK_MONOTONIC) - asked_at;
+            BWT_PROBE5(grade, topic, width, verdict, attempts, latency_us);
+            switch (verdict) {
+                case BWT_VERDICT_CORRECT:
+                    bwt_metric_inc(BWT_METRIC_CORRECT);
+                    bwt_metric_observe_latency(latency_us);
+                    fputs(bwt_msg_text(MSG_RESULT_CORRECT), stdout);
+                    printf("\n");
+                    rec.flags |= BWT_RECORD_CORRECT;
+                    correct = true;
+                    break;
+                case BWT_VERDICT_WRONG:
+                    bwt_metric_inc(BWT_METRIC_WRONG);
+                    fputs(bwt_msg_text(MSG_RESULT_WRONG), stdout);
+                    print_feedback(&q, answer);
+                    printf("\n");
+                    break;
+                default:
+                    bwt_metric_inc(BWT_METRIC_INVALID);
+                    describe_answer(&q, multiple_choice, expected_form, sizeof(expected_form));
+                    BWT_MSG_PRINT(MSG_RESULT_INVALID, expected_form);
+                    printf("\n");
+            }
+        }
+        bwt_sched_update(&learner->sched, bucket, correct, attempts);
+
+        write_record(&rec, asked_at, attempts);
+    }
+    fputs(bwt_msg_text(MSG_ADAPTIVE_DONE), stdout);
+
+    // How the round's topics went lately, from the learner's answer history
+    fputs(bwt_msg_text(MSG_ADAPTIVE_ACCURACY_TITLE), stdout);
+    for (uint8_t topic = 0; topic < BWT_TOPIC_COUNT; topic++) {
+        for (uint8_t w = 0; w < BWT_WIDTH_COUNT; w++) {
+            if (!practiced[topic][w]) {
+                continue;
+            }
+            uint8_t width = bwt_width_from_index(w);
+            struct bwt_history_tally tally;
+            bwt_history_tally(&learner->sched.history, topic, width, ADAPTIVE_HISTORY_WINDOW, &tally);
+            int accuracy = bwt_history_accuracy(&learner->sched.history, topic, width, ADAPTIVE_HISTORY_WINDOW);
+            char width_str[BWT_MSG_INT_SIZE], accuracy_str[BWT_MSG_INT_SIZE], total_str[BWT_MSG_INT_SIZE];
+            BWT_MSG_PRINT(MSG_ADAPTIVE_ACCURACY, bwt_topic_name(topic), bwt_msg_int(width_str, width),
+                          bwt_msg_int(accuracy_str, accuracy), bwt_msg_int(total_str, tally.total));
+        }
+    }
+}
 
 /**
- * Main function
+ * Sit an exam: every question is derived from the exam seed, the student
+ * and its number (see bwt_exam.h) and takes one answer, graded at the end
+ *
+ * @param seed The exam
+ * @param student Student id
+ * @param questions Number of questions
+ * @param answers Stream the answers are appended to as `student index
+ *                answer` lines for --regrade, or NULL
+ * @return Number of correct answers
+ */
+uint32_t run_exam(uint64_t seed, uint32_t student, uint32_t questions, FILE* answers) {
+    char prompt[BWT_PROMPT_SIZE];
+    char expected_form[64];
+    char user_input[100];
+    char student_str[BWT_MSG_INT_SIZE], count_str[BWT_MSG_INT_SIZE], correct_str[BWT_MSG_INT_SIZE];
+    uint32_t correct = 0;
+    uint32_t index = 0;
+
+    BWT_MSG_PRINT(MSG_EXAM_INTRO, bwt_msg_int(student_str, student), bwt_msg_int(count_str, questions));
+    for (; index < questions; index++) {
+        struct bwt_question q;
+        struct bwt_choices choices;
+        bwt_exam_question(&q, seed, student, index);
+        bwt_question_render(&q, (int)index + 1, prompt, sizeof(prompt));
+        printf("%s", prompt);
+        if (multiple_choice) {
+            bwt_exam_choices(&q, seed, student, index, &choices);
+            bwt_choices_render(&q, &choices, prompt, sizeof(prompt));
+            printf("%s", prompt);
+        }
+
+        enum bwt_verdict verdict;
+        uint32_t answer;
+        do {
+            if (!read_answer_line(user_input, sizeof(user_input))) {
+                goto done;  // end of input
+            }
+            verdict = grade_answer(&q, multiple_choice ? &choices : NULL, user_input, &answer);
+            if (verdict == BWT_VERDICT_INVALID) {
+                describe_answer(&q, multiple_choice, expected_form, sizeof(expected_form));
+                BWT_MSG_PRINT(MSG_RESULT_INVALID, expected_form);
+            }
+        } while (verdict == BWT_VERDICT_INVALID);
+        printf("\n");
+
+        correct += verdict == BWT_VERDICT_CORRECT;
+        if (answers != NULL) {
+            fprintf(answers, "%u %u %s\n", student, index, user_input);
+            fflush(answers);
+        }
+    }
+done:
+    BWT_MSG_PRINT(MSG_EXAM_SCORE, bwt_msg_int(correct_str, correct), bwt_msg_int(count_str, index));
+    return correct;
+}
+
+
+/**
+ * Show the main menu and run the chosen quizzes until the student exits
  */
-int main(void) {
-    // Verify our implementations with assertions
-    {
-        // Test basic binary conversion
-        uint8_t test_u8 = 42;
-        char* test_bin = uint8_to_binary(test_u8);
-        assert(strcmp(test_bin, "00101010") == 0);
-        free_if_not_null(test_bin);
-
-        // Test signed integers
-        int8_t test_i8 = -42;
-        test_bin = int8_to_binary(test_i8);
-        assert(strcmp(test_bin, "11010110") == 0);
-        free_if_not_null(test_bin);
-
-        // Test bitwise operations
-        uint8_t a = 5;   // 00000101
-        uint8_t b = 9;   // 00001001
-
-        assert((a & b) == 1);      // 5 & 9 == 1
-        assert((a | b) == 13);     // 5 | 9 == 13
-        assert((a ^ b) == 12);     // 5 ^ 9 == 12
-
-        // Critical test cases for bitwise NOT
-        int8_t signed_2 = 2;
-        int8_t signed_not_2 = ~signed_2;
-        assert(signed_not_2 == -3); // ~2 == -3 for signed int
-
-        uint8_t unsigned_2 = 2;
-        uint8_t unsigned_not_2 = ~unsigned_2;
-        assert(unsigned_not_2 == 253); // ~2 == 253 for unsigned int
-
-        int8_t signed_5 = 5;
-        int8_t signed_not_5 = ~signed_5;
-        assert(signed_not_5 == -6); // ~5 == -6 for signed int
-
-        // Test shift operations
-        assert((a << 1) == 10);    // 5 << 1 == 10
-        assert((a >> 1) == 2);     // 5 >> 1 == 2
-    }
-
-    // Seed random number generator
-    srand((unsigned int)time(NULL));
-
-    printf("Welcome to Bitwise Tutor (bwt)!\n");
-    printf("This program will help you practice bitwise operations and binary conversions.\n");
-    printf("Let's get started!\n\n");
+void run_menu(void) {
+    fputs(bwt_msg_text(MSG_WELCOME), stdout);
 
     int choice;
     bool running = true;
 
     while (running) {
-printf("\nChoose a quiz type:\n");
-        printf("1. Bitwise AND quiz (decimal values given)\n");
-        printf("2. Bitwise quiz (binary values given)\n");
-        printf("3. Bitwise XOR quiz (decimal values given)\n");
-        printf("4. Bitwise OR quiz (decimal values given)\n");
-        printf("5. Bitwise NOT quiz (signed vs unsigned)\n");
-        printf("6. Binary <--> decimal conversions\n");
-        printf("7. Bit-shift operations quiz\n");
-        printf("8. Exit\n");
-        printf("Enter your choice (1-8): ");
+        flush_results();
+        fputs(bwt_msg_text(MSG_MENU), stdout);
 
         if (scanf("%d", &choice) != 1) {
-            printf("Invalid input. Please enter a number.\n");
+            if (feof(stdin)) {
+                break;
+            }
+            fputs(bwt_msg_text(MSG_MENU_INVALID), stdout);
             clear_input_buffer();
             continue;
         }
 
         clear_input_buffer();
+        refresh_settings();
 
 switch (choice) {
         case 1:
@@ -1265,13 +1697,400 @@ switch (choice) {
             run_shift_quiz();
             break;
         case 8:
-            printf("Thank you for using Bitwise Tutor. Goodbye!\n");
+            run_adaptive_quiz();
+            break;
+        case 9:
+            fputs(bwt_msg_text(MSG_GOODBYE), stdout);
             running = false;
             break;
             default:
-                printf("Invalid choice. Please try again.\n");
+                fputs(bwt_msg_text(MSG_MENU_UNKNOWN_CHOICE), stdout);
+        }
+    }
+}
+
+/**
+ * Run one session of the main menu from a seed, as started by main or
+ * replayed by bwt_replay_main
+ *
+ * @param seed Seed of the random number generator
+ */
+void run_session(uint32_t seed) {
+    bwt_srand(seed);
+    learner->session_id = bwt_rand32();
+    bwt_sched_init(&learner->sched);
+    load_history();
+    refresh_settings();
+    // The filter size may differ between replayed recordings; without memory
+    // for it only 8-bit questions are tracked
+    bwt_coverage_free(&learner->coverage);
+    (void)bwt_coverage_init(&learner->coverage, bwt_dist_active()->coverage_kb);
+    uint64_t started = clock_us(CLOCK_MONOTONIC);
+    uint64_t asked = questions_asked();
+    run_menu();
+    flush_results();
+    if (BWT_PROBE_ENABLED(session_end)) {
+        BWT_PROBE3(session_end, 0, questions_asked() - asked, clock_us(CLOCK_MONOTONIC) - started);
+    }
+}
+
+/**
+ * Quiz state of a learner of --serve-menu, made current while their session runs
+ *
+ * @param id Learner id of the connection, stored in their results
+ */
+void* create_learner(uint32_t id) {
+    struct learner* l = calloc(1, sizeof(struct learner));
+    if (l != NULL) {
+        l->id = id;
+        l->anonymous = true;
+    }
+    return l;
+}
+
+void enter_learner(void* state) {
+    learner = state;
+    bwt_rng_local = &learner->rng;
+    bwt_settings_local = learner->settings;
+}
+
+void destroy_learner(void* state) {
+    struct learner* l = state;
+    bwt_settings_leave(l->settings);
+    bwt_settings_release(l->settings);
+    bwt_coverage_free(&l->coverage);
+    free(l);
+}
+
+/**
+ * Pick up an edited settings file and move the learner to the newest
+ * settings, before a quiz or question draws its operands
+ */
+void refresh_settings(void) {
+    bwt_settings_refresh(settings_watch, &learner->settings);
+}
+
+/**
+ * Questions this thread has asked so far, from its metrics shard
+ */
+uint64_t questions_asked(void) {
+    struct bwt_metrics_shard* shard = bwt_metrics_local;
+    return shard != NULL ? atomic_load_explicit(&shard->counters[BWT_METRIC_QUESTIONS], memory_order_relaxed) : 0;
+}
+
+/**
+ * Fill the learner's answer history from the results file, if it has any
+ *
+ * Anonymous learners start afresh: their id is new, so no records are theirs.
+ */
+void load_history(void) {
+    struct bwt_store_map map;
+    if (!learner->anonymous && history_path != NULL && bwt_store_map_open(&map, history_path) == 0) {
+        bwt_history_load(&learner->sched.history, map.records, map.count, learner->id);
+        bwt_store_map_close(&map);
+    }
+}
+
+/**
+ * Print command line usage
+ *
+ * @param prog Name the program was invoked as
+ */
+void print_usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [options]\n", prog);
+    fprintf(stderr, "  --config FILE    read settings from FILE instead of %s\n", DEFAULT_SETTINGS_FILE);
+    fprintf(stderr, "  --results FILE   append a record of every answered question to FILE\n");
+    fprintf(stderr, "  --learner ID     numeric learner id stored in results (default: user id)\n");
+    fprintf(stderr, "  --metrics FILE   write Prometheus metrics to FILE every 10 seconds\n");
+    fprintf(stderr, "  --metrics-socket PATH serve Prometheus metrics over HTTP on local socket PATH\n");
+    fprintf(stderr, "  --protocol jsonl talk JSON lines on stdin/stdout instead of the menu\n");
+    fprintf(stderr, "  --tui            full-screen adaptive practice with colored bits\n");
+    fprintf(stderr, "  --window N       questions open at once with --protocol (default: 4)\n");
+    fprintf(stderr, "  --broadcast PORT push questions to every learner connected to PORT\n");
+    fprintf(stderr, "  --serve PORT     serve adaptive practice to learners connecting to PORT\n");
+    fprintf(stderr, "  --workers N      worker processes for --serve (default: one per CPU)\n");
+    fprintf(stderr, "  --serve-menu PORT run the menu for every learner connecting to PORT, in one thread\n");
+    fprintf(stderr, "  --scoreboard PORT print class statistics of the --serve workers on PORT\n");
+    fprintf(stderr, "  --kernels NAME   binary format/parse kernels: auto, avx2, bmi2 or scalar\n");
+    fprintf(stderr, "  --lang LANG      language of questions and feedback, e.g. ko (default: $LANG)\n");
+    fprintf(stderr, "  --record FILE    save the seed, input and output of this session to FILE\n");
+    fprintf(stderr, "  --replay FILE... run recorded sessions again and compare their output, then exit\n");
+    fprintf(stderr, "  --replay-update FILE... rewrite recordings with the output of this build\n");
+    fprintf(stderr, "  --exam SEED      sit exam SEED as --learner ID, one answer per question\n");
+    fprintf(stderr, "  --questions N    questions in the exam (default: 20)\n");
+    fprintf(stderr, "  --answers FILE   append the exam answers to FILE for --regrade\n");
+    fprintf(stderr, "  --regrade FILE... with --exam SEED, grade the answers in FILEs, then exit\n");
+    fprintf(stderr, "  --scores FILE... with --exam SEED, print every student's score and bitmap, then exit\n");
+    fprintf(stderr, "  --choices        multiple-choice questions in adaptive practice and --exam\n");
+    fprintf(stderr, "  --threads N      worker threads for --report and --regrade (default: one per CPU)\n");
+    fprintf(stderr, "  --report FILE... print accuracy, latency and per-bit error statistics\n");
+    fprintf(stderr, "                   from results files, then exit\n");
+}
+
+/**
+ * Parse a TCP port number given on the command line
+ *
+ * @param arg The argument
+ * @return The port, or -1 after printing an error
+ */
+long parse_port(const char* arg) {
+    char* end;
+    long port = strtol(arg, &end, 10);
+    if (*end != '\0' || port <= 0 || port > 65535) {
+        fprintf(stderr, "Invalid port %s\n", arg);
+        return -1;
+    }
+    return port;
+}
+
+/**
+ * Main function
+ */
+int main(int argc, char* argv[]) {
+    const char* settings_path = NULL;
+    const char* results_path = NULL;
+    const char* metrics_file = NULL;
+    const char* metrics_socket = NULL;
+    const char* lang = NULL;
+    const char* record_path = NULL;
+    bool protocol = false;
+    bool tui = false;
+    long window = 4;
+    long broadcast_port = 0;
+    long serve_port = 0;
+    long menu_port = 0;
+    long workers = sysconf(_SC_NPROCESSORS_ONLN);
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    bool exam = false;
+    uint64_t exam_seed = 0;
+    long exam_questions = 20;
+    const char* answers_path = NULL;
+    long scoreboard_port = 0;
+    const char* command = NULL;  // --report, --regrade, --scores or --replay[-update]
+    int nfiles = 0;              // the FILEs of the command, gathered in argv + 1
+
+    terminal_learner.id = (uint32_t)getuid();
+    bwt_rng_local = &terminal_learner.rng;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--config") == 0 && i + 1 < argc) {
+            settings_path = argv[++i];
+        } else if (strcmp(argv[i], "--results") == 0 && i + 1 < argc) {
+            results_path = argv[++i];
+        } else if (strcmp(argv[i], "--learner") == 0 && i + 1 < argc) {
+            terminal_learner.id = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--kernels") == 0 && i + 1 < argc) {
+            if (bwt_kernels_select(argv[++i]) < 0) {
+                fprintf(stderr, "Kernels %s are unknown or not supported by this CPU (supported:", argv[i]);
+                for (size_t k = 0; bwt_kernels_all[k] != NULL; k++) {
+                    if (bwt_kernels_all[k]->supported()) {
+                        fprintf(stderr, " %s", bwt_kernels_all[k]->name);
+                    }
+                }
+                fprintf(stderr, ")\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--lang") == 0 && i + 1 < argc) {
+            lang = argv[++i];
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = strtol(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--metrics") == 0 && i + 1 < argc) {
+            metrics_file = argv[++i];
+        } else if (strcmp(argv[i], "--metrics-socket") == 0 && i + 1 < argc) {
+            metrics_socket = argv[++i];
+        } else if (strcmp(argv[i], "--protocol") == 0 && i + 1 < argc) {
+            if (strcmp(argv[++i], "jsonl") != 0) {
+                fprintf(stderr, "Unknown protocol %s (supported: jsonl)\n", argv[i]);
+                return 1;
+            }
+            protocol = true;
+        } else if (strcmp(argv[i], "--tui") == 0) {
+            tui = true;
+        } else if (strcmp(argv[i], "--window") == 0 && i + 1 < argc) {
+            window = strtol(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--broadcast") == 0 && i + 1 < argc) {
+            if ((broadcast_port = parse_port(argv[++i])) < 0) {
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--serve") == 0 && i + 1 < argc) {
+            if ((serve_port = parse_port(argv[++i])) < 0) {
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--serve-menu") == 0 && i + 1 < argc) {
+            if ((menu_port = parse_port(argv[++i])) < 0) {
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            workers = strtol(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--scoreboard") == 0 && i + 1 < argc) {
+            if ((scoreboard_port = parse_port(argv[++i])) < 0) {
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            record_path = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 || strcmp(argv[i], "--replay-update") == 0
+                   || strcmp(argv[i], "--regrade") == 0 || strcmp(argv[i], "--scores") == 0
+                   || strcmp(argv[i], "--report") == 0) {
+            if (command != NULL && strcmp(command, argv[i]) != 0) {
+                fprintf(stderr, "%s and %s cannot be combined\n", command, argv[i]);
+                return 1;
+            }
+            command = argv[i];
+        } else if (command != NULL && argv[i][0] != '-') {
+            argv[1 + nfiles++] = argv[i];  // never ahead of i, so no argument is lost
+        } else if (strcmp(argv[i], "--exam") == 0 && i + 1 < argc) {
+            char* end;
+            exam_seed = strtoull(argv[++i], &end, 0);
+            if (*end != '\0') {
+                fprintf(stderr, "Invalid exam seed %s\n", argv[i]);
+                return 1;
+            }
+            exam = true;
+        } else if (strcmp(argv[i], "--choices") == 0) {
+            multiple_choice = true;
+        } else if (strcmp(argv[i], "--questions") == 0 && i + 1 < argc) {
+            exam_questions = strtol(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--answers") == 0 && i + 1 < argc) {
+            answers_path = argv[++i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    // Commands that run and exit, once every option has been read
+    if (scoreboard_port != 0) {
+        return bwt_scoreboard_main((uint16_t)scoreboard_port);
+    }
+    if (command != NULL) {
+        if (nfiles == 0) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        if (strcmp(command, "--report") == 0) {
+            return bwt_report_main(argv + 1, nfiles, threads > 0 ? (int)threads : 1);
+        }
+        if (strncmp(command, "--replay", 8) == 0) {
+            int status = bwt_replay_main(argv + 1, nfiles, command[8] != '\0', run_session);
+            bwt_coverage_free(&learner->coverage);
+            return status;
+        }
+        if (!exam) {
+            fprintf(stderr, "%s needs --exam SEED\n", command);
+            return 1;
+        }
+        if (strcmp(command, "--regrade") == 0) {
+            return bwt_exam_regrade_main(argv + 1, nfiles, exam_seed, multiple_choice, threads > 0 ? (int)threads : 1);
+        }
+        return bwt_exam_score_main(argv + 1, nfiles, exam_seed, multiple_choice,
+                                   exam_questions > 0 ? (uint32_t)exam_questions : 0);
+    }
+
+    if (record_path != NULL && (protocol || tui || broadcast_port != 0 || serve_port != 0 || menu_port != 0)) {
+        fprintf(stderr, "--record works with the interactive menu only\n");
+        return 1;
+    }
+    if (results_path != NULL && (serve_port != 0 || broadcast_port != 0)) {
+        fprintf(stderr, "--results does not work with --serve or --broadcast, which keep no answers\n");
+        return 1;
+    }
+    if ((metrics_file != NULL || metrics_socket != NULL) && serve_port != 0) {
+        fprintf(stderr, "--metrics and --metrics-socket do not work with --serve, whose workers are processes\n");
+        return 1;
+    }
+    if (multiple_choice && (record_path != NULL || protocol || tui || broadcast_port != 0 || serve_port != 0)) {
+        fprintf(stderr, "--choices works with the interactive menu and --exam only, and is not recorded\n");
+        return 1;
+    }
+
+    // Messages in the language asked for, or the locale's; English otherwise
+    if (bwt_catalog_select(lang) < 0 && lang != NULL) {
+        fprintf(stderr, "No message catalog for %s, using English\n", lang);
+    }
+
+    // Operand and width distributions: built-in defaults, then the settings file
+    if (bwt_settings_load(settings_path != NULL ? settings_path : DEFAULT_SETTINGS_FILE) < 0
+        && settings_path != NULL) {
+        fprintf(stderr, "Could not open settings file %s\n", settings_path);
+        return 1;
+    }
+
+    if (exam) {
+        FILE* answers = answers_path != NULL ? fopen(answers_path, "a") : NULL;
+        if (answers_path != NULL && answers == NULL) {
+            perror(answers_path);
+            return 1;
+        }
+        run_exam(exam_seed, learner->id, exam_questions > 0 ? (uint32_t)exam_questions : 0, answers);
+        if (answers != NULL && fclose(answers) != 0) {
+            perror(answers_path);
+            return 1;
         }
+        return 0;
     }
 
+    bwt_sched_init(&learner->sched);
+    if (bwt_coverage_init(&learner->coverage, bwt_dist_active()->coverage_kb) < 0) {
+        perror("Could not allocate coverage filter");
+        return 1;
+    }
+    if (results_path != NULL && bwt_appender_open(&results, results_path) < 0) {
+        perror(results_path);
+        return 1;
+    }
+    history_path = results_path;
+
+    // Seed random number generator, saved by --record so the session can be replayed
+    uint32_t seed = (uint32_t)time(NULL);
+    bwt_srand(seed);
+    learner->session_id = bwt_rand32();
+
+    if (serve_port != 0) {
+        return bwt_serve_main((uint16_t)serve_port, (int)workers);
+    }
+    if ((metrics_file != NULL || metrics_socket != NULL)
+        && bwt_metrics_start(metrics_file, metrics_socket) < 0) {
+        perror("Could not start metrics export");
+        return 1;
+    }
+    settings_watch = bwt_settings_watch();
+    if (menu_port != 0) {
+        static const struct bwt_mux_learner menu_learner = { create_learner, enter_learner, destroy_learner };
+        int status = bwt_mux_main((uint16_t)menu_port, run_session, &menu_learner);
+        enter_learner(&terminal_learner);
+        bwt_metrics_stop();
+        bwt_coverage_free(&learner->coverage);
+        if (bwt_appender_close(&results) < 0) {
+            perror("Could not write results");
+        }
+        return status;
+    }
+    if (broadcast_port != 0 || protocol || tui) {
+        load_history();
+        int status = protocol ? bwt_proto_run((int)window, &learner->sched, &learner->coverage, &results, learner->id,
+                                              learner->session_id, settings_watch)
+            : tui ? bwt_tui_run(&learner->sched, &learner->coverage, &results, learner->id, learner->session_id,
+                                settings_watch)
+            : bwt_broadcast_main((uint16_t)broadcast_port, settings_watch);
+        bwt_metrics_stop();
+        bwt_coverage_free(&learner->coverage);
+        if (bwt_appender_close(&results) < 0) {
+            perror("Could not write results");
+        }
+        return status;
+    }
+
+    if (record_path != NULL && bwt_record_start(record_path, seed, settings_path != NULL
+                                                ? settings_path : DEFAULT_SETTINGS_FILE) < 0) {
+        perror(record_path);
+        return 1;
+    }
+    run_session(seed);
+    bwt_record_stop();
+    bwt_coverage_free(&learner->coverage);
+
+    if (bwt_appender_close(&results) < 0) {
+        perror("Could not write results");
+    }
+    bwt_metrics_stop();
     return 0;
 }
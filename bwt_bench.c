@@ -0,0 +1,550 @@
+/*
+ * bwt_bench.c - Benchmarks for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * Build and run with `make bench`. Pass a settings file to benchmark the
+ * distributions configured there instead of the built-in ones:
+ *
+ *     ./bin/bwt_bench [--config FILE]
+ */
+
+#define _POSIX_C_SOURCE 200809L  // clock_gettime
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bwt_question.h"
+#include "bwt_dist.h"
+#include "bwt_store.h"
+#include "bwt_report.h"
+#include "bwt_kernels.h"
+#include "bwt_catalog.h"
+#include "bwt_coverage.h"
+#include "bwt_history.h"
+#include "bwt_choice.h"
+#include "bwt_coro.h"
+#include "bwt_settings.h"
+#include "bwt_sheet.h"
+#include "bwt_exam.h"
+
+#define SAMPLES 2000000
+#define REPORT_RECORDS 4000000  // 160 MB of synthetic results
+
+/**
+ * Monotonic clock in nanoseconds
+ */
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Sample a distribution and compare observed frequencies with its weights
+ *
+ * @param name Name printed in the report
+ * @param d Distribution to sample
+ * @param labels Names of the categories
+ */
+static void bench_dist(const char* name, const struct bwt_dist* d, const char* const* labels) {
+    uint64_t counts[BWT_DIST_MAX] = { 0 };
+    uint64_t total_weight = 0;
+
+    for (uint8_t i = 0; i < d->n; i++) {
+        total_weight += d->weight[i];
+    }
+
+    uint64_t start = now_ns();
+    for (int i = 0; i < SAMPLES; i++) {
+        counts[bwt_dist_sample(d)]++;
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    double max_error = 0.0;
+    printf("%s: %.1f ns/sample\n", name, (double)elapsed / SAMPLES);
+    printf("  %-10s %9s %9s\n", "category", "expected", "observed");
+    for (uint8_t i = 0; i < d->n; i++) {
+        double expected = 100.0 * d->weight[i] / (double)total_weight;
+        double observed = 100.0 * (double)counts[i] / SAMPLES;
+        double error = observed > expected ? observed - expected : expected - observed;
+        max_error = error > max_error ? error : max_error;
+        printf("  %-10s %8.2f%% %8.2f%%\n", labels[i], expected, observed);
+    }
+    printf("  max deviation %.3f percentage points\n\n", max_error);
+}
+
+/**
+ * Scan synthetic results in memory with `bwt --report`'s scanner
+ */
+static void bench_report(void) {
+    struct bwt_record* records = malloc(REPORT_RECORDS * sizeof(*records));
+    struct bwt_report* report = malloc(sizeof(*report));
+    if (records == NULL || report == NULL) {
+        free(records);
+        free(report);
+        printf("report scan: skipped, out of memory\n\n");
+        return;
+    }
+
+    for (size_t i = 0; i < REPORT_RECORDS; i++) {
+        struct bwt_question q;
+        bwt_question_generate(&q, (uint8_t)(bwt_rand32() % BWT_TOPIC_COUNT), bwt_sample_width(),
+                              bwt_rand32() % 2, BWT_PATTERN_RANDOM);
+        records[i] = (struct bwt_record){
+            .learner = bwt_rand32() % 1000,
+            .latency_us = 2000000 + bwt_rand32() % 20000000,
+            .a = q.a,
+            .b = q.b,
+            .expected = q.expected,
+            // a third of first answers have one or two bits wrong
+            .first_answer = q.expected ^ (bwt_rand32() % 3 == 0 ? bwt_rand32() & 0x11u : 0),
+            .topic = q.topic,
+            .width = q.width,
+            .flags = (q.is_signed ? BWT_RECORD_SIGNED : 0) | BWT_RECORD_CORRECT,
+            .attempts = 1,
+        };
+    }
+
+    struct bwt_store_map map = { .records = records, .count = REPORT_RECORDS };
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = threads > 0 ? threads : 1;
+
+    uint64_t start = now_ns();
+    bwt_report_scan(&map, 1, (int)threads, report);
+    uint64_t elapsed = now_ns() - start;
+
+    double seconds = (double)elapsed / 1e9;
+    printf("report scan: %d records, %ld thread(s), %.1f ms, %.1f M records/s, %.2f GB/s\n\n",
+           REPORT_RECORDS, threads, seconds * 1e3, REPORT_RECORDS / seconds / 1e6,
+           REPORT_RECORDS * sizeof(struct bwt_record) / seconds / 1e9);
+    free(records);
+    free(report);
+}
+
+/**
+ * Format and parse random values with every kernel the CPU supports
+ */
+static void bench_kernels(void) {
+    static uint32_t values[4096];
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        values[i] = bwt_rand32();
+    }
+
+    for (size_t k = 0; bwt_kernels_all[k] != NULL; k++) {
+        const struct bwt_kernels* kern = bwt_kernels_all[k];
+        if (!kern->supported()) {
+            printf("%-7s not supported by this CPU\n", kern->name);
+            continue;
+        }
+        for (uint8_t width = 8; width <= 32; width *= 2) {
+            char bin[BWT_MAX_WIDTH + 1];
+            uint32_t check = 0;
+            uint64_t start = now_ns();
+            for (int i = 0; i < SAMPLES; i++) {
+                kern->format(bin, values[i % 4096] ^ check, width);
+                check ^= (uint32_t)bin[i % width];
+            }
+            uint64_t formatted = now_ns();
+            for (int i = 0; i < SAMPLES; i++) {
+                uint32_t bits;
+                bin[i % width] = (char)('0' + (i & 1));
+                kern->parse(bin, width, &bits);
+                check += bits;
+            }
+            uint64_t parsed = now_ns();
+            printf("%-7s %2u bits: format %5.2f ns, parse %5.2f ns  (%08x)\n", kern->name, width,
+                   (double)(formatted - start) / SAMPLES, (double)(parsed - formatted) / SAMPLES, check);
+        }
+    }
+
+    // Hex and octal use the same lookup tables on every CPU
+    for (int octal = 0; octal < 2; octal++) {
+        char digits[BWT_MAX_WIDTH + 1];
+        size_t len = octal ? 11 : 8;
+        uint32_t check = 0;
+        uint64_t start = now_ns();
+        for (int i = 0; i < SAMPLES; i++) {
+            (octal ? bwt_format_octal : bwt_format_hex)(digits, values[i % 4096] ^ check, 32);
+            check ^= (uint32_t)digits[i % len];
+        }
+        uint64_t formatted = now_ns();
+        for (int i = 0; i < SAMPLES; i++) {
+            uint32_t bits = 0;
+            digits[i % len] = (char)('0' + (i & 3));
+            (octal ? bwt_parse_octal : bwt_parse_hex)(digits, len, &bits);
+            check += bits;
+        }
+        uint64_t parsed = now_ns();
+        printf("%-7s 32 bits: format %5.2f ns, parse %5.2f ns  (%08x)\n", octal ? "octal" : "hex",
+               (double)(formatted - start) / SAMPLES, (double)(parsed - formatted) / SAMPLES, check);
+    }
+    printf("\n");
+}
+
+/**
+ * Format a large array of values into one buffer with every kernel, plain
+ * and as an answer key with a value per line and grouped nibbles
+ */
+static void bench_arrays(void) {
+    enum { VALUES = 1 << 16, ROUNDS = 64 };
+    static uint32_t values[VALUES];
+    static const struct bwt_binary_style styles[] = { { 0, 0 }, { '\n', '_' } };
+    char* out = malloc(bwt_binary_array_size(VALUES, 32, &styles[1]));
+    const char* selected = bwt_kernels_name();
+
+    if (out == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < VALUES; i++) {
+        values[i] = bwt_rand32();
+    }
+    for (size_t k = 0; bwt_kernels_all[k] != NULL; k++) {
+        const struct bwt_kernels* kern = bwt_kernels_all[k];
+        if (!kern->supported()) {
+            continue;
+        }
+        bwt_kernels_select(kern->name);
+        for (uint8_t width = 8; width <= 32; width *= 2) {
+            double gbs[2];
+            for (size_t j = 0; j < 2; j++) {
+                size_t count = sizeof(values) / (width / 8);  // every byte of the array
+                size_t written = 0;
+                uint64_t start = now_ns();
+                for (int r = 0; r < ROUNDS; r++) {
+                    written += bwt_format_binary_array(out, values, count, width, &styles[j]);
+                }
+                gbs[j] = (double)written / (double)(now_ns() - start);
+            }
+            printf("%-7s %2u bits: %5.2f GB/s plain, %5.2f GB/s one per line in nibbles\n", kern->name, width,
+                   gbs[0], gbs[1]);
+        }
+    }
+    bwt_kernels_select(selected);
+    free(out);
+    printf("\n");
+}
+
+/**
+ * Format a question from the message catalog and with the printf format
+ * string it replaced
+ */
+static void bench_messages(void) {
+    char buf[BWT_PROMPT_SIZE];
+    char num[BWT_MSG_INT_SIZE];
+    size_t check = 0;
+
+    uint64_t start = now_ns();
+    for (int i = 0; i < SAMPLES; i++) {
+        check += (size_t)BWT_MSG(buf, sizeof(buf), MSG_QUESTION_BITWISE,
+                                 "signed", "8", "-42", "17", bwt_msg_int(num, i), "&", "binary");
+    }
+    uint64_t catalog = now_ns();
+    for (int i = 0; i < SAMPLES; i++) {
+        check += (size_t)snprintf(buf, sizeof(buf),
+                                  "The following question is about %s %u-bit integers *a* and *b*.\n"
+                                  "Given `a=%s` and `b=%s`,\n\nQ%d: What is the result of `a%cb` in %s?\n",
+                                  "signed", 8u, "-42", "17", i, '&', "binary");
+    }
+    uint64_t formatted = now_ns();
+    printf("catalog  %6.1f ns/question\n", (double)(catalog - start) / SAMPLES);
+    printf("snprintf %6.1f ns/question  (%zu)\n\n", (double)(formatted - catalog) / SAMPLES, check);
+}
+
+/**
+ * Time coverage lookups, measure the filter's false positives when full
+ * and count repeats among the first questions of a learner
+ */
+static void bench_coverage(void) {
+    static struct bwt_coverage cov;
+    uint32_t check = 0;
+
+    if (bwt_coverage_init(&cov, bwt_dist_active()->coverage_kb) < 0) {
+        perror("bwt_coverage_init");
+        return;
+    }
+    static uint32_t values[4096];
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        values[i] = bwt_rand32();
+        bwt_coverage_add(&cov, BWT_TOPIC_XOR, i & 1 ? 32 : 8, false, values[i] & 0xFF, values[i] >> 24);
+    }
+    for (uint8_t width = 8; width <= 32; width *= 4) {
+        uint64_t start = now_ns();
+        for (int i = 0; i < SAMPLES; i++) {
+            uint32_t v = values[i % 4096] ^ check;
+            check += bwt_coverage_seen(&cov, BWT_TOPIC_XOR, width, false, v & 0xFF, v >> 24);
+        }
+        printf("seen  %2u bits %5.2f ns/lookup\n", width, (double)(now_ns() - start) / SAMPLES);
+    }
+
+    // Fill the filter to just below the point where it is cleared
+    bwt_coverage_free(&cov);
+    bwt_coverage_init(&cov, bwt_dist_active()->coverage_kb);
+    uint32_t fill = cov.filter_capacity - 1;
+    for (uint32_t i = 0; i < fill; i++) {
+        bwt_coverage_add(&cov, BWT_TOPIC_AND, 32, false, i, i * 7u);
+    }
+    uint32_t false_positives = 0;
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        false_positives += bwt_coverage_seen(&cov, BWT_TOPIC_OR, 32, false, i, i * 7u);
+    }
+    printf("filter %u KiB, %u questions: %.2f%% false positives\n", bwt_dist_active()->coverage_kb, fill,
+           100.0 * false_positives / SAMPLES);
+    bwt_coverage_free(&cov);
+
+    // Repeats among the first 200 AND questions, drawn plainly and with coverage
+    static uint64_t asked[2][BWT_COVERAGE_PAIRS8 / 64];
+    int repeats[2] = { 0, 0 };
+    bwt_coverage_init(&cov, 0);
+    for (int i = 0; i < 200; i++) {
+        uint32_t a, b;
+        for (int with = 0; with < 2; with++) {
+            if (with) {
+                bwt_coverage_pair(&cov, BWT_DIST_AND, BWT_TOPIC_AND, 8, true, &a, &b);
+            } else {
+                a = bwt_sample_operand(BWT_DIST_AND, 8);
+                b = bwt_sample_operand(BWT_DIST_AND, 8);
+            }
+            uint32_t key = a << 8 | b;
+            repeats[with] += asked[with][key >> 6] >> (key & 63) & 1;
+            asked[with][key >> 6] |= UINT64_C(1) << (key & 63);
+        }
+    }
+    bwt_coverage_free(&cov);
+    printf("repeats in 200 8-bit AND questions: %d plain, %d with coverage  (%u)\n\n",
+           repeats[0], repeats[1], check);
+}
+
+/**
+ * Record and query outcomes in a learner's bit-packed answer history
+ */
+static void bench_history(void) {
+    static struct bwt_history h;
+    static uint32_t values[4096];
+    uint32_t check = 0;
+
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        values[i] = bwt_rand32();
+    }
+    bwt_history_init(&h);
+    uint64_t start = now_ns();
+    for (int i = 0; i < SAMPLES; i++) {
+        uint32_t v = values[i % 4096];
+        bwt_history_push(&h, (uint8_t)(v % BWT_TOPIC_COUNT), bwt_width_from_index((uint8_t)(v >> 8) % BWT_WIDTH_COUNT),
+                         (enum bwt_outcome)(v >> 16 & 3));
+    }
+    uint64_t pushed = now_ns();
+    for (int i = 0; i < SAMPLES; i++) {
+        uint32_t v = values[i % 4096] ^ check;
+        check += (uint32_t)bwt_history_accuracy(&h, (uint8_t)(v % BWT_TOPIC_COUNT),
+                                                bwt_width_from_index((uint8_t)(v >> 8) % BWT_WIDTH_COUNT), 20 + v % 40);
+    }
+    uint64_t queried = now_ns();
+    printf("%zu bytes per learner: push %5.2f ns, accuracy %5.2f ns  (%u)\n\n", sizeof(h),
+           (double)(pushed - start) / SAMPLES, (double)(queried - pushed) / SAMPLES, check);
+}
+
+static void bench_choices(void) {
+    static struct bwt_question questions[4096];
+    struct bwt_choices c;
+    uint32_t check = 0;
+
+    for (size_t i = 0; i < sizeof(questions) / sizeof(questions[0]); i++) {
+        bwt_question_generate(&questions[i], (uint8_t)(i % BWT_TOPIC_COUNT), bwt_width_from_index(i / 16 % 3),
+                              i / 8 % 2, BWT_PATTERN_RANDOM);
+    }
+    uint64_t start = now_ns();
+    for (int i = 0; i < SAMPLES; i++) {
+        bwt_choices_make(&questions[i % 4096], (uint32_t)i * 2654435761u, &c);
+        check += c.option[c.correct ^ 1].bits;
+    }
+    uint64_t end = now_ns();
+    printf("%d options from modeled mistakes: %5.2f ns per question  (%u)\n\n", BWT_CHOICES,
+           (double)(end - start) / SAMPLES, check);
+}
+
+static void bench_sheets(void) {
+    enum { SHEETS = 1 << 16, QUESTIONS = 20, ROUNDS = 16 };
+    uint8_t widths[QUESTIONS];
+    uint32_t key[QUESTIONS];
+    struct bwt_sheets sheets;
+    const char* selected = bwt_kernels_name();
+
+    for (uint32_t i = 0; i < QUESTIONS; i++) {
+        widths[i] = (uint8_t[]){ 8, 8, 16, 32 }[i % 4];  // the mix of widths in an exam
+        key[i] = bwt_rand32() & bwt_width_mask(widths[i]);
+    }
+    if (bwt_sheets_init(&sheets, widths, QUESTIONS, SHEETS, true) < 0) {
+        return;
+    }
+    for (uint32_t i = 0; i < QUESTIONS; i++) {
+        bwt_sheets_set_key(&sheets, 0, i, key[i]);
+    }
+    for (size_t sheet = 0; sheet < SHEETS; sheet++) {
+        for (uint32_t i = 0; i < QUESTIONS; i++) {
+            uint32_t r = bwt_rand32();
+            bwt_sheets_set_answer(&sheets, sheet, i, r % 4 ? key[i] : key[i] ^ r, r % 16 != 1);
+        }
+    }
+    for (size_t k = 0; bwt_kernels_all[k] != NULL; k++) {
+        const struct bwt_kernels* kern = bwt_kernels_all[k];
+        if (!kern->supported()) {
+            continue;
+        }
+        bwt_kernels_select(kern->name);
+        uint64_t total = 0;
+        uint64_t start = now_ns();
+        for (int r = 0; r < ROUNDS; r++) {
+            bwt_sheets_grade(&sheets, 0, SHEETS);
+            total += sheets.score[r];
+        }
+        uint64_t end = now_ns();
+        printf("%-7s %d questions of 8, 16 and 32 bits: %8.0f sheets/ms  (%llu)\n", kern->name, QUESTIONS,
+               (double)SHEETS * ROUNDS / ((double)(end - start) / 1e6), (unsigned long long)total);
+    }
+    printf("\n");
+    bwt_kernels_select(selected);
+    bwt_sheets_free(&sheets);
+}
+
+/**
+ * Regrade a cohort's answers on one and on several threads, and check that
+ * the verdicts come out the same and in the same order
+ */
+static void bench_regrade(void) {
+    enum { STUDENTS = 2000, QUESTIONS = 50, RUNS = 3 };
+    const int threads[RUNS] = { 1, 4, 0 };  // 0: one per CPU
+    char* text;
+    size_t len;
+    char* graded[RUNS] = { NULL };
+    size_t graded_len[RUNS] = { 0 };
+    struct bwt_exam_tally tally[RUNS];
+
+    FILE* in = open_memstream(&text, &len);
+    if (in == NULL) {
+        printf("regrade: skipped, out of memory\n\n");
+        return;
+    }
+    for (uint32_t student = 0; student < STUDENTS; student++) {
+        for (uint32_t index = 0; index < QUESTIONS; index++) {
+            struct bwt_question q;
+            char answer[BWT_ANSWER_SIZE];
+            bwt_exam_question(&q, 0xB17, student, index);
+            bwt_question_format_answer(&q, bwt_rand32() % 4 ? q.expected : ~q.expected, answer, sizeof(answer));
+            fprintf(in, "%u %u %s\n", student, index, answer);
+        }
+    }
+    fputs("# done\n7 x", in);
+    fclose(in);
+
+    for (int r = 0; r < RUNS; r++) {
+        int n = threads[r] > 0 ? threads[r] : (int)sysconf(_SC_NPROCESSORS_ONLN);
+        FILE* out = open_memstream(&graded[r], &graded_len[r]);
+        if (out == NULL) {
+            break;
+        }
+        memset(&tally[r], 0, sizeof(tally[r]));
+        uint64_t start = now_ns();
+        int rc = bwt_exam_regrade(text, len, 0xB17, false, n, out, &tally[r]);
+        uint64_t end = now_ns();
+        fclose(out);
+        bool same = rc == 0 && graded_len[r] == graded_len[0] && memcmp(graded[r], graded[0], graded_len[0]) == 0
+                    && memcmp(&tally[r], &tally[0], sizeof(tally[0])) == 0 && tally[r].malformed == 1;
+        printf("regrade %2d thread(s): %d answers, %6.1f ms, %s\n", n, STUDENTS * QUESTIONS,
+               (double)(end - start) / 1e6, same ? "same verdicts" : "VERDICTS DIFFER");
+    }
+    printf("\n");
+    for (int r = 0; r < RUNS; r++) {
+        free(graded[r]);
+    }
+    free(text);
+}
+
+static void bench_coro_loop(void* arg) {
+    for (;;) {
+        (*(uint64_t*)arg)++;
+        bwt_coro_yield();
+    }
+}
+
+static void bench_coro(void) {
+    enum { COROS = 1000, ROUNDS = 1000 };
+    static struct bwt_coro coros[COROS];
+    uint64_t count = 0;
+    size_t resident = 0;
+    int started = 0;
+
+    for (; started < COROS; started++) {
+        if (bwt_coro_init(&coros[started], 0, bench_coro_loop, &count) < 0) {
+            break;
+        }
+    }
+    uint64_t start = now_ns();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int i = 0; i < started; i++) {
+            bwt_coro_resume(&coros[i]);
+        }
+    }
+    uint64_t end = now_ns();
+    for (int i = 0; i < started; i++) {
+        resident += bwt_coro_stack_resident(&coros[i]);
+        bwt_coro_free(&coros[i]);
+    }
+    printf("%d coroutines: %5.1f ns per resume and yield, %zu bytes of stack each  (%llu)\n\n", started,
+           (double)(end - start) / (double)(count > 0 ? count : 1), started > 0 ? resident / (size_t)started : 0,
+           (unsigned long long)count);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 3 && strcmp(argv[1], "--config") == 0) {
+        if (bwt_settings_load(argv[2]) < 0) {
+            fprintf(stderr, "Could not open settings file %s\n", argv[2]);
+            return 1;
+        }
+    } else if (argc != 1) {
+        fprintf(stderr, "Usage: %s [--config FILE]\n", argv[0]);
+        return 1;
+    }
+    bwt_srand(1);
+
+    printf("=== Binary format/parse kernels ===\n\n");
+    bench_kernels();
+
+    printf("=== Binary arrays ===\n\n");
+    bench_arrays();
+
+    printf("=== Message catalog ===\n\n");
+    bench_messages();
+
+    printf("=== Operand coverage ===\n\n");
+    bench_coverage();
+
+    printf("=== Answer history ===\n\n");
+    bench_history();
+    printf("=== Multiple choice ===\n\n");
+    bench_choices();
+    printf("=== Answer sheets ===\n\n");
+    bench_sheets();
+    printf("=== Exam regrading ===\n\n");
+    bench_regrade();
+    printf("=== Coroutines ===\n\n");
+    bench_coro();
+
+    printf("=== Operand and width distributions (alias method) ===\n\n");
+    for (int quiz = 0; quiz < BWT_DIST_QUIZ_COUNT; quiz++) {
+        char name[64];
+        snprintf(name, sizeof(name), "operands.%s", bwt_dist_quiz_names[quiz]);
+        bench_dist(name, &bwt_dist_active()->operands[quiz], bwt_operand_class_names);
+    }
+    bench_dist("widths", &bwt_dist_active()->widths, bwt_width_names);
+
+    printf("=== Results analytics ===\n\n");
+    bench_report();
+
+    return 0;
+}
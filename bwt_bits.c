@@ -0,0 +1,470 @@
+/*
+ * bwt_bits.c - Show the bits of a file, like xxd -b
+ * Created on: Sat 07 Jun 2025
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * bwt-bits prints a file (or stdin) as rows of offset, binary, hex and
+ * ASCII, so file headers and packed structs can be read bit by bit:
+ *
+ *   $ bwt-bits --word 2 --little --signed /bin/ls | head -1
+ *   00000000: 0100010101111111 0100011001001100 ...  457F 464C ...   17791  17996 ...  .ELF....
+ *
+ * Bytes are grouped into 1-, 2- or 4-byte words, read big-endian (in file
+ * order) unless --little is given; hex and decimal columns show the same
+ * words, with --unsigned and --signed each adding a decimal column.
+ * Regular files are mapped, anything else is read in blocks. Each block of
+ * rows has its binary column formatted in one call to
+ * bwt_format_binary_array(), which uses the AVX2 kernel where the CPU has
+ * it, and the rows are then put together with copies into one output
+ * buffer: a gigabyte of input turns into some 15 GB of text, written
+ * faster than a pipe takes it.
+ */
+
+#define _POSIX_C_SOURCE 200809L  // mmap, posix_madvise
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "bwt_kernels.h"
+
+#define BLOCK_BYTES 16384   // most input formatted per call, so its text stays in cache
+#define MAX_COLS 256        // bytes per row
+#define DEFAULT_COLS 8
+#define OFFSET_DIGITS 8     // more once an offset needs them
+
+struct layout {
+    size_t cols;         // bytes per row
+    size_t word;         // bytes per word: 1, 2 or 4
+    bool little;         // words are little-endian
+    bool decimal[2];     // unsigned and signed decimal columns shown
+    char group;          // between nibbles, '\0' for none
+    size_t words;        // per row
+    size_t bin_word;     // chars of one word in the binary column
+    size_t dec_word[2];  // chars of one word in the unsigned and signed columns
+    size_t row_size;     // most chars of a row, newline included
+};
+
+static struct layout layout;
+static uint16_t words16[BLOCK_BYTES / 2];
+static uint32_t words32[BLOCK_BYTES / 4];
+static char hex_pairs[512];  // both hex digits of every byte
+static char printable[256];  // ASCII column char of every byte
+static char* binary;     // binary column of a block
+static char* out;        // rows of a block
+static size_t out_len;
+
+/**
+ * Work out column widths from the bytes per row and the word size
+ */
+static void plan_layout(struct layout* l) {
+    static const size_t unsigned_digits[] = { 0, 3, 5, 0, 10 };
+    l->words = l->cols / l->word;
+    l->bin_word = l->word * 8 + (l->group ? l->word * 2 - 1 : 0);
+    l->row_size = 16 + 2                                   // offset
+                  + l->words * (l->bin_word + 1) + 1       // binary
+                  + l->words * (l->word * 2 + 1) + 1       // hex
+                  + l->cols + 1;                           // ASCII and newline
+    for (int is_signed = 0; is_signed < 2; is_signed++) {
+        l->dec_word[is_signed] = unsigned_digits[l->word] + (size_t)is_signed;
+        if (l->decimal[is_signed]) {
+            l->row_size += l->words * (l->dec_word[is_signed] + 1) + 1;
+        }
+    }
+}
+
+/**
+ * Value of word k of the data, in the chosen byte order
+ */
+static inline uint32_t word_at(const uint8_t* data, size_t k) {
+    uint32_t v;
+    switch (layout.word) {
+        case 1:
+            return data[k];
+        case 2: {
+            uint16_t w;
+            memcpy(&w, data + 2 * k, 2);
+            return layout.little ? w : __builtin_bswap16(w);
+        }
+        default:
+            memcpy(&v, data + 4 * k, 4);
+            return layout.little ? v : __builtin_bswap32(v);
+    }
+}
+
+/**
+ * Write a number right-aligned in a field
+ *
+ * @param is_signed Read the word as two's complement
+ * @return Chars written, always width
+ */
+static size_t format_decimal(char* p, uint32_t bits, size_t width, bool is_signed) {
+    bool negative = false;
+    uint64_t v = bits;
+    char* q = p + width;
+
+    if (is_signed && (bits >> (layout.word * 8 - 1)) & 1) {
+        negative = true;
+        v = (UINT64_C(1) << (layout.word * 8)) - bits;
+    }
+    do {
+        *--q = (char)('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+    if (negative) {
+        *--q = '-';
+    }
+    memset(p, ' ', (size_t)(q - p));
+    return width;
+}
+
+static void flush_out(void) {
+    if (out_len > 0 && fwrite(out, 1, out_len, stdout) != out_len) {
+        perror("bwt-bits: write");
+        exit(1);
+    }
+    out_len = 0;
+}
+
+/**
+ * Format whole rows into the output buffer
+ *
+ * @param data Bytes to show, a multiple of the row size and at most BLOCK_BYTES
+ * @param len Number of bytes
+ * @param offset Offset of the first byte in the file
+ */
+static void format_rows(const uint8_t* data, size_t len, uint64_t offset) {
+    struct bwt_binary_style style = { ' ', layout.group };
+    size_t count = len / layout.word;
+    const void* values = data;
+
+    // One call for the whole binary column; row r's text starts every
+    // words * (bin_word + 1) chars, ending in a separator
+    if (layout.word == 2) {
+        for (size_t k = 0; k < count; k++) {
+            words16[k] = (uint16_t)word_at(data, k);
+        }
+        values = words16;
+    } else if (layout.word == 4) {
+        for (size_t k = 0; k < count; k++) {
+            words32[k] = word_at(data, k);
+        }
+        values = words32;
+    }
+    bwt_format_binary_array(binary, values, count, (uint8_t)(layout.word * 8), &style);
+
+    // Columns are written through char pointers, which may alias the
+    // globals, so the layout is copied once
+    const struct layout l = layout;
+    size_t bin_row = l.words * (l.bin_word + 1);
+    char* p = out + out_len;
+    for (size_t row = 0; row < len / l.cols; row++, offset += l.cols) {
+        const uint8_t* bytes = data + row * l.cols;
+
+        if (offset >> 32) {
+            bwt_format_hex(p, (uint32_t)(offset >> 32), 32);
+            p += 8;
+        }
+        bwt_format_hex(p, (uint32_t)offset, 32);
+        p += OFFSET_DIGITS;
+        *p++ = ':';
+        *p++ = ' ';
+        memcpy(p, binary + row * bin_row, bin_row);
+        p += bin_row;
+        p[-1] = ' ';  // the terminator after the last row of the block
+        *p++ = ' ';
+        for (size_t k = 0; k < l.cols; k += l.word) {
+            // Most significant byte first: file order unless little-endian
+            for (size_t j = 0; j < l.word; j++) {
+                memcpy(p, hex_pairs + 2 * bytes[k + (l.little ? l.word - 1 - j : j)], 2);
+                p += 2;
+            }
+            *p++ = ' ';
+        }
+        for (int is_signed = 0; is_signed < 2; is_signed++) {
+            if (!l.decimal[is_signed]) {
+                continue;
+            }
+            *p++ = ' ';
+            for (size_t k = 0; k < l.words; k++) {
+                p += format_decimal(p, word_at(bytes, k), l.dec_word[is_signed], is_signed);
+                *p++ = ' ';
+            }
+        }
+        *p++ = ' ';
+        for (size_t i = 0; i < l.cols; i++) {
+            p[i] = printable[bytes[i]];
+        }
+        p += l.cols;
+        *p++ = '\n';
+    }
+    out_len = (size_t)(p - out);
+}
+
+/**
+ * Format a last row shorter than the others: it is formatted padded with
+ * zero bytes, then the padding is blanked, so a word cut off by the end
+ * shows only its real bytes in binary and hex and no decimal value
+ */
+static void format_short_row(const uint8_t* data, size_t len, uint64_t offset) {
+    uint8_t padded[MAX_COLS] = { 0 };
+    size_t start = out_len;
+    size_t nibble = 4 + (layout.group ? 1 : 0);  // chars of a nibble and its separator
+
+    memcpy(padded, data, len);
+    format_rows(padded, layout.cols, offset);
+
+    char* row = out + start;
+    char* bin = strchr(row, ':') + 2;
+    char* hex = bin + layout.words * (layout.bin_word + 1) + 1;
+    char* dec[2];
+    char* ascii = hex + layout.words * (layout.word * 2 + 1) + 1;
+    for (int is_signed = 0; is_signed < 2; is_signed++) {
+        dec[is_signed] = ascii;
+        if (layout.decimal[is_signed]) {
+            ascii += layout.words * (layout.dec_word[is_signed] + 1) + 1;
+        }
+    }
+    for (size_t k = len / layout.word; k < layout.words; k++) {
+        char* bin_word = bin + k * (layout.bin_word + 1);
+        for (size_t j = 0; j < layout.word; j++) {
+            // Byte j of the word as shown, most significant first
+            size_t byte = k * layout.word + (layout.little ? layout.word - 1 - j : j);
+            if (byte < len) {
+                continue;
+            }
+            // Its eight digits, and the separators on either side of them
+            size_t first = 2 * j * nibble - (layout.group && j > 0 ? 1 : 0);
+            size_t end = (2 * j + 1) * nibble + 4 + (layout.group && j + 1 < layout.word ? 1 : 0);
+            memset(bin_word + first, ' ', end - first);
+            memset(hex + k * (layout.word * 2 + 1) + 2 * j, ' ', 2);
+        }
+        for (int is_signed = 0; is_signed < 2; is_signed++) {
+            if (layout.decimal[is_signed]) {
+                memset(dec[is_signed] + k * (layout.dec_word[is_signed] + 1), ' ', layout.dec_word[is_signed]);
+            }
+        }
+    }
+    ascii[len] = '\n';
+    out_len = (size_t)(ascii + len + 1 - out);
+}
+
+/**
+ * Show bytes, whole blocks at a time
+ *
+ * @param data Bytes to show
+ * @param len Number of bytes
+ * @param offset Offset of the first byte in the file
+ * @param last Whether the input ends with these bytes
+ * @return Bytes shown; fewer than len (less than a row) unless last
+ */
+static size_t show(const uint8_t* data, size_t len, uint64_t offset, bool last) {
+    size_t done = 0;
+    while (len - done >= layout.cols) {
+        size_t n = len - done < BLOCK_BYTES ? len - done : BLOCK_BYTES;
+        n -= n % layout.cols;
+        format_rows(data + done, n, offset + done);
+        flush_out();
+        done += n;
+    }
+    if (last && done < len) {
+        format_short_row(data + done, len - done, offset + done);
+        flush_out();
+        done = len;
+    }
+    return done;
+}
+
+/**
+ * Show a regular file through a read-only mapping
+ *
+ * @return 0 on success, -1 after printing an error
+ */
+static int show_mapped(int fd, const char* path, uint64_t size, uint64_t skip, uint64_t length) {
+    if (skip >= size) {
+        return 0;
+    }
+    uint64_t len = size - skip < length ? size - skip : length;
+    uint8_t* map = mmap(NULL, (size_t)size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "bwt-bits: %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    posix_madvise(map, (size_t)size, POSIX_MADV_SEQUENTIAL);
+    show(map + skip, (size_t)len, skip, true);
+    munmap(map, (size_t)size);
+    return 0;
+}
+
+/**
+ * Show a pipe, terminal or other file that cannot be mapped, reading it in
+ * blocks and carrying a partial row over to the next one
+ *
+ * @return 0 on success, -1 after printing an error
+ */
+static int show_stream(int fd, const char* path, uint64_t skip, uint64_t length) {
+    static uint8_t buf[BLOCK_BYTES + MAX_COLS];
+    uint64_t offset = 0;
+    size_t have = 0;
+
+    while (length > 0) {
+        ssize_t n = read(fd, buf + have, sizeof(buf) - have);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            fprintf(stderr, "bwt-bits: %s: %s\n", path, strerror(errno));
+            return -1;
+        }
+        if (n == 0) {
+            break;
+        }
+        // Drop what is before --skip, and what is after --length
+        size_t fresh = (size_t)n;
+        if (skip > 0) {
+            size_t dropped = skip < fresh ? (size_t)skip : fresh;
+            memmove(buf + have, buf + have + dropped, fresh - dropped);
+            fresh -= dropped;
+            skip -= dropped;
+            offset += dropped;
+        }
+        if (fresh > length) {
+            fresh = (size_t)length;
+        }
+        length -= fresh;
+        have += fresh;
+
+        size_t done = show(buf, have, offset, false);
+        memmove(buf, buf + done, have - done);
+        have -= done;
+        offset += done;
+    }
+    show(buf, have, offset, true);
+    return 0;
+}
+
+static void print_usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [options] [FILE]\n", prog);
+    fprintf(stderr, "Show FILE (default: stdin) as offset, binary, hex and ASCII columns.\n");
+    fprintf(stderr, "  --cols N         bytes per row, a multiple of the word size (default: %d)\n", DEFAULT_COLS);
+    fprintf(stderr, "  --word N         bytes per word: 1, 2 or 4 (default: 1)\n");
+    fprintf(stderr, "  --little         read words little-endian (default: big-endian, file order)\n");
+    fprintf(stderr, "  --unsigned       add a column of the words in unsigned decimal\n");
+    fprintf(stderr, "  --signed         add a column of the words in signed decimal\n");
+    fprintf(stderr, "  --nibbles        separate the nibbles of binary words with '_'\n");
+    fprintf(stderr, "  --skip N         start at byte N\n");
+    fprintf(stderr, "  --length N       show at most N bytes\n");
+    fprintf(stderr, "  --kernels NAME   binary format kernels: auto, avx2, bmi2 or scalar\n");
+}
+
+/**
+ * Parse a byte count given on the command line
+ *
+ * @return false if the argument is not a number
+ */
+static bool parse_count(const char* arg, uint64_t* value) {
+    char* end;
+    errno = 0;
+    unsigned long long v = strtoull(arg, &end, 0);
+    if (*arg == '\0' || *arg == '-' || *end != '\0' || errno != 0) {
+        return false;
+    }
+    *value = v;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    const char* path = NULL;
+    uint64_t cols = DEFAULT_COLS, word = 1, skip = 0, length = UINT64_MAX;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--cols") == 0 && i + 1 < argc) {
+            if (!parse_count(argv[++i], &cols)) {
+                cols = 0;
+            }
+        } else if (strcmp(argv[i], "--word") == 0 && i + 1 < argc) {
+            if (!parse_count(argv[++i], &word)) {
+                word = 0;
+            }
+        } else if (strcmp(argv[i], "--little") == 0) {
+            layout.little = true;
+        } else if (strcmp(argv[i], "--unsigned") == 0) {
+            layout.decimal[0] = true;
+        } else if (strcmp(argv[i], "--signed") == 0) {
+            layout.decimal[1] = true;
+        } else if (strcmp(argv[i], "--nibbles") == 0) {
+            layout.group = '_';
+        } else if (strcmp(argv[i], "--skip") == 0 && i + 1 < argc) {
+            if (!parse_count(argv[++i], &skip)) {
+                fprintf(stderr, "bwt-bits: bad --skip %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--length") == 0 && i + 1 < argc) {
+            if (!parse_count(argv[++i], &length)) {
+                fprintf(stderr, "bwt-bits: bad --length %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--kernels") == 0 && i + 1 < argc) {
+            if (bwt_kernels_select(argv[++i]) < 0) {
+                fprintf(stderr, "bwt-bits: kernels %s are unknown or not supported by this CPU\n", argv[i]);
+                return 1;
+            }
+        } else if (path == NULL && (argv[i][0] != '-' || strcmp(argv[i], "-") == 0)) {
+            path = argv[i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (word != 1 && word != 2 && word != 4) {
+        fprintf(stderr, "bwt-bits: --word must be 1, 2 or 4\n");
+        return 1;
+    }
+    if (cols == 0 || cols > MAX_COLS || cols % word != 0) {
+        fprintf(stderr, "bwt-bits: --cols must be a multiple of %u up to %d\n", (unsigned)word, MAX_COLS);
+        return 1;
+    }
+    for (int c = 0; c < 256; c++) {
+        hex_pairs[2 * c] = "0123456789ABCDEF"[c >> 4];
+        hex_pairs[2 * c + 1] = "0123456789ABCDEF"[c & 0xF];
+        printable[c] = c >= 0x20 && c < 0x7F ? (char)c : '.';
+    }
+    layout.cols = (size_t)cols;
+    layout.word = (size_t)word;
+    plan_layout(&layout);
+
+    struct bwt_binary_style style = { ' ', layout.group };
+    binary = malloc(bwt_binary_array_size(BLOCK_BYTES, 8, &style));
+    out = malloc((BLOCK_BYTES / layout.cols + 1) * layout.row_size);
+    if (binary == NULL || out == NULL) {
+        perror("bwt-bits");
+        return 1;
+    }
+
+    int fd = STDIN_FILENO;
+    if (path != NULL && strcmp(path, "-") != 0 && (fd = open(path, O_RDONLY)) < 0) {
+        fprintf(stderr, "bwt-bits: %s: %s\n", path, strerror(errno));
+        return 1;
+    }
+    struct stat st;
+    int status;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        status = show_mapped(fd, path != NULL ? path : "stdin", (uint64_t)st.st_size, skip, length);
+    } else {
+        status = show_stream(fd, path != NULL ? path : "stdin", skip, length);
+    }
+    if (fd != STDIN_FILENO) {
+        close(fd);
+    }
+    free(binary);
+    free(out);
+    return status < 0 || fflush(stdout) != 0 ? 1 : 0;
+}
@@ -0,0 +1,499 @@
+/*
+ * bwt_broadcast.c - Instructor-driven classroom broadcast for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include "bwt_broadcast.h"
+#include "bwt_catalog.h"
+#include "bwt_dist.h"
+#include "bwt_feedback.h"
+#include "bwt_metrics.h"
+#include "bwt_net.h"
+#include "bwt_question.h"
+#include "bwt_settings.h"
+
+#define PROMPT "> "
+
+struct learner {
+    struct bwt_rcbuf* pending;  // question still being written, NULL once sent
+    size_t sent;                // bytes of pending already written
+    uint32_t answered;          // number of the last question answered correctly
+    uint32_t score;
+    struct bwt_line_reader in;
+};
+
+struct classroom {
+    struct pollfd* fds;         // [0] instructor, [1] listener, [2 + i] learner i
+    struct learner* learners;
+    size_t count;
+    size_t capacity;
+    struct bwt_question q;
+    struct bwt_rcbuf* current;  // the rendered question, NULL before the first
+    uint32_t number;
+    uint64_t pushed_us;         // when the current question was pushed
+    uint32_t correct;           // learners who answered the current question
+    uint32_t wrong;             // wrong answers to the current question
+    int settings_watch;         // from bwt_settings_watch, or -1
+    const struct bwt_settings* settings;  // snapshot questions are drawn from
+};
+
+static uint64_t monotonic_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+/**
+ * Write as much of a learner's pending question as the socket accepts
+ *
+ * @param c The classroom
+ * @param i Learner index
+ * @return 0 on success, -1 if the connection failed
+ */
+static int flush_pending(struct classroom* c, size_t i) {
+    struct learner* l = &c->learners[i];
+    struct pollfd* p = &c->fds[2 + i];
+
+    while (l->pending != NULL) {
+        ssize_t n = write(p->fd, l->pending->data + l->sent, l->pending->len - l->sent);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                p->events |= POLLOUT;
+                return 0;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        l->sent += (size_t)n;
+        if (l->sent == l->pending->len) {
+            bwt_rcbuf_unref(l->pending);
+            l->pending = NULL;
+        }
+    }
+    p->events &= ~POLLOUT;
+    return 0;
+}
+
+/**
+ * Write a short reply to a learner
+ *
+ * Replies are dropped while a question is still queued for the learner, so
+ * that they never interleave with it; a client that does not read has
+ * nothing to reply to anyway.
+ *
+ * @param c The classroom
+ * @param i Learner index
+ * @param iov Pieces of the reply
+ * @param iovcnt Number of pieces
+ */
+static void send_reply(struct classroom* c, size_t i, const struct iovec* iov, int iovcnt) {
+    if (c->learners[i].pending == NULL) {
+        (void)!writev(c->fds[2 + i].fd, iov, iovcnt);
+    }
+}
+
+/**
+ * Send a message from the catalog, followed by the prompt
+ */
+static void send_message(struct classroom* c, size_t i, enum bwt_msg id) {
+    const char* text = bwt_msg_text(id);
+    struct iovec iov[2] = {
+        { .iov_base = (void*)text, .iov_len = strlen(text) },
+        { .iov_base = (void*)PROMPT, .iov_len = sizeof(PROMPT) - 1 },
+    };
+    send_reply(c, i, iov, 2);
+}
+
+/**
+ * Queue the current question for a learner
+ */
+static int queue_question(struct classroom* c, size_t i) {
+    struct learner* l = &c->learners[i];
+    bwt_rcbuf_unref(l->pending);
+    l->pending = bwt_rcbuf_ref(c->current);
+    l->sent = 0;
+    return flush_pending(c, i);
+}
+
+/**
+ * Close a learner's connection, moving the last learner into its place
+ */
+static void drop_learner(struct classroom* c, size_t i) {
+    close(c->fds[2 + i].fd);
+    bwt_rcbuf_unref(c->learners[i].pending);
+    c->count--;
+    c->fds[2 + i] = c->fds[2 + c->count];
+    c->learners[i] = c->learners[c->count];
+}
+
+/**
+ * Generate a question and send it to every connected learner
+ *
+ * The question is rendered once; learners share the buffer by reference.
+ *
+ * @param c The classroom
+ * @param topic BWT_TOPIC_AND, BWT_TOPIC_XOR or BWT_TOPIC_NOT
+ * @return 0 on success, -1 if out of memory
+ */
+static int push_question(struct classroom* c, uint8_t topic) {
+    struct bwt_rcbuf* buf = bwt_rcbuf_new(BWT_PROMPT_SIZE);
+    if (buf == NULL) {
+        return -1;
+    }
+
+    c->number++;
+    bwt_settings_refresh(c->settings_watch, &c->settings);
+    bwt_question_generate(&c->q, topic, bwt_sample_width(), bwt_rand32() & 1, BWT_PATTERN_RANDOM);
+    int len = snprintf(buf->data, BWT_PROMPT_SIZE, "\n");
+    len += bwt_question_render(&c->q, (int)c->number, buf->data + len, BWT_PROMPT_SIZE - (size_t)len);
+    len += snprintf(buf->data + len, BWT_PROMPT_SIZE - (size_t)len, PROMPT);
+    buf->len = len < BWT_PROMPT_SIZE ? (size_t)len : BWT_PROMPT_SIZE - 1;
+
+    bwt_rcbuf_unref(c->current);
+    c->current = buf;
+    c->pushed_us = monotonic_us();
+    c->correct = 0;
+    c->wrong = 0;
+
+    for (size_t i = 0; i < c->count;) {
+        if (queue_question(c, i) < 0) {
+            drop_learner(c, i);
+        } else {
+            i++;
+        }
+    }
+    bwt_metric_add(BWT_METRIC_QUESTIONS, c->count);
+    char number[BWT_MSG_INT_SIZE], width[BWT_MSG_INT_SIZE], count[BWT_MSG_INT_SIZE];
+    BWT_MSG_PRINT(MSG_BROADCAST_PUSHED, bwt_msg_int(number, c->number), bwt_topic_name(c->q.topic),
+                  bwt_msg_int(width, c->q.width),
+                  bwt_msg_text(c->q.is_signed ? MSG_KIND_SIGNED : MSG_KIND_UNSIGNED),
+                  bwt_msg_int(count, (long long)c->count));
+    return 0;
+}
+
+/**
+ * Grade one answer line from a learner
+ */
+static void handle_answer(struct classroom* c, size_t i, const char* line) {
+    struct learner* l = &c->learners[i];
+    uint32_t bits = 0;
+
+    if (c->current == NULL) {
+        send_message(c, i, MSG_BROADCAST_WAITING);
+        return;
+    }
+    if (l->answered == c->number) {
+        send_message(c, i, MSG_BROADCAST_ALREADY);
+        return;
+    }
+
+    switch (bwt_question_grade(&c->q, line, &bits)) {
+        case BWT_VERDICT_CORRECT:
+            l->answered = c->number;
+            l->score++;
+            c->correct++;
+            bwt_metric_inc(BWT_METRIC_CORRECT);
+            bwt_metric_observe_latency(monotonic_us() - c->pushed_us);
+            send_message(c, i, MSG_RESULT_CORRECT);
+            break;
+        case BWT_VERDICT_WRONG: {
+            struct bwt_feedback fb;
+            char text[BWT_FEEDBACK_SIZE];
+            c->wrong++;
+            bwt_metric_inc(BWT_METRIC_WRONG);
+            bwt_feedback_analyze(&c->q, bits, &fb);
+            int len = bwt_feedback_render(&c->q, bits, &fb, text, sizeof(text));
+            const char* wrong = bwt_msg_text(MSG_RESULT_WRONG);
+            struct iovec iov[3] = {
+                { .iov_base = (void*)wrong, .iov_len = strlen(wrong) },
+                { .iov_base = text, .iov_len = (size_t)len },
+                { .iov_base = (void*)("\n" PROMPT), .iov_len = sizeof("\n" PROMPT) - 1 },
+            };
+            send_reply(c, i, iov, 3);
+            break;
+        }
+        default: {
+            char form[96];
+            char text[BWT_FEEDBACK_SIZE];
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            bwt_question_describe_answer(&c->q, form, sizeof(form));
+            int len = BWT_MSG(text, sizeof(text), MSG_RESULT_INVALID, form);
+            struct iovec iov[2] = {
+                { .iov_base = text, .iov_len = len < (int)sizeof(text) ? (size_t)len : sizeof(text) - 1 },
+                { .iov_base = (void*)PROMPT, .iov_len = sizeof(PROMPT) - 1 },
+            };
+            send_reply(c, i, iov, 2);
+            break;
+        }
+    }
+}
+
+/**
+ * Read what a learner sent and grade every complete line
+ *
+ * @return 0 on success, -1 if the learner disconnected
+ */
+static int read_learner(struct classroom* c, size_t i) {
+    char chunk[256];
+    ssize_t n = read(c->fds[2 + i].fd, chunk, sizeof(chunk));
+    if (n == 0) {
+        return -1;
+    }
+    if (n < 0) {
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ? 0 : -1;
+    }
+
+    for (size_t k = 0; k < (size_t)n;) {
+        bool complete;
+        k += bwt_line_feed(&c->learners[i].in, chunk + k, (size_t)n - k, &complete);
+        if (complete) {
+            handle_answer(c, i, c->learners[i].in.line);
+        }
+    }
+    return 0;
+}
+
+/**
+ * Accept every pending connection
+ */
+static void accept_learners(struct classroom* c) {
+    for (;;) {
+        int fd = accept(c->fds[1].fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                perror("accept");
+            }
+            return;
+        }
+        if (bwt_set_nonblocking(fd) < 0) {
+            close(fd);
+            continue;
+        }
+
+        if (c->count == c->capacity) {
+            size_t capacity = c->capacity ? c->capacity * 2 : 64;
+            struct pollfd* fds = realloc(c->fds, (2 + capacity) * sizeof(*fds));
+            if (fds != NULL) {
+                c->fds = fds;
+            }
+            struct learner* learners = fds ? realloc(c->learners, capacity * sizeof(*learners)) : NULL;
+            if (learners == NULL) {
+                close(fd);
+                return;
+            }
+            c->learners = learners;
+            c->capacity = capacity;
+        }
+
+        size_t i = c->count++;
+        c->fds[2 + i] = (struct pollfd){ .fd = fd, .events = POLLIN };
+        c->learners[i] = (struct learner){ 0 };
+        const char* welcome = bwt_msg_text(MSG_BROADCAST_WELCOME);
+        (void)!write(fd, welcome, strlen(welcome));
+        if (c->current != NULL) {
+            if (queue_question(c, i) < 0) {
+                drop_learner(c, i);
+            }
+        } else {
+            send_message(c, i, MSG_BROADCAST_WAITING);
+        }
+    }
+}
+
+/**
+ * Print how the class is doing on the current question
+ */
+static void print_status(const struct classroom* c) {
+    char count[BWT_MSG_INT_SIZE];
+    bwt_msg_int(count, (long long)c->count);
+    if (c->current == NULL) {
+        BWT_MSG_PRINT(MSG_BROADCAST_IDLE, count);
+    } else {
+        char number[BWT_MSG_INT_SIZE], correct[BWT_MSG_INT_SIZE], wrong[BWT_MSG_INT_SIZE];
+        BWT_MSG_PRINT(MSG_BROADCAST_STATUS, bwt_msg_int(number, c->number), bwt_msg_int(correct, c->correct),
+                      count, bwt_msg_int(wrong, c->wrong));
+    }
+}
+
+/**
+ * Handle a command typed by the instructor
+ *
+ * @return false to stop broadcasting
+ */
+static bool instructor_command(struct classroom* c, char* line) {
+    static const uint8_t topics[] = { BWT_TOPIC_AND, BWT_TOPIC_XOR, BWT_TOPIC_NOT };
+    line[strcspn(line, "\r\n")] = '\0';
+
+    if (strcmp(line, "q") == 0) {
+        return false;
+    }
+    if (strcmp(line, "s") == 0) {
+        print_status(c);
+        return true;
+    }
+    for (size_t t = 0; t < sizeof(topics); t++) {
+        if (strcmp(line, bwt_topic_name(topics[t])) == 0) {
+            push_question(c, topics[t]);
+            return true;
+        }
+    }
+    if (line[0] == '\0') {
+        if (c->current != NULL) {
+            print_status(c);
+        }
+        push_question(c, topics[bwt_rand32() % sizeof(topics)]);
+    } else {
+        fputs(bwt_msg_text(MSG_BROADCAST_COMMANDS), stdout);
+    }
+    return true;
+}
+
+/**
+ * Read what the instructor typed and run every complete command in it
+ *
+ * stdin is read with read() rather than stdio, so no command is left in a
+ * stdio buffer where poll cannot see it.
+ *
+ * @param line Buffer of partial input, kept between calls
+ * @param size Size of the buffer
+ * @param len Bytes of partial input in the buffer
+ * @return false to stop broadcasting: q, end of input or an error
+ */
+static bool instructor_input(struct classroom* c, char* line, size_t size, size_t* len) {
+    ssize_t n = read(STDIN_FILENO, line + *len, size - 1 - *len);
+    if (n < 0) {
+        return errno == EINTR || errno == EAGAIN;
+    }
+    if (n == 0) {
+        if (*len > 0) {  // a last command without a newline still counts
+            line[*len] = '\0';
+            instructor_command(c, line);
+        }
+        return false;
+    }
+    *len += (size_t)n;
+
+    size_t start = 0;
+    char* nl;
+    while ((nl = memchr(line + start, '\n', *len - start)) != NULL) {
+        *nl = '\0';
+        if (!instructor_command(c, line + start)) {
+            return false;
+        }
+        start = (size_t)(nl - line) + 1;
+    }
+    memmove(line, line + start, *len - start);
+    *len -= start;
+    if (*len == size - 1) {  // a line longer than the buffer is taken as it is
+        line[*len] = '\0';
+        *len = 0;
+        return instructor_command(c, line);
+    }
+    return true;
+}
+
+/**
+ * Run the instructor side of classroom broadcast
+ *
+ * @param port TCP port learners connect to
+ * @param settings_watch Descriptor from bwt_settings_watch, or -1
+ * @return Exit status for main
+ */
+int bwt_broadcast_main(uint16_t port, int settings_watch) {
+    struct classroom c = { .settings_watch = settings_watch };
+    char line[128];
+    size_t line_len = 0;
+    int status = 0;
+
+    signal(SIGPIPE, SIG_IGN);  // a learner hanging up must not kill the class
+    bwt_raise_fd_limit();
+
+    int listener = bwt_listen_tcp(port, false);
+    if (listener < 0) {
+        perror("listen");
+        return 1;
+    }
+    c.fds = malloc(2 * sizeof(*c.fds));
+    if (c.fds == NULL) {
+        close(listener);
+        return 1;
+    }
+    c.fds[0] = (struct pollfd){ .fd = STDIN_FILENO, .events = POLLIN };
+    c.fds[1] = (struct pollfd){ .fd = listener, .events = POLLIN };
+
+    char port_dec[BWT_MSG_INT_SIZE];
+    BWT_MSG_PRINT(MSG_BROADCAST_LISTENING, bwt_msg_int(port_dec, port));
+
+    for (;;) {
+        fflush(stdout);
+        if (poll(c.fds, 2 + c.count, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("poll");
+            status = 1;
+            break;
+        }
+
+        if (c.fds[0].revents & (POLLIN | POLLHUP)) {
+            if (!instructor_input(&c, line, sizeof(line), &line_len)) {
+                break;
+            }
+            continue;  // a push may have moved learners around
+        }
+
+        for (size_t i = 0; i < c.count;) {
+            short revents = c.fds[2 + i].revents;
+            int rc = 0;
+            if (revents & POLLOUT) {
+                rc = flush_pending(&c, i);
+            }
+            if (rc == 0 && (revents & (POLLIN | POLLHUP | POLLERR))) {
+                rc = read_learner(&c, i);
+            }
+            if (rc < 0) {
+                drop_learner(&c, i);
+                c.fds[2 + i].revents = 0;  // the moved learner is handled next poll
+            } else {
+                i++;
+            }
+        }
+        if (c.fds[1].revents & POLLIN) {
+            accept_learners(&c);
+        }
+    }
+
+    print_status(&c);
+    while (c.count > 0) {
+        drop_learner(&c, c.count - 1);
+    }
+    bwt_rcbuf_unref(c.current);
+    bwt_settings_leave(c.settings);
+    bwt_settings_release(c.settings);
+    free(c.learners);
+    free(c.fds);
+    close(listener);
+    return status;
+}
@@ -0,0 +1,23 @@
+/*
+ * bwt_broadcast.h - Instructor-driven classroom broadcast for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * `bwt --broadcast PORT` listens for learners, who connect with any line
+ * based client such as `nc HOST PORT`. Every time the instructor presses
+ * Enter, one AND, XOR or NOT question is generated and rendered once into
+ * an immutable, reference-counted buffer. Each learner connection holds a
+ * reference to that buffer and an offset into it, so the same bytes are
+ * written to every socket and a question costs one render however many
+ * learners there are. Answers are graded against the shared question.
+ */
+
+#ifndef BWT_BROADCAST_H
+#define BWT_BROADCAST_H
+
+#include <stdint.h>
+
+int bwt_broadcast_main(uint16_t port, int settings_watch);
+
+#endif // BWT_BROADCAST_H
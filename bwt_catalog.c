@@ -0,0 +1,482 @@
+/*
+ * bwt_catalog.c - Compiled message catalogs for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ */
+
+#define _POSIX_C_SOURCE 200809L  // readlink
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "bwt_catalog.h"
+
+#define CATALOG_PATH_SIZE 4096
+
+const char* const bwt_msg_keys[BWT_MSG_COUNT] = {
+#define BWT_MSG_KEY(id, key, text) key,
+    BWT_MESSAGES(BWT_MSG_KEY)
+#undef BWT_MSG_KEY
+};
+
+const char* const bwt_msg_english[BWT_MSG_COUNT] = {
+#define BWT_MSG_TEXT(id, key, text) text,
+    BWT_MESSAGES(BWT_MSG_TEXT)
+#undef BWT_MSG_TEXT
+};
+
+static struct bwt_catalog builtin;   // English, built on first use
+static struct bwt_catalog selected;  // catalog of the user's language, if any
+static pthread_once_t builtin_once = PTHREAD_ONCE_INIT;
+static char selected_lang[32] = "en";
+
+/**
+ * Hash of every message key in order, so that a catalog compiled for a
+ * different list of messages is never used
+ *
+ * @return 32-bit FNV-1a hash
+ */
+uint32_t bwt_catalog_keys_hash(void) {
+    uint32_t hash = 2166136261u;
+    for (int id = 0; id < BWT_MSG_COUNT; id++) {
+        for (const char* p = bwt_msg_keys[id]; ; p++) {
+            hash = (hash ^ (uint8_t)*p) * 16777619u;
+            if (*p == '\0') {
+                break;
+            }
+        }
+    }
+    return hash;
+}
+
+/**
+ * Split a template into segments
+ *
+ * Called once to count and once to fill in: with `segments` NULL only the
+ * counts are updated.
+ *
+ * @param tmpl The template
+ * @param segments Segment array to fill, or NULL
+ * @param nsegments Number of segments so far, updated
+ * @param text Text area to fill, or NULL
+ * @param text_size Bytes of text so far, updated
+ */
+static void split_template(const char* tmpl, struct bwt_catalog_segment* segments, uint32_t* nsegments,
+                           char* text, uint32_t* text_size) {
+    const char* p = tmpl;
+
+    while (*p != '\0') {
+        if (p[0] == '{' && p[1] >= '0' && p[1] <= '9' && p[2] == '}') {
+            if (segments != NULL) {
+                segments[*nsegments] = (struct bwt_catalog_segment){ 0, 0, (uint16_t)(p[1] - '0') };
+            }
+            (*nsegments)++;
+            p += 3;
+            continue;
+        }
+        // Literal text up to the next argument, with {{ read as {
+        uint32_t start = *text_size;
+        while (*p != '\0' && !(p[0] == '{' && p[1] >= '0' && p[1] <= '9' && p[2] == '}')) {
+            if (text != NULL) {
+                text[*text_size] = *p;
+            }
+            (*text_size)++;
+            p += (p[0] == '{' && p[1] == '{') ? 2 : 1;
+        }
+        if (segments != NULL) {
+            text[*text_size] = '\0';
+            segments[*nsegments] = (struct bwt_catalog_segment){
+                start, (uint16_t)(*text_size - start), BWT_CATALOG_LITERAL
+            };
+        }
+        (*text_size)++;  // the terminator
+        (*nsegments)++;
+    }
+}
+
+/**
+ * Compile templates into a catalog image
+ *
+ * @param templates One template per message id, NULL for messages that
+ *                  are not translated
+ * @param size Set to the size of the image
+ * @return The image, to be freed by the caller, or NULL if out of memory
+ */
+void* bwt_catalog_build(const char* const* templates, size_t* size) {
+    uint32_t nsegments = 0;
+    uint32_t text_size = 0;
+
+    for (int id = 0; id < BWT_MSG_COUNT; id++) {
+        if (templates[id] != NULL) {
+            split_template(templates[id], NULL, &nsegments, NULL, &text_size);
+        }
+    }
+
+    size_t index_offset = sizeof(struct bwt_catalog_header);
+    size_t segments_offset = index_offset + BWT_MSG_COUNT * sizeof(struct bwt_catalog_entry);
+    size_t text_offset = segments_offset + nsegments * sizeof(struct bwt_catalog_segment);
+    *size = text_offset + text_size;
+
+    char* image = calloc(1, *size);
+    if (image == NULL) {
+        return NULL;
+    }
+    struct bwt_catalog_header* header = (struct bwt_catalog_header*)image;
+    struct bwt_catalog_entry* index = (struct bwt_catalog_entry*)(image + index_offset);
+    struct bwt_catalog_segment* segments = (struct bwt_catalog_segment*)(image + segments_offset);
+
+    memcpy(header->magic, BWT_CATALOG_MAGIC, sizeof(header->magic));
+    header->version = BWT_CATALOG_VERSION;
+    header->keys_hash = bwt_catalog_keys_hash();
+    header->count = BWT_MSG_COUNT;
+    header->segment_count = nsegments;
+    header->text_size = text_size;
+
+    nsegments = 0;
+    text_size = 0;
+    for (int id = 0; id < BWT_MSG_COUNT; id++) {
+        index[id].first = nsegments;
+        if (templates[id] != NULL) {
+            split_template(templates[id], segments, &nsegments, image + text_offset, &text_size);
+        }
+        index[id].count = nsegments - index[id].first;
+    }
+    return image;
+}
+
+/**
+ * Check a catalog image and set up pointers into it
+ *
+ * @return 0 on success, -1 if the image is not a valid catalog for this
+ *         build of bwt
+ */
+static int attach(struct bwt_catalog* cat, const char* image, size_t size) {
+    const struct bwt_catalog_header* header = (const struct bwt_catalog_header*)image;
+
+    if (size < sizeof(*header)
+        || memcmp(header->magic, BWT_CATALOG_MAGIC, sizeof(header->magic)) != 0
+        || header->version != BWT_CATALOG_VERSION
+        || header->keys_hash != bwt_catalog_keys_hash()
+        || header->count != BWT_MSG_COUNT) {
+        return -1;
+    }
+    size_t segments_offset = sizeof(*header) + BWT_MSG_COUNT * sizeof(struct bwt_catalog_entry);
+    size_t text_offset = segments_offset + (size_t)header->segment_count * sizeof(struct bwt_catalog_segment);
+    if (text_offset + header->text_size != size) {
+        return -1;
+    }
+
+    cat->header = header;
+    cat->index = (const struct bwt_catalog_entry*)(image + sizeof(*header));
+    cat->segments = (const struct bwt_catalog_segment*)(image + segments_offset);
+    cat->text = image + text_offset;
+    cat->size = size;
+
+    // Validate once here so that lookups need no bounds checks
+    for (int id = 0; id < BWT_MSG_COUNT; id++) {
+        if (cat->index[id].first > header->segment_count
+            || cat->index[id].count > header->segment_count - cat->index[id].first) {
+            return -1;
+        }
+    }
+    for (uint32_t i = 0; i < header->segment_count; i++) {
+        const struct bwt_catalog_segment* seg = &cat->segments[i];
+        if (seg->arg == BWT_CATALOG_LITERAL
+            ? (seg->offset >= header->text_size || header->text_size - seg->offset <= seg->length
+               || cat->text[seg->offset + seg->length] != '\0')
+            : seg->arg > 9) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Map a compiled catalog file read-only
+ *
+ * @param cat The catalog to set up
+ * @param path Path of the .cat file
+ * @return 0 on success, -1 if the file is missing or not a valid catalog
+ */
+int bwt_catalog_open(struct bwt_catalog* cat, const char* path) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+
+    if (fd < 0) {
+        return -1;
+    }
+    if (fstat(fd, &st) < 0 || st.st_size <= 0) {
+        close(fd);
+        return -1;
+    }
+    void* image = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED) {
+        return -1;
+    }
+    if (attach(cat, image, (size_t)st.st_size) < 0) {
+        munmap(image, (size_t)st.st_size);
+        *cat = (struct bwt_catalog){ 0 };
+        return -1;
+    }
+    cat->mapped = true;
+    return 0;
+}
+
+static void build_builtin(void) {
+    size_t size;
+    char* image = bwt_catalog_build(bwt_msg_english, &size);
+    if (image == NULL || attach(&builtin, image, size) < 0) {
+        fprintf(stderr, "bwt: could not build the message catalog\n");
+        exit(1);
+    }
+}
+
+/**
+ * Directory catalogs are looked for in: $BWT_CATALOG_DIR, or msg/ next
+ * to the executable
+ */
+static bool catalog_dir(char* dir, size_t size) {
+    const char* env = getenv("BWT_CATALOG_DIR");
+    if (env != NULL && *env != '\0') {
+        return (size_t)snprintf(dir, size, "%s", env) < size;
+    }
+    ssize_t n = readlink("/proc/self/exe", dir, size - 1);
+    if (n <= 0) {
+        return false;
+    }
+    dir[n] = '\0';
+    char* slash = strrchr(dir, '/');
+    if (slash == NULL || (size_t)(slash - dir) + sizeof("/msg") > size) {
+        return false;
+    }
+    strcpy(slash, "/msg");
+    return true;
+}
+
+/**
+ * Choose the catalog for a language
+ *
+ * Tries `<lang>.cat` with the territory (ko_KR) and then without it (ko).
+ * With `lang` NULL the language comes from LC_ALL, LC_MESSAGES or LANG.
+ * Call once at startup, before any thread formats a message.
+ *
+ * @param lang Language such as "ko" or "ko_KR.UTF-8", or NULL
+ * @return 0 if a catalog was found or none is needed (English), -1 if
+ *         the language has no usable catalog and English is used
+ */
+int bwt_catalog_select(const char* lang) {
+    static const char* const vars[] = { "LC_ALL", "LC_MESSAGES", "LANG" };
+    char dir[CATALOG_PATH_SIZE];
+    char path[CATALOG_PATH_SIZE + 64];
+    char name[32];
+
+    for (size_t i = 0; lang == NULL && i < sizeof(vars) / sizeof(vars[0]); i++) {
+        const char* value = getenv(vars[i]);
+        lang = (value != NULL && *value != '\0') ? value : NULL;
+    }
+    if (lang == NULL || strcmp(lang, "C") == 0 || strcmp(lang, "POSIX") == 0) {
+        lang = "en";
+    }
+    // Drop the encoding and modifier: ko_KR.UTF-8@euro -> ko_KR
+    size_t len = strcspn(lang, ".@");
+    if (len == 0 || len >= sizeof(name)) {
+        return -1;
+    }
+    memcpy(name, lang, len);
+    name[len] = '\0';
+
+    if (selected.mapped) {
+        munmap((void*)selected.header, selected.size);
+    }
+    selected = (struct bwt_catalog){ 0 };
+    snprintf(selected_lang, sizeof(selected_lang), "en");
+
+    bool english = strncmp(name, "en", 2) == 0 && (name[2] == '\0' || name[2] == '_');
+    if (catalog_dir(dir, sizeof(dir))) {
+        for (int pass = 0; pass < 2; pass++) {
+            if (pass == 1) {
+                name[strcspn(name, "_")] = '\0';
+            }
+            snprintf(path, sizeof(path), "%s/%s.cat", dir, name);
+            if (bwt_catalog_open(&selected, path) == 0) {
+                snprintf(selected_lang, sizeof(selected_lang), "%s", name);
+                return 0;
+            }
+        }
+    }
+    return english ? 0 : -1;
+}
+
+/**
+ * Language of the selected catalog, "en" for the built-in messages
+ */
+const char* bwt_catalog_lang(void) {
+    return selected_lang;
+}
+
+/**
+ * The catalog that has a message: the selected one, or built-in English
+ */
+static const struct bwt_catalog* catalog_for(enum bwt_msg id) {
+    if (selected.header != NULL && selected.index[id].count > 0) {
+        return &selected;
+    }
+    pthread_once(&builtin_once, build_builtin);
+    return &builtin;
+}
+
+/**
+ * Format a message
+ *
+ * @param buf Output buffer
+ * @param size Size of the output buffer
+ * @param id The message
+ * @param args Arguments for {0}, {1}... ; missing ones are left empty
+ * @param nargs Number of arguments
+ * @return Length of the whole message, as for snprintf
+ */
+int bwt_msg_format(char* buf, size_t size, enum bwt_msg id, const char* const* args, int nargs) {
+    const struct bwt_catalog* cat = catalog_for(id);
+    const struct bwt_catalog_entry* entry = &cat->index[id];
+    size_t len = 0;
+
+    for (uint32_t i = 0; i < entry->count; i++) {
+        const struct bwt_catalog_segment* seg = &cat->segments[entry->first + i];
+        const char* src;
+        size_t n;
+        if (seg->arg == BWT_CATALOG_LITERAL) {
+            src = cat->text + seg->offset;
+            n = seg->length;
+        } else {
+            src = seg->arg < nargs && args[seg->arg] != NULL ? args[seg->arg] : "";
+            n = strlen(src);
+        }
+        if (len < size) {
+            memcpy(buf + len, src, len + n < size ? n : size - len);
+        }
+        len += n;
+    }
+    if (size > 0) {
+        buf[len < size ? len : size - 1] = '\0';
+    }
+    return (int)len;
+}
+
+/**
+ * Print a message
+ *
+ * @param out Stream to print to
+ * @param id The message
+ * @param args Arguments for {0}, {1}...
+ * @param nargs Number of arguments
+ */
+void bwt_msg_print(FILE* out, enum bwt_msg id, const char* const* args, int nargs) {
+    const struct bwt_catalog* cat = catalog_for(id);
+    const struct bwt_catalog_entry* entry = &cat->index[id];
+
+    for (uint32_t i = 0; i < entry->count; i++) {
+        const struct bwt_catalog_segment* seg = &cat->segments[entry->first + i];
+        if (seg->arg == BWT_CATALOG_LITERAL) {
+            fwrite(cat->text + seg->offset, 1, seg->length, out);
+        } else if (seg->arg < nargs && args[seg->arg] != NULL) {
+            fputs(args[seg->arg], out);
+        }
+    }
+}
+
+/**
+ * Text of a message without arguments, straight from the catalog
+ *
+ * @param id The message
+ * @return The text; for a message with arguments, only the text before
+ *         the first one
+ */
+const char* bwt_msg_text(enum bwt_msg id) {
+    const struct bwt_catalog* cat = catalog_for(id);
+    const struct bwt_catalog_entry* entry = &cat->index[id];
+
+    if (entry->count == 0 || cat->segments[entry->first].arg != BWT_CATALOG_LITERAL) {
+        return "";
+    }
+    return cat->text + cat->segments[entry->first].offset;
+}
+
+/**
+ * Write an integer as decimal digits, for use as a message argument
+ *
+ * @param buf Buffer of at least BWT_MSG_INT_SIZE bytes
+ * @param value The integer
+ * @return buf
+ */
+char* bwt_msg_int(char* buf, long long value) {
+    char digits[BWT_MSG_INT_SIZE];
+    unsigned long long magnitude = value < 0 ? 0ull - (unsigned long long)value : (unsigned long long)value;
+    int n = 0;
+
+    do {
+        digits[n++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    char* p = buf;
+    if (value < 0) {
+        *p++ = '-';
+    }
+    while (n > 0) {
+        *p++ = digits[--n];
+    }
+    *p = '\0';
+    return buf;
+}
+
+/**
+ * Measure the UTF-8 character a string starts with
+ *
+ * @param s The string, not empty
+ * @param columns Set to the terminal columns it takes: two for Hangul and
+ *        other East Asian wide characters, one otherwise
+ * @return Its length in bytes, 1 to 4
+ */
+int bwt_msg_char(const char* s, int* columns) {
+    const unsigned char* p = (const unsigned char*)s;
+    uint32_t cp = *p;
+    int extra = cp >= 0xF0 ? 3 : cp >= 0xE0 ? 2 : cp >= 0xC0 ? 1 : 0;
+    int len = 1;
+
+    cp &= extra == 0 ? 0x7F : (0x3F >> extra);
+    for (; extra > 0 && (p[len] & 0xC0) == 0x80; extra--, len++) {
+        cp = (cp << 6) | (p[len] & 0x3F);
+    }
+    bool wide = (cp >= 0x1100 && cp <= 0x115F) || (cp >= 0x2E80 && cp <= 0xA4CF)
+                || (cp >= 0xAC00 && cp <= 0xD7A3) || (cp >= 0xF900 && cp <= 0xFAFF)
+                || (cp >= 0xFF00 && cp <= 0xFF60) || (cp >= 0xFFE0 && cp <= 0xFFE6);
+    *columns = wide ? 2 : 1;
+    return len;
+}
+
+/**
+ * Number of terminal columns a UTF-8 string takes, counting Hangul and
+ * other East Asian wide characters as two, for lining up under a message
+ *
+ * @param s The string
+ * @return Number of columns
+ */
+int bwt_msg_columns(const char* s) {
+    int columns = 0;
+
+    while (*s != '\0') {
+        int width;
+        s += bwt_msg_char(s, &width);
+        columns += width;
+    }
+    return columns;
+}
@@ -0,0 +1,301 @@
+/*
+ * bwt_catalog.h - Compiled message catalogs for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * User-facing text is looked up by message id instead of being written as
+ * printf format strings. The English text lives in BWT_MESSAGES below;
+ * translations are plain `key = text` files in msg/ that bwt_msgc compiles
+ * into a binary catalog. A catalog holds every message already split into
+ * segments, each either literal text or an argument number, with an index
+ * by message id, so formatting a message is a few memcpys and never parses
+ * a format string. Catalogs are mapped read-only, so every bwt process
+ * shares the same pages. Messages missing from a catalog, or all messages
+ * when no catalog is found, fall back to the built-in English text.
+ *
+ * In templates `{0}` to `{9}` are replaced by the arguments, which are
+ * always strings, and `{{` is a literal `{`. A translation may use the
+ * arguments in any order, or leave some out (such as English articles).
+ */
+
+#ifndef BWT_CATALOG_H
+#define BWT_CATALOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define BWT_CATALOG_MAGIC "BWTCAT1"  // 8 bytes including the terminator
+#define BWT_CATALOG_VERSION 1
+#define BWT_CATALOG_LITERAL UINT16_MAX  // segment arg of literal text
+
+// X(id, key, English template)
+#define BWT_MESSAGES(X) \
+    X(MSG_KIND_SIGNED, "kind.signed", "signed") \
+    X(MSG_KIND_UNSIGNED, "kind.unsigned", "unsigned") \
+    X(MSG_FORMAT_BINARY, "format.binary", "binary") \
+    X(MSG_FORMAT_HEX, "format.hex", "hex") \
+    X(MSG_FORMAT_OCTAL, "format.octal", "octal") \
+    X(MSG_FORMAT_DECIMAL, "format.decimal", "decimal") \
+    X(MSG_QUESTION_BITWISE, "question.bitwise", \
+      "The following question is about {0} {1}-bit integers *a* and *b*.\n" \
+      "Given `a={2}` and `b={3}`,\n\nQ{4}: What is the result of `a{5}b` in {6}?\n") \
+    X(MSG_QUESTION_NOT, "question.not", \
+      "Given {0} {1}-bit integer `a={2}`,\n\nQ{3}: What is `~a` in {4}? (a is {0})\n") \
+    X(MSG_QUESTION_SHIFT, "question.shift", \
+      "Given {0} {1}-bit integer `a={2}`,\n\nQ{3}: What is the {4} result of a {5} {6}?\n") \
+    X(MSG_QUESTION_DEC2BIN, "question.dec2bin", \
+      "Q{0}: Convert the {1} decimal {2} to {3}-bit {4} representation.\n") \
+    X(MSG_QUESTION_BIN2DEC, "question.bin2dec", \
+      "Q{0}: What is the decimal value of {1} when interpreted as {2} {3} {4}-bit integer?\n") \
+    X(MSG_QUESTION_BIN2HEX, "question.bin2hex", "Q{0}: Write the {1}-bit binary number {2} in hex.\n") \
+    X(MSG_QUESTION_HEX2BIN, "question.hex2bin", "Q{0}: Write {1} as {2} {3}-bit binary number.\n") \
+    X(MSG_QUESTION_UNKNOWN, "question.unknown", "Q{0}: (unknown topic)\n") \
+    X(MSG_ANSWER_DECIMAL, "answer.decimal", "a decimal number") \
+    X(MSG_ANSWER_BINARY, "answer.binary", "{0} {1}-bit binary number") \
+    X(MSG_ANSWER_DIGITS, "answer.digits", "{0} {1} number of up to {2} digits") \
+    X(MSG_ANSWER_CHOICE, "answer.choice", "the letter of an option, a to {0}") \
+    X(MSG_FEEDBACK_ANSWER, "feedback.answer", "Your answer: ") \
+    X(MSG_FEEDBACK_ANSWER_BINARY, "feedback.answer_binary", "Your answer in binary: ") \
+    X(MSG_FEEDBACK_WRONG_BITS, "feedback.wrong_bits", "  ({0} of {1} bits wrong)\n") \
+    X(MSG_FEEDBACK_HINT, "feedback.hint", "Hint: {0}\n") \
+    X(MSG_HINT_NONE, "hint.none", "") \
+    X(MSG_HINT_FORGOT_PLUS_ONE, "hint.forgot_plus_one", \
+      "That is the one's complement. For two's complement, flip the bits of the magnitude and then add 1.") \
+    X(MSG_HINT_SIGN_MAGNITUDE, "hint.sign_magnitude", \
+      "That is sign-magnitude. C stores negative integers in two's complement: " \
+      "flip the bits of the magnitude and add 1.") \
+    X(MSG_HINT_FORGOT_SIGN, "hint.forgot_sign", \
+      "That is the magnitude only. The number is negative, so write its two's complement.") \
+    X(MSG_HINT_NEGATED, "hint.negated", "That is -a, not ~a. ~ only flips the bits; -a is ~a + 1.") \
+    X(MSG_HINT_NOT_FLIPPED, "hint.not_flipped", "~ flips every bit, 0s become 1s and 1s become 0s.") \
+    X(MSG_HINT_WRONG_DIRECTION, "hint.wrong_direction", \
+      "You shifted the wrong way: << moves bits toward the MSB, >> toward the LSB.") \
+    X(MSG_HINT_NO_SIGN_EXTENSION, "hint.no_sign_extension", \
+      "a is signed and negative, so >> copies the sign bit into the vacated bits (sign extension).") \
+    X(MSG_HINT_SIGN_EXTENDED, "hint.sign_extended", "a is unsigned, so >> always shifts in zeros.") \
+    X(MSG_HINT_SHIFT_AMOUNT, "hint.shift_amount", "Check how many places to shift.") \
+    X(MSG_HINT_WRONG_OPERATOR, "hint.wrong_operator", "that is the result of `a{0}b`.") \
+    X(MSG_HINT_UNSIGNED_READING, "hint.unsigned_reading", \
+      "That is the unsigned reading. In a signed integer the MSB is the sign bit.") \
+    X(MSG_HINT_SIGNED_READING, "hint.signed_reading", \
+      "The integer is unsigned, so every bit, including the MSB, adds to the magnitude.") \
+    X(MSG_HINT_REVERSED, "hint.reversed", "The bits are in reverse order. Write the most significant bit first.") \
+    X(MSG_HINT_INVERTED, "hint.inverted", "Every bit is flipped. Check your 0s and 1s.") \
+    X(MSG_HINT_TRUNCATED, "hint.truncated", "Only the low half of the bits is there; the result keeps its whole width.") \
+    X(MSG_RESULT_CORRECT, "result.correct", "Correct!\n") \
+    X(MSG_RESULT_WRONG, "result.wrong", "Sorry, that is incorrect! Please try again\n") \
+    X(MSG_RESULT_ANSWER, "result.answer", "The answer is {0}\n") \
+    X(MSG_RESULT_INVALID, "result.invalid", "Invalid input. Please enter {0}.\n") \
+    X(MSG_ADAPTIVE_INTRO, "adaptive.intro", \
+      "\n=== Adaptive Practice ===\n" \
+      "bwt picks each question based on your previous answers.\n" \
+      "Enter `?` to see the answer, or `q` to return to the main menu.\n\n") \
+    X(MSG_ADAPTIVE_DONE, "adaptive.done", "Round complete! Choose adaptive practice again to keep going.\n") \
+    X(MSG_ADAPTIVE_ACCURACY_TITLE, "adaptive.accuracy_title", "Right on the first try, recently:\n") \
+    X(MSG_ADAPTIVE_ACCURACY, "adaptive.accuracy", "  {0} {1}-bit: {2}% of the last {3}\n") \
+    X(MSG_EXAM_INTRO, "exam.intro", \
+      "\n=== Exam ===\n" \
+      "Student {0}, {1} questions. Each question takes one answer and is graded at the end.\n\n") \
+    X(MSG_EXAM_SCORE, "exam.score", "\nYou answered {0} of {1} questions correctly.\n") \
+    X(MSG_QUIZ_DECIMAL_AB, "quiz.decimal_ab", \
+      "\nThe following questions are about signed 8-bit integers *a* and *b*.\n" \
+      "Given `a={0}` and `b={1}`,\n\n") \
+    X(MSG_QUIZ_BINARY_AB, "quiz.binary_ab", \
+      "\nThe following questions are about signed 8-bit integers *a* and *b*.\n" \
+      "Given `a={0}` and `b={1}` in binary,\n\n") \
+    X(MSG_QUIZ_BINARY_OF, "quiz.binary_of", "Q{0}: What is the binary representation of `{1}`?\n") \
+    X(MSG_QUIZ_RESULT, "quiz.result", "Q{0}: What is the result of `a{1}b` in {2}?\n") \
+    X(MSG_QUIZ_VALUE, "quiz.value", "Q{0}: What is `{1}` in {2}?\n") \
+    X(MSG_QUIZ_DIGITS_ONLY, "quiz.digits_only", "Please enter digits only.\n") \
+    X(MSG_QUIZ_NOT_INTRO, "quiz.not_intro", \
+      "\nThe following questions are about the bitwise NOT operator with different integer types.\n" \
+      "Given signed int `a={0}` and unsigned int `b={1}`,\n\n" \
+      "a (signed) in binary: {2}\n" \
+      "b (unsigned) in binary: {3}\n\n") \
+    X(MSG_QUIZ_NOT, "quiz.not", "Q{0}: What is `~{1}` in {2}? ({1} is {3})\n") \
+    X(MSG_QUIZ_NOT_EXPLAIN, "quiz.not_explain", \
+      "Did you notice the difference?\n" \
+      "~{0} (signed) = {1}, while ~{2} (unsigned) = {3}\n" \
+      "This is because negative numbers are stored using two's complement.\n" \
+      "For bitwise NOT (~) operation:\n" \
+      "1. When we apply ~ to a number, we simply flip all the bits.\n" \
+      "2. For unsigned integers, this just gives us the bitwise complement.\n" \
+      "3. For signed integers, the result is interpreted as a two's complement representation\n" \
+      "   of a negative number if the most significant bit is 1.\n" \
+      "\nTo verify: The binary representation of {0} is {4}\n" \
+      "Applying ~ gives us {5} (which is {1} in decimal)\n" \
+      "This matches our expectation since ~{0} = {1} for signed 8-bit integers.\n") \
+    X(MSG_QUIZ_SHIFT_INTRO, "quiz.shift_intro", \
+      "\nThe following questions are about shifting unsigned 8-bit integer a bitwise.\n" \
+      "Given a = {0}\n") \
+    X(MSG_QUIZ_SHIFT_BINARY_OF, "quiz.shift_binary_of", "Q{0}: What is the binary representation of {1}?\n") \
+    X(MSG_QUIZ_SHIFT, "quiz.shift", "Q{0}: What is the {1} result of a {2} {3}?\n") \
+    X(MSG_QUIZ_UNKNOWN_CHOICE, "quiz.unknown_choice", "Invalid choice. Returning to main menu.\n") \
+    X(MSG_CONVERT_MENU, "convert.menu", \
+      "\n=== Binary <--> Decimal Conversion Quiz ===\n" \
+      "This quiz will help you understand how the same binary pattern\n" \
+      "can represent different values as signed or unsigned integers.\n\n" \
+      "Choose a sub-topic:\n" \
+      "1. Decimal to Binary conversions\n" \
+      "2. Binary to Decimal conversions\n" \
+      "3. Same binary, different interpretations\n" \
+      "Enter your choice (1-3): ") \
+    X(MSG_CONVERT_DEC2BIN_TITLE, "convert.dec2bin_title", "\n=== Decimal to Binary Conversion ===\n") \
+    X(MSG_CONVERT_DEC2BIN_CORRECT, "convert.dec2bin_correct", "Correct! {0} in binary is {1}\n\n") \
+    X(MSG_CONVERT_BIN2DEC_TITLE, "convert.bin2dec_title", \
+      "\n=== Binary to Decimal Conversion ===\n" \
+      "Given the binary number: {0}\n\n") \
+    X(MSG_CONVERT_BIN2DEC_CORRECT, "convert.bin2dec_correct", "Correct! {0} as {1} {2} integer is {3}\n\n") \
+    X(MSG_CONVERT_PATTERNS_INTRO, "convert.patterns_intro", \
+      "\n=== Same Binary, Different Interpretations ===\n" \
+      "This quiz demonstrates how the same binary pattern can represent\n" \
+      "different values depending on whether it's interpreted as signed or unsigned.\n\n") \
+    X(MSG_CONVERT_PATTERN, "convert.pattern", \
+      "Binary pattern: {0}\n" \
+      "As unsigned 8-bit integer: {1}\n" \
+      "As signed 8-bit integer: {2}\n\n") \
+    X(MSG_CONVERT_WHY, "convert.why", \
+      "Q{0}: Why does the binary pattern {1} represent different values?\n" \
+      "1. Because binary numbers are always ambiguous\n" \
+      "2. Because the most significant bit is interpreted as the sign bit for signed integers\n" \
+      "3. Because unsigned integers can only be positive\n" \
+      "4. Because signed integers use a different counting system\n") \
+    X(MSG_CONVERT_WHY_PROMPT, "convert.why_prompt", "Enter your answer (1-4): ") \
+    X(MSG_CONVERT_WHY_CORRECT, "convert.why_correct", \
+      "Correct! In signed integers, the most significant bit (leftmost) is the sign bit.\n" \
+      "If it's 1, the number is negative and uses two's complement representation.\n" \
+      "In unsigned integers, all bits (including the most significant) represent magnitude.\n\n") \
+    X(MSG_CONVERT_INSIGHTS, "convert.insights", \
+      "=== Key Insights ===\n" \
+      "1. The same binary pattern can have different decimal values depending on interpretation.\n" \
+      "2. For signed integers (using two's complement):\n" \
+      "   - If the most significant bit is 0, the number is positive.\n" \
+      "   - If the most significant bit is 1, the number is negative.\n" \
+      "3. For unsigned integers, all bits contribute to the magnitude.\n" \
+      "4. To convert a negative number to two's complement:\n" \
+      "   - Take the absolute value in binary\n" \
+      "   - Invert all bits (one's complement)\n" \
+      "   - Add 1 to the result\n" \
+      "5. Example: -5 in two's complement 8-bit binary:\n" \
+      "   - 5 in binary: 00000101\n" \
+      "   - Invert bits: 11111010\n" \
+      "   - Add 1:      11111011\n") \
+    X(MSG_WELCOME, "menu.welcome", \
+      "Welcome to Bitwise Tutor (bwt)!\n" \
+      "This program will help you practice bitwise operations and binary conversions.\n" \
+      "Let's get started!\n\n") \
+    X(MSG_MENU, "menu.choices", \
+      "\nChoose a quiz type:\n" \
+      "1. Bitwise AND quiz (decimal values given)\n" \
+      "2. Bitwise quiz (binary values given)\n" \
+      "3. Bitwise XOR quiz (decimal values given)\n" \
+      "4. Bitwise OR quiz (decimal values given)\n" \
+      "5. Bitwise NOT quiz (signed vs unsigned)\n" \
+      "6. Binary <--> decimal conversions\n" \
+      "7. Bit-shift operations quiz\n" \
+      "8. Adaptive practice (bwt picks the questions)\n" \
+      "9. Exit\n" \
+      "Enter your choice (1-9): ") \
+    X(MSG_MENU_INVALID, "menu.invalid", "Invalid input. Please enter a number.\n") \
+    X(MSG_MENU_UNKNOWN_CHOICE, "menu.unknown_choice", "Invalid choice. Please try again.\n") \
+    X(MSG_GOODBYE, "menu.goodbye", "Thank you for using Bitwise Tutor. Goodbye!\n") \
+    X(MSG_SERVE_LISTENING, "serve.listening", \
+      "Serving on port {0} with {1} workers. `bwt --scoreboard {0}` shows the class.\n") \
+    X(MSG_SERVE_WORKER_DIED, "serve.worker_died", "Worker {0} died of signal {1}, restarting it\n") \
+    X(MSG_SERVE_WELCOME, "serve.welcome", \
+      "Connected to bitwise-tutor practice.\n" \
+      "Enter `?` to see the answer, or `q` to leave.\n") \
+    X(MSG_MUX_LISTENING, "mux.listening", "Serving the menu on port {0} in one thread. Ctrl-C stops.\n") \
+    X(MSG_MUX_SUMMARY, "mux.summary", \
+      "\nbwt serve-menu: {0} learners served, {1} at once at most, {2} KiB of stack at most\n") \
+    X(MSG_BROADCAST_LISTENING, "broadcast.listening", \
+      "Broadcasting on port {0}. Learners join with `nc HOST {0}`.\n" \
+      "Press Enter to push a question; s = status, q = quit.\n") \
+    X(MSG_BROADCAST_PUSHED, "broadcast.pushed", "Pushed Q{0} ({1}, {2}-bit {3}) to {4} learners.\n") \
+    X(MSG_BROADCAST_IDLE, "broadcast.idle", "{0} learners connected, no question pushed yet.\n") \
+    X(MSG_BROADCAST_STATUS, "broadcast.status", "Q{0}: {1} of {2} learners correct, {3} wrong answers.\n") \
+    X(MSG_BROADCAST_COMMANDS, "broadcast.commands", \
+      "Commands: Enter = next question, and/xor/not = next question on that topic,\n" \
+      "          s = status, q = quit\n") \
+    X(MSG_BROADCAST_WELCOME, "broadcast.welcome", \
+      "Connected to the bitwise-tutor classroom.\n" \
+      "Type your answer and press Enter when a question appears.\n") \
+    X(MSG_BROADCAST_WAITING, "broadcast.waiting", "Waiting for the instructor's first question.\n") \
+    X(MSG_BROADCAST_ALREADY, "broadcast.already", "You already answered this one. Wait for the next question.\n") \
+    X(MSG_TUI_STATUS, "tui.status", "{0}/{1} correct, avg {2}s") \
+    X(MSG_TUI_RECENT, "tui.recent", ", {0}/{1} recent {2}%") \
+    X(MSG_TUI_CORRECT, "tui.correct", "Q{0} correct!") \
+    X(MSG_TUI_CORRECT_RETRIES, "tui.correct_retries", "Q{0} correct after retries") \
+    X(MSG_TUI_ANSWER, "tui.answer", "Q{0} answer:") \
+    X(MSG_TUI_WRONG, "tui.wrong", "Not quite: {0} of {1} bits wrong") \
+    X(MSG_TUI_YOURS, "tui.yours", "yours") \
+    X(MSG_TUI_KEYS, "tui.keys", "Enter: check answer   ?: show answer   q: quit") \
+    X(MSG_TUI_SUMMARY, "tui.summary", "{0} of {1} questions correct. {2} bytes sent to the terminal.\n") \
+    X(MSG_TUI_SUMMARY_PER_QUESTION, "tui.summary_per_question", \
+      "{0} of {1} questions correct. {2} bytes sent to the terminal, {3} per question.\n")
+
+enum bwt_msg {
+#define BWT_MSG_ID(id, key, text) id,
+    BWT_MESSAGES(BWT_MSG_ID)
+#undef BWT_MSG_ID
+    BWT_MSG_COUNT
+};
+
+struct bwt_catalog_header {
+    char magic[8];             // BWT_CATALOG_MAGIC
+    uint32_t version;          // BWT_CATALOG_VERSION
+    uint32_t keys_hash;        // FNV-1a of all message keys, in order
+    uint32_t count;            // messages in the index
+    uint32_t segment_count;
+    uint32_t text_size;
+    uint32_t reserved;
+};
+
+struct bwt_catalog_entry {
+    uint32_t first;            // index of the message's first segment
+    uint32_t count;            // number of segments, 0 if not translated
+};
+
+struct bwt_catalog_segment {
+    uint32_t offset;           // of the text in the text area, NUL-terminated
+    uint16_t length;
+    uint16_t arg;              // argument number, or BWT_CATALOG_LITERAL
+};
+
+// A catalog is the header, then the index, the segments and the text
+struct bwt_catalog {
+    const struct bwt_catalog_header* header;
+    const struct bwt_catalog_entry* index;
+    const struct bwt_catalog_segment* segments;
+    const char* text;
+    size_t size;               // of the whole image
+    bool mapped;               // munmap rather than free
+};
+
+extern const char* const bwt_msg_keys[BWT_MSG_COUNT];
+extern const char* const bwt_msg_english[BWT_MSG_COUNT];
+
+uint32_t bwt_catalog_keys_hash(void);
+void* bwt_catalog_build(const char* const* templates, size_t* size);
+int bwt_catalog_open(struct bwt_catalog* cat, const char* path);
+int bwt_catalog_select(const char* lang);
+const char* bwt_catalog_lang(void);
+int bwt_msg_format(char* buf, size_t size, enum bwt_msg id, const char* const* args, int nargs);
+void bwt_msg_print(FILE* out, enum bwt_msg id, const char* const* args, int nargs);
+const char* bwt_msg_text(enum bwt_msg id);
+char* bwt_msg_int(char* buf, long long value);
+int bwt_msg_char(const char* s, int* columns);
+int bwt_msg_columns(const char* s);
+
+#define BWT_MSG_INT_SIZE 24  // "-9223372036854775808" and the terminator
+
+// Format or print a message with string arguments, e.g. BWT_MSG(buf, size, MSG_RESULT_ANSWER, expected)
+#define BWT_MSG_ARGS(...) (const char* const[]){ __VA_ARGS__ }, \
+    (int)(sizeof((const char* const[]){ __VA_ARGS__ }) / sizeof(const char*))
+#define BWT_MSG(buf, size, id, ...) bwt_msg_format(buf, size, id, BWT_MSG_ARGS(__VA_ARGS__))
+#define BWT_MSG_PRINT(id, ...) bwt_msg_print(stdout, id, BWT_MSG_ARGS(__VA_ARGS__))
+
+#endif // BWT_CATALOG_H
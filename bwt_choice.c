@@ -0,0 +1,205 @@
+/*
+ * bwt_choice.c - Multiple-choice questions for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ */
+
+#include "bwt_choice.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bwt_catalog.h"
+#include "bwt_feedback.h"
+
+#define MAX_CANDIDATES 12  // topic mistakes, generic mistakes and one-bit slips
+
+struct candidates {
+    struct bwt_choice c[MAX_CANDIDATES];
+    uint8_t n;
+    uint32_t mask;
+    bool is_signed;
+};
+
+static void add(struct candidates* list, uint32_t bits, uint8_t mistake) {
+    list->c[list->n++] = (struct bwt_choice){ bits & list->mask, list->is_signed, mistake };
+}
+
+static void add_reading(struct candidates* list, uint32_t bits, bool is_signed, uint8_t mistake) {
+    list->c[list->n++] = (struct bwt_choice){ bits & list->mask, is_signed, mistake };
+}
+
+/**
+ * a >> n as an arithmetic (signed) or logical (unsigned) shift
+ */
+static uint32_t shift_right(const struct bwt_question* q, uint32_t a, uint32_t n, bool arithmetic) {
+    if (arithmetic) {
+        return (uint32_t)(bwt_value(a, q->width, true) >> n);
+    }
+    return a >> n;
+}
+
+/**
+ * What an option reads as, so options that would print the same compare equal
+ */
+static int64_t option_key(const struct bwt_question* q, const struct bwt_choice* c) {
+    if (bwt_question_wants_decimal(q)) {
+        return bwt_value(c->bits, q->width, c->is_signed);
+    }
+    return c->bits;
+}
+
+/**
+ * Make the options of a multiple-choice question
+ *
+ * @param q The question
+ * @param random Random bits for the order of the options
+ * @param c Receives the options
+ */
+void bwt_choices_make(const struct bwt_question* q, uint32_t random, struct bwt_choices* c) {
+    uint32_t mask = bwt_width_mask(q->width);
+    uint32_t msb = UINT32_C(1) << (q->width - 1);
+    uint32_t a = q->a & mask;
+    uint32_t b = q->b & mask;
+    uint32_t n = q->b;
+    uint32_t e = q->expected;
+    struct candidates list = { .mask = mask, .is_signed = q->is_signed };
+
+    // The mistakes of the topic first, most telling first
+    switch (q->topic) {
+        case BWT_TOPIC_DEC2BIN:
+            if (q->is_signed && (a & msb)) {
+                uint32_t magnitude = ~a + 1;
+                add(&list, ~magnitude, BWT_MISTAKE_FORGOT_PLUS_ONE);
+                add(&list, magnitude | msb, BWT_MISTAKE_SIGN_MAGNITUDE);
+                add(&list, magnitude, BWT_MISTAKE_FORGOT_SIGN);
+            }
+            break;
+        case BWT_TOPIC_BIN2DEC:
+            if (a & msb) {
+                add_reading(&list, a, !q->is_signed,
+                            q->is_signed ? BWT_MISTAKE_UNSIGNED_READING : BWT_MISTAKE_SIGNED_READING);
+                if (q->is_signed) {
+                    add(&list, a + 1, BWT_MISTAKE_FORGOT_PLUS_ONE);  // -(~a) instead of -(~a + 1)
+                    add(&list, ~(a & ~msb) + 1, BWT_MISTAKE_SIGN_MAGNITUDE);
+                }
+            }
+            break;
+        case BWT_TOPIC_NOT:
+            add(&list, ~a + 1, BWT_MISTAKE_NEGATED);
+            add(&list, a, BWT_MISTAKE_NOT_FLIPPED);
+            break;
+        case BWT_TOPIC_SHL:
+            add(&list, shift_right(q, a, n, q->is_signed), BWT_MISTAKE_WRONG_DIRECTION);
+            add(&list, a << (n + 1), BWT_MISTAKE_SHIFT_AMOUNT);
+            if (n > 0) {
+                add(&list, a << (n - 1), BWT_MISTAKE_SHIFT_AMOUNT);
+            }
+            break;
+        case BWT_TOPIC_SHR:
+            add(&list, shift_right(q, a, n, !q->is_signed),
+                q->is_signed ? BWT_MISTAKE_NO_SIGN_EXTENSION : BWT_MISTAKE_SIGN_EXTENDED);
+            add(&list, a << n, BWT_MISTAKE_WRONG_DIRECTION);
+            add(&list, shift_right(q, a, n + 1, q->is_signed), BWT_MISTAKE_SHIFT_AMOUNT);
+            if (n > 0) {
+                add(&list, shift_right(q, a, n - 1, q->is_signed), BWT_MISTAKE_SHIFT_AMOUNT);
+            }
+            break;
+        case BWT_TOPIC_AND:
+            add(&list, a | b, BWT_MISTAKE_WRONG_OPERATOR);
+            add(&list, a ^ b, BWT_MISTAKE_WRONG_OPERATOR);
+            break;
+        case BWT_TOPIC_OR:
+            add(&list, a ^ b, BWT_MISTAKE_WRONG_OPERATOR);
+            add(&list, a & b, BWT_MISTAKE_WRONG_OPERATOR);
+            break;
+        case BWT_TOPIC_XOR:
+            add(&list, a | b, BWT_MISTAKE_WRONG_OPERATOR);
+            add(&list, a & b, BWT_MISTAKE_WRONG_OPERATOR);
+            break;
+        default:
+            break;
+    }
+    // Mistakes any answer can have, then one-bit slips, which always differ
+    add(&list, e & (mask >> q->width / 2), BWT_MISTAKE_TRUNCATED);
+    add(&list, ~e, BWT_MISTAKE_INVERTED);
+    add(&list, bwt_reverse_bits(e, q->width), BWT_MISTAKE_REVERSED);
+    add(&list, e ^ 1, BWT_MISTAKE_NONE);
+    add(&list, e ^ msb, BWT_MISTAKE_NONE);
+    add(&list, e ^ (msb >> 1), BWT_MISTAKE_NONE);
+
+    // The answer goes first, then the first candidates that read differently
+    c->option[0] = (struct bwt_choice){ e, q->is_signed, BWT_MISTAKE_NONE };
+    int64_t keys[BWT_CHOICES] = { option_key(q, &c->option[0]) };
+    uint8_t taken = 1;
+    for (uint8_t i = 0; i < list.n && taken < BWT_CHOICES; i++) {
+        int64_t key = option_key(q, &list.c[i]);
+        bool seen = false;
+        for (uint8_t j = 0; j < taken; j++) {
+            seen |= keys[j] == key;
+        }
+        if (!seen) {
+            keys[taken] = key;
+            c->option[taken++] = list.c[i];
+        }
+    }
+
+    // Shuffle, keeping track of where the answer went
+    c->correct = 0;
+    for (uint8_t i = BWT_CHOICES - 1; i > 0; i--) {
+        uint8_t j = (uint8_t)(random % (i + 1u));
+        random /= i + 1u;
+        struct bwt_choice t = c->option[i];
+        c->option[i] = c->option[j];
+        c->option[j] = t;
+        if (c->correct == i) {
+            c->correct = j;
+        } else if (c->correct == j) {
+            c->correct = i;
+        }
+    }
+}
+
+/**
+ * Render the options of a question, one per line
+ *
+ * @param q The question
+ * @param c Its options
+ * @param buf Output buffer, e.g. "  a) 0xF8\n  b) 0xF9\n..."
+ * @param size Size of the output buffer
+ * @return Number of characters written, truncated to fit like snprintf
+ */
+int bwt_choices_render(const struct bwt_question* q, const struct bwt_choices* c, char* buf, size_t size) {
+    uint8_t format = bwt_question_answer_format(q);
+    char value[BWT_ANSWER_SIZE];
+    int len = 0;
+
+    if (size == 0) {
+        return 0;
+    }
+    buf[0] = '\0';
+    for (uint8_t i = 0; i < BWT_CHOICES && len < (int)size; i++) {
+        bwt_format_value(value, sizeof(value), c->option[i].bits, q->width, c->option[i].is_signed, format);
+        len += snprintf(buf + len, size - (size_t)len, "  %c) %s\n", 'a' + i, value);
+    }
+    return len < (int)size ? len : (int)size - 1;
+}
+
+/**
+ * Grade the letter of an option
+ *
+ * @param c The options
+ * @param input A letter from `a`, either case, surrounding blanks allowed
+ * @param picked Set to the index of the option, if there was one
+ * @return BWT_VERDICT_CORRECT, BWT_VERDICT_WRONG or BWT_VERDICT_INVALID
+ */
+enum bwt_verdict bwt_choices_grade(const struct bwt_choices* c, const char* input, uint8_t* picked) {
+    input += strspn(input, " \t");
+    char letter = (char)(input[0] | 0x20);  // lower case
+    if (letter < 'a' || letter >= 'a' + BWT_CHOICES || input[strspn(input + 1, " \t") + 1] != '\0') {
+        return BWT_VERDICT_INVALID;
+    }
+    *picked = (uint8_t)(letter - 'a');
+    return *picked == c->correct ? BWT_VERDICT_CORRECT : BWT_VERDICT_WRONG;
+}
@@ -0,0 +1,49 @@
+/*
+ * bwt_choice.h - Multiple-choice questions for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * Any question can be asked as multiple choice: the expected answer and
+ * BWT_CHOICES - 1 wrong ones, picked by a letter. The wrong options are
+ * the answers the mistakes of bwt_feedback.h lead to for the question
+ * (one's instead of two's complement, a logical instead of an arithmetic
+ * shift, the low half of the width only, another operator...), each one
+ * or two bit operations on the operands. Candidates that would read the
+ * same as the answer or as an option already taken are skipped, and
+ * one-bit slips of the answer fill in when a question has too few
+ * mistakes, so there are always BWT_CHOICES different options. The
+ * options are then shuffled with a four-element Fisher-Yates on one
+ * random word: constant time and no allocation per question.
+ *
+ * Options keep their mistake, so a wrong pick gets the same hint as the
+ * same answer typed in.
+ */
+
+#ifndef BWT_CHOICE_H
+#define BWT_CHOICE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bwt_question.h"
+
+#define BWT_CHOICES 4
+
+struct bwt_choice {
+    uint32_t bits;     // option as a bit pattern masked to width
+    bool is_signed;    // how a decimal option is read, differs for reading mistakes
+    uint8_t mistake;   // enum bwt_mistake leading to it, BWT_MISTAKE_NONE for the answer
+};
+
+struct bwt_choices {
+    struct bwt_choice option[BWT_CHOICES];
+    uint8_t correct;   // index of the expected answer
+};
+
+void bwt_choices_make(const struct bwt_question* q, uint32_t random, struct bwt_choices* c);
+int bwt_choices_render(const struct bwt_question* q, const struct bwt_choices* c, char* buf, size_t size);
+enum bwt_verdict bwt_choices_grade(const struct bwt_choices* c, const char* input, uint8_t* picked);
+
+#endif // BWT_CHOICE_H
@@ -0,0 +1,233 @@
+/*
+ * bwt_coro.c - Stackful coroutines for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ */
+
+#define _DEFAULT_SOURCE  // MAP_ANONYMOUS, MAP_STACK, mincore
+
+#include "bwt_coro.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#ifdef __SANITIZE_ADDRESS__
+#include <sanitizer/asan_interface.h>
+#include <sanitizer/common_interface_defs.h>
+#define START_SWITCH(save, bottom, size) __sanitizer_start_switch_fiber(save, bottom, size)
+#define FINISH_SWITCH(save, bottom, size) __sanitizer_finish_switch_fiber(save, bottom, size)
+#define UNPOISON(addr, size) ASAN_UNPOISON_MEMORY_REGION(addr, size)
+#else
+#define START_SWITCH(save, bottom, size) ((void)(save), (void)(bottom), (void)(size))
+#define FINISH_SWITCH(save, bottom, size) ((void)(save), (void)(bottom), (void)(size))
+#define UNPOISON(addr, size) ((void)(addr), (void)(size))
+#endif
+
+#ifdef BWT_CORO_X86
+
+/*
+ * Push the callee-saved registers, store the stack pointer in *save, load
+ * the one at `load` and pop the registers saved there. The MXCSR and x87
+ * control words are callee-saved too, but nothing here changes them.
+ */
+void bwt_coro_switch(void** save, void* load);
+__asm__(
+    ".text\n"
+    ".p2align 4\n"
+    ".globl bwt_coro_switch\n"
+    ".hidden bwt_coro_switch\n"
+    ".type bwt_coro_switch, @function\n"
+    "bwt_coro_switch:\n"
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    movq %rsp, (%rdi)\n"
+    "    movq %rsi, %rsp\n"
+    "    popq %r15\n"
+    "    popq %r14\n"
+    "    popq %r13\n"
+    "    popq %r12\n"
+    "    popq %rbx\n"
+    "    popq %rbp\n"
+    "    ret\n"
+    ".size bwt_coro_switch, .-bwt_coro_switch\n");
+
+#define SWITCH_IN(co) bwt_coro_switch(&(co)->caller_sp, (co)->sp)
+#define SWITCH_OUT(co) bwt_coro_switch(&(co)->sp, (co)->caller_sp)
+
+#else
+
+#define SWITCH_IN(co) swapcontext(&(co)->caller, &(co)->context)
+#define SWITCH_OUT(co) swapcontext(&(co)->context, &(co)->caller)
+
+#endif // BWT_CORO_X86
+
+// The coroutine running on this thread, NULL outside any
+static _Thread_local struct bwt_coro* current;
+
+static size_t page_size(void) {
+    static size_t size;
+    if (size == 0) {
+        long n = sysconf(_SC_PAGESIZE);
+        size = n > 0 ? (size_t)n : 4096;
+    }
+    return size;
+}
+
+/**
+ * First function on a coroutine's stack: run it, then switch back for good
+ */
+static void coro_main(void) {
+    struct bwt_coro* co = current;
+
+    FINISH_SWITCH(NULL, &co->caller_bottom, &co->caller_size);
+    co->fn(co->arg);
+    co->done = true;
+    // A NULL save lets AddressSanitizer drop this stack's state
+    START_SWITCH(NULL, co->caller_bottom, co->caller_size);
+    SWITCH_OUT(co);
+    __builtin_unreachable();
+}
+
+/**
+ * Point a new coroutine at coro_main on its stack
+ */
+static int prepare(struct bwt_coro* co, char* stack, size_t size) {
+#ifdef BWT_CORO_X86
+    // coro_main's (never used) return address, the switch's return into
+    // it, then six zeroed registers; rsp ends up as after a call
+    void** top = (void**)(stack + size);
+    top[-1] = NULL;
+    top[-2] = (void*)(uintptr_t)coro_main;
+    for (int i = 3; i <= 8; i++) {
+        top[-i] = NULL;
+    }
+    co->sp = &top[-8];
+    return 0;
+#else
+    if (getcontext(&co->context) < 0) {
+        return -1;
+    }
+    co->context.uc_stack.ss_sp = stack;
+    co->context.uc_stack.ss_size = size;
+    co->context.uc_link = NULL;
+    makecontext(&co->context, coro_main, 0);
+    return 0;
+#endif
+}
+
+/**
+ * Set up a coroutine that will run fn(arg) when first resumed
+ *
+ * @param co The coroutine
+ * @param stack_size Bytes of stack, rounded up to whole pages; 0 for BWT_CORO_STACK
+ * @param fn Its function; the coroutine is done when it returns
+ * @param arg Argument of fn
+ * @return 0 on success, -1 with errno set if the stack could not be mapped
+ */
+int bwt_coro_init(struct bwt_coro* co, size_t stack_size, void (*fn)(void* arg), void* arg) {
+    size_t page = page_size();
+
+    memset(co, 0, sizeof(*co));
+    stack_size = ((stack_size > 0 ? stack_size : BWT_CORO_STACK) + page - 1) / page * page;
+    co->map_size = stack_size + page;
+    co->map = mmap(NULL, co->map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE
+                   | MAP_STACK, -1, 0);
+    if (co->map == MAP_FAILED) {
+        co->map = NULL;
+        return -1;
+    }
+    if (mprotect(co->map, page, PROT_NONE) < 0 || prepare(co, co->map + page, stack_size) < 0) {
+        bwt_coro_free(co);
+        return -1;
+    }
+    co->fn = fn;
+    co->arg = arg;
+    return 0;
+}
+
+/**
+ * Run a coroutine until it yields or returns
+ *
+ * @param co The coroutine, not done and not running
+ * @return true if it yielded, false if it is done
+ */
+bool bwt_coro_resume(struct bwt_coro* co) {
+    void* fake_stack = NULL;
+
+    co->resumer = current;
+    current = co;
+    START_SWITCH(&fake_stack, co->map + page_size(), co->map_size - page_size());
+    SWITCH_IN(co);
+    FINISH_SWITCH(fake_stack, NULL, NULL);
+    current = co->resumer;
+    return !co->done;
+}
+
+/**
+ * Give the CPU back to whoever resumed the running coroutine
+ *
+ * Returns when the coroutine is resumed again. Must be called from inside
+ * a coroutine.
+ */
+void bwt_coro_yield(void) {
+    struct bwt_coro* co = current;
+
+    START_SWITCH(&co->fake_stack, co->caller_bottom, co->caller_size);
+    SWITCH_OUT(co);
+    FINISH_SWITCH(co->fake_stack, &co->caller_bottom, &co->caller_size);
+}
+
+/**
+ * The coroutine running on this thread
+ *
+ * @return The coroutine, or NULL when called from outside any
+ */
+struct bwt_coro* bwt_coro_current(void) {
+    return current;
+}
+
+/**
+ * Bytes of a coroutine's stack that are backed by memory: the pages its
+ * deepest call so far has touched
+ */
+size_t bwt_coro_stack_resident(const struct bwt_coro* co) {
+    size_t page = page_size();
+    size_t pages = co->map_size / page - 1;
+    unsigned char resident[256];
+    size_t total = 0;
+
+    for (size_t i = 0; i < pages; i += sizeof(resident)) {
+        size_t n = pages - i < sizeof(resident) ? pages - i : sizeof(resident);
+        if (mincore(co->map + page * (i + 1), n * page, resident) < 0) {
+            return 0;
+        }
+        for (size_t j = 0; j < n; j++) {
+            total += (resident[j] & 1) * page;
+        }
+    }
+    return total;
+}
+
+/**
+ * Unmap a coroutine's stack
+ *
+ * A coroutine that is not done still has the frames of its function on
+ * the stack; whatever they own is not released.
+ */
+void bwt_coro_free(struct bwt_coro* co) {
+    if (co->map != NULL) {
+        // Frames left on the stack leave their redzones poisoned, and the
+        // next stack may be mapped at the same address
+        UNPOISON(co->map + page_size(), co->map_size - page_size());
+        munmap(co->map, co->map_size);
+        co->map = NULL;
+    }
+}
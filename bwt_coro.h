@@ -0,0 +1,73 @@
+/*
+ * bwt_coro.h - Stackful coroutines for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * A coroutine runs a function on its own stack and can give the CPU back
+ * from anywhere in it, however deep, with bwt_coro_yield(); the next
+ * bwt_coro_resume() carries on where it stopped. This lets code written
+ * for blocking stdio, like the menu quizzes, wait for input without
+ * blocking the thread: the input function yields instead, and one thread
+ * interleaves thousands of learners (see bwt_mux.h).
+ *
+ * On x86-64 a switch saves the callee-saved registers on the stack being
+ * left and swaps stack pointers, a dozen instructions and no system call;
+ * elsewhere, or with -DBWT_CORO_UCONTEXT, it is a ucontext swapcontext.
+ * Stacks are mmap'd with no backing until touched and a PROT_NONE guard
+ * page below them, so a coroutine reserves BWT_CORO_STACK of address
+ * space but only costs the pages its deepest call reached, and
+ * overflowing the stack faults instead of writing over the next one.
+ * Under AddressSanitizer every switch is announced with the fiber-switch
+ * hooks, so stack checks follow the coroutine.
+ *
+ * Coroutines are not shared between threads: a coroutine is resumed by
+ * the thread that created it, and may itself resume others.
+ */
+
+#ifndef BWT_CORO_H
+#define BWT_CORO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(BWT_CORO_UCONTEXT)
+#define BWT_CORO_X86 1
+#else
+#include <ucontext.h>
+#endif
+
+// Stack reserved per coroutine; instrumented frames are several times larger
+#ifdef __SANITIZE_ADDRESS__
+#define BWT_CORO_STACK (256 * 1024)
+#else
+#define BWT_CORO_STACK (64 * 1024)
+#endif
+
+struct bwt_coro {
+#ifdef BWT_CORO_X86
+    void* sp;                   // the coroutine's stack, while it is suspended
+    void* caller_sp;            // the resumer's, while it runs
+#else
+    ucontext_t context;
+    ucontext_t caller;
+#endif
+    void (*fn)(void* arg);
+    void* arg;
+    char* map;                  // guard page, then the stack
+    size_t map_size;
+    bool done;                  // fn has returned
+    struct bwt_coro* resumer;   // the coroutine running before, if any
+    void* fake_stack;           // AddressSanitizer state of the suspended side
+    const void* caller_bottom;  // the resumer's stack, for switching back
+    size_t caller_size;
+};
+
+int bwt_coro_init(struct bwt_coro* co, size_t stack_size, void (*fn)(void* arg), void* arg);
+bool bwt_coro_resume(struct bwt_coro* co);
+void bwt_coro_yield(void);
+struct bwt_coro* bwt_coro_current(void);
+size_t bwt_coro_stack_resident(const struct bwt_coro* co);
+void bwt_coro_free(struct bwt_coro* co);
+
+#endif // BWT_CORO_H
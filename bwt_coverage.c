@@ -0,0 +1,262 @@
+/*
+ * bwt_coverage.c - Operand coverage tracking for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ */
+
+#include "bwt_coverage.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Scramble 64 bits (the splitmix64 finalizer)
+ */
+static uint64_t mix64(uint64_t x) {
+    x = (x ^ (x >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    x = (x ^ (x >> 27)) * UINT64_C(0x94d049bb133111eb);
+    return x ^ (x >> 31);
+}
+
+/**
+ * Hash a wide question: the low bits pick the filter word, the top 24 bits
+ * the four bits set in it
+ */
+static uint64_t filter_hash(uint8_t topic, uint8_t width, bool is_signed, uint32_t a, uint32_t b) {
+    return mix64(((uint64_t)a << 32 | b) ^ mix64((uint64_t)is_signed << 16 | (uint64_t)topic << 8 | width));
+}
+
+/**
+ * Find the bit that records an 8-bit question in the exact sets
+ *
+ * @param bit Set to the bit within the returned word
+ * @return The word, or NULL if the topic's set is not allocated (or the
+ *         topic is unknown)
+ */
+static uint64_t* exact_word(const struct bwt_coverage* c, uint8_t topic, bool is_signed,
+                            uint32_t a, uint32_t b, uint64_t* bit) {
+    const uint64_t* set;
+    uint32_t key;
+
+    switch (topic) {
+        case BWT_TOPIC_AND:
+        case BWT_TOPIC_OR:
+        case BWT_TOPIC_XOR:
+            set = c->pairs8[topic - BWT_TOPIC_AND][is_signed];
+            key = a << 8 | b;
+            break;
+        case BWT_TOPIC_SHL:
+        case BWT_TOPIC_SHR:
+            set = c->shifts8[topic - BWT_TOPIC_SHL][is_signed];
+            key = a << 3 | (b & 7);
+            break;
+        default:
+            if (topic >= BWT_TOPIC_COUNT) {
+                return NULL;
+            }
+            set = c->values8[topic][is_signed];
+            key = a;
+    }
+    if (set == NULL) {
+        return NULL;
+    }
+    *bit = UINT64_C(1) << (key & 63);
+    return (uint64_t*)&set[key >> 6];
+}
+
+static uint64_t filter_bits(uint64_t h) {
+    return UINT64_C(1) << (h >> 40 & 63) | UINT64_C(1) << (h >> 46 & 63)
+           | UINT64_C(1) << (h >> 52 & 63) | UINT64_C(1) << (h >> 58);
+}
+
+/**
+ * Set up empty coverage for a learner
+ *
+ * @param c Coverage to initialize
+ * @param filter_kb Size of the filter for wider questions in KiB, rounded
+ *                  down to a power of two; 0 tracks 8-bit questions only
+ * @return 0 on success, -1 if the filter could not be allocated
+ */
+int bwt_coverage_init(struct bwt_coverage* c, uint32_t filter_kb) {
+    memset(c, 0, sizeof(*c));
+    if (filter_kb == 0) {
+        return 0;
+    }
+    if (filter_kb > BWT_COVERAGE_MAX_KB) {
+        filter_kb = BWT_COVERAGE_MAX_KB;
+    }
+    uint32_t words = 128;  // 1 KiB
+    while (words * 2 <= filter_kb * 128) {
+        words *= 2;
+    }
+    c->filter = calloc(words, sizeof(uint64_t));
+    if (c->filter == NULL) {
+        return -1;
+    }
+    c->filter_mask = words - 1;
+    c->filter_capacity = words * 64 / BWT_COVERAGE_BITS_PER_KEY;
+    return 0;
+}
+
+/**
+ * Release the pair sets and the filter of a learner's coverage
+ */
+void bwt_coverage_free(struct bwt_coverage* c) {
+    for (int t = 0; t < 3; t++) {
+        for (int s = 0; s < 2; s++) {
+            free(c->pairs8[t][s]);
+            c->pairs8[t][s] = NULL;
+        }
+    }
+    free(c->filter);
+    c->filter = NULL;
+}
+
+/**
+ * Check whether a question was asked before
+ *
+ * @param c Coverage of the learner
+ * @param topic Topic of the question (enum bwt_topic)
+ * @param width Width in bits
+ * @param is_signed Whether the operands are signed
+ * @param a First operand as a bit pattern masked to width
+ * @param b Second operand or shift amount, 0 if none
+ * @return true if asked before; for wider questions, possibly a false positive
+ */
+bool bwt_coverage_seen(const struct bwt_coverage* c, uint8_t topic, uint8_t width, bool is_signed,
+                       uint32_t a, uint32_t b) {
+    if (width == 8) {
+        uint64_t bit;
+        const uint64_t* word = exact_word(c, topic, is_signed, a, b, &bit);
+        return word != NULL && (*word & bit) != 0;
+    }
+    if (c->filter == NULL) {
+        return false;
+    }
+    uint64_t h = filter_hash(topic, width, is_signed, a, b);
+    uint64_t bits = filter_bits(h);
+    return (c->filter[h & c->filter_mask] & bits) == bits;
+}
+
+/**
+ * Record a question as asked
+ *
+ * A pair topic's 8-bit set is allocated here the first time; without
+ * memory for it, its questions are not remembered.
+ *
+ * @return true if it had not been asked before, as for bwt_coverage_seen
+ */
+bool bwt_coverage_add(struct bwt_coverage* c, uint8_t topic, uint8_t width, bool is_signed,
+                      uint32_t a, uint32_t b) {
+    if (width == 8) {
+        if (topic <= BWT_TOPIC_XOR && c->pairs8[topic - BWT_TOPIC_AND][is_signed] == NULL) {
+            c->pairs8[topic - BWT_TOPIC_AND][is_signed] = calloc(BWT_COVERAGE_PAIRS8 / 64, sizeof(uint64_t));
+        }
+        uint64_t bit;
+        uint64_t* word = exact_word(c, topic, is_signed, a, b, &bit);
+        if (word == NULL) {
+            return true;
+        }
+        bool added = (*word & bit) == 0;
+        *word |= bit;
+        return added;
+    }
+    if (c->filter == NULL) {
+        return true;
+    }
+    uint64_t h = filter_hash(topic, width, is_signed, a, b);
+    uint64_t bits = filter_bits(h);
+    uint64_t* word = &c->filter[h & c->filter_mask];
+    if ((*word & bits) == bits) {
+        return false;
+    }
+    // Start over rather than let the false positive rate climb
+    if (c->filter_count >= c->filter_capacity) {
+        memset(c->filter, 0, ((size_t)c->filter_mask + 1) * sizeof(uint64_t));
+        c->filter_count = 0;
+    }
+    *word |= bits;
+    c->filter_count++;
+    return true;
+}
+
+/**
+ * Draw an operand from a quiz's distribution, steering toward categories
+ * the learner has not seen yet
+ *
+ * @param c Coverage of the learner
+ * @param quiz Quiz whose distribution to draw from (enum bwt_dist_quiz)
+ * @param width Width in bits
+ * @return Bit pattern masked to width
+ */
+uint32_t bwt_coverage_operand(struct bwt_coverage* c, uint8_t quiz, uint8_t width) {
+    const struct bwt_dist* d = &bwt_dist_active()->operands[quiz];
+    uint8_t* covered = &c->classes[quiz][bwt_width_index(width)];
+    uint8_t cls = bwt_dist_sample(d);
+    uint32_t uncovered_weight = 0;
+
+    _Static_assert(BWT_OPERAND_CLASS_COUNT <= 8, "covered categories must fit in a byte");
+    for (uint8_t i = 0; i < d->n; i++) {
+        uncovered_weight += (*covered >> i & 1) == 0 ? d->weight[i] : 0;
+    }
+    if (uncovered_weight == 0) {
+        *covered = 0;  // every category came up, start a new round
+    } else if ((*covered >> cls & 1) != 0 && (bwt_rand32() & 1) != 0) {
+        uint32_t r = bwt_rand32() % uncovered_weight;
+        for (cls = 0; cls < d->n; cls++) {
+            uint32_t w = (*covered >> cls & 1) == 0 ? d->weight[cls] : 0;
+            if (r < w) {
+                break;
+            }
+            r -= w;
+        }
+    }
+    *covered |= (uint8_t)(1u << cls);
+    return bwt_operand_from_class(cls, width);
+}
+
+/**
+ * Draw operands for a quiz that were not asked before, if that takes fewer
+ * than BWT_COVERAGE_TRIES draws, and record them as asked
+ *
+ * @param c Coverage of the learner
+ * @param quiz Quiz whose distribution to draw from (enum bwt_dist_quiz)
+ * @param topic Topic the operands are recorded under (enum bwt_topic)
+ * @param width Width in bits
+ * @param is_signed Whether the quiz reads the operands as signed
+ * @param a Set to the first operand
+ * @param b Set to the second operand, or NULL for quizzes with one operand
+ */
+void bwt_coverage_pair(struct bwt_coverage* c, uint8_t quiz, uint8_t topic, uint8_t width, bool is_signed,
+                       uint32_t* a, uint32_t* b) {
+    uint32_t second = 0;
+    for (int tries = 1; ; tries++) {
+        *a = bwt_coverage_operand(c, quiz, width);
+        if (b != NULL) {
+            second = bwt_coverage_operand(c, quiz, width);
+        }
+        if (tries == BWT_COVERAGE_TRIES || !bwt_coverage_seen(c, topic, width, is_signed, *a, second)) {
+            break;
+        }
+    }
+    if (b != NULL) {
+        *b = second;
+    }
+    bwt_coverage_add(c, topic, width, is_signed, *a, second);
+}
+
+/**
+ * Generate a question, as bwt_question_generate, that was not asked before
+ * if that takes fewer than BWT_COVERAGE_TRIES draws, and record it as asked
+ */
+void bwt_coverage_generate(struct bwt_coverage* c, struct bwt_question* q, uint8_t topic,
+                           uint8_t width, bool is_signed, uint8_t pattern) {
+    for (int tries = 1; ; tries++) {
+        bwt_question_generate(q, topic, width, is_signed, pattern);
+        if (tries == BWT_COVERAGE_TRIES || !bwt_coverage_seen(c, q->topic, q->width, q->is_signed, q->a, q->b)) {
+            break;
+        }
+    }
+    bwt_coverage_add(c, q->topic, q->width, q->is_signed, q->a, q->b);
+}
@@ -0,0 +1,72 @@
+/*
+ * bwt_coverage.h - Operand coverage tracking for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * Remembers which questions a learner has already been asked, so the same
+ * operands do not come up twice. 8-bit questions are few enough to keep
+ * exactly, in a bit set for each topic and signedness: 65,536 bits for the
+ * (a, b) pairs of AND, OR and XOR, allocated when the topic is first asked,
+ * 2,048 for an operand and a shift amount, and 256 for one operand (NOT and
+ * the conversions). Wider questions go into a blocked Bloom filter keyed by
+ * topic, signedness, width and operands, where each key sets 4 bits of a
+ * single 64-bit word, so a lookup
+ * is one hash and one load. The filter has a fixed size set by
+ * `coverage.filter_kb` in the settings file; once it holds a key per 10 bits
+ * it is cleared, which keeps false positives to a few percent and lets old
+ * questions come back after a long while.
+ *
+ * Operands drawn from the weighted distributions also steer toward operand
+ * categories (zero, all ones, MSB set...) the learner has not seen yet: when
+ * the drawn category was already covered, half of the time an uncovered one
+ * is drawn instead, by weight. Once every category with a weight has come up
+ * the round starts over.
+ *
+ * Lookups are O(1), and a repeat is only rejected BWT_COVERAGE_TRIES - 1
+ * times before it is asked anyway, so generating a question stays bounded
+ * once a small space (such as 8-bit small values) is used up.
+ */
+
+#ifndef BWT_COVERAGE_H
+#define BWT_COVERAGE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bwt_dist.h"
+#include "bwt_question.h"
+
+#define BWT_COVERAGE_PAIRS8 65536     // every (a, b) pair of 8-bit operands
+#define BWT_COVERAGE_SHIFTS8 2048     // every 8-bit operand with a shift amount below 8
+#define BWT_COVERAGE_VALUES8 256      // every 8-bit operand
+#define BWT_COVERAGE_TRIES 8          // draws before a repeat is accepted
+#define BWT_COVERAGE_BITS_PER_KEY 10  // filter is cleared beyond this load
+#define BWT_COVERAGE_DEFAULT_KB 4
+#define BWT_COVERAGE_MAX_KB 1024
+
+// 8-bit sets are indexed by topic (AND, OR and XOR; SHL and SHR) and is_signed
+struct bwt_coverage {
+    uint64_t* pairs8[3][2];     // bit a << 8 | b, NULL until the topic is asked
+    uint64_t shifts8[2][2][BWT_COVERAGE_SHIFTS8 / 64];  // bit a << 3 | amount
+    uint64_t values8[BWT_TOPIC_COUNT][2][BWT_COVERAGE_VALUES8 / 64];  // bit a
+    uint64_t* filter;           // wider questions, NULL if the filter is off
+    uint32_t filter_mask;       // filter words - 1, a power of two minus one
+    uint32_t filter_count;      // keys added since the filter was cleared
+    uint32_t filter_capacity;   // keys it takes before it is cleared
+    uint8_t classes[BWT_DIST_QUIZ_COUNT][BWT_WIDTH_COUNT];  // covered operand categories
+};
+
+int bwt_coverage_init(struct bwt_coverage* c, uint32_t filter_kb);
+void bwt_coverage_free(struct bwt_coverage* c);
+bool bwt_coverage_seen(const struct bwt_coverage* c, uint8_t topic, uint8_t width, bool is_signed,
+                       uint32_t a, uint32_t b);
+bool bwt_coverage_add(struct bwt_coverage* c, uint8_t topic, uint8_t width, bool is_signed,
+                      uint32_t a, uint32_t b);
+uint32_t bwt_coverage_operand(struct bwt_coverage* c, uint8_t quiz, uint8_t width);
+void bwt_coverage_pair(struct bwt_coverage* c, uint8_t quiz, uint8_t topic, uint8_t width, bool is_signed,
+                       uint32_t* a, uint32_t* b);
+void bwt_coverage_generate(struct bwt_coverage* c, struct bwt_question* q, uint8_t topic,
+                           uint8_t width, bool is_signed, uint8_t pattern);
+
+#endif // BWT_COVERAGE_H
@@ -0,0 +1,398 @@
+/*
+ * bwt_dist.c - Weighted operand and width distributions for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * Alias tables are built with Vose's variant of Walker's method using
+ * integer arithmetic only, so a table built from the same weights is
+ * identical on every machine and sampling is two compares and a lookup.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <ctype.h>
+
+#include "bwt_dist.h"
+#include "bwt_coverage.h"
+
+#define MAX_WEIGHT 1000000u  // keeps the sum of weights well below 2^28
+#define GOLDEN_GAMMA UINT64_C(0x9E3779B97F4A7C15)
+
+_Thread_local struct bwt_rng* bwt_rng_local = NULL;
+static _Thread_local struct bwt_rng thread_rng;  // used while no generator is current
+
+const char* const bwt_operand_class_names[BWT_OPERAND_CLASS_COUNT] = {
+    "zero", "all_ones", "min", "max", "pow2", "msb_set", "small", "uniform"
+};
+
+const char* const bwt_dist_quiz_names[BWT_DIST_QUIZ_COUNT] = {
+    "and", "or", "xor", "shift", "convert", "adaptive"
+};
+
+const char* const bwt_width_names[BWT_WIDTH_COUNT] = { "8", "16", "32" };
+
+const char* const bwt_answer_format_names[BWT_ANSWER_FORMATS] = { "binary", "hex", "octal" };
+
+/**
+ * Seed the current random number generator
+ *
+ * @param seed Seed, e.g. of a session that is to be replayed
+ */
+void bwt_srand(uint64_t seed) {
+    (bwt_rng_local != NULL ? bwt_rng_local : &thread_rng)->state = seed;
+}
+
+/**
+ * 64 random bits from the current generator (SplitMix64), one step of it
+ *
+ * @return Random 64-bit value
+ */
+uint64_t bwt_rand64(void) {
+    struct bwt_rng* rng = bwt_rng_local != NULL ? bwt_rng_local : &thread_rng;
+    uint64_t z = rng->state += GOLDEN_GAMMA;
+    z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+    return z ^ (z >> 31);
+}
+
+/**
+ * 32 random bits from the current generator, the high half of a step
+ *
+ * @return Random 32-bit value
+ */
+uint32_t bwt_rand32(void) {
+    return (uint32_t)(bwt_rand64() >> 32);
+}
+
+/**
+ * Build an alias table from integer weights
+ *
+ * @param d Distribution to build
+ * @param weights Weight of each category, zero to never pick it
+ * @param n Number of categories, at most BWT_DIST_MAX
+ * @return true on success, false if all weights are zero or one is too large
+ */
+bool bwt_dist_build(struct bwt_dist* d, const uint32_t* weights, uint8_t n) {
+    uint64_t total = 0;
+    uint64_t scaled[BWT_DIST_MAX];
+    uint8_t small[BWT_DIST_MAX], large[BWT_DIST_MAX];
+    int n_small = 0, n_large = 0;
+
+    if (n == 0 || n > BWT_DIST_MAX) {
+        return false;
+    }
+    for (uint8_t i = 0; i < n; i++) {
+        if (weights[i] > MAX_WEIGHT) {
+            return false;
+        }
+        total += weights[i];
+    }
+    if (total == 0) {
+        return false;
+    }
+
+    // Each column holds `total` units; a category owns weight * n of them
+    for (uint8_t i = 0; i < n; i++) {
+        d->weight[i] = weights[i];
+        d->alias[i] = i;
+        scaled[i] = (uint64_t)weights[i] * n;
+        if (scaled[i] < total) {
+            small[n_small++] = i;
+        } else {
+            large[n_large++] = i;
+        }
+    }
+
+    // Fill each under-full column with units from an over-full one
+    while (n_small > 0 && n_large > 0) {
+        uint8_t s = small[--n_small];
+        uint8_t l = large[n_large - 1];
+        d->prob[s] = (scaled[s] << 32) / total;
+        d->alias[s] = l;
+        scaled[l] -= total - scaled[s];
+        if (scaled[l] < total) {
+            n_large--;
+            small[n_small++] = l;
+        }
+    }
+    // Whatever is left is exactly full
+    while (n_large > 0) {
+        d->prob[large[--n_large]] = UINT64_C(1) << 32;
+    }
+    while (n_small > 0) {
+        d->prob[small[--n_small]] = UINT64_C(1) << 32;
+    }
+    d->n = n;
+    return true;
+}
+
+/**
+ * Draw a category from a distribution in constant time
+ *
+ * One generator step is split in two: the high 32 bits pick the column and
+ * the low 32 bits are the coin, compared with the column's probability at
+ * its full 2^32 scale, so the draw is as exact as with two numbers.
+ *
+ * @param d Distribution built with bwt_dist_build
+ * @return Category index in the range [0, d->n)
+ */
+uint8_t bwt_dist_sample(const struct bwt_dist* d) {
+    uint64_t r = bwt_rand64();
+    uint8_t column = (uint8_t)(((r >> 32) * d->n) >> 32);
+    uint32_t coin = (uint32_t)r;
+    return coin < d->prob[column] ? column : d->alias[column];
+}
+
+/**
+ * Parse a distribution such as "zero:1, pow2:2, uniform:6"
+ *
+ * Labels that are not mentioned get weight zero.
+ *
+ * @param d Distribution to build
+ * @param spec Comma separated label:weight pairs
+ * @param labels Names of the categories
+ * @param nlabels Number of categories
+ * @return true on success, false on a syntax error or unknown label
+ */
+bool bwt_dist_parse(struct bwt_dist* d, const char* spec, const char* const* labels, uint8_t nlabels) {
+    uint32_t weights[BWT_DIST_MAX] = { 0 };
+    const char* p = spec;
+
+    while (*p != '\0') {
+        while (isspace((unsigned char)*p) || *p == ',') {
+            p++;
+        }
+        if (*p == '\0') {
+            break;
+        }
+
+        size_t len = strcspn(p, ": \t");
+        uint8_t label = nlabels;
+        for (uint8_t i = 0; i < nlabels; i++) {
+            if (strlen(labels[i]) == len && strncmp(p, labels[i], len) == 0) {
+                label = i;
+                break;
+            }
+        }
+        p += len;
+        while (isspace((unsigned char)*p)) {
+            p++;
+        }
+        if (label == nlabels || *p != ':') {
+            return false;
+        }
+
+        char* end = NULL;
+        unsigned long weight = strtoul(p + 1, &end, 10);
+        if (end == p + 1 || weight > MAX_WEIGHT) {
+            return false;
+        }
+        weights[label] = (uint32_t)weight;
+        p = end;
+    }
+    return bwt_dist_build(d, weights, nlabels);
+}
+
+/**
+ * Fill in the built-in distributions
+ *
+ * Mostly 8-bit, occasionally 16-bit and rarely 32-bit values, with extra
+ * weight on the values students get wrong most often. Answers are mostly
+ * binary, often hex and sometimes octal.
+ *
+ * @param config Distributions to initialise
+ */
+void bwt_dist_defaults(struct bwt_dist_config* config) {
+    // zero, all_ones, min, max, pow2, msb_set, small, uniform
+    static const uint32_t bitwise[BWT_OPERAND_CLASS_COUNT] = { 1, 1, 1, 1, 2, 3, 3, 8 };
+    static const uint32_t shift[BWT_OPERAND_CLASS_COUNT] = { 0, 0, 0, 1, 2, 0, 3, 4 };
+    static const uint32_t convert[BWT_OPERAND_CLASS_COUNT] = { 1, 2, 2, 1, 2, 4, 4, 4 };
+    static const uint32_t widths[BWT_WIDTH_COUNT] = { 80, 15, 5 };
+    static const uint32_t formats[BWT_ANSWER_FORMATS] = { 6, 3, 1 };
+
+    for (int quiz = 0; quiz < BWT_DIST_QUIZ_COUNT; quiz++) {
+        const uint32_t* w = quiz == BWT_DIST_SHIFT ? shift
+                            : (quiz == BWT_DIST_CONVERT ? convert : bitwise);
+        bwt_dist_build(&config->operands[quiz], w, BWT_OPERAND_CLASS_COUNT);
+    }
+    bwt_dist_build(&config->widths, widths, BWT_WIDTH_COUNT);
+    bwt_dist_build(&config->formats, formats, BWT_ANSWER_FORMATS);
+    config->coverage_kb = BWT_COVERAGE_DEFAULT_KB;
+}
+
+/**
+ * Remove leading and trailing whitespace in place
+ */
+static char* trim(char* s) {
+    while (isspace((unsigned char)*s)) {
+        s++;
+    }
+    size_t len = strlen(s);
+    while (len > 0 && isspace((unsigned char)s[len - 1])) {
+        s[--len] = '\0';
+    }
+    return s;
+}
+
+/**
+ * Load distributions from a settings file
+ *
+ * Lines are `key = value`, `#` starts a comment and keys other than
+ * `operands`, `operands.<quiz>`, `widths` and `formats` are left to other
+ * settings.
+ * A bad line is reported on stderr and leaves that distribution unchanged.
+ *
+ * @param config Distributions to update
+ * @param path Path of the settings file
+ * @return Number of bad lines, or -1 if the file could not be opened
+ */
+int bwt_dist_load(struct bwt_dist_config* config, const char* path) {
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL) {
+        return -1;
+    }
+    int errors = bwt_dist_load_stream(config, fp, path);
+    fclose(fp);
+    return errors;
+}
+
+/**
+ * Load distributions from settings read from a stream, such as the
+ * settings saved in a session recording
+ *
+ * @param config Distributions to update
+ * @param fp Stream of settings lines
+ * @param path Name of the settings shown in error messages
+ * @return Number of bad lines
+ */
+int bwt_dist_load_stream(struct bwt_dist_config* config, FILE* fp, const char* path) {
+    char line[512];
+    int lineno = 0;
+    int errors = 0;
+
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        lineno++;
+        line[strcspn(line, "#\r\n")] = '\0';
+        char* eq = strchr(line, '=');
+        if (eq == NULL) {
+            continue;
+        }
+        *eq = '\0';
+        char* key = trim(line);
+        char* value = trim(eq + 1);
+        bool ok = true;
+
+        if (strcmp(key, "widths") == 0) {
+            ok = bwt_dist_parse(&config->widths, value, bwt_width_names, BWT_WIDTH_COUNT);
+        } else if (strcmp(key, "formats") == 0) {
+            ok = bwt_dist_parse(&config->formats, value, bwt_answer_format_names, BWT_ANSWER_FORMATS);
+        } else if (strcmp(key, "operands") == 0) {
+            struct bwt_dist d;
+            ok = bwt_dist_parse(&d, value, bwt_operand_class_names, BWT_OPERAND_CLASS_COUNT);
+            for (int quiz = 0; ok && quiz < BWT_DIST_QUIZ_COUNT; quiz++) {
+                config->operands[quiz] = d;
+            }
+        } else if (strncmp(key, "operands.", 9) == 0) {
+            ok = false;
+            for (int quiz = 0; quiz < BWT_DIST_QUIZ_COUNT; quiz++) {
+                if (strcmp(key + 9, bwt_dist_quiz_names[quiz]) == 0) {
+                    ok = bwt_dist_parse(&config->operands[quiz], value,
+                                        bwt_operand_class_names, BWT_OPERAND_CLASS_COUNT);
+                    break;
+                }
+            }
+        } else if (strcmp(key, "coverage.filter_kb") == 0) {
+            char* end;
+            unsigned long kb = strtoul(value, &end, 10);
+            if (*value == '\0' || *end != '\0' || kb > BWT_COVERAGE_MAX_KB) {
+                fprintf(stderr, "%s:%d: `%s` must be 0 to %d\n", path, lineno, key, BWT_COVERAGE_MAX_KB);
+                errors++;
+                continue;
+            }
+            config->coverage_kb = (uint32_t)kb;
+        }
+
+        if (!ok) {
+            fprintf(stderr, "%s:%d: invalid distribution for `%s`\n", path, lineno, key);
+            errors++;
+        }
+    }
+    return errors;
+}
+
+/**
+ * Make a value of a given width in an operand category from random bits
+ *
+ * @param cls Operand category (enum bwt_operand_class)
+ * @param width Width in bits
+ * @param r Random bits, unused by the categories of a single value
+ * @return Bit pattern masked to width
+ */
+uint32_t bwt_operand_from_bits(uint8_t cls, uint8_t width, uint32_t r) {
+    uint32_t mask = bwt_width_mask(width);
+    uint32_t msb = UINT32_C(1) << (width - 1);
+
+    switch (cls) {
+        case BWT_OPERAND_ZERO:
+            return 0;
+        case BWT_OPERAND_ALL_ONES:
+            return mask;
+        case BWT_OPERAND_MIN:
+            return msb;
+        case BWT_OPERAND_MAX:
+            return mask >> 1;
+        case BWT_OPERAND_POW2:
+            return UINT32_C(1) << (r % width);
+        case BWT_OPERAND_MSB_SET:
+            return (r | msb) & mask;
+        case BWT_OPERAND_SMALL:
+            return r % 16;
+        default:
+            return r & mask;
+    }
+}
+
+/**
+ * Draw a value of a given width from an operand category
+ *
+ * @param cls Operand category (enum bwt_operand_class)
+ * @param width Width in bits
+ * @return Bit pattern masked to width
+ */
+uint32_t bwt_operand_from_class(uint8_t cls, uint8_t width) {
+    // Categories of a single value draw nothing, as they always have
+    return bwt_operand_from_bits(cls, width, cls >= BWT_OPERAND_POW2 ? bwt_rand32() : 0);
+}
+
+/**
+ * Draw an operand for a quiz from its configured distribution
+ *
+ * @param quiz The quiz (enum bwt_dist_quiz)
+ * @param width Width in bits
+ * @return Bit pattern masked to width
+ */
+uint32_t bwt_sample_operand(uint8_t quiz, uint8_t width) {
+    return bwt_operand_from_class(bwt_dist_sample(&bwt_dist_active()->operands[quiz]), width);
+}
+
+/**
+ * Draw a width from the configured distribution
+ *
+ * @return 8, 16 or 32
+ */
+uint8_t bwt_sample_width(void) {
+    return bwt_width_from_index(bwt_dist_sample(&bwt_dist_active()->widths));
+}
+
+/**
+ * Draw an answer format from the configured distribution
+ *
+ * @return BWT_FORMAT_BINARY, BWT_FORMAT_HEX or BWT_FORMAT_OCTAL
+ */
+uint8_t bwt_sample_format(void) {
+    return bwt_dist_sample(&bwt_dist_active()->formats);
+}
@@ -0,0 +1,114 @@
+/*
+ * bwt_dist.h - Weighted operand and width distributions for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * Operands are drawn by first picking a category of interesting value
+ * (zero, all ones, the minimum, powers of two, values with the MSB set...)
+ * and then a value from that category. Categories are picked with Walker's
+ * alias method, so a draw costs one random number and one table lookup no
+ * matter how many categories there are.
+ *
+ * Weights are read from the settings file, one distribution per line:
+ *
+ *     # bwt.conf
+ *     operands = zero:1, all_ones:1, min:1, pow2:2, msb_set:3, uniform:6
+ *     operands.shift = small:3, pow2:2, uniform:2
+ *     widths = 8:80, 16:15, 32:5
+ *     formats = binary:6, hex:3, octal:1
+ *
+ * `operands` sets the default for every quiz, `operands.<quiz>` overrides it
+ * for one quiz (and, or, xor, shift, convert, adaptive). The same file sets
+ * `coverage.filter_kb`, the memory each learner's coverage filter takes
+ * (see bwt_coverage.h). The file is loaded into snapshots that can be
+ * swapped while sessions run (see bwt_settings.h); samplers read the
+ * snapshot bwt_dist_active() returns.
+ *
+ * Random numbers come from a small SplitMix64 generator rather than
+ * rand(), whose one generator every session in the process would share.
+ * Each learner has a generator of their own and makes it current with
+ * bwt_rng_local, so a session seeded the same way asks the same questions
+ * however many others run beside it.
+ */
+
+#ifndef BWT_DIST_H
+#define BWT_DIST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "bwt_question.h"
+
+#define BWT_DIST_MAX 16  // most categories a distribution can have
+#define BWT_ANSWER_FORMATS 3  // binary, hex and octal; decimal answers are never drawn
+
+enum bwt_operand_class {
+    BWT_OPERAND_ZERO,
+    BWT_OPERAND_ALL_ONES,  // -1 when signed
+    BWT_OPERAND_MIN,       // only the MSB set, e.g. INT8_MIN
+    BWT_OPERAND_MAX,       // all but the MSB set, e.g. INT8_MAX
+    BWT_OPERAND_POW2,
+    BWT_OPERAND_MSB_SET,   // random value with the MSB set
+    BWT_OPERAND_SMALL,     // 0..15
+    BWT_OPERAND_UNIFORM,   // any bit pattern of the width
+    BWT_OPERAND_CLASS_COUNT
+};
+
+enum bwt_dist_quiz {
+    BWT_DIST_AND,
+    BWT_DIST_OR,
+    BWT_DIST_XOR,
+    BWT_DIST_SHIFT,
+    BWT_DIST_CONVERT,
+    BWT_DIST_ADAPTIVE,
+    BWT_DIST_QUIZ_COUNT
+};
+
+// Alias table: column i is kept with probability prob[i] / 2^32,
+// otherwise its alias is returned
+struct bwt_dist {
+    uint8_t n;
+    uint8_t alias[BWT_DIST_MAX];
+    uint64_t prob[BWT_DIST_MAX];
+    uint32_t weight[BWT_DIST_MAX];  // weights as configured, for reporting
+};
+
+struct bwt_dist_config {
+    struct bwt_dist operands[BWT_DIST_QUIZ_COUNT];  // over enum bwt_operand_class
+    struct bwt_dist widths;                         // over 8, 16 and 32 bits
+    struct bwt_dist formats;                        // over binary, hex and octal answers
+    uint32_t coverage_kb;                           // coverage filter size per learner
+};
+
+// State of a random number generator, e.g. one per learner
+struct bwt_rng {
+    uint64_t state;
+};
+
+// The generator bwt_rand64 and bwt_rand32 draw from; NULL for the thread's own
+extern _Thread_local struct bwt_rng* bwt_rng_local;
+
+const struct bwt_dist_config* bwt_dist_active(void);  // in bwt_settings.c
+void bwt_srand(uint64_t seed);
+uint64_t bwt_rand64(void);
+uint32_t bwt_rand32(void);
+bool bwt_dist_build(struct bwt_dist* d, const uint32_t* weights, uint8_t n);
+uint8_t bwt_dist_sample(const struct bwt_dist* d);
+bool bwt_dist_parse(struct bwt_dist* d, const char* spec, const char* const* labels, uint8_t nlabels);
+void bwt_dist_defaults(struct bwt_dist_config* config);
+int bwt_dist_load(struct bwt_dist_config* config, const char* path);
+int bwt_dist_load_stream(struct bwt_dist_config* config, FILE* fp, const char* path);
+uint32_t bwt_operand_from_bits(uint8_t cls, uint8_t width, uint32_t r);
+uint32_t bwt_operand_from_class(uint8_t cls, uint8_t width);
+uint32_t bwt_sample_operand(uint8_t quiz, uint8_t width);
+uint8_t bwt_sample_width(void);
+uint8_t bwt_sample_format(void);
+
+extern const char* const bwt_operand_class_names[BWT_OPERAND_CLASS_COUNT];
+extern const char* const bwt_dist_quiz_names[BWT_DIST_QUIZ_COUNT];
+extern const char* const bwt_width_names[BWT_WIDTH_COUNT];
+extern const char* const bwt_answer_format_names[BWT_ANSWER_FORMATS];
+
+#endif // BWT_DIST_H
@@ -0,0 +1,589 @@
+/*
+ * bwt_exam.c - Reproducible per-student exams for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ */
+
+#define _POSIX_C_SOURCE 200809L  // open_memstream, clock_gettime
+
+#include "bwt_exam.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "bwt_dist.h"
+#include "bwt_sheet.h"
+
+#define GOLDEN_GAMMA UINT64_C(0x9E3779B97F4A7C15)
+#define TOPIC_COUNTER UINT64_MAX  // counter of a student's topic offset, past every question's block
+
+// Fixed exam tables, picked from with the low bits of a draw
+static const uint8_t exam_widths[4] = { 8, 8, 16, 32 };
+static const uint8_t exam_formats[4] = { BWT_FORMAT_BINARY, BWT_FORMAT_BINARY, BWT_FORMAT_HEX, BWT_FORMAT_OCTAL };
+static const uint8_t exam_edges[4] = { BWT_OPERAND_ZERO, BWT_OPERAND_ALL_ONES, BWT_OPERAND_MIN, BWT_OPERAND_MAX };
+// The default `operands` weights of bwt.conf, one entry per unit of weight
+static const uint8_t exam_classes[20] = {
+    BWT_OPERAND_ZERO, BWT_OPERAND_ALL_ONES, BWT_OPERAND_MIN, BWT_OPERAND_MAX,
+    BWT_OPERAND_POW2, BWT_OPERAND_POW2,
+    BWT_OPERAND_MSB_SET, BWT_OPERAND_MSB_SET, BWT_OPERAND_MSB_SET,
+    BWT_OPERAND_SMALL, BWT_OPERAND_SMALL, BWT_OPERAND_SMALL,
+    BWT_OPERAND_UNIFORM, BWT_OPERAND_UNIFORM, BWT_OPERAND_UNIFORM, BWT_OPERAND_UNIFORM,
+    BWT_OPERAND_UNIFORM, BWT_OPERAND_UNIFORM, BWT_OPERAND_UNIFORM, BWT_OPERAND_UNIFORM,
+};
+
+static const char* const verdict_names[3] = { "invalid", "wrong", "correct" };
+
+/**
+ * Random value number `counter` of the stream `key`
+ *
+ * SplitMix64 walks key + n * gamma and scrambles each point; computing a
+ * point directly from n makes it a counter-based generator that needs no
+ * state and can start anywhere.
+ *
+ * @param key Stream, e.g. an exam seed
+ * @param counter Position in the stream
+ * @return 64 random bits
+ */
+uint64_t bwt_exam_random(uint64_t key, uint64_t counter) {
+    uint64_t z = key + (counter + 1) * GOLDEN_GAMMA;
+    z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+    return z ^ (z >> 31);
+}
+
+/**
+ * Scale 32 random bits to [0, n)
+ */
+static uint32_t below(uint64_t r, uint32_t n) {
+    return (uint32_t)(((r >> 32) * n) >> 32);
+}
+
+/**
+ * Derive a question of an exam
+ *
+ * @param q The question to fill in
+ * @param seed The exam
+ * @param student Student id
+ * @param index Question number, from 0
+ */
+void bwt_exam_question(struct bwt_question* q, uint64_t seed, uint32_t student, uint32_t index) {
+    uint64_t key = bwt_exam_random(seed, student);
+    uint64_t counter = (uint64_t)index * BWT_EXAM_DRAWS;
+    uint64_t shape = bwt_exam_random(key, counter);
+    uint32_t offset = below(bwt_exam_random(key, TOPIC_COUNTER), BWT_TOPIC_COUNT);
+
+    q->topic = (uint8_t)((index % BWT_TOPIC_COUNT + offset) % BWT_TOPIC_COUNT);
+    q->width = exam_widths[shape & 3];
+    q->is_signed = (shape >> 2 & 1) != 0;
+    q->pattern = (uint8_t)(shape >> 3 & 3);
+    q->format = exam_formats[shape >> 5 & 3];
+
+    uint64_t ra = bwt_exam_random(key, counter + 1);
+    uint8_t cls;
+    switch (q->pattern) {
+        case BWT_PATTERN_SMALL:
+            cls = BWT_OPERAND_SMALL;
+            break;
+        case BWT_PATTERN_SIGN_SET:
+            cls = BWT_OPERAND_MSB_SET;
+            break;
+        case BWT_PATTERN_EDGE:
+            cls = exam_edges[ra >> 62];
+            break;
+        default:
+            cls = exam_classes[below(ra, sizeof(exam_classes))];
+    }
+    q->a = bwt_operand_from_bits(cls, q->width, (uint32_t)ra);
+
+    uint64_t rb = bwt_exam_random(key, counter + 2);
+    q->b = 0;
+    if (bwt_topic_is_binary_op(q->topic)) {
+        q->b = bwt_operand_from_bits(exam_classes[below(rb, sizeof(exam_classes))], q->width, (uint32_t)rb);
+    } else if (q->topic == BWT_TOPIC_SHL || q->topic == BWT_TOPIC_SHR) {
+        q->b = 1 + (uint32_t)rb % (q->width / 2u - 1u);
+    }
+    bwt_question_eval(q);
+}
+
+/**
+ * Derive the order of the options of an exam question asked as multiple choice
+ *
+ * @param q The question, from bwt_exam_question
+ * @param seed The exam
+ * @param student Student id
+ * @param index Question number, from 0
+ * @param c Receives the options
+ */
+void bwt_exam_choices(const struct bwt_question* q, uint64_t seed, uint32_t student, uint32_t index,
+                      struct bwt_choices* c) {
+    uint64_t key = bwt_exam_random(seed, student);
+    bwt_choices_make(q, (uint32_t)bwt_exam_random(key, (uint64_t)index * BWT_EXAM_DRAWS + 3), c);
+}
+
+/**
+ * Read a decimal number at *p, moving past it and the blanks after it
+ *
+ * @return true if there was a number that fits in 32 bits
+ */
+static bool parse_number(const char** p, const char* end, uint32_t* value) {
+    uint64_t v = 0;
+    const char* s = *p;
+
+    if (s == end || *s < '0' || *s > '9') {
+        return false;
+    }
+    while (s < end && *s >= '0' && *s <= '9') {
+        v = v * 10 + (uint64_t)(*s++ - '0');
+        if (v > UINT32_MAX) {
+            return false;
+        }
+    }
+    while (s < end && (*s == ' ' || *s == '\t')) {
+        s++;
+    }
+    *p = s;
+    *value = (uint32_t)v;
+    return true;
+}
+
+enum answer_line { ANSWER_LINE, BLANK_LINE, MALFORMED_LINE };
+
+/**
+ * Read the answer line at *line, moving past it
+ *
+ * @param answer Receives the answer, terminated
+ * @param size Size of the answer buffer
+ * @return ANSWER_LINE, BLANK_LINE for blank lines and comments, or MALFORMED_LINE
+ */
+static enum answer_line read_answer(const char** line, const char* end, uint32_t* student, uint32_t* index,
+                                    char* answer, size_t size) {
+    const char* eol = memchr(*line, '\n', (size_t)(end - *line));
+    if (eol == NULL) {
+        eol = end;
+    }
+    const char* p = *line;
+    const char* stop = eol;
+    *line = eol + 1;
+
+    while (p < stop && (*p == ' ' || *p == '\t')) {
+        p++;
+    }
+    while (stop > p && (stop[-1] == ' ' || stop[-1] == '\t' || stop[-1] == '\r')) {
+        stop--;
+    }
+    if (p == stop || *p == '#') {
+        return BLANK_LINE;
+    }
+
+    size_t len;
+    if (!parse_number(&p, stop, student) || !parse_number(&p, stop, index)
+        || (len = (size_t)(stop - p)) == 0 || len >= size) {
+        return MALFORMED_LINE;
+    }
+    memcpy(answer, p, len);
+    answer[len] = '\0';
+    return ANSWER_LINE;
+}
+
+/**
+ * Regrade the answer lines in [start, end)
+ */
+static void regrade_lines(const char* start, const char* end, uint64_t seed, bool choices, FILE* out,
+                          struct bwt_exam_tally* tally) {
+    char answer[100];
+    char expected[BWT_ANSWER_SIZE];
+
+    for (const char* line = start; line < end;) {
+        uint32_t student, index;
+        enum answer_line kind = read_answer(&line, end, &student, &index, answer, sizeof(answer));
+        if (kind == MALFORMED_LINE) {
+            tally->malformed++;
+        }
+        if (kind != ANSWER_LINE) {
+            continue;
+        }
+
+        struct bwt_question q;
+        enum bwt_verdict verdict;
+        bwt_exam_question(&q, seed, student, index);
+        if (choices) {
+            struct bwt_choices c;
+            uint8_t picked;
+            bwt_exam_choices(&q, seed, student, index, &c);
+            verdict = bwt_choices_grade(&c, answer, &picked);
+            snprintf(expected, sizeof(expected), "%c", 'a' + c.correct);
+        } else {
+            uint32_t bits;
+            verdict = bwt_question_grade(&q, answer, &bits);
+            bwt_question_format_answer(&q, q.expected, expected, sizeof(expected));
+        }
+        tally->verdict[verdict]++;
+        fprintf(out, "%u %u %s %s\n", student, index, verdict_names[verdict], expected);
+    }
+}
+
+struct regrade_worker {
+    pthread_t thread;
+    const char* start;
+    const char* end;
+    uint64_t seed;
+    bool choices;
+    char* out;
+    size_t out_len;
+    struct bwt_exam_tally tally;
+};
+
+static void* regrade_main(void* arg) {
+    struct regrade_worker* w = arg;
+    FILE* out = open_memstream(&w->out, &w->out_len);
+    if (out != NULL) {
+        regrade_lines(w->start, w->end, w->seed, w->choices, out, &w->tally);
+        fclose(out);
+    }
+    return NULL;
+}
+
+/**
+ * Regrade answer lines with several threads
+ *
+ * The text is cut into one run of whole lines per thread, every thread
+ * writes its verdicts to its own buffer, and the buffers are written out
+ * in order, so the output is the same for any number of threads.
+ *
+ * @param text Answer lines
+ * @param len Length of the text
+ * @param seed The exam
+ * @param choices true if the questions were asked as multiple choice
+ * @param threads Number of worker threads, at least 1
+ * @param out Stream for the verdicts
+ * @param tally Answers counted by verdict, added to
+ * @return 0 on success, -1 if memory or threads could not be allocated
+ */
+int bwt_exam_regrade(const char* text, size_t len, uint64_t seed, bool choices, int threads, FILE* out,
+                     struct bwt_exam_tally* tally) {
+    struct regrade_worker* workers = calloc((size_t)threads, sizeof(*workers));
+    const char* end = text + len;
+    const char* start = text;
+    int started = 0;
+    int rc = 0;
+
+    if (workers == NULL) {
+        return -1;
+    }
+    for (int t = 0; t < threads; t++) {
+        const char* cut = t == threads - 1 ? end : text + len / (size_t)threads * (size_t)(t + 1);
+        if (cut < start) {
+            cut = start;
+        }
+        const char* eol = cut < end ? memchr(cut, '\n', (size_t)(end - cut)) : NULL;
+        cut = eol != NULL ? eol + 1 : end;
+
+        workers[t].start = start;
+        workers[t].end = cut;
+        workers[t].seed = seed;
+        workers[t].choices = choices;
+        start = cut;
+        if (pthread_create(&workers[t].thread, NULL, regrade_main, &workers[t]) != 0) {
+            rc = -1;
+            break;
+        }
+        started++;
+    }
+
+    for (int t = 0; t < started; t++) {
+        pthread_join(workers[t].thread, NULL);
+        if (workers[t].out == NULL) {
+            rc = -1;
+        } else {
+            fwrite(workers[t].out, 1, workers[t].out_len, out);
+            free(workers[t].out);
+        }
+        for (int v = 0; v < 3; v++) {
+            tally->verdict[v] += workers[t].tally.verdict[v];
+        }
+        tally->malformed += workers[t].tally.malformed;
+    }
+    free(workers);
+    return rc;
+}
+
+/**
+ * Regrade answer files of an exam and print a verdict for every answer
+ *
+ * @param paths Answer files
+ * @param npaths Number of files
+ * @param seed The exam
+ * @param choices true if the questions were asked as multiple choice
+ * @param threads Number of worker threads
+ * @return Exit status for main
+ */
+int bwt_exam_regrade_main(char* const* paths, int npaths, uint64_t seed, bool choices, int threads) {
+    struct bwt_exam_tally tally = { 0 };
+    struct timespec start, end;
+    int status = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < npaths; i++) {
+        struct stat st;
+        int fd = open(paths[i], O_RDONLY);
+        if (fd < 0 || fstat(fd, &st) < 0) {
+            perror(paths[i]);
+            if (fd >= 0) {
+                close(fd);
+            }
+            status = 1;
+            continue;
+        }
+        if (st.st_size == 0) {
+            close(fd);
+            continue;
+        }
+        void* text = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (text == MAP_FAILED) {
+            perror(paths[i]);
+            status = 1;
+            continue;
+        }
+        if (bwt_exam_regrade(text, (size_t)st.st_size, seed, choices, threads, stdout, &tally) < 0) {
+            fprintf(stderr, "%s: could not start regrade threads\n", paths[i]);
+            status = 1;
+        }
+        munmap(text, (size_t)st.st_size);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double ms = (double)(end.tv_sec - start.tv_sec) * 1e3 + (double)(end.tv_nsec - start.tv_nsec) / 1e6;
+    uint64_t answers = tally.verdict[BWT_VERDICT_CORRECT] + tally.verdict[BWT_VERDICT_WRONG]
+                       + tally.verdict[BWT_VERDICT_INVALID];
+    fprintf(stderr, "bwt regrade: %llu answers (%llu correct, %llu wrong, %llu invalid), "
+            "%llu malformed lines, %d thread(s), %.1f ms\n",
+            (unsigned long long)answers, (unsigned long long)tally.verdict[BWT_VERDICT_CORRECT],
+            (unsigned long long)tally.verdict[BWT_VERDICT_WRONG],
+            (unsigned long long)tally.verdict[BWT_VERDICT_INVALID],
+            (unsigned long long)tally.malformed, threads, ms);
+    if (tally.malformed > 0) {
+        status = 1;
+    }
+    return status;
+}
+
+// A parsed answer line, for scoring
+struct sheet_answer {
+    uint32_t student;
+    uint32_t index;
+    uint32_t bits;
+    bool valid;
+};
+
+static int compare_students(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Score the answer sheets of an exam and print one line per student
+ *
+ * Every answer is parsed once into a set of sheets (bwt_sheet.h), one per
+ * student, with the student's own questions as key; the sheets are then
+ * graded together. All questions are stored as 32-bit values (letters as
+ * 8-bit values with --choices), since the width of question i differs
+ * from student to student. Questions a student did not answer, and
+ * answers to questions past `questions`, count as wrong; the last answer
+ * to a question counts.
+ *
+ * @param text Answer lines
+ * @param len Length of the text
+ * @param seed The exam
+ * @param choices true if the questions were asked as multiple choice
+ * @param questions Questions in the exam
+ * @param out Stream for `student score bitmap` lines, in order of student
+ *            id, with a '1' or '0' per question from question 0
+ * @param tally Questions counted by verdict (unanswered as invalid), added to
+ * @param grade_ns Set to the time spent comparing, in nanoseconds; may be NULL
+ * @return Number of students, or -1 if memory could not be allocated
+ */
+long bwt_exam_score(const char* text, size_t len, uint64_t seed, bool choices, uint32_t questions, FILE* out,
+                    struct bwt_exam_tally* tally, uint64_t* grade_ns) {
+    struct sheet_answer* list = NULL;
+    size_t n = 0, capacity = 0;
+    uint32_t* students = NULL;
+    uint8_t* widths = malloc((questions > 0 ? questions : 1) * sizeof(*widths));
+    char answer[100];
+    long rc = -1;
+
+    if (widths == NULL) {
+        return -1;
+    }
+    for (const char* line = text; line < text + len;) {
+        struct sheet_answer a;
+        enum answer_line kind = read_answer(&line, text + len, &a.student, &a.index, answer, sizeof(answer));
+        if (kind == MALFORMED_LINE || (kind == ANSWER_LINE && a.index >= questions)) {
+            tally->malformed++;
+            continue;
+        }
+        if (kind != ANSWER_LINE) {
+            continue;
+        }
+
+        struct bwt_question q;
+        bwt_exam_question(&q, seed, a.student, a.index);
+        if (choices) {
+            struct bwt_choices c;
+            uint8_t picked = 0;
+            bwt_exam_choices(&q, seed, a.student, a.index, &c);
+            a.valid = bwt_choices_grade(&c, answer, &picked) != BWT_VERDICT_INVALID;
+            a.bits = picked;
+        } else {
+            a.valid = bwt_question_parse(&q, answer, &a.bits);
+        }
+        if (n == capacity) {
+            capacity = capacity > 0 ? capacity * 2 : 1024;
+            struct sheet_answer* grown = realloc(list, capacity * sizeof(*list));
+            if (grown == NULL) {
+                goto done;
+            }
+            list = grown;
+        }
+        list[n++] = a;
+    }
+
+    // One sheet per student, in order of id
+    students = malloc((n > 0 ? n : 1) * sizeof(*students));
+    if (students == NULL) {
+        goto done;
+    }
+    for (size_t i = 0; i < n; i++) {
+        students[i] = list[i].student;
+    }
+    qsort(students, n, sizeof(*students), compare_students);
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (count == 0 || students[count - 1] != students[i]) {
+            students[count++] = students[i];
+        }
+    }
+
+    struct bwt_sheets sheets;
+    memset(widths, choices ? 8 : 32, questions);
+    if (bwt_sheets_init(&sheets, widths, questions, count, false) < 0) {
+        goto done;
+    }
+    for (size_t sheet = 0; sheet < count; sheet++) {
+        for (uint32_t index = 0; index < questions; index++) {
+            struct bwt_question q;
+            bwt_exam_question(&q, seed, students[sheet], index);
+            if (choices) {
+                struct bwt_choices c;
+                bwt_exam_choices(&q, seed, students[sheet], index, &c);
+                bwt_sheets_set_key(&sheets, sheet, index, c.correct);
+            } else {
+                bwt_sheets_set_key(&sheets, sheet, index, q.expected);
+            }
+        }
+    }
+    for (size_t i = 0; i < n; i++) {
+        const uint32_t* found = bsearch(&list[i].student, students, count, sizeof(*students), compare_students);
+        bwt_sheets_set_answer(&sheets, (size_t)(found - students), list[i].index, list[i].bits, list[i].valid);
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    bwt_sheets_grade(&sheets, 0, count);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if (grade_ns != NULL) {
+        *grade_ns = (uint64_t)(end.tv_sec - start.tv_sec) * 1000000000u + (uint64_t)end.tv_nsec
+                    - (uint64_t)start.tv_nsec;
+    }
+
+    char* bitmap = malloc((size_t)questions + 1);
+    if (bitmap != NULL) {
+        for (size_t sheet = 0; sheet < count; sheet++) {
+            uint32_t valid = 0;
+            for (uint32_t index = 0; index < questions; index++) {
+                bitmap[index] = bwt_sheets_correct(&sheets, sheet, index) ? '1' : '0';
+            }
+            bitmap[questions] = '\0';
+            for (uint32_t w = 0; w < sheets.words; w++) {
+                valid += (uint32_t)__builtin_popcount(sheets.valid[sheet * sheets.words + w]);
+            }
+            fprintf(out, "%u %u %s\n", students[sheet], sheets.score[sheet], bitmap);
+            tally->verdict[BWT_VERDICT_CORRECT] += sheets.score[sheet];
+            tally->verdict[BWT_VERDICT_INVALID] += questions - valid;
+            tally->verdict[BWT_VERDICT_WRONG] += valid - sheets.score[sheet];
+        }
+        free(bitmap);
+        rc = (long)count;
+    }
+    bwt_sheets_free(&sheets);
+
+done:
+    free(widths);
+    free(list);
+    free(students);
+    return rc;
+}
+
+/**
+ * Score answer files of an exam and print a line per student
+ *
+ * @param paths Answer files, read as one
+ * @param npaths Number of files
+ * @param seed The exam
+ * @param choices true if the questions were asked as multiple choice
+ * @param questions Questions in the exam
+ * @return Exit status for main
+ */
+int bwt_exam_score_main(char* const* paths, int npaths, uint64_t seed, bool choices, uint32_t questions) {
+    struct bwt_exam_tally tally = { 0 };
+    char* text = NULL;
+    size_t len = 0;
+    FILE* all = open_memstream(&text, &len);
+    int status = 0;
+
+    if (all == NULL) {
+        perror("open_memstream");
+        return 1;
+    }
+    for (int i = 0; i < npaths; i++) {
+        char buf[65536];
+        size_t got;
+        FILE* f = fopen(paths[i], "r");
+        if (f == NULL) {
+            perror(paths[i]);
+            status = 1;
+            continue;
+        }
+        while ((got = fread(buf, 1, sizeof(buf), f)) > 0) {
+            fwrite(buf, 1, got, all);
+        }
+        fclose(f);
+        fputc('\n', all);  // a last line without newline ends with its file
+    }
+    fclose(all);
+
+    uint64_t ns = 0;
+    long students = bwt_exam_score(text, len, seed, choices, questions, stdout, &tally, &ns);
+    free(text);
+    if (students < 0) {
+        fprintf(stderr, "bwt scores: out of memory\n");
+        return 1;
+    }
+    fprintf(stderr, "bwt scores: %ld sheets of %u questions (%llu correct, %llu wrong, %llu invalid), "
+            "%llu malformed lines, graded in %.3f ms\n",
+            students, questions, (unsigned long long)tally.verdict[BWT_VERDICT_CORRECT],
+            (unsigned long long)tally.verdict[BWT_VERDICT_WRONG],
+            (unsigned long long)tally.verdict[BWT_VERDICT_INVALID],
+            (unsigned long long)tally.malformed, (double)ns / 1e6);
+    if (tally.malformed > 0) {
+        status = 1;
+    }
+    return status;
+}
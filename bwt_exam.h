@@ -0,0 +1,67 @@
+/*
+ * bwt_exam.h - Reproducible per-student exams for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * An exam is never stored. Question `index` of student `student` in exam
+ * `seed` is a pure function of those three numbers: a counter-based
+ * generator (SplitMix64's finalizer applied to key + counter * golden
+ * ratio, with the key derived from the seed and the student) gives every
+ * question its own block of BWT_EXAM_DRAWS counters, from which the
+ * width, signedness, operand pattern, answer format and operands are
+ * drawn. Topics go round every BWT_TOPIC_COUNT questions from an offset
+ * that depends on the student, so each exam covers the operators evenly
+ * while neighbours see them in a different order.
+ *
+ * The draws use fixed tables rather than the distributions of bwt.conf,
+ * so the same exam comes out of every build and node whatever its
+ * settings. Any single question can be regenerated and regraded in
+ * constant time, and regrading a cohort's answers needs nothing shared:
+ * `bwt --exam SEED --regrade FILE...` splits the answer files between
+ * --threads worker threads.
+ *
+ * Answer files have one answer per line, `student index answer`, with
+ * questions numbered from 0 and `#` starting a comment; `bwt --exam SEED
+ * --learner ID --answers FILE` appends them as the student sits the exam.
+ * Regrading prints `student index verdict expected` for every answer.
+ *
+ * `bwt --exam SEED --scores FILE...` grades whole answer sheets instead:
+ * every answer is parsed once into a bwt_sheet.h set of sheets and they
+ * are compared in one pass, printing `student score bitmap` per student.
+ *
+ * With --choices the questions are multiple choice (see bwt_choice.h),
+ * the order of the options also comes from the question's counters, and
+ * answers and expected answers are option letters.
+ */
+
+#ifndef BWT_EXAM_H
+#define BWT_EXAM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "bwt_choice.h"
+#include "bwt_question.h"
+
+#define BWT_EXAM_DRAWS 8  // counters reserved for each question
+
+// Answers regraded, by verdict (enum bwt_verdict)
+struct bwt_exam_tally {
+    uint64_t verdict[3];
+    uint64_t malformed;  // lines that are not `student index answer`
+};
+
+uint64_t bwt_exam_random(uint64_t key, uint64_t counter);
+void bwt_exam_question(struct bwt_question* q, uint64_t seed, uint32_t student, uint32_t index);
+void bwt_exam_choices(const struct bwt_question* q, uint64_t seed, uint32_t student, uint32_t index,
+                      struct bwt_choices* c);
+int bwt_exam_regrade(const char* text, size_t len, uint64_t seed, bool choices, int threads, FILE* out,
+                     struct bwt_exam_tally* tally);
+long bwt_exam_score(const char* text, size_t len, uint64_t seed, bool choices, uint32_t questions, FILE* out,
+                    struct bwt_exam_tally* tally, uint64_t* grade_ns);
+int bwt_exam_score_main(char* const* paths, int npaths, uint64_t seed, bool choices, uint32_t questions);
+int bwt_exam_regrade_main(char* const* paths, int npaths, uint64_t seed, bool choices, int threads);
+
+#endif // BWT_EXAM_H
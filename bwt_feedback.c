@@ -0,0 +1,239 @@
+/*
+ * bwt_feedback.c - Bit-level feedback on wrong answers for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "bwt_feedback.h"
+#include "bwt_catalog.h"
+
+_Static_assert(MSG_HINT_TRUNCATED - MSG_HINT_NONE == BWT_MISTAKE_TRUNCATED - BWT_MISTAKE_NONE,
+               "hint messages must be in the order of enum bwt_mistake");
+
+static const char* const mistake_names[BWT_MISTAKE_COUNT] = {
+    "none", "forgot_plus_one", "sign_magnitude", "forgot_sign", "negated", "not_flipped",
+    "wrong_direction", "no_sign_extension", "sign_extended", "shift_amount", "wrong_operator",
+    "unsigned_reading", "signed_reading", "reversed", "inverted", "truncated",
+};
+
+/**
+ * Get the short name of a mistake, as used in machine-readable output
+ *
+ * @param mistake The mistake (enum bwt_mistake)
+ * @return Name such as "forgot_plus_one"
+ */
+const char* bwt_mistake_name(uint8_t mistake) {
+    return mistake < BWT_MISTAKE_COUNT ? mistake_names[mistake] : "unknown";
+}
+
+/**
+ * Reverse the order of the low `width` bits
+ *
+ * @param bits Bit pattern
+ * @param width Width in bits
+ * @return The pattern with its MSB and LSB swapped, and so on
+ */
+uint32_t bwt_reverse_bits(uint32_t bits, uint8_t width) {
+    bits = ((bits >> 1) & 0x55555555u) | ((bits & 0x55555555u) << 1);
+    bits = ((bits >> 2) & 0x33333333u) | ((bits & 0x33333333u) << 2);
+    bits = ((bits >> 4) & 0x0F0F0F0Fu) | ((bits & 0x0F0F0F0Fu) << 4);
+    bits = __builtin_bswap32(bits);
+    return bits >> (32 - width);
+}
+
+/**
+ * Result of a >> n as an arithmetic (signed) or logical (unsigned) shift
+ */
+static uint32_t shift_right(const struct bwt_question* q, uint32_t a, uint32_t n, bool arithmetic) {
+    uint32_t mask = bwt_width_mask(q->width);
+    if (arithmetic) {
+        return (uint32_t)(bwt_value(a, q->width, true) >> n) & mask;
+    }
+    return (a & mask) >> n;
+}
+
+/**
+ * Compare a wrong answer with the expected value
+ *
+ * @param q The question
+ * @param answer The answer as a bit pattern, as returned by bwt_question_grade
+ * @param fb Receives the analysis
+ */
+void bwt_feedback_analyze(const struct bwt_question* q, uint32_t answer, struct bwt_feedback* fb) {
+    uint32_t mask = bwt_width_mask(q->width);
+    uint32_t msb = UINT32_C(1) << (q->width - 1);
+    uint32_t a = q->a & mask;
+    uint32_t b = q->b & mask;
+    uint32_t n = q->b;
+    uint32_t diff = (answer ^ q->expected) & mask;
+
+    answer &= mask;
+    fb->diff = diff;
+    fb->wrong_bits = (uint8_t)__builtin_popcount(diff);
+    fb->highest = (int8_t)(diff ? 31 - __builtin_clz(diff) : -1);
+    fb->lowest = (int8_t)(diff ? __builtin_ctz(diff) : -1);
+    fb->mistake = BWT_MISTAKE_NONE;
+    fb->other_op = q->topic;
+
+    if (diff == 0) {
+        // Same bits but graded wrong: a decimal outside the type's range
+        fb->mistake = q->is_signed ? BWT_MISTAKE_UNSIGNED_READING : BWT_MISTAKE_SIGNED_READING;
+        return;
+    }
+
+    switch (q->topic) {
+        case BWT_TOPIC_DEC2BIN:
+            if (q->is_signed && (a & msb)) {
+                uint32_t magnitude = (~a + 1) & mask;
+                if (answer == (~magnitude & mask)) {
+                    fb->mistake = BWT_MISTAKE_FORGOT_PLUS_ONE;
+                } else if (answer == (magnitude | msb)) {
+                    fb->mistake = BWT_MISTAKE_SIGN_MAGNITUDE;
+                } else if (answer == magnitude) {
+                    fb->mistake = BWT_MISTAKE_FORGOT_SIGN;
+                }
+            }
+            break;
+        case BWT_TOPIC_BIN2DEC:
+            // A negative read as -(~a), or as sign bit and magnitude
+            if (q->is_signed && (a & msb)) {
+                if (answer == ((a + 1) & mask)) {
+                    fb->mistake = BWT_MISTAKE_FORGOT_PLUS_ONE;
+                } else if (answer == ((~(a & ~msb) + 1) & mask)) {
+                    fb->mistake = BWT_MISTAKE_SIGN_MAGNITUDE;
+                }
+            }
+            break;
+        case BWT_TOPIC_NOT:
+            if (answer == ((~a + 1) & mask)) {
+                fb->mistake = BWT_MISTAKE_NEGATED;
+            } else if (answer == a) {
+                fb->mistake = BWT_MISTAKE_NOT_FLIPPED;
+            }
+            break;
+        case BWT_TOPIC_SHL:
+            if (answer == shift_right(q, a, n, q->is_signed)) {
+                fb->mistake = BWT_MISTAKE_WRONG_DIRECTION;
+            } else if ((n > 0 && answer == ((a << (n - 1)) & mask)) || answer == ((a << (n + 1)) & mask)) {
+                fb->mistake = BWT_MISTAKE_SHIFT_AMOUNT;
+            }
+            break;
+        case BWT_TOPIC_SHR:
+            if (answer == ((a << n) & mask)) {
+                fb->mistake = BWT_MISTAKE_WRONG_DIRECTION;
+            } else if (answer == shift_right(q, a, n, !q->is_signed)) {
+                fb->mistake = q->is_signed ? BWT_MISTAKE_NO_SIGN_EXTENSION : BWT_MISTAKE_SIGN_EXTENDED;
+            } else if ((n > 0 && answer == shift_right(q, a, n - 1, q->is_signed))
+                       || answer == shift_right(q, a, n + 1, q->is_signed)) {
+                fb->mistake = BWT_MISTAKE_SHIFT_AMOUNT;
+            }
+            break;
+        case BWT_TOPIC_AND:
+        case BWT_TOPIC_OR:
+        case BWT_TOPIC_XOR: {
+            const uint32_t results[3] = { a & b, a | b, a ^ b };
+            for (uint8_t op = 0; op < 3; op++) {
+                if (BWT_TOPIC_AND + op != q->topic && answer == results[op]) {
+                    fb->mistake = BWT_MISTAKE_WRONG_OPERATOR;
+                    fb->other_op = BWT_TOPIC_AND + op;
+                    break;
+                }
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    if (fb->mistake == BWT_MISTAKE_NONE) {
+        if (answer == bwt_reverse_bits(q->expected, q->width)) {
+            fb->mistake = BWT_MISTAKE_REVERSED;
+        } else if (answer == (~q->expected & mask)) {
+            fb->mistake = BWT_MISTAKE_INVERTED;
+        } else if (answer == (q->expected & (mask >> q->width / 2))) {
+            fb->mistake = BWT_MISTAKE_TRUNCATED;
+        }
+    }
+}
+
+/**
+ * Render the hint line for a known mistake
+ *
+ * @param fb Analysis from bwt_feedback_analyze
+ * @param buf Output buffer, e.g. "Hint: Check how many places to shift.\n"
+ * @param size Size of the output buffer
+ * @return Number of characters written as for snprintf, 0 if there is no hint
+ */
+int bwt_feedback_hint(const struct bwt_feedback* fb, char* buf, size_t size) {
+    static const char* const op_strs[] = { "&", "|", "^" };
+    char hint[BWT_FEEDBACK_SIZE];
+
+    if (size > 0) {
+        buf[0] = '\0';
+    }
+    if (fb->mistake == BWT_MISTAKE_NONE || fb->mistake >= BWT_MISTAKE_COUNT) {
+        return 0;
+    }
+    if (fb->mistake == BWT_MISTAKE_WRONG_OPERATOR) {
+        BWT_MSG(hint, sizeof(hint), MSG_HINT_WRONG_OPERATOR, op_strs[fb->other_op - BWT_TOPIC_AND]);
+    } else {
+        bwt_msg_format(hint, sizeof(hint), MSG_HINT_NONE + fb->mistake, NULL, 0);
+    }
+    return BWT_MSG(buf, size, MSG_FEEDBACK_HINT, hint);
+}
+
+/**
+ * Render feedback on a wrong answer
+ *
+ * Shows the answer in binary with a `^` under every wrong bit, how many
+ * bits are wrong and a hint when the mistake is a known one. The expected
+ * value itself is never shown, so the student can try again.
+ *
+ * @param q The question
+ * @param answer The answer as a bit pattern
+ * @param fb Analysis from bwt_feedback_analyze
+ * @param buf Output buffer
+ * @param size Size of the output buffer
+ * @return Number of characters written, truncated to fit like snprintf
+ */
+int bwt_feedback_render(const struct bwt_question* q, uint32_t answer,
+                        const struct bwt_feedback* fb, char* buf, size_t size) {
+    bool binary = bwt_question_answer_format(q) == BWT_FORMAT_BINARY;
+    const char* label = bwt_msg_text(binary ? MSG_FEEDBACK_ANSWER : MSG_FEEDBACK_ANSWER_BINARY);
+    char answer_bin[BWT_MAX_WIDTH + 1];
+    char markers[BWT_MAX_WIDTH + 1];
+    char wrong[BWT_MSG_INT_SIZE];
+    char width[BWT_MSG_INT_SIZE];
+    int len = 0;
+
+    if (size == 0) {
+        return 0;
+    }
+    buf[0] = '\0';
+
+    if (fb->diff != 0) {
+        bwt_format_binary(answer_bin, answer, q->width);
+        for (int i = 0; i < q->width; i++) {
+            markers[i] = ((fb->diff >> (q->width - 1 - i)) & 1) ? '^' : ' ';
+        }
+        markers[fb->highest >= 0 ? q->width - fb->lowest : 0] = '\0';
+
+        // The markers line up under the answer whatever the label's script
+        len += snprintf(buf + len, size - (size_t)len, "%s%s\n%*s%s",
+                        label, answer_bin, bwt_msg_columns(label), "", markers);
+        if (len < (int)size) {
+            len += BWT_MSG(buf + len, size - (size_t)len, MSG_FEEDBACK_WRONG_BITS,
+                           bwt_msg_int(wrong, fb->wrong_bits), bwt_msg_int(width, q->width));
+        }
+    }
+    if (len < (int)size) {
+        len += bwt_feedback_hint(fb, buf + len, size - (size_t)len);
+    }
+    return len < (int)size ? len : (int)size - 1;
+}
@@ -0,0 +1,62 @@
+/*
+ * bwt_feedback.h - Bit-level feedback on wrong answers for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * A wrong answer is compared with the expected value as integers: the XOR
+ * of the two gives the wrong bits, popcount how many there are and
+ * ctz/clz the lowest and highest one. The answer is also checked against
+ * the results of the usual mistakes (forgetting the +1 of two's complement,
+ * shifting the wrong way, sign extension on >>...), each of which is one
+ * or two bit operations, so analysis takes constant time and never
+ * allocates.
+ */
+
+#ifndef BWT_FEEDBACK_H
+#define BWT_FEEDBACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bwt_question.h"
+
+#define BWT_FEEDBACK_SIZE 512  // large enough for any rendered feedback
+
+enum bwt_mistake {
+    BWT_MISTAKE_NONE,               // no known pattern
+    BWT_MISTAKE_FORGOT_PLUS_ONE,    // one's instead of two's complement of a negative
+    BWT_MISTAKE_SIGN_MAGNITUDE,     // negative written as sign bit + magnitude
+    BWT_MISTAKE_FORGOT_SIGN,        // magnitude of a negative number only
+    BWT_MISTAKE_NEGATED,            // ~a answered with -a, i.e. added 1
+    BWT_MISTAKE_NOT_FLIPPED,        // ~a answered with a
+    BWT_MISTAKE_WRONG_DIRECTION,    // shifted left instead of right or vice versa
+    BWT_MISTAKE_NO_SIGN_EXTENSION,  // logical >> of a negative signed value
+    BWT_MISTAKE_SIGN_EXTENDED,      // arithmetic >> of an unsigned value
+    BWT_MISTAKE_SHIFT_AMOUNT,       // shifted one place too few or too many
+    BWT_MISTAKE_WRONG_OPERATOR,     // e.g. a|b given for a&b
+    BWT_MISTAKE_UNSIGNED_READING,   // signed pattern read as unsigned
+    BWT_MISTAKE_SIGNED_READING,     // unsigned pattern read as signed
+    BWT_MISTAKE_REVERSED,           // bits written LSB first
+    BWT_MISTAKE_INVERTED,           // every bit flipped
+    BWT_MISTAKE_TRUNCATED,          // only the low half of the width kept
+    BWT_MISTAKE_COUNT
+};
+
+struct bwt_feedback {
+    uint32_t diff;       // answer XOR expected, masked to width
+    uint8_t wrong_bits;  // popcount of diff
+    int8_t highest;      // highest wrong bit position, -1 if none
+    int8_t lowest;       // lowest wrong bit position, -1 if none
+    uint8_t mistake;     // enum bwt_mistake
+    uint8_t other_op;    // topic of the operator used by mistake, for WRONG_OPERATOR
+};
+
+void bwt_feedback_analyze(const struct bwt_question* q, uint32_t answer, struct bwt_feedback* fb);
+int bwt_feedback_render(const struct bwt_question* q, uint32_t answer,
+                        const struct bwt_feedback* fb, char* buf, size_t size);
+int bwt_feedback_hint(const struct bwt_feedback* fb, char* buf, size_t size);
+uint32_t bwt_reverse_bits(uint32_t bits, uint8_t width);
+const char* bwt_mistake_name(uint8_t mistake);
+
+#endif // BWT_FEEDBACK_H
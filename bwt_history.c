@@ -0,0 +1,129 @@
+/*
+ * bwt_history.c - Bit-packed answer history for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ */
+
+#include "bwt_history.h"
+
+#include <string.h>
+
+#define LOW_BITS UINT64_C(0x5555555555555555)  // the low bit of every code
+
+/**
+ * Start an empty history
+ */
+void bwt_history_init(struct bwt_history* h) {
+    memset(h, 0, sizeof(*h));
+}
+
+/**
+ * Outcome of a question that was closed
+ *
+ * @param correct Whether it was answered correctly, rather than given up
+ * @param attempts Well-formed answers given, including the correct one
+ */
+enum bwt_outcome bwt_outcome_of(bool correct, uint32_t attempts) {
+    if (!correct) {
+        return BWT_OUTCOME_GAVE_UP;
+    }
+    return attempts <= 1 ? BWT_OUTCOME_FIRST_TRY : BWT_OUTCOME_RETRIED;
+}
+
+/**
+ * Record how a question ended, dropping the oldest outcome of a full ring
+ *
+ * @param h History of the learner
+ * @param topic Topic of the question (enum bwt_topic)
+ * @param width Width in bits
+ * @param outcome How it ended
+ */
+void bwt_history_push(struct bwt_history* h, uint8_t topic, uint8_t width, enum bwt_outcome outcome) {
+    uint8_t w = bwt_width_index(width);
+    uint64_t* ring = h->ring[topic][w];
+
+    for (int i = BWT_HISTORY_WORDS - 1; i > 0; i--) {
+        ring[i] = ring[i] << 2 | ring[i - 1] >> 62;
+    }
+    ring[0] = ring[0] << 2 | (uint64_t)outcome;
+    if (h->count[topic][w] < BWT_HISTORY_CAPACITY) {
+        h->count[topic][w]++;
+    }
+}
+
+/**
+ * Count the outcomes of the last questions of a (topic, width)
+ *
+ * @param h History of the learner
+ * @param topic Topic (enum bwt_topic)
+ * @param width Width in bits
+ * @param last How many of the most recent questions to count, at most
+ *             BWT_HISTORY_CAPACITY are kept
+ * @param tally Set to the counts
+ */
+void bwt_history_tally(const struct bwt_history* h, uint8_t topic, uint8_t width, uint32_t last,
+                       struct bwt_history_tally* tally) {
+    uint8_t w = bwt_width_index(width);
+    const uint64_t* ring = h->ring[topic][w];
+    uint32_t n = last < h->count[topic][w] ? last : h->count[topic][w];
+    uint32_t lo_count = 0, hi_count = 0, both = 0, any = 0;
+
+    for (int i = 0; i < BWT_HISTORY_WORDS && n > 32u * (uint32_t)i; i++) {
+        uint32_t k = n - 32u * (uint32_t)i;
+        uint64_t mask = k >= 32 ? LOW_BITS : LOW_BITS & ((UINT64_C(1) << (2 * k)) - 1);
+        uint64_t lo = ring[i] & mask;
+        uint64_t hi = (ring[i] >> 1) & mask;
+        lo_count += (uint32_t)__builtin_popcountll(lo);
+        hi_count += (uint32_t)__builtin_popcountll(hi);
+        both += (uint32_t)__builtin_popcountll(lo & hi);
+        any += (uint32_t)__builtin_popcountll(lo | hi);
+    }
+    tally->total = n;
+    tally->outcome[BWT_OUTCOME_FIRST_TRY] = n - any;
+    tally->outcome[BWT_OUTCOME_RETRIED] = lo_count - both;
+    tally->outcome[BWT_OUTCOME_GAVE_UP] = hi_count - both;
+    tally->outcome[BWT_OUTCOME_TIMED_OUT] = both;
+}
+
+/**
+ * Rolling accuracy: the share of the last questions of a (topic, width)
+ * answered correctly on the first try
+ *
+ * @return Percentage, rounded, or -1 if there were no questions yet
+ */
+int bwt_history_accuracy(const struct bwt_history* h, uint8_t topic, uint8_t width, uint32_t last) {
+    struct bwt_history_tally tally;
+    bwt_history_tally(h, topic, width, last, &tally);
+    if (tally.total == 0) {
+        return -1;
+    }
+    return (int)((tally.outcome[BWT_OUTCOME_FIRST_TRY] * 100 + tally.total / 2) / tally.total);
+}
+
+/**
+ * Replay a learner's results into a history, oldest first
+ *
+ * @param h History to add to
+ * @param records Results, in the order they were appended
+ * @param count Number of records
+ * @param learner Learner whose records to use
+ * @return Number of records used
+ */
+size_t bwt_history_load(struct bwt_history* h, const struct bwt_record* records, size_t count,
+                        uint32_t learner) {
+    size_t used = 0;
+    for (size_t i = 0; i < count; i++) {
+        const struct bwt_record* r = &records[i];
+        if (r->learner != learner || r->topic >= BWT_TOPIC_COUNT
+            || (r->width != 8 && r->width != 16 && r->width != 32)) {
+            continue;
+        }
+        enum bwt_outcome outcome = (r->flags & BWT_RECORD_CORRECT) ? bwt_outcome_of(true, r->attempts)
+                                   : (r->flags & BWT_RECORD_GAVE_UP) ? BWT_OUTCOME_GAVE_UP
+                                   : BWT_OUTCOME_TIMED_OUT;
+        bwt_history_push(h, r->topic, r->width, outcome);
+        used++;
+    }
+    return used;
+}
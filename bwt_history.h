@@ -0,0 +1,67 @@
+/*
+ * bwt_history.h - Bit-packed answer history for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * Keeps how each of a learner's recent questions ended as a 2-bit code,
+ * per (topic, width), instead of a record per attempt. Each ring is
+ * BWT_HISTORY_WORDS 64-bit words used as a shift register: a new outcome
+ * goes into the low two bits of the first word and the oldest one falls
+ * off the top of the last, so the last n outcomes are always the low 2n
+ * bits. Counting them is a mask and a popcount per word:
+ *
+ *   code   hi lo
+ *   first  0  0   correct on the first try
+ *   retry  0  1   correct after wrong answers
+ *   gave   1  0   asked for the answer
+ *   timed  1  1   no answer before the time limit
+ *
+ * The high bit is set for questions never answered correctly, the low bit
+ * for ones not answered right away. The whole history is a fixed-size
+ * struct with no pointers, about 500 bytes per learner, and recording or
+ * querying an outcome takes a few nanoseconds.
+ */
+
+#ifndef BWT_HISTORY_H
+#define BWT_HISTORY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bwt_question.h"
+#include "bwt_store.h"
+
+#define BWT_HISTORY_WORDS 2                            // per (topic, width)
+#define BWT_HISTORY_CAPACITY (BWT_HISTORY_WORDS * 32)  // outcomes kept per ring
+
+enum bwt_outcome {
+    BWT_OUTCOME_FIRST_TRY,
+    BWT_OUTCOME_RETRIED,
+    BWT_OUTCOME_GAVE_UP,
+    BWT_OUTCOME_TIMED_OUT,
+    BWT_OUTCOME_COUNT
+};
+
+struct bwt_history {
+    uint64_t ring[BWT_TOPIC_COUNT][BWT_WIDTH_COUNT][BWT_HISTORY_WORDS];
+    uint8_t count[BWT_TOPIC_COUNT][BWT_WIDTH_COUNT];  // outcomes in the ring, up to the capacity
+};
+
+// Outcomes among the last questions of a (topic, width)
+struct bwt_history_tally {
+    uint32_t total;
+    uint32_t outcome[BWT_OUTCOME_COUNT];
+};
+
+void bwt_history_init(struct bwt_history* h);
+enum bwt_outcome bwt_outcome_of(bool correct, uint32_t attempts);
+void bwt_history_push(struct bwt_history* h, uint8_t topic, uint8_t width, enum bwt_outcome outcome);
+void bwt_history_tally(const struct bwt_history* h, uint8_t topic, uint8_t width, uint32_t last,
+                       struct bwt_history_tally* tally);
+int bwt_history_accuracy(const struct bwt_history* h, uint8_t topic, uint8_t width, uint32_t last);
+size_t bwt_history_load(struct bwt_history* h, const struct bwt_record* records, size_t count,
+                        uint32_t learner);
+
+#endif // BWT_HISTORY_H
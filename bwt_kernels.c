@@ -0,0 +1,569 @@
+/*
+ * bwt_kernels.c - Binary, hex and octal string formatting and parsing
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ */
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "bwt_kernels.h"
+#include "bwt_question.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define BWT_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+#define BYTE_LSBS UINT64_C(0x0101010101010101)  // bit 0 of every byte
+#define ASCII_ZEROS UINT64_C(0x3030303030303030)  // eight '0' characters
+
+/* ---- Portable ---- */
+
+static void format_scalar(char* out, uint32_t bits, uint8_t width) {
+    for (int i = width - 1; i >= 0; i--) {
+        out[width - 1 - i] = ((bits >> i) & 1) ? '1' : '0';
+    }
+    out[width] = '\0';
+}
+
+static bool parse_scalar(const char* in, uint8_t width, uint32_t* bits) {
+    uint32_t parsed = 0;
+    for (size_t i = 0; i < width; i++) {
+        if (in[i] != '0' && in[i] != '1') {
+            return false;
+        }
+        parsed = (parsed << 1) | (uint32_t)(in[i] - '0');
+    }
+    *bits = parsed;
+    return true;
+}
+
+// Element i of an array of 8-, 16- or 32-bit values
+static inline uint32_t array_value(const void* values, size_t i, uint8_t width) {
+    switch (width) {
+        case 8:
+            return ((const uint8_t*)values)[i];
+        case 16:
+            return ((const uint16_t*)values)[i];
+        default:
+            return ((const uint32_t*)values)[i];
+    }
+}
+
+static size_t format_array_scalar(char* out, const void* values, size_t count, uint8_t width,
+                                  const struct bwt_binary_style* style) {
+    char* p = out;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t bits = array_value(values, i, width);
+        for (int b = width - 1; b >= 0; b--) {
+            *p++ = ((bits >> b) & 1) ? '1' : '0';
+            if (style->group && b % 4 == 0 && b > 0) {
+                *p++ = style->group;
+            }
+        }
+        if (style->separator && i + 1 < count) {
+            *p++ = style->separator;
+        }
+    }
+    *p = '\0';
+    return (size_t)(p - out);
+}
+
+static void match_scalar(uint32_t* masks, const void* keys, const void* answers, size_t blocks, uint8_t width) {
+    for (size_t b = 0; b < blocks; b++) {
+        uint32_t mask = 0;
+        for (size_t lane = 0; lane < 32; lane++) {
+            size_t i = b * 32 + lane;
+            mask |= (uint32_t)(array_value(keys, i, width) == array_value(answers, i, width)) << lane;
+        }
+        masks[b] = mask;
+    }
+}
+
+static bool supported_always(void) {
+    return true;
+}
+
+static const struct bwt_kernels scalar_kernels = {
+    "scalar", format_scalar, parse_scalar, format_array_scalar, match_scalar, supported_always
+};
+
+#ifdef BWT_X86_KERNELS
+
+/* ---- BMI2: eight bits per pdep/pext ---- */
+
+__attribute__((target("bmi2")))
+static void format_bmi2(char* out, uint32_t bits, uint8_t width) {
+    if (width % 8 != 0) {
+        format_scalar(out, bits, width);
+        return;
+    }
+    for (int shift = width - 8; shift >= 0; shift -= 8) {
+        // Bit k of the byte goes to char k; swap so the high bit comes first
+        uint64_t chars = _pdep_u64((bits >> shift) & 0xFF, BYTE_LSBS);
+        chars = __builtin_bswap64(chars) + ASCII_ZEROS;
+        memcpy(out, &chars, 8);
+        out += 8;
+    }
+    *out = '\0';
+}
+
+__attribute__((target("bmi2")))
+static bool parse_bmi2(const char* in, uint8_t width, uint32_t* bits) {
+    if (width % 8 != 0) {
+        return parse_scalar(in, width, bits);
+    }
+    uint64_t parsed = 0;
+    for (size_t i = 0; i < width; i += 8) {
+        uint64_t chars;
+        memcpy(&chars, in + i, 8);
+        chars ^= ASCII_ZEROS;  // '0' -> 0, '1' -> 1, anything else has other bits set
+        if (chars & ~BYTE_LSBS) {
+            return false;
+        }
+        parsed = (parsed << 8) | _pext_u64(__builtin_bswap64(chars), BYTE_LSBS);
+    }
+    *bits = (uint32_t)parsed;
+    return true;
+}
+
+__attribute__((target("bmi2")))
+static size_t format_array_bmi2(char* out, const void* values, size_t count, uint8_t width,
+                                const struct bwt_binary_style* style) {
+    char* p = out;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t bits = array_value(values, i, width);
+        for (int shift = width - 8; shift >= 0; shift -= 8) {
+            uint64_t chars = _pdep_u64((bits >> shift) & 0xFF, BYTE_LSBS);
+            chars = __builtin_bswap64(chars) + ASCII_ZEROS;
+            if (style->group) {
+                // Both nibbles of the byte, and the group after it unless it is the last
+                memcpy(p, &chars, 4);
+                p[4] = style->group;
+                memcpy(p + 5, (const char*)&chars + 4, 4);
+                p[9] = style->group;
+                p += shift > 0 ? 10 : 9;
+            } else {
+                memcpy(p, &chars, 8);
+                p += 8;
+            }
+        }
+        if (style->separator && i + 1 < count) {
+            *p++ = style->separator;
+        }
+    }
+    *p = '\0';
+    return (size_t)(p - out);
+}
+
+static bool supported_bmi2(void) {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("bmi2");
+}
+
+static const struct bwt_kernels bmi2_kernels = {
+    "bmi2", format_bmi2, parse_bmi2, format_array_bmi2, match_scalar, supported_bmi2
+};
+
+/* ---- AVX2: all 32 bits in one vector ---- */
+
+__attribute__((target("avx2")))
+static void format_avx2(char* out, uint32_t bits, uint8_t width) {
+    if (width != 8 && width != 16 && width != 32) {
+        format_scalar(out, bits, width);
+        return;
+    }
+    // Move the wanted bits to the top so the first `width` chars are the ones stored
+    __m256i v = _mm256_set1_epi32((int)(bits << (32 - width)));
+    // Char i takes byte 3 - i / 8 of the value, and within it bit 7 - i % 8
+    const __m256i spread = _mm256_setr_epi8(3, 3, 3, 3, 3, 3, 3, 3, 2, 2, 2, 2, 2, 2, 2, 2,
+                                            1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i select = _mm256_set1_epi64x((int64_t)UINT64_C(0x0102040810204080));
+    v = _mm256_and_si256(_mm256_shuffle_epi8(v, spread), select);
+    v = _mm256_cmpeq_epi8(v, select);                   // 0xFF where the bit is set
+    v = _mm256_sub_epi8(_mm256_set1_epi8('0'), v);      // '0' - -1 == '1'
+    if (width == 32) {
+        _mm256_storeu_si256((__m256i*)out, v);
+    } else if (width == 16) {
+        _mm_storeu_si128((__m128i*)out, _mm256_castsi256_si128(v));
+    } else {
+        _mm_storel_epi64((__m128i*)out, _mm256_castsi256_si128(v));
+    }
+    out[width] = '\0';
+}
+
+__attribute__((target("avx2")))
+static bool parse_avx2(const char* in, uint8_t width, uint32_t* bits) {
+    __m256i v;
+    // Load exactly `width` chars, so the input is never read past its end
+    if (width == 32) {
+        v = _mm256_loadu_si256((const __m256i*)in);
+    } else if (width == 16) {
+        v = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)in));
+    } else if (width == 8) {
+        v = _mm256_castsi128_si256(_mm_loadl_epi64((const __m128i*)in));
+    } else {
+        return parse_scalar(in, width, bits);
+    }
+    v = _mm256_sub_epi8(v, _mm256_set1_epi8('0'));
+    const __m256i one = _mm256_set1_epi8(1);
+    uint32_t valid = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(v, one), one));
+    if ((valid | ~bwt_width_mask(width)) != UINT32_MAX) {
+        return false;
+    }
+    // Reverse the chars so the last one (bit 0) lands in the lowest mask bit
+    const __m256i reverse = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                             15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    v = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(v, reverse), 0x4E);
+    *bits = (uint32_t)_mm256_movemask_epi8(_mm256_slli_epi16(v, 7)) >> (32 - width);
+    return true;
+}
+
+// Where each char of a run of output comes from: a bit of the eight
+// source bytes, or a fixed group or separator char
+struct array_plan {
+    size_t values;      // per run
+    size_t len;         // chars per run, separators included
+    size_t stores;      // 32-byte stores per run
+    __m256i spread[2];  // source byte of each char
+    __m256i select[2];  // its bit, 0 for fixed chars
+    __m256i ones[2];    // 1 for bits, 0 for fixed chars
+    __m256i base[2];    // '0' for bits, the fixed char otherwise
+};
+
+/**
+ * Lay out as many whole values as fit in one run: at most 8 source bytes,
+ * and up to 64 chars written with two stores
+ */
+__attribute__((target("avx2")))
+static void plan_array(struct array_plan* plan, uint8_t width, const struct bwt_binary_style* style) {
+    uint8_t spread[64] = { 0 }, select[64] = { 0 }, ones[64] = { 0 }, base[64] = { 0 };
+    size_t per_value = width + (style->group ? width / 4 - 1 : 0) + (style->separator ? 1 : 0);
+    size_t len = 0;
+
+    plan->values = 32 / per_value > 0 ? 32 / per_value : 1;
+    for (size_t v = 0; v < plan->values; v++) {
+        for (int b = width - 1; b >= 0; b--) {
+            spread[len] = (uint8_t)(v * width / 8 + (size_t)b / 8);
+            select[len] = (uint8_t)(1u << (b % 8));
+            ones[len] = 1;
+            base[len++] = '0';
+            if (style->group && b % 4 == 0 && b > 0) {
+                base[len++] = (uint8_t)style->group;
+            }
+        }
+        // Every value of the run gets one; the scalar tail ends the output
+        if (style->separator) {
+            base[len++] = (uint8_t)style->separator;
+        }
+    }
+    plan->len = len;
+    plan->stores = (len + 31) / 32;
+    for (size_t i = 0; i < plan->stores; i++) {
+        plan->spread[i] = _mm256_loadu_si256((const __m256i*)(spread + 32 * i));
+        plan->select[i] = _mm256_loadu_si256((const __m256i*)(select + 32 * i));
+        plan->ones[i] = _mm256_loadu_si256((const __m256i*)(ones + 32 * i));
+        plan->base[i] = _mm256_loadu_si256((const __m256i*)(base + 32 * i));
+    }
+}
+
+__attribute__((target("avx2")))
+static size_t format_array_avx2(char* out, const void* values, size_t count, uint8_t width,
+                                const struct bwt_binary_style* style) {
+    if (width != 8 && width != 16 && width != 32) {
+        return format_array_scalar(out, values, count, width, style);
+    }
+    struct array_plan plan;
+    plan_array(&plan, width, style);
+
+    const uint8_t* src = values;
+    size_t bytes = count * width / 8;
+    size_t per_value = plan.len / plan.values;
+    size_t total = count * per_value - (style->separator && count > 0 ? 1 : 0) + 1;
+    char* p = out;
+    size_t i = 0;
+
+    // Whole runs that can read 8 source bytes and store past their end; the
+    // last value is always left to the scalar tail, which terminates
+    while (i + plan.values < count && i * width / 8 + 8 <= bytes
+           && (size_t)(out + total - p) >= 32 * plan.stores) {
+        uint64_t chunk;
+        memcpy(&chunk, src + i * width / 8, 8);
+        __m256i v = _mm256_set1_epi64x((int64_t)chunk);
+        for (size_t k = 0; k < plan.stores; k++) {
+            __m256i c = _mm256_and_si256(_mm256_shuffle_epi8(v, plan.spread[k]), plan.select[k]);
+            c = _mm256_and_si256(_mm256_cmpeq_epi8(c, plan.select[k]), plan.ones[k]);
+            _mm256_storeu_si256((__m256i*)(p + 32 * k), _mm256_add_epi8(plan.base[k], c));
+        }
+        p += plan.len;
+        i += plan.values;
+    }
+    return (size_t)(p - out) + format_array_scalar(p, src + i * width / 8, count - i, width, style);
+}
+
+// One 32-lane block per iteration: 1, 2 or 4 compares, packed down to one byte per lane
+__attribute__((target("avx2")))
+static void match_avx2(uint32_t* masks, const void* keys, const void* answers, size_t blocks, uint8_t width) {
+    const __m256i* k = keys;
+    const __m256i* a = answers;
+    size_t vectors = width / 8u;  // per block
+
+    if (width != 8 && width != 16 && width != 32) {
+        match_scalar(masks, keys, answers, blocks, width);
+        return;
+    }
+    // Lanes 0-3, 8-11, 16-19, 24-27 end up in the low half after the packs
+    const __m256i dwords = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    for (size_t b = 0; b < blocks; b++, k += vectors, a += vectors) {
+        __m256i eq;
+        if (width == 8) {
+            eq = _mm256_cmpeq_epi8(_mm256_load_si256(k), _mm256_load_si256(a));
+        } else if (width == 16) {
+            __m256i c0 = _mm256_cmpeq_epi16(_mm256_load_si256(k), _mm256_load_si256(a));
+            __m256i c1 = _mm256_cmpeq_epi16(_mm256_load_si256(k + 1), _mm256_load_si256(a + 1));
+            eq = _mm256_permute4x64_epi64(_mm256_packs_epi16(c0, c1), 0xD8);
+        } else {
+            __m256i c0 = _mm256_cmpeq_epi32(_mm256_load_si256(k), _mm256_load_si256(a));
+            __m256i c1 = _mm256_cmpeq_epi32(_mm256_load_si256(k + 1), _mm256_load_si256(a + 1));
+            __m256i c2 = _mm256_cmpeq_epi32(_mm256_load_si256(k + 2), _mm256_load_si256(a + 2));
+            __m256i c3 = _mm256_cmpeq_epi32(_mm256_load_si256(k + 3), _mm256_load_si256(a + 3));
+            __m256i packed = _mm256_packs_epi16(_mm256_packs_epi32(c0, c1), _mm256_packs_epi32(c2, c3));
+            eq = _mm256_permutevar8x32_epi32(packed, dwords);
+        }
+        masks[b] = (uint32_t)_mm256_movemask_epi8(eq);
+    }
+}
+
+static bool supported_avx2(void) {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+static const struct bwt_kernels avx2_kernels = {
+    "avx2", format_avx2, parse_avx2, format_array_avx2, match_avx2, supported_avx2
+};
+
+#endif // BWT_X86_KERNELS
+
+const struct bwt_kernels* const bwt_kernels_all[] = {
+#ifdef BWT_X86_KERNELS
+    &avx2_kernels,
+    &bmi2_kernels,
+#endif
+    &scalar_kernels,
+    NULL
+};
+
+static _Atomic(const struct bwt_kernels*) active;
+
+static const struct bwt_kernels* kernels(void) {
+    const struct bwt_kernels* k = atomic_load_explicit(&active, memory_order_relaxed);
+    if (k == NULL) {
+        bwt_kernels_select(NULL);
+        k = atomic_load_explicit(&active, memory_order_relaxed);
+    }
+    return k;
+}
+
+/**
+ * Choose the kernels used by bwt_format_binary and bwt_parse_binary
+ *
+ * @param name Kernel name, or NULL or "auto" for the best the CPU supports
+ * @return 0 on success, -1 if the kernels are unknown or not supported
+ */
+int bwt_kernels_select(const char* name) {
+    bool any = name == NULL || strcmp(name, "auto") == 0;
+    for (size_t i = 0; bwt_kernels_all[i] != NULL; i++) {
+        const struct bwt_kernels* k = bwt_kernels_all[i];
+        if ((any || strcmp(name, k->name) == 0) && k->supported()) {
+            atomic_store_explicit(&active, k, memory_order_relaxed);
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Name of the kernels in use
+ */
+const char* bwt_kernels_name(void) {
+    return kernels()->name;
+}
+
+/**
+ * Write the left-padded binary representation of a bit pattern
+ *
+ * @param out Output buffer of at least width + 1 bytes
+ * @param bits Bit pattern
+ * @param width Number of digits to write
+ */
+void bwt_format_binary(char* out, uint32_t bits, uint8_t width) {
+    kernels()->format(out, bits, width);
+}
+
+/**
+ * Bytes bwt_format_binary_array writes for an array, the terminator included
+ *
+ * @param count Number of values
+ * @param width Width of each value, 8, 16 or 32
+ * @param style Separator and grouping, or NULL for neither
+ */
+size_t bwt_binary_array_size(size_t count, uint8_t width, const struct bwt_binary_style* style) {
+    size_t per_value = width;
+    if (count == 0) {
+        return 1;
+    }
+    if (style != NULL && style->group) {
+        per_value += width / 4 - 1;
+    }
+    if (style != NULL && style->separator) {
+        per_value++;
+    }
+    return count * per_value - (style != NULL && style->separator ? 1 : 0) + 1;
+}
+
+/**
+ * Write the binary representations of an array of values into one string
+ *
+ * @param out Buffer of at least bwt_binary_array_size() bytes
+ * @param values uint8_t, uint16_t or uint32_t array, as given by width
+ * @param count Number of values
+ * @param width Width of each value, 8, 16 or 32
+ * @param style Separator between values and between nibbles, or NULL for
+ *              all the digits run together
+ * @return Length of the string written
+ */
+size_t bwt_format_binary_array(char* out, const void* values, size_t count, uint8_t width,
+                               const struct bwt_binary_style* style) {
+    static const struct bwt_binary_style plain = { 0 };
+    return kernels()->format_array(out, values, count, width, style != NULL ? style : &plain);
+}
+
+/**
+ * Parse exactly `width` binary digits
+ *
+ * @param in Digits, most significant first; need not be terminated
+ * @param width Number of digits, at most 32
+ * @param bits Set to the bit pattern on success
+ * @return false if any of the characters is not '0' or '1'
+ */
+bool bwt_parse_binary(const char* in, uint8_t width, uint32_t* bits) {
+    return kernels()->parse(in, width, bits);
+}
+
+/**
+ * Compare two arrays of values 32 lanes at a time
+ *
+ * Both arrays hold `blocks * 32` values of `width` bits, 8-, 16- or
+ * 32-bit elements according to the width, and must be 32-byte aligned.
+ *
+ * @param masks Receives one word per block, bit i set where lane i is equal
+ * @param keys Expected values
+ * @param answers Values to compare with them
+ * @param blocks Number of 32-lane blocks
+ * @param width Width of the values in bits (8, 16 or 32)
+ */
+void bwt_match_array(uint32_t* masks, const void* keys, const void* answers, size_t blocks, uint8_t width) {
+    kernels()->match(masks, keys, answers, blocks, width);
+}
+
+/* ---- Hex and octal: table driven, the same on every CPU ---- */
+
+// Two digits per entry, so a byte (hex) or six bits (octal) cost one copy
+static const char hex_pairs[512] =
+    "000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F"
+    "202122232425262728292A2B2C2D2E2F303132333435363738393A3B3C3D3E3F"
+    "404142434445464748494A4B4C4D4E4F505152535455565758595A5B5C5D5E5F"
+    "606162636465666768696A6B6C6D6E6F707172737475767778797A7B7C7D7E7F"
+    "808182838485868788898A8B8C8D8E8F909192939495969798999A9B9C9D9E9F"
+    "A0A1A2A3A4A5A6A7A8A9AAABACADAEAFB0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+    "C0C1C2C3C4C5C6C7C8C9CACBCCCDCECFD0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+    "E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEFF0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+
+static const char octal_pairs[128] =
+    "0001020304050607101112131415161720212223242526273031323334353637"
+    "4041424344454647505152535455565760616263646566677071727374757677";
+
+// Value + 1 of every hex digit, 0 for any other character
+static const uint8_t digit_values[256] = {
+    ['0'] = 1, ['1'] = 2, ['2'] = 3, ['3'] = 4, ['4'] = 5, ['5'] = 6, ['6'] = 7, ['7'] = 8,
+    ['8'] = 9, ['9'] = 10, ['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16,
+    ['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16,
+};
+
+/**
+ * Write the zero-padded hex digits of a bit pattern, without a prefix
+ *
+ * @param out Output buffer of at least (width + 3) / 4 + 1 bytes
+ * @param bits Bit pattern
+ * @param width Width in bits
+ */
+void bwt_format_hex(char* out, uint32_t bits, uint8_t width) {
+    int n = (width + 3) / 4;
+    out[n] = '\0';
+    for (; n >= 2; n -= 2, bits >>= 8) {
+        memcpy(out + n - 2, hex_pairs + 2 * (bits & 0xFF), 2);
+    }
+    if (n == 1) {
+        out[0] = hex_pairs[2 * (bits & 0xF) + 1];
+    }
+}
+
+/**
+ * Write the zero-padded octal digits of a bit pattern, without a prefix
+ *
+ * @param out Output buffer of at least (width + 2) / 3 + 1 bytes
+ * @param bits Bit pattern
+ * @param width Width in bits
+ */
+void bwt_format_octal(char* out, uint32_t bits, uint8_t width) {
+    uint32_t mask = width >= 32 ? UINT32_MAX : (UINT32_C(1) << width) - 1;
+    int n = (width + 2) / 3;
+    bits &= mask;
+    out[n] = '\0';
+    for (; n >= 2; n -= 2, bits >>= 6) {
+        memcpy(out + n - 2, octal_pairs + 2 * (bits & 0x3F), 2);
+    }
+    if (n == 1) {
+        out[0] = octal_pairs[2 * (bits & 0x7) + 1];
+    }
+}
+
+/**
+ * Parse hex or octal digits in one pass
+ *
+ * @param in Digits, most significant first; need not be terminated
+ * @param len Number of digits
+ * @param radix_bits 4 for hex, 3 for octal
+ * @param bits Set to the value on success
+ * @return false if a character is not a digit of the radix or the value
+ *         does not fit in 32 bits
+ */
+static bool parse_radix(const char* in, size_t len, unsigned radix_bits, uint32_t* bits) {
+    unsigned radix = 1u << radix_bits;
+    uint64_t value = 0;
+    if (len == 0) {
+        return false;
+    }
+    for (size_t i = 0; i < len; i++) {
+        unsigned digit = digit_values[(unsigned char)in[i]] - 1u;  // wraps for non-digits
+        if (digit >= radix || (value = value << radix_bits | digit) > UINT32_MAX) {
+            return false;
+        }
+    }
+    *bits = (uint32_t)value;
+    return true;
+}
+
+bool bwt_parse_hex(const char* in, size_t len, uint32_t* bits) {
+    return parse_radix(in, len, 4, bits);
+}
+
+bool bwt_parse_octal(const char* in, size_t len, uint32_t* bits) {
+    return parse_radix(in, len, 3, bits);
+}
@@ -0,0 +1,69 @@
+/*
+ * bwt_kernels.h - Binary, hex and octal string formatting and parsing
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * Turning a bit pattern into '0'/'1' characters and back is done by one
+ * of several kernels: a portable scalar loop, a BMI2 version that spreads
+ * and gathers eight bits at a time with pdep/pext, and an AVX2 version
+ * that handles all 32 bits in one vector with pshufb/movemask. bwt is
+ * built without target flags; the x86 kernels are compiled with GCC
+ * target attributes and the best one the CPU supports is picked at run
+ * time, on first use or with bwt_kernels_select() (`bwt --kernels NAME`).
+ * bwt_format_binary() in bwt_question.h goes through the selected kernel.
+ *
+ * Whole arrays (answer keys, transcripts) are formatted into one buffer
+ * by bwt_format_binary_array(), optionally with a separator between
+ * values and one between nibbles. The AVX2 kernel lays out a run of
+ * values once per call, as the source byte, bit or fixed char of every
+ * output position, and then expands up to 32 chars per pshufb from an
+ * 8-byte load, storing whole vectors that the next run overwrites.
+ *
+ * Answer sheets (bwt_sheet.h) are graded by bwt_match_array(), which
+ * compares two aligned arrays of 8-, 16- or 32-bit values 32 lanes at a
+ * time and returns a bit mask per 32 lanes; the AVX2 kernel packs the
+ * compare results of a block down to bytes and takes one movemask.
+ *
+ * Hex and octal digits are formatted two at a time from lookup tables and
+ * parsed in a single pass with a digit-value table, with no allocation.
+ */
+
+#ifndef BWT_KERNELS_H
+#define BWT_KERNELS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// How bwt_format_binary_array lays out its values
+struct bwt_binary_style {
+    char separator;  // between values, such as '\n'; '\0' for none
+    char group;      // between nibbles, such as '_'; '\0' for none
+};
+
+struct bwt_kernels {
+    const char* name;
+    void (*format)(char* out, uint32_t bits, uint8_t width);
+    bool (*parse)(const char* in, uint8_t width, uint32_t* bits);
+    size_t (*format_array)(char* out, const void* values, size_t count, uint8_t width,
+                           const struct bwt_binary_style* style);
+    void (*match)(uint32_t* masks, const void* keys, const void* answers, size_t blocks, uint8_t width);
+    bool (*supported)(void);
+};
+
+extern const struct bwt_kernels* const bwt_kernels_all[];  // NULL-terminated, best first
+
+int bwt_kernels_select(const char* name);
+const char* bwt_kernels_name(void);
+size_t bwt_binary_array_size(size_t count, uint8_t width, const struct bwt_binary_style* style);
+size_t bwt_format_binary_array(char* out, const void* values, size_t count, uint8_t width,
+                               const struct bwt_binary_style* style);
+void bwt_match_array(uint32_t* masks, const void* keys, const void* answers, size_t blocks, uint8_t width);
+bool bwt_parse_binary(const char* in, uint8_t width, uint32_t* bits);
+void bwt_format_hex(char* out, uint32_t bits, uint8_t width);
+void bwt_format_octal(char* out, uint32_t bits, uint8_t width);
+bool bwt_parse_hex(const char* in, size_t len, uint32_t* bits);
+bool bwt_parse_octal(const char* in, size_t len, uint32_t* bits);
+
+#endif // BWT_KERNELS_H
@@ -0,0 +1,290 @@
+/*
+ * bwt_metrics.c - Counters and Prometheus exposition for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "bwt_metrics.h"
+
+#define METRICS_INTERVAL_MS 10000  // how often --metrics FILE is rewritten
+
+_Thread_local struct bwt_metrics_shard* bwt_metrics_local = NULL;
+
+static _Atomic(struct bwt_metrics_shard*) shards = NULL;
+
+static const uint32_t latency_bounds_ms[BWT_LATENCY_BUCKETS - 1] = {
+    500, 1000, 2000, 5000, 10000, 20000, 30000, 60000
+};
+
+static struct {
+    const char* file;         // rewritten every METRICS_INTERVAL_MS, or NULL
+    const char* socket_path;  // local socket serving scrapes, or NULL
+    int listen_fd;
+    int stop_pipe[2];         // written to stop the exporter thread
+    pthread_t thread;
+    bool running;
+} exporter = { .listen_fd = -1, .stop_pipe = { -1, -1 } };
+
+/**
+ * Give the calling thread its shard
+ *
+ * @return The shard, or NULL if out of memory (the event is not counted)
+ */
+struct bwt_metrics_shard* bwt_metrics_register(void) {
+    struct bwt_metrics_shard* s = aligned_alloc(alignof(struct bwt_metrics_shard), sizeof(*s));
+    if (s == NULL) {
+        return NULL;
+    }
+    memset(s, 0, sizeof(*s));
+
+    s->next = atomic_load_explicit(&shards, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&shards, &s->next, s,
+                                                  memory_order_release, memory_order_relaxed)) {
+    }
+    bwt_metrics_local = s;
+    return s;
+}
+
+/**
+ * Count the time a learner took to answer a question correctly
+ *
+ * @param latency_us Time from question to answer
+ */
+void bwt_metric_observe_latency(uint64_t latency_us) {
+    struct bwt_metrics_shard* s = bwt_metrics_local;
+    if (s == NULL && (s = bwt_metrics_register()) == NULL) {
+        return;
+    }
+
+    int b = 0;
+    while (b < BWT_LATENCY_BUCKETS - 1 && latency_us > latency_bounds_ms[b] * UINT64_C(1000)) {
+        b++;
+    }
+    atomic_store_explicit(&s->latency[b],
+                          atomic_load_explicit(&s->latency[b], memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+    atomic_store_explicit(&s->latency_sum_us,
+                          atomic_load_explicit(&s->latency_sum_us, memory_order_relaxed) + latency_us,
+                          memory_order_relaxed);
+}
+
+/**
+ * Sum all shards and write them in the Prometheus text format
+ *
+ * @param out Stream to write to
+ */
+void bwt_metrics_write(FILE* out) {
+    uint64_t counters[BWT_METRIC_COUNT] = { 0 };
+    uint64_t latency[BWT_LATENCY_BUCKETS] = { 0 };
+    uint64_t latency_sum_us = 0;
+
+    for (struct bwt_metrics_shard* s = atomic_load_explicit(&shards, memory_order_acquire);
+         s != NULL; s = s->next) {
+        for (int m = 0; m < BWT_METRIC_COUNT; m++) {
+            counters[m] += atomic_load_explicit(&s->counters[m], memory_order_relaxed);
+        }
+        for (int b = 0; b < BWT_LATENCY_BUCKETS; b++) {
+            latency[b] += atomic_load_explicit(&s->latency[b], memory_order_relaxed);
+        }
+        latency_sum_us += atomic_load_explicit(&s->latency_sum_us, memory_order_relaxed);
+    }
+
+    fprintf(out, "# HELP bwt_questions_total Questions asked.\n"
+                 "# TYPE bwt_questions_total counter\n"
+                 "bwt_questions_total %llu\n",
+            (unsigned long long)counters[BWT_METRIC_QUESTIONS]);
+    fprintf(out, "# HELP bwt_answers_total Answers graded, by verdict.\n"
+                 "# TYPE bwt_answers_total counter\n"
+                 "bwt_answers_total{verdict=\"correct\"} %llu\n"
+                 "bwt_answers_total{verdict=\"wrong\"} %llu\n"
+                 "bwt_answers_total{verdict=\"invalid\"} %llu\n",
+            (unsigned long long)counters[BWT_METRIC_CORRECT],
+            (unsigned long long)counters[BWT_METRIC_WRONG],
+            (unsigned long long)counters[BWT_METRIC_INVALID]);
+    fprintf(out, "# HELP bwt_gave_up_total Questions given up.\n"
+                 "# TYPE bwt_gave_up_total counter\n"
+                 "bwt_gave_up_total %llu\n",
+            (unsigned long long)counters[BWT_METRIC_GAVE_UP]);
+
+    fprintf(out, "# HELP bwt_answer_latency_seconds Time to a correct answer.\n"
+                 "# TYPE bwt_answer_latency_seconds histogram\n");
+    uint64_t cumulative = 0;
+    for (int b = 0; b < BWT_LATENCY_BUCKETS - 1; b++) {
+        cumulative += latency[b];
+        fprintf(out, "bwt_answer_latency_seconds_bucket{le=\"%g\"} %llu\n",
+                latency_bounds_ms[b] / 1000.0, (unsigned long long)cumulative);
+    }
+    cumulative += latency[BWT_LATENCY_BUCKETS - 1];
+    fprintf(out, "bwt_answer_latency_seconds_bucket{le=\"+Inf\"} %llu\n"
+                 "bwt_answer_latency_seconds_sum %.6f\n"
+                 "bwt_answer_latency_seconds_count %llu\n",
+            (unsigned long long)cumulative, (double)latency_sum_us / 1e6, (unsigned long long)cumulative);
+}
+
+/**
+ * Replace the metrics file with the current values
+ */
+static void write_file(void) {
+    char tmp[4096];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", exporter.file);
+    FILE* f = fopen(tmp, "w");
+    if (f == NULL) {
+        return;
+    }
+    bwt_metrics_write(f);
+    if (fclose(f) == 0) {
+        rename(tmp, exporter.file);  // readers never see a half-written file
+    }
+}
+
+/**
+ * Answer one scrape on the local socket as HTTP/1.0
+ */
+static void serve_scrape(int fd) {
+    char request[1024];
+    char* body = NULL;
+    size_t len = 0;
+
+    // Take the request if it comes quickly; `nc -U` sends none
+    struct pollfd p = { .fd = fd, .events = POLLIN };
+    if (poll(&p, 1, 100) > 0) {
+        (void)!read(fd, request, sizeof(request));
+    }
+
+    FILE* out = open_memstream(&body, &len);
+    if (out != NULL) {
+        fprintf(out, "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\n\r\n");
+        bwt_metrics_write(out);
+        if (fclose(out) == 0) {
+            for (size_t sent = 0; sent < len;) {
+                ssize_t n = send(fd, body + sent, len - sent, MSG_NOSIGNAL);
+                if (n <= 0) {
+                    break;
+                }
+                sent += (size_t)n;
+            }
+        }
+        free(body);
+    }
+    close(fd);
+}
+
+static uint64_t monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+/**
+ * Serve scrapes and rewrite the metrics file on time; the file is due by
+ * the clock, so a steady stream of scrapes does not hold it back
+ */
+static void* exporter_main(void* arg) {
+    (void)arg;
+    struct pollfd fds[2] = {
+        { .fd = exporter.stop_pipe[0], .events = POLLIN },
+        { .fd = exporter.listen_fd, .events = POLLIN },
+    };
+    uint64_t due = monotonic_ms() + METRICS_INTERVAL_MS;
+
+    for (;;) {
+        int timeout = -1;
+        if (exporter.file != NULL) {
+            uint64_t now = monotonic_ms();
+            timeout = now < due ? (int)(due - now) : 0;
+        }
+        int n = poll(fds, exporter.listen_fd >= 0 ? 2 : 1, timeout);
+        if (n < 0 && errno != EINTR) {
+            break;
+        }
+        if (n > 0 && fds[0].revents) {
+            break;
+        }
+        if (n > 0 && (fds[1].revents & POLLIN)) {
+            int fd = accept(exporter.listen_fd, NULL, NULL);
+            if (fd >= 0) {
+                serve_scrape(fd);
+            }
+        }
+        if (exporter.file != NULL && monotonic_ms() >= due) {
+            write_file();
+            due = monotonic_ms() + METRICS_INTERVAL_MS;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Start exporting metrics from a background thread
+ *
+ * @param file File to rewrite every 10 seconds, or NULL
+ * @param socket_path Local (Unix domain) socket to serve scrapes on, or NULL
+ * @return 0 on success, -1 on error (errno is set)
+ */
+int bwt_metrics_start(const char* file, const char* socket_path) {
+    exporter.file = file;
+    exporter.socket_path = socket_path;
+
+    if (socket_path != NULL) {
+        struct sockaddr_un addr = { .sun_family = AF_UNIX };
+        if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+            errno = ENAMETOOLONG;
+            return -1;
+        }
+        strcpy(addr.sun_path, socket_path);
+        exporter.listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        unlink(socket_path);  // left over from an earlier run
+        if (exporter.listen_fd < 0
+            || bind(exporter.listen_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0
+            || listen(exporter.listen_fd, 16) < 0) {
+            return -1;
+        }
+    }
+    if (pipe(exporter.stop_pipe) < 0) {
+        return -1;
+    }
+    errno = pthread_create(&exporter.thread, NULL, exporter_main, NULL);
+    if (errno != 0) {
+        return -1;
+    }
+    exporter.running = true;
+    return 0;
+}
+
+/**
+ * Stop the exporter, writing the metrics file one last time
+ */
+void bwt_metrics_stop(void) {
+    if (!exporter.running) {
+        return;
+    }
+    (void)!write(exporter.stop_pipe[1], "", 1);
+    pthread_join(exporter.thread, NULL);
+    exporter.running = false;
+
+    if (exporter.file != NULL) {
+        write_file();
+    }
+    if (exporter.listen_fd >= 0) {
+        close(exporter.listen_fd);
+        unlink(exporter.socket_path);
+    }
+    close(exporter.stop_pipe[0]);
+    close(exporter.stop_pipe[1]);
+}
@@ -0,0 +1,72 @@
+/*
+ * bwt_metrics.h - Counters and Prometheus exposition for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * Every thread that counts something gets its own shard, aligned to a
+ * cache line and written only by that thread, so counting is a plain load
+ * and store with no locked instruction and no sharing between cores.
+ * Shards are registered once per thread and never freed. The exporter
+ * thread sums the shards only when metrics are scraped or written out.
+ */
+
+#ifndef BWT_METRICS_H
+#define BWT_METRICS_H
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+enum bwt_metric {
+    BWT_METRIC_QUESTIONS,  // questions asked
+    BWT_METRIC_CORRECT,    // answers graded correct
+    BWT_METRIC_WRONG,      // answers graded wrong
+    BWT_METRIC_INVALID,    // answers that were not a number of the right form
+    BWT_METRIC_GAVE_UP,    // questions given up with `?`
+    BWT_METRIC_COUNT
+};
+
+#define BWT_LATENCY_BUCKETS 9  // 0.5, 1, 2, 5, 10, 20, 30, 60 s and +Inf
+
+struct bwt_metrics_shard {
+    alignas(64) atomic_uint_least64_t counters[BWT_METRIC_COUNT];
+    atomic_uint_least64_t latency[BWT_LATENCY_BUCKETS];  // answer latency, not cumulative
+    atomic_uint_least64_t latency_sum_us;
+    struct bwt_metrics_shard* next;
+};
+
+extern _Thread_local struct bwt_metrics_shard* bwt_metrics_local;
+
+struct bwt_metrics_shard* bwt_metrics_register(void);
+void bwt_metric_observe_latency(uint64_t latency_us);
+void bwt_metrics_write(FILE* out);
+int bwt_metrics_start(const char* file, const char* socket_path);
+void bwt_metrics_stop(void);
+
+/**
+ * Add to a counter of the calling thread
+ *
+ * The thread is the only writer of its shard, so a relaxed load and store
+ * is enough; the exporter may read a value that is one event behind.
+ *
+ * @param m The counter
+ * @param n Amount to add
+ */
+static inline void bwt_metric_add(enum bwt_metric m, uint64_t n) {
+    struct bwt_metrics_shard* s = bwt_metrics_local;
+    if (s == NULL && (s = bwt_metrics_register()) == NULL) {
+        return;
+    }
+    atomic_store_explicit(&s->counters[m],
+                          atomic_load_explicit(&s->counters[m], memory_order_relaxed) + n,
+                          memory_order_relaxed);
+}
+
+static inline void bwt_metric_inc(enum bwt_metric m) {
+    bwt_metric_add(m, 1);
+}
+
+#endif // BWT_METRICS_H
@@ -0,0 +1,181 @@
+/*
+ * bwt_msgc.c - Message catalog compiler for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * Compiles a message source file into the binary catalog bwt maps at
+ * startup:
+ *
+ *   bwt_msgc msg/ko.msg bin/msg/ko.cat
+ *   bwt_msgc bin/msg/en.cat            (the built-in English messages)
+ *
+ * A source file has one `key = text` line per message, keys as in
+ * BWT_MESSAGES in bwt_catalog.h. Lines starting with # are comments.
+ * Escapes in the text: \n newline, \t tab, \s space (for leading spaces)
+ * and \\ backslash. Messages left out are shown in English.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "bwt_catalog.h"
+
+#define MSGC_LINE_SIZE 4096
+
+/**
+ * Highest argument number a template uses, -1 if none
+ */
+static int max_arg(const char* tmpl) {
+    int max = -1;
+    for (const char* p = tmpl; *p != '\0'; p++) {
+        if (p[0] == '{' && p[1] == '{') {
+            p++;
+        } else if (p[0] == '{' && p[1] >= '0' && p[1] <= '9' && p[2] == '}' && p[1] - '0' > max) {
+            max = p[1] - '0';
+        }
+    }
+    return max;
+}
+
+/**
+ * Decode the escapes of a message text in place
+ *
+ * @return false if the text has an unknown escape
+ */
+static bool unescape(char* text) {
+    char* out = text;
+    for (const char* p = text; *p != '\0'; p++) {
+        if (*p != '\\') {
+            *out++ = *p;
+            continue;
+        }
+        switch (*++p) {
+            case 'n': *out++ = '\n'; break;
+            case 't': *out++ = '\t'; break;
+            case 's': *out++ = ' '; break;
+            case '\\': *out++ = '\\'; break;
+            default: return false;
+        }
+    }
+    *out = '\0';
+    return true;
+}
+
+/**
+ * Read a message source file
+ *
+ * @param path Path of the source file
+ * @param templates Set to the translated templates, NULL for the rest
+ * @return 0 on success, -1 after printing an error
+ */
+static int read_source(const char* path, char* templates[BWT_MSG_COUNT]) {
+    FILE* in = fopen(path, "r");
+    char line[MSGC_LINE_SIZE];
+    int lineno = 0;
+    int status = 0;
+
+    if (in == NULL) {
+        perror(path);
+        return -1;
+    }
+    while (status == 0 && fgets(line, sizeof(line), in) != NULL) {
+        lineno++;
+        line[strcspn(line, "\r\n")] = '\0';
+        char* key = line + strspn(line, " \t");
+        if (*key == '\0' || *key == '#') {
+            continue;
+        }
+        char* eq = strchr(key, '=');
+        if (eq == NULL) {
+            fprintf(stderr, "%s:%d: expected `key = text`\n", path, lineno);
+            status = -1;
+            break;
+        }
+        char* text = eq + 1 + strspn(eq + 1, " \t");
+        do {
+            *eq-- = '\0';
+        } while (eq >= key && (*eq == ' ' || *eq == '\t'));
+
+        int id = 0;
+        while (id < BWT_MSG_COUNT && strcmp(bwt_msg_keys[id], key) != 0) {
+            id++;
+        }
+        if (id == BWT_MSG_COUNT) {
+            fprintf(stderr, "%s:%d: unknown message %s\n", path, lineno, key);
+            status = -1;
+        } else if (templates[id] != NULL) {
+            fprintf(stderr, "%s:%d: %s given twice\n", path, lineno, key);
+            status = -1;
+        } else if (!unescape(text)) {
+            fprintf(stderr, "%s:%d: unknown escape in %s\n", path, lineno, key);
+            status = -1;
+        } else if (max_arg(text) > max_arg(bwt_msg_english[id])) {
+            fprintf(stderr, "%s:%d: %s uses {%d}, but the message has only %d arguments\n",
+                    path, lineno, key, max_arg(text), max_arg(bwt_msg_english[id]) + 1);
+            status = -1;
+        } else if ((templates[id] = strdup(text)) == NULL) {
+            perror("strdup");
+            status = -1;
+        }
+    }
+    fclose(in);
+    return status;
+}
+
+/**
+ * Main function
+ */
+int main(int argc, char* argv[]) {
+    char* templates[BWT_MSG_COUNT] = { 0 };
+    const char* output = argv[argc - 1];
+    int status = 0;
+
+    if (argc != 2 && argc != 3) {
+        fprintf(stderr, "Usage: %s [SOURCE.msg] OUTPUT.cat\n", argv[0]);
+        return 1;
+    }
+    if (argc == 3) {
+        status = read_source(argv[1], templates);
+        int missing = 0;
+        for (int id = 0; id < BWT_MSG_COUNT; id++) {
+            missing += templates[id] == NULL && bwt_msg_english[id][0] != '\0';
+        }
+        if (status == 0 && missing > 0) {
+            fprintf(stderr, "%s: %d of %d messages not translated, English is shown for them\n",
+                    argv[1], missing, BWT_MSG_COUNT);
+        }
+    }
+
+    size_t size = 0;
+    void* image = NULL;
+    if (status == 0) {
+        image = bwt_catalog_build(argc == 3 ? (const char* const*)templates : bwt_msg_english, &size);
+        if (image == NULL) {
+            perror("bwt_catalog_build");
+            status = -1;
+        }
+    }
+    // Write a new file and rename it over the old one, so running bwt processes keep their mapping
+    if (status == 0) {
+        char tmp[MSGC_LINE_SIZE];
+        snprintf(tmp, sizeof(tmp), "%s.tmp", output);
+        FILE* out = fopen(tmp, "wb");
+        bool written = out != NULL && fwrite(image, 1, size, out) == size;
+        if (out != NULL && fclose(out) != 0) {
+            written = false;
+        }
+        if (!written || rename(tmp, output) < 0) {
+            perror(output);
+            status = -1;
+        }
+    }
+
+    free(image);
+    for (int id = 0; id < BWT_MSG_COUNT; id++) {
+        free(templates[id]);
+    }
+    return status == 0 ? 0 : 1;
+}
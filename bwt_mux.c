@@ -0,0 +1,342 @@
+/*
+ * bwt_mux.c - The menu quizzes for many learners in one thread
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ */
+
+#define _GNU_SOURCE  // fopencookie
+
+#include "bwt_mux.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "bwt_catalog.h"
+#include "bwt_coro.h"
+#include "bwt_net.h"
+#include "bwt_probe.h"
+
+#define MAX_UNSENT (64 * 1024)  // output a learner may leave unread before being dropped
+
+struct conn {
+    struct bwt_coro co;
+    int fd;
+    FILE* in;              // the session's stdin and stdout
+    FILE* out;
+    void* state;           // quiz state, from bwt_mux_learner.create
+    uint32_t seed;
+    bool eof;              // the learner closed the connection, or it failed
+    bool done;             // the session has ended
+    size_t in_len;
+    char* unsent;          // output the socket has not taken yet
+    size_t unsent_len;
+    size_t unsent_cap;
+    char input[512];       // received, not read by the session yet
+    char in_buf[256];      // stdio buffers of in and out
+    char out_buf[1024];
+};
+
+struct mux {
+    struct pollfd* fds;    // [0] listener, [1 + i] learner i
+    struct conn** conns;
+    size_t count;
+    size_t capacity;
+    bwt_session_fn run;
+    const struct bwt_mux_learner* learner;
+    size_t served;
+    size_t most;           // learners connected at once
+    size_t deepest;        // most stack a session touched, in bytes
+};
+
+static struct mux* running;  // the mux whose session functions run
+static volatile sig_atomic_t stopping = 0;
+
+static void on_stop_signal(int sig) {
+    (void)sig;
+    stopping = 1;
+}
+
+/**
+ * fopencookie read function of a session's stdin: wait for input by
+ * yielding to the poll loop
+ */
+static ssize_t conn_read(void* cookie, char* buf, size_t size) {
+    struct conn* c = cookie;
+
+    // The prompt is sent before waiting for the answer to it
+    fflush(c->out);
+    while (c->in_len == 0 && !c->eof) {
+        bwt_coro_yield();
+    }
+    size_t n = c->in_len < size ? c->in_len : size;
+    memcpy(buf, c->input, n);
+    memmove(c->input, c->input + n, c->in_len - n);
+    c->in_len -= n;
+    return (ssize_t)n;
+}
+
+/**
+ * Write as much unsent output as the socket takes
+ *
+ * @return 0 on success, -1 if the connection failed
+ */
+static int flush_unsent(struct conn* c) {
+    size_t sent = 0;
+    while (sent < c->unsent_len) {
+        ssize_t n = send(c->fd, c->unsent + sent, c->unsent_len - sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            return -1;
+        }
+        sent += (size_t)n;
+    }
+    BWT_PROBE2(flush, c->fd, sent);
+    memmove(c->unsent, c->unsent + sent, c->unsent_len - sent);
+    c->unsent_len -= sent;
+    return 0;
+}
+
+/**
+ * fopencookie write function of a session's stdout
+ */
+static ssize_t conn_write(void* cookie, const char* buf, size_t size) {
+    struct conn* c = cookie;
+
+    if (c->unsent_len + size > MAX_UNSENT) {
+        c->eof = true;  // the session sees end of input and ends
+        return -1;
+    }
+    if (c->unsent_len + size > c->unsent_cap) {
+        size_t cap = c->unsent_cap > 0 ? c->unsent_cap : 1024;
+        while (cap < c->unsent_len + size) {
+            cap *= 2;
+        }
+        char* grown = realloc(c->unsent, cap);
+        if (grown == NULL) {
+            c->eof = true;
+            return -1;
+        }
+        c->unsent = grown;
+        c->unsent_cap = cap;
+    }
+    memcpy(c->unsent + c->unsent_len, buf, size);
+    c->unsent_len += size;
+    if (flush_unsent(c) < 0) {
+        c->eof = true;
+        return -1;
+    }
+    return (ssize_t)size;
+}
+
+static void conn_main(void* arg) {
+    struct conn* c = arg;
+    running->run(c->seed);
+}
+
+/**
+ * Run a session until it waits for input or ends
+ */
+static void resume(struct mux* m, struct conn* c) {
+    FILE* saved_in = stdin;
+    FILE* saved_out = stdout;
+
+    if (c->done) {
+        return;
+    }
+    m->learner->enter(c->state);
+    stdin = c->in;
+    stdout = c->out;
+    if (!bwt_coro_resume(&c->co)) {
+        size_t used = bwt_coro_stack_resident(&c->co);
+        m->deepest = used > m->deepest ? used : m->deepest;
+        c->done = true;
+    }
+    fflush(c->out);
+    stdin = saved_in;
+    stdout = saved_out;
+}
+
+static void conn_free(struct mux* m, struct conn* c) {
+    if (c->in != NULL) {
+        fclose(c->in);
+    }
+    if (c->out != NULL) {
+        fclose(c->out);
+    }
+    if (c->state != NULL) {
+        m->learner->destroy(c->state);
+    }
+    bwt_coro_free(&c->co);
+    close(c->fd);
+    free(c->unsent);
+    free(c);
+}
+
+/**
+ * Set up a session for a new connection and run it to its first prompt
+ *
+ * @return 0 on success, -1 if out of memory (the connection is closed)
+ */
+static int add_learner(struct mux* m, int fd) {
+    cookie_io_functions_t io = { .read = conn_read, .write = conn_write };
+    struct conn* c = calloc(1, sizeof(*c));
+
+    if (c == NULL) {
+        close(fd);
+        return -1;
+    }
+    c->fd = fd;
+    c->seed = (uint32_t)time(NULL) ^ (uint32_t)(m->served * 2654435761u);
+    if (m->count == m->capacity) {
+        size_t cap = m->capacity > 0 ? m->capacity * 2 : 64;
+        struct pollfd* fds = realloc(m->fds, (cap + 1) * sizeof(*fds));
+        if (fds != NULL) {
+            m->fds = fds;
+        }
+        struct conn** conns = fds != NULL ? realloc(m->conns, cap * sizeof(*conns)) : NULL;
+        if (conns == NULL) {
+            conn_free(m, c);
+            return -1;
+        }
+        m->conns = conns;
+        m->capacity = cap;
+    }
+    // A learner id of its own, so connections do not share an answer history
+    c->state = m->learner->create(BWT_MUX_LEARNER_ID | (c->seed * 2654435761u));
+    c->in = fopencookie(c, "r", io);
+    c->out = fopencookie(c, "w", io);
+    if (c->state == NULL || c->in == NULL || c->out == NULL || bwt_coro_init(&c->co, 0, conn_main, c) < 0) {
+        conn_free(m, c);
+        return -1;
+    }
+    setvbuf(c->in, c->in_buf, _IOFBF, sizeof(c->in_buf));
+    setvbuf(c->out, c->out_buf, _IOFBF, sizeof(c->out_buf));
+
+    m->fds[1 + m->count] = (struct pollfd){ .fd = fd };
+    m->conns[m->count++] = c;
+    m->served++;
+    m->most = m->count > m->most ? m->count : m->most;
+    resume(m, c);
+    return 0;
+}
+
+/**
+ * Read what a learner sent and let the session take it
+ */
+static void serve_input(struct mux* m, struct conn* c) {
+    ssize_t n = recv(c->fd, c->input + c->in_len, sizeof(c->input) - c->in_len, 0);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        return;
+    }
+    if (n <= 0) {
+        c->eof = true;
+    } else {
+        c->in_len += (size_t)n;
+    }
+    resume(m, c);
+}
+
+/**
+ * Serve the menu session to every learner connecting to a port, in one thread
+ *
+ * @param port TCP port to listen on
+ * @param run The session, run once per connection on its stdin and stdout
+ * @param learner Creates and switches the quiz state of each session
+ * @return Exit status for main
+ */
+int bwt_mux_main(uint16_t port, bwt_session_fn run, const struct bwt_mux_learner* learner) {
+    struct mux m = { .run = run, .learner = learner };
+    struct sigaction sa = { .sa_handler = on_stop_signal };
+
+    int listener = bwt_listen_tcp(port, false);
+    if (listener < 0) {
+        perror("listen");
+        return 1;
+    }
+    m.fds = malloc(sizeof(*m.fds));
+    if (m.fds == NULL) {
+        close(listener);
+        return 1;
+    }
+    m.fds[0] = (struct pollfd){ .fd = listener, .events = POLLIN };
+    running = &m;
+
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+    bwt_raise_fd_limit();
+    char port_dec[BWT_MSG_INT_SIZE];
+    BWT_MSG_PRINT(MSG_MUX_LISTENING, bwt_msg_int(port_dec, port));
+    fflush(stdout);
+
+    while (!stopping) {
+        for (size_t i = 0; i < m.count; i++) {
+            const struct conn* c = m.conns[i];
+            m.fds[1 + i].events = (short)((c->in_len < sizeof(c->input) && !c->eof ? POLLIN : 0)
+                                          | (c->unsent_len > 0 ? POLLOUT : 0));
+            m.fds[1 + i].revents = 0;
+        }
+        if (poll(m.fds, 1 + m.count, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("poll");
+            break;
+        }
+
+        if (m.fds[0].revents & POLLIN) {
+            int fd;
+            while ((fd = accept(listener, NULL, NULL)) >= 0) {
+                if (bwt_set_nonblocking(fd) < 0 || add_learner(&m, fd) < 0) {
+                    fprintf(stderr, "Could not start a session for a learner\n");
+                }
+            }
+        }
+
+        for (size_t i = 0; i < m.count;) {
+            struct conn* c = m.conns[i];
+            short revents = m.fds[1 + i].revents;
+            if (revents & (POLLIN | POLLHUP | POLLERR)) {
+                serve_input(&m, c);
+            }
+            if ((revents & POLLOUT) && flush_unsent(c) < 0) {
+                c->eof = true;
+                resume(&m, c);
+            }
+            // A session ends once its output is sent, or cannot be
+            if (c->done && (c->unsent_len == 0 || c->eof)) {
+                conn_free(&m, c);
+                m.conns[i] = m.conns[--m.count];
+                m.fds[1 + i] = m.fds[1 + m.count];
+                continue;
+            }
+            i++;
+        }
+    }
+
+    // Sessions still waiting for a learner are dropped where they stand
+    for (size_t i = 0; i < m.count; i++) {
+        conn_free(&m, m.conns[i]);
+    }
+    char served[BWT_MSG_INT_SIZE], most[BWT_MSG_INT_SIZE], stack_kb[BWT_MSG_INT_SIZE];
+    bwt_msg_print(stderr, MSG_MUX_SUMMARY, BWT_MSG_ARGS(bwt_msg_int(served, (long long)m.served),
+                                                        bwt_msg_int(most, (long long)m.most),
+                                                        bwt_msg_int(stack_kb, (long long)(m.deepest / 1024))));
+    close(listener);
+    running = NULL;
+    free(m.fds);
+    free(m.conns);
+    return 0;
+}
@@ -0,0 +1,42 @@
+/*
+ * bwt_mux.h - The menu quizzes for many learners in one thread
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * `bwt --serve-menu PORT` runs the menu session, the same code as at a
+ * terminal, for every learner who connects to PORT, all in one thread.
+ * Each connection gets a coroutine (see bwt_coro.h) and a stdin and
+ * stdout of its own, fopencookie streams over the socket. When the quiz
+ * code reads and no line has arrived yet, the read function yields to a
+ * poll loop, which resumes the coroutine once the learner's next input is
+ * there, with stdin, stdout and the learner's quiz state switched to it.
+ * Output is written straight to the non-blocking socket, and kept until
+ * the socket takes it when the learner reads slowly.
+ *
+ * The quiz code is unchanged: its blocking fgets and scanf calls block
+ * only their own coroutine. A learner costs a few KB of stack, its stdio
+ * buffers and its quiz state.
+ */
+
+#ifndef BWT_MUX_H
+#define BWT_MUX_H
+
+#include <stdint.h>
+
+#include "bwt_replay.h"
+
+// Set in the learner ids of connections, which are anonymous, so they are
+// not taken for the uid or --learner id of someone at a terminal
+#define BWT_MUX_LEARNER_ID 0x80000000u
+
+// The quiz state of a learner, created for each connection
+struct bwt_mux_learner {
+    void* (*create)(uint32_t id); // NULL if out of memory
+    void (*enter)(void* state);   // make it the state the quiz code uses
+    void (*destroy)(void* state);
+};
+
+int bwt_mux_main(uint16_t port, bwt_session_fn run, const struct bwt_mux_learner* learner);
+
+#endif // BWT_MUX_H
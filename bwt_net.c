@@ -0,0 +1,160 @@
+/*
+ * bwt_net.c - Sockets and shared buffers for bitwise-tutor's network modes
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ */
+
+#define _DEFAULT_SOURCE  // SO_REUSEPORT
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+
+#include "bwt_net.h"
+
+#define LISTEN_BACKLOG 1024
+
+/**
+ * Allocate a shared buffer with one reference
+ *
+ * @param capacity Bytes of data the buffer can hold
+ * @return The buffer, or NULL if out of memory
+ */
+struct bwt_rcbuf* bwt_rcbuf_new(size_t capacity) {
+    struct bwt_rcbuf* buf = malloc(sizeof(*buf) + capacity);
+    if (buf == NULL) {
+        return NULL;
+    }
+    buf->refs = 1;
+    buf->len = 0;
+    return buf;
+}
+
+/**
+ * Take another reference to a shared buffer
+ *
+ * @param buf The buffer
+ * @return The same buffer
+ */
+struct bwt_rcbuf* bwt_rcbuf_ref(struct bwt_rcbuf* buf) {
+    buf->refs++;
+    return buf;
+}
+
+/**
+ * Drop a reference to a shared buffer, freeing it with the last one
+ *
+ * @param buf The buffer, or NULL
+ */
+void bwt_rcbuf_unref(struct bwt_rcbuf* buf) {
+    if (buf != NULL && --buf->refs == 0) {
+        free(buf);
+    }
+}
+
+/**
+ * Feed received bytes to a line reader until a line is complete
+ *
+ * Call repeatedly with the unconsumed rest of the data. When a line is
+ * complete it is in r->line, NUL-terminated and without "\r\n", and stays
+ * there until the next call.
+ *
+ * @param r The line reader
+ * @param data Received bytes
+ * @param n Number of bytes
+ * @param complete Set to true if a line was completed
+ * @return Number of bytes consumed
+ */
+size_t bwt_line_feed(struct bwt_line_reader* r, const char* data, size_t n, bool* complete) {
+    *complete = false;
+    for (size_t k = 0; k < n; k++) {
+        if (data[k] == '\n') {
+            bool keep = !r->discarding;
+            if (r->len > 0 && r->line[r->len - 1] == '\r') {
+                r->len--;
+            }
+            r->line[r->len] = '\0';
+            r->len = 0;
+            r->discarding = false;
+            if (keep) {
+                *complete = true;
+                return k + 1;
+            }
+        } else if (r->len < BWT_LINE_SIZE - 1) {
+            r->line[r->len++] = data[k];
+        } else {
+            r->discarding = true;
+        }
+    }
+    return n;
+}
+
+/**
+ * Make a file descriptor non-blocking
+ *
+ * @param fd File descriptor
+ * @return 0 on success, -1 on error
+ */
+int bwt_set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL);
+    if (flags < 0) {
+        return -1;
+    }
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+/**
+ * Open a non-blocking TCP socket listening on all addresses
+ *
+ * @param port Port to listen on
+ * @param reuseport true to let several processes listen on the same port,
+ *                  with the kernel spreading connections between them
+ * @return The listening socket, or -1 on error (errno is set)
+ */
+int bwt_listen_tcp(uint16_t port, bool reuseport) {
+    int fd = socket(AF_INET6, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    int on = 1;
+    int off = 0;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &off, sizeof(off));  // IPv4 too
+    if (reuseport && setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    struct sockaddr_in6 addr = {
+        .sin6_family = AF_INET6,
+        .sin6_port = htons(port),
+        .sin6_addr = IN6ADDR_ANY_INIT,
+    };
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0
+        || listen(fd, LISTEN_BACKLOG) < 0
+        || bwt_set_nonblocking(fd) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * Raise the soft limit on open files to the hard limit, so that a server
+ * can hold thousands of connections
+ */
+void bwt_raise_fd_limit(void) {
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+}
@@ -0,0 +1,42 @@
+/*
+ * bwt_net.h - Sockets and shared buffers for bitwise-tutor's network modes
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ */
+
+#ifndef BWT_NET_H
+#define BWT_NET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Immutable, reference-counted buffer: rendered once, then sent to any
+// number of connections without copying. Only used from one thread.
+struct bwt_rcbuf {
+    unsigned refs;
+    size_t len;
+    char data[];
+};
+
+struct bwt_rcbuf* bwt_rcbuf_new(size_t capacity);
+struct bwt_rcbuf* bwt_rcbuf_ref(struct bwt_rcbuf* buf);
+void bwt_rcbuf_unref(struct bwt_rcbuf* buf);
+
+#define BWT_LINE_SIZE 64  // longest answer line kept; 32 binary digits plus room
+
+// Splits what a connection sends into lines, skipping lines that are too long
+struct bwt_line_reader {
+    uint16_t len;
+    bool discarding;  // skipping the rest of an over-long line
+    char line[BWT_LINE_SIZE];
+};
+
+size_t bwt_line_feed(struct bwt_line_reader* r, const char* data, size_t n, bool* complete);
+
+int bwt_listen_tcp(uint16_t port, bool reuseport);
+int bwt_set_nonblocking(int fd);
+void bwt_raise_fd_limit(void);
+
+#endif // BWT_NET_H
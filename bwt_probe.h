@@ -0,0 +1,68 @@
+/*
+ * bwt_probe.h - Static tracepoints for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * USDT probes of provider `bwt` along the path of a question through a
+ * libbwt session (--serve and embedders) or adaptive practice in the
+ * menu, so a running bwt can be traced with bpftrace or perf without a
+ * rebuild:
+ *
+ *   bpftrace -e 'usdt:./bin/bwt:bwt:grade { @us[arg0] = hist(arg4); }' -p PID
+ *
+ *   question(topic, width, pattern, number)  a question was generated
+ *   input(session, len)                      bytes a learner sent
+ *   parse(topic, format, valid, bits)        an answer was parsed
+ *   grade(topic, width, verdict, attempts, latency_us)
+ *                                            an answer was graded
+ *   flush(fd, bytes)                         replies were sent (--serve,
+ *                                            --serve-menu, --protocol)
+ *   session_end(session, questions, duration_us)
+ *
+ * Verdicts are enum bwt_verdict; session is the address of the session
+ * (0 in the menu). With <sys/sdt.h> (systemtap-sdt-dev) each probe is a
+ * single nop plus an ELF note telling tracers where it is and where its
+ * arguments live; its arguments are values the code has at hand anyway.
+ * An argument that costs something to compute is computed only under
+ * BWT_PROBE_ENABLED(name), which reads the probe's semaphore: tracers
+ * count themselves in it while attached. Without the header, or with
+ * -DBWT_NO_PROBES, the probes compile to nothing, their arguments are not
+ * evaluated and BWT_PROBE_ENABLED is constant false.
+ */
+
+#ifndef BWT_PROBE_H
+#define BWT_PROBE_H
+
+#if !defined(BWT_NO_PROBES) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#define _SDT_HAS_SEMAPHORES 1
+#include <sys/sdt.h>
+#define BWT_PROBES 1
+#endif
+#endif
+
+#ifdef BWT_PROBES
+#define BWT_PROBE2(name, a, b) DTRACE_PROBE2(bwt, name, a, b)
+#define BWT_PROBE3(name, a, b, c) DTRACE_PROBE3(bwt, name, a, b, c)
+#define BWT_PROBE4(name, a, b, c, d) DTRACE_PROBE4(bwt, name, a, b, c, d)
+#define BWT_PROBE5(name, a, b, c, d, e) DTRACE_PROBE5(bwt, name, a, b, c, d, e)
+#define BWT_PROBE_ENABLED(name) __builtin_expect(*(volatile unsigned short*)&bwt_##name##_semaphore != 0, 0)
+
+// Semaphores of the probes, defined in libbwt.c
+#define BWT_PROBE_SEMAPHORE(name) unsigned short bwt_##name##_semaphore
+extern BWT_PROBE_SEMAPHORE(question);
+extern BWT_PROBE_SEMAPHORE(input);
+extern BWT_PROBE_SEMAPHORE(parse);
+extern BWT_PROBE_SEMAPHORE(grade);
+extern BWT_PROBE_SEMAPHORE(flush);
+extern BWT_PROBE_SEMAPHORE(session_end);
+#else
+#define BWT_PROBE2(name, a, b) ((void)sizeof(a), (void)sizeof(b))
+#define BWT_PROBE3(name, a, b, c) (BWT_PROBE2(name, a, b), (void)sizeof(c))
+#define BWT_PROBE4(name, a, b, c, d) (BWT_PROBE3(name, a, b, c), (void)sizeof(d))
+#define BWT_PROBE5(name, a, b, c, d, e) (BWT_PROBE4(name, a, b, c, d), (void)sizeof(e))
+#define BWT_PROBE_ENABLED(name) 0
+#endif
+
+#endif // BWT_PROBE_H
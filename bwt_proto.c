@@ -0,0 +1,430 @@
+/*
+ * bwt_proto.c - JSON-lines protocol for driving bitwise-tutor from programs
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bwt_proto.h"
+#include "bwt_feedback.h"
+#include "bwt_metrics.h"
+#include "bwt_probe.h"
+#include "bwt_question.h"
+#include "bwt_settings.h"
+
+#define READ_BUFFER_SIZE (BWT_PROTO_LINE_SIZE * 8)
+#define REPLY_SIZE 256  // longer than any reply
+
+struct open_question {
+    uint32_t id;  // 0 while the slot is free
+    uint16_t bucket;
+    uint32_t attempts;
+    uint64_t asked_us;
+    struct bwt_question q;
+    struct bwt_record rec;
+};
+
+struct proto {
+    struct bwt_sched* sched;
+    struct bwt_coverage* coverage;
+    struct bwt_appender* results;
+    uint32_t learner;
+    uint32_t session;
+    int settings_watch;
+    const struct bwt_settings* settings;  // snapshot questions are drawn from
+    int window;
+    uint32_t next_id;
+    struct open_question open[BWT_PROTO_MAX_WINDOW];
+};
+
+// One input line, with strings pointing into the line itself
+struct message {
+    bool has_id;
+    uint32_t id;
+    const char* answer;  // NUL-terminated once parsed, NULL if absent
+    bool give_up;
+    bool quit;
+};
+
+static uint64_t now_us(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static size_t unflushed;  // bytes emitted since stdout was last flushed
+
+static void emit(const char* buf, int len) {
+    unflushed += fwrite(buf, 1, len < REPLY_SIZE ? (size_t)len : REPLY_SIZE - 1, stdout);
+}
+
+/**
+ * Send the replies emitted so far, and write out the results behind them
+ */
+static void flush_replies(struct proto* p) {
+    fflush(stdout);
+    BWT_PROBE2(flush, STDOUT_FILENO, unflushed);
+    unflushed = 0;
+    if (p->results != NULL && p->results->fd >= 0 && bwt_appender_flush(p->results) < 0) {
+        perror("Could not write results");
+    }
+}
+
+static void emit_error(uint32_t id, const char* message) {
+    char buf[REPLY_SIZE];
+    int len = id ? snprintf(buf, sizeof(buf), "{\"type\":\"error\",\"id\":%u,\"message\":\"%s\"}\n", id, message)
+                 : snprintf(buf, sizeof(buf), "{\"type\":\"error\",\"message\":\"%s\"}\n", message);
+    emit(buf, len);
+}
+
+/**
+ * Draw a new question into a free slot and send it
+ */
+static void ask(struct proto* p, struct open_question* oq) {
+    uint8_t topic, width, pattern;
+    bool is_signed;
+    char buf[REPLY_SIZE];
+    const struct bwt_question* q = &oq->q;
+
+    bwt_settings_refresh(p->settings_watch, &p->settings);
+    oq->bucket = bwt_sched_select(p->sched);
+    bwt_sched_decode(oq->bucket, &topic, &width, &is_signed, &pattern);
+    bwt_coverage_generate(p->coverage, &oq->q, topic, width, is_signed, pattern);
+    oq->id = ++p->next_id;
+    oq->attempts = 0;
+    oq->rec = (struct bwt_record){
+        .timestamp_us = now_us(CLOCK_REALTIME),
+        .learner = p->learner,
+        .session = p->session,
+        .a = q->a,
+        .b = q->b,
+        .expected = q->expected,
+        .topic = q->topic,
+        .width = q->width,
+        .flags = (q->is_signed ? BWT_RECORD_SIGNED : 0) | BWT_RECORD_FORMAT(q->format),
+    };
+
+    int len = snprintf(buf, sizeof(buf), "{\"type\":\"question\",\"id\":%u,\"topic\":\"%s\",\"width\":%u,\"signed\":%s",
+                       oq->id, bwt_topic_name(q->topic), q->width, q->is_signed ? "true" : "false");
+    if (q->topic == BWT_TOPIC_BIN2DEC || q->topic == BWT_TOPIC_BIN2HEX || q->topic == BWT_TOPIC_HEX2BIN) {
+        // The operand is given as the quiz shows it: binary, 0x hex or 0 octal
+        char given[BWT_ANSWER_SIZE];
+        uint8_t format = q->topic == BWT_TOPIC_BIN2DEC ? q->format
+            : (q->topic == BWT_TOPIC_BIN2HEX ? BWT_FORMAT_BINARY : BWT_FORMAT_HEX);
+        bwt_format_value(given, sizeof(given), q->a, q->width, q->is_signed, format);
+        len += snprintf(buf + len, sizeof(buf) - (size_t)len, ",\"a\":\"%s\"", given);
+    } else {
+        len += snprintf(buf + len, sizeof(buf) - (size_t)len, ",\"a\":%lld",
+                        (long long)bwt_value(q->a, q->width, q->is_signed));
+    }
+    if (bwt_topic_is_binary_op(q->topic)) {
+        len += snprintf(buf + len, sizeof(buf) - (size_t)len, ",\"b\":%lld",
+                        (long long)bwt_value(q->b, q->width, q->is_signed));
+    } else if (q->topic == BWT_TOPIC_SHL || q->topic == BWT_TOPIC_SHR) {
+        len += snprintf(buf + len, sizeof(buf) - (size_t)len, ",\"b\":%u", q->b);
+    }
+    uint8_t format = bwt_question_answer_format(q);
+    if (format == BWT_FORMAT_DECIMAL) {
+        len += snprintf(buf + len, sizeof(buf) - (size_t)len, ",\"format\":\"decimal\"}\n");
+    } else {
+        len += snprintf(buf + len, sizeof(buf) - (size_t)len, ",\"format\":\"%s\",\"digits\":%u}\n",
+                        bwt_format_name(format), bwt_format_digits(format, q->width));
+    }
+    emit(buf, len);
+    bwt_metric_inc(BWT_METRIC_QUESTIONS);
+    oq->asked_us = now_us(CLOCK_MONOTONIC);
+}
+
+/**
+ * Close a question that was answered correctly or given up, then ask another
+ */
+static void resolve(struct proto* p, struct open_question* oq, bool correct) {
+    uint64_t latency = now_us(CLOCK_MONOTONIC) - oq->asked_us;
+
+    bwt_sched_update(p->sched, oq->bucket, correct, oq->attempts);
+    if (p->results != NULL && p->results->fd >= 0) {
+        oq->rec.latency_us = latency < UINT32_MAX ? (uint32_t)latency : UINT32_MAX;
+        oq->rec.attempts = oq->attempts < UINT8_MAX ? (uint8_t)oq->attempts : UINT8_MAX;
+        oq->rec.flags |= correct ? BWT_RECORD_CORRECT : BWT_RECORD_GAVE_UP;
+        if (bwt_appender_append(p->results, &oq->rec) < 0) {
+            perror("Could not write results");
+        }
+    }
+    if (correct) {
+        bwt_metric_observe_latency(latency);
+    }
+    ask(p, oq);
+}
+
+static const char* skip_ws(const char* s) {
+    while (*s == ' ' || *s == '\t' || *s == '\r') {
+        s++;
+    }
+    return s;
+}
+
+/**
+ * Parse one flat JSON object in place
+ *
+ * Only what the protocol needs is supported: string, number and literal
+ * values, with no escapes in strings. Unknown keys are skipped.
+ *
+ * @param line The line, modified to terminate the answer string
+ * @param m Receives the message
+ * @return NULL on success, else a description of the error
+ */
+static const char* parse_message(char* line, struct message* m) {
+    char* answer_end = NULL;
+    const char* s = skip_ws(line);
+
+    memset(m, 0, sizeof(*m));
+    if (*s++ != '{') {
+        return "expected a JSON object";
+    }
+    s = skip_ws(s);
+    bool done = *s == '}';
+    if (done) {
+        s = skip_ws(s + 1);
+    }
+    while (!done) {
+        // Key
+        if (*s++ != '"') {
+            return "expected a key";
+        }
+        const char* key = s;
+        while (*s != '"' && *s != '\\' && *s != '\0') {
+            s++;
+        }
+        if (*s != '"') {
+            return "unsupported or unterminated key";
+        }
+        size_t key_len = (size_t)(s - key);
+        s = skip_ws(s + 1);
+        if (*s++ != ':') {
+            return "expected ':'";
+        }
+        s = skip_ws(s);
+
+        // Value
+        const char* value = s;
+        size_t value_len;
+        bool is_string = *s == '"';
+        if (is_string) {
+            value = ++s;
+            while (*s != '"' && *s != '\\' && *s != '\0') {
+                s++;
+            }
+            if (*s != '"') {
+                return "unsupported or unterminated string";
+            }
+            value_len = (size_t)(s - value);
+            s++;
+        } else {
+            while ((*s >= '0' && *s <= '9') || (*s >= 'a' && *s <= 'z') || *s == '-' || *s == '+' || *s == '.') {
+                s++;
+            }
+            value_len = (size_t)(s - value);
+            if (value_len == 0) {
+                return "unsupported value";
+            }
+        }
+
+        if (key_len == 2 && memcmp(key, "id", 2) == 0) {
+            char* end;
+            unsigned long id = strtoul(value, &end, 10);
+            if (is_string || end != value + value_len || value[0] == '-' || id == 0 || id > UINT32_MAX) {
+                return "\\\"id\\\" must be a question id";
+            }
+            m->has_id = true;
+            m->id = (uint32_t)id;
+        } else if (key_len == 6 && memcmp(key, "answer", 6) == 0) {
+            m->answer = value;
+            answer_end = (char*)value + value_len;
+        } else if (key_len == 7 && memcmp(key, "give_up", 7) == 0) {
+            m->give_up = !is_string && value_len == 4 && memcmp(value, "true", 4) == 0;
+        } else if (key_len == 4 && memcmp(key, "quit", 4) == 0) {
+            m->quit = !is_string && value_len == 4 && memcmp(value, "true", 4) == 0;
+        }
+
+        s = skip_ws(s);
+        if (*s != ',' && *s != '}') {
+            return "expected ',' or '}'";
+        }
+        done = *s == '}';
+        s = skip_ws(s + 1);
+    }
+    if (*s != '\0') {
+        return "trailing characters after the object";
+    }
+    if (answer_end != NULL) {
+        *answer_end = '\0';  // safe now that the whole line has been read
+    }
+    return NULL;
+}
+
+/**
+ * Handle one input line
+ *
+ * @return false when the front end asked to quit
+ */
+static bool handle_line(struct proto* p, char* line) {
+    struct message m;
+    char buf[REPLY_SIZE];
+    const char* error = parse_message(line, &m);
+
+    if (error != NULL) {
+        emit_error(0, error);
+        return true;
+    }
+    if (m.quit) {
+        return false;
+    }
+    if (!m.has_id) {
+        emit_error(0, "missing \\\"id\\\"");
+        return true;
+    }
+
+    struct open_question* oq = NULL;
+    for (int i = 0; i < p->window; i++) {
+        if (p->open[i].id == m.id) {
+            oq = &p->open[i];
+            break;
+        }
+    }
+    if (oq == NULL) {
+        emit_error(m.id, "unknown or closed question id");
+        return true;
+    }
+    const struct bwt_question* q = &oq->q;
+
+    if (m.give_up) {
+        char expected[BWT_ANSWER_SIZE];
+        bwt_question_format_answer(q, q->expected, expected, sizeof(expected));
+        emit(buf, snprintf(buf, sizeof(buf), "{\"type\":\"result\",\"id\":%u,\"verdict\":\"gave_up\",\"expected\":\"%s\"}\n",
+                           oq->id, expected));
+        bwt_metric_inc(BWT_METRIC_GAVE_UP);
+        resolve(p, oq, false);
+        return true;
+    }
+    if (m.answer == NULL) {
+        emit_error(m.id, "missing \\\"answer\\\"");
+        return true;
+    }
+
+    uint32_t bits;
+    enum bwt_verdict verdict = bwt_question_grade(q, m.answer, &bits);
+    if (verdict != BWT_VERDICT_INVALID && oq->attempts++ == 0) {
+        oq->rec.first_answer = bits;
+    }
+    switch (verdict) {
+        case BWT_VERDICT_CORRECT:
+            bwt_metric_inc(BWT_METRIC_CORRECT);
+            emit(buf, snprintf(buf, sizeof(buf), "{\"type\":\"result\",\"id\":%u,\"verdict\":\"correct\",\"attempts\":%u}\n",
+                               oq->id, oq->attempts));
+            resolve(p, oq, true);
+            break;
+        case BWT_VERDICT_WRONG: {
+            struct bwt_feedback fb;
+            bwt_metric_inc(BWT_METRIC_WRONG);
+            bwt_feedback_analyze(q, bits, &fb);
+            emit(buf, snprintf(buf, sizeof(buf),
+                               "{\"type\":\"result\",\"id\":%u,\"verdict\":\"wrong\",\"wrong_bits\":%u,\"mistake\":\"%s\"}\n",
+                               oq->id, fb.wrong_bits, bwt_mistake_name(fb.mistake)));
+            break;
+        }
+        default:
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            emit(buf, snprintf(buf, sizeof(buf), "{\"type\":\"result\",\"id\":%u,\"verdict\":\"invalid\"}\n", oq->id));
+    }
+    return true;
+}
+
+/**
+ * Serve the JSON-lines protocol on stdin and stdout until end of input
+ *
+ * @param window Number of questions open at once
+ * @param sched The learner's scheduler state
+ * @param coverage The learner's operand coverage
+ * @param results Results file to append to, or NULL
+ * @param learner Learner id for results
+ * @param session Session id for results
+ * @param settings_watch Descriptor from bwt_settings_watch, or -1
+ * @return Exit status for main
+ */
+int bwt_proto_run(int window, struct bwt_sched* sched, struct bwt_coverage* coverage, struct bwt_appender* results,
+                  uint32_t learner, uint32_t session, int settings_watch) {
+    static struct proto p;
+    static char in[READ_BUFFER_SIZE];
+    size_t start = 0;
+    size_t end = 0;
+    bool discarding = false;  // inside a line that was too long
+
+    if (window < 1 || window > BWT_PROTO_MAX_WINDOW) {
+        fprintf(stderr, "--window must be between 1 and %d\n", BWT_PROTO_MAX_WINDOW);
+        return 1;
+    }
+    p = (struct proto){ .sched = sched, .coverage = coverage, .results = results, .learner = learner,
+                        .session = session, .settings_watch = settings_watch, .window = window };
+
+    char hello[64];
+    emit(hello, snprintf(hello, sizeof(hello), "{\"type\":\"hello\",\"protocol\":%d,\"window\":%d}\n",
+                         BWT_PROTO_VERSION, window));
+    for (int i = 0; i < window; i++) {
+        ask(&p, &p.open[i]);
+    }
+
+    for (;;) {
+        char* nl = memchr(in + start, '\n', end - start);
+        if (nl != NULL) {
+            size_t len = (size_t)(nl - (in + start));
+            *nl = '\0';
+            if (discarding || len >= BWT_PROTO_LINE_SIZE) {
+                if (!discarding) {
+                    emit_error(0, "line too long");
+                }
+                discarding = false;
+            } else if (len > 0 && !handle_line(&p, in + start)) {
+                break;
+            }
+            start += len + 1;
+            continue;
+        }
+
+        // No complete line left: keep the partial one and read more
+        if (end - start >= BWT_PROTO_LINE_SIZE) {
+            if (!discarding) {
+                emit_error(0, "line too long");
+            }
+            discarding = true;
+            start = end;
+        }
+        memmove(in, in + start, end - start);
+        end -= start;
+        start = 0;
+
+        flush_replies(&p);  // everything read so far is answered; send it in one go
+        ssize_t n = read(STDIN_FILENO, in + end, sizeof(in) - end);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        end += (size_t)n;
+    }
+    flush_replies(&p);
+    bwt_settings_leave(p.settings);
+    bwt_settings_release(p.settings);
+    return 0;
+}
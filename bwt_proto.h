@@ -0,0 +1,54 @@
+/*
+ * bwt_proto.h - JSON-lines protocol for driving bitwise-tutor from programs
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * `bwt --protocol jsonl` writes one JSON object per line to stdout and
+ * reads one per line from stdin. Up to `--window N` questions are open at
+ * once, so a front end can answer several without waiting for each reply.
+ *
+ * bwt sends:
+ *   {"type":"hello","protocol":1,"window":4}
+ *   {"type":"question","id":1,"topic":"xor","width":8,"signed":true,
+ *    "a":-5,"b":3,"format":"hex","digits":2}
+ *   {"type":"result","id":1,"verdict":"wrong","wrong_bits":2,"mistake":"wrong_operator"}
+ *   {"type":"result","id":1,"verdict":"correct","attempts":2}
+ *   {"type":"result","id":1,"verdict":"gave_up","expected":"00000110"}
+ *   {"type":"error","id":1,"message":"unknown question id"}
+ *
+ * Operands are given as decimal values, except for bin2dec, bin2hex and
+ * hex2bin where "a" is the string to convert as the quiz shows it (binary
+ * digits, 0x-prefixed hex or 0-prefixed octal). Shifts have the shift
+ * amount in "b"; single-operand topics have no "b". "format" is the form
+ * of the expected answer (binary, hex, octal or decimal) and "digits" the
+ * number of digits of a full-width binary, hex or octal answer. Wrong and invalid answers leave the question
+ * open; a correct answer or a give-up closes it and a new question is sent.
+ *
+ * The front end sends:
+ *   {"id":1,"answer":"00000110"}   (decimal answers may be JSON numbers)
+ *   {"id":1,"give_up":true}
+ *   {"quit":true}                  (or end of input)
+ *
+ * Lines are parsed in place in a fixed buffer and replies are formatted
+ * into a fixed buffer, so no message allocates. Replies are flushed only
+ * when bwt has consumed all input it has and is about to wait for more.
+ */
+
+#ifndef BWT_PROTO_H
+#define BWT_PROTO_H
+
+#include <stdint.h>
+
+#include "bwt_coverage.h"
+#include "bwt_sched.h"
+#include "bwt_store.h"
+
+#define BWT_PROTO_VERSION 1
+#define BWT_PROTO_MAX_WINDOW 64
+#define BWT_PROTO_LINE_SIZE 512  // longest input line accepted
+
+int bwt_proto_run(int window, struct bwt_sched* sched, struct bwt_coverage* coverage, struct bwt_appender* results,
+                  uint32_t learner, uint32_t session, int settings_watch);
+
+#endif // BWT_PROTO_H
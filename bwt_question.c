@@ -0,0 +1,497 @@
+/*
+ * bwt_question.c - Question model for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * Generation, evaluation, rendering and grading of a single question.
+ * Nothing in here allocates memory or touches stdin/stdout, so the same
+ * code can be driven by the interactive quiz or by other front ends.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#include "bwt_question.h"
+#include "bwt_dist.h"
+#include "bwt_kernels.h"
+#include "bwt_probe.h"
+#include "bwt_catalog.h"
+
+static const char* const topic_names[BWT_TOPIC_COUNT] = {
+    "and", "or", "xor", "not", "shl", "shr", "dec2bin", "bin2dec", "bin2hex", "hex2bin"
+};
+
+static const char* const format_names[BWT_FORMAT_COUNT] = {
+    "binary", "hex", "octal", "decimal"
+};
+
+/**
+ * Mask with the low `width` bits set
+ *
+ * @param width Width in bits (8, 16 or 32)
+ * @return Bit mask for the width
+ */
+uint32_t bwt_width_mask(uint8_t width) {
+    return width >= 32 ? UINT32_MAX : (UINT32_C(1) << width) - 1;
+}
+
+/**
+ * Map a width in bits to a dense index (8 -> 0, 16 -> 1, 32 -> 2)
+ *
+ * @param width Width in bits
+ * @return Index in the range [0, BWT_WIDTH_COUNT)
+ */
+uint8_t bwt_width_index(uint8_t width) {
+    return width <= 8 ? 0 : (width <= 16 ? 1 : 2);
+}
+
+/**
+ * Map a dense width index back to a width in bits
+ *
+ * @param index Index in the range [0, BWT_WIDTH_COUNT)
+ * @return Width in bits
+ */
+uint8_t bwt_width_from_index(uint8_t index) {
+    return (uint8_t)(8u << index);
+}
+
+/**
+ * Interpret a bit pattern as a signed or unsigned integer of the given width
+ *
+ * @param bits Bit pattern, only the low `width` bits are used
+ * @param width Width in bits
+ * @param is_signed true to interpret as two's complement
+ * @return The decimal value of the pattern
+ */
+int64_t bwt_value(uint32_t bits, uint8_t width, bool is_signed) {
+    uint32_t mask = bwt_width_mask(width);
+    bits &= mask;
+    if (is_signed && (bits >> (width - 1)) & 1) {
+        // Sign bit set: subtract 2^width to get the negative value
+        return (int64_t)bits - ((int64_t)mask + 1);
+    }
+    return (int64_t)bits;
+}
+
+/**
+ * Short, stable name of a topic, used in reports and protocols
+ *
+ * @param topic The topic
+ * @return Name of the topic, or "unknown"
+ */
+const char* bwt_topic_name(uint8_t topic) {
+    return topic < BWT_TOPIC_COUNT ? topic_names[topic] : "unknown";
+}
+
+/**
+ * Check whether a topic takes two operands `a` and `b`
+ *
+ * @param topic The topic
+ * @return true for AND, OR and XOR
+ */
+bool bwt_topic_is_binary_op(uint8_t topic) {
+    return topic == BWT_TOPIC_AND || topic == BWT_TOPIC_OR || topic == BWT_TOPIC_XOR;
+}
+
+/**
+ * Get the name of a format, as used in questions and settings
+ *
+ * @param format The format (enum bwt_format)
+ * @return Lower-case name of the format
+ */
+const char* bwt_format_name(uint8_t format) {
+    return format < BWT_FORMAT_COUNT ? format_names[format] : "unknown";
+}
+
+/**
+ * Number of digits a full-width bit pattern has in a format
+ *
+ * @param format BWT_FORMAT_BINARY, BWT_FORMAT_HEX or BWT_FORMAT_OCTAL
+ * @param width Width in bits
+ * @return Number of digits, without prefix
+ */
+uint8_t bwt_format_digits(uint8_t format, uint8_t width) {
+    switch (format) {
+        case BWT_FORMAT_HEX:
+            return (uint8_t)((width + 3) / 4);
+        case BWT_FORMAT_OCTAL:
+            return (uint8_t)((width + 2) / 3);
+        default:
+            return width;
+    }
+}
+
+/**
+ * Write a bit pattern the way it is shown to students: binary digits,
+ * 0x-prefixed hex, 0-prefixed octal or a decimal value
+ *
+ * @param out Output buffer
+ * @param size Size of the output buffer, BWT_ANSWER_SIZE is always enough
+ * @param bits Bit pattern
+ * @param width Width in bits
+ * @param is_signed Whether a decimal value is signed
+ * @param format The format (enum bwt_format)
+ * @return Number of characters written, as for snprintf
+ */
+int bwt_format_value(char* out, size_t size, uint32_t bits, uint8_t width, bool is_signed, uint8_t format) {
+    char digits[BWT_MAX_WIDTH + 1];
+
+    switch (format) {
+        case BWT_FORMAT_HEX:
+            bwt_format_hex(digits, bits, width);
+            return snprintf(out, size, "0x%s", digits);
+        case BWT_FORMAT_OCTAL:
+            bwt_format_octal(digits, bits, width);
+            return snprintf(out, size, "0%s", digits);
+        case BWT_FORMAT_DECIMAL:
+            return snprintf(out, size, "%lld", (long long)bwt_value(bits, width, is_signed));
+        default:
+            bwt_format_binary(digits, bits, width);
+            return snprintf(out, size, "%s", digits);
+    }
+}
+
+/**
+ * Get the format a question's answer is written in
+ *
+ * @param q The question
+ * @return The format (enum bwt_format)
+ */
+uint8_t bwt_question_answer_format(const struct bwt_question* q) {
+    switch (q->topic) {
+        case BWT_TOPIC_BIN2DEC:
+            return BWT_FORMAT_DECIMAL;
+        case BWT_TOPIC_BIN2HEX:
+            return BWT_FORMAT_HEX;
+        case BWT_TOPIC_HEX2BIN:
+            return BWT_FORMAT_BINARY;
+        default:
+            return q->format;
+    }
+}
+
+/**
+ * Check whether a question expects a decimal rather than a bit pattern
+ *
+ * @param q The question
+ * @return true if the answer is typed in decimal
+ */
+bool bwt_question_wants_decimal(const struct bwt_question* q) {
+    return bwt_question_answer_format(q) == BWT_FORMAT_DECIMAL;
+}
+
+/**
+ * Describe the form of answer a question expects, for invalid-input messages
+ *
+ * @param q The question
+ * @param buf Output buffer, e.g. "an 8-bit binary number"
+ * @param size Size of the output buffer
+ * @return Number of characters written, as for snprintf
+ */
+int bwt_question_describe_answer(const struct bwt_question* q, char* buf, size_t size) {
+    uint8_t format = bwt_question_answer_format(q);
+    char digits[BWT_MSG_INT_SIZE];
+    char width[BWT_MSG_INT_SIZE];
+
+    switch (format) {
+        case BWT_FORMAT_DECIMAL:
+            return bwt_msg_format(buf, size, MSG_ANSWER_DECIMAL, NULL, 0);
+        case BWT_FORMAT_HEX:
+        case BWT_FORMAT_OCTAL:
+            return BWT_MSG(buf, size, MSG_ANSWER_DIGITS, format == BWT_FORMAT_HEX ? "a" : "an",
+                           bwt_msg_text(MSG_FORMAT_BINARY + format),
+                           bwt_msg_int(digits, bwt_format_digits(format, q->width)));
+        default:
+            return BWT_MSG(buf, size, MSG_ANSWER_BINARY, q->width == 8 ? "an" : "a", bwt_msg_int(width, q->width));
+    }
+}
+
+/**
+ * Write a bit pattern in the format of a question's answer, e.g. to show
+ * the expected answer
+ *
+ * @param q The question
+ * @param bits Bit pattern
+ * @param buf Output buffer, BWT_ANSWER_SIZE is always enough
+ * @param size Size of the output buffer
+ * @return Number of characters written, as for snprintf
+ */
+int bwt_question_format_answer(const struct bwt_question* q, uint32_t bits, char* buf, size_t size) {
+    return bwt_format_value(buf, size, bits, q->width, q->is_signed, bwt_question_answer_format(q));
+}
+
+/**
+ * Compute the expected result of a question from its operands
+ *
+ * @param q The question, `expected` is filled in
+ */
+void bwt_question_eval(struct bwt_question* q) {
+    uint32_t mask = bwt_width_mask(q->width);
+    uint32_t a = q->a & mask;
+    uint32_t b = q->b & mask;
+    uint32_t result = 0;
+
+    switch (q->topic) {
+        case BWT_TOPIC_AND:
+            result = a & b;
+            break;
+        case BWT_TOPIC_OR:
+            result = a | b;
+            break;
+        case BWT_TOPIC_XOR:
+            result = a ^ b;
+            break;
+        case BWT_TOPIC_NOT:
+            result = ~a;
+            break;
+        case BWT_TOPIC_SHL:
+            result = a << q->b;
+            break;
+        case BWT_TOPIC_SHR:
+            if (q->is_signed) {
+                // Arithmetic shift: the sign bit is copied into the vacated bits
+                result = (uint32_t)(bwt_value(a, q->width, true) >> q->b);
+            } else {
+                result = a >> q->b;
+            }
+            break;
+        case BWT_TOPIC_DEC2BIN:
+        case BWT_TOPIC_BIN2DEC:
+        case BWT_TOPIC_BIN2HEX:
+        case BWT_TOPIC_HEX2BIN:
+            result = a;
+            break;
+        default:
+            break;
+    }
+    q->expected = result & mask;
+}
+
+/**
+ * Build a question from given operands
+ *
+ * @param topic The topic (enum bwt_topic)
+ * @param width Width in bits (8, 16 or 32)
+ * @param is_signed true for intN_t operands, false for uintN_t
+ * @param a First operand, truncated to width
+ * @param b Second operand or shift amount, 0 if unused
+ * @return The question with its expected result
+ */
+struct bwt_question bwt_question_make(uint8_t topic, uint8_t width, bool is_signed,
+                                      uint32_t a, uint32_t b) {
+    uint32_t mask = bwt_width_mask(width);
+    bool is_shift = topic == BWT_TOPIC_SHL || topic == BWT_TOPIC_SHR;
+    struct bwt_question q = {
+        .topic = topic,
+        .width = width,
+        .is_signed = is_signed,
+        .pattern = BWT_PATTERN_RANDOM,
+        .format = BWT_FORMAT_BINARY,
+        .a = a & mask,
+        .b = is_shift ? b : b & mask,
+    };
+    bwt_question_eval(&q);
+    return q;
+}
+
+/**
+ * Draw a random operand from a pattern class
+ *
+ * @param pattern The pattern class (enum bwt_pattern)
+ * @param width Width in bits
+ * @return Bit pattern masked to width
+ */
+static uint32_t random_operand(uint8_t pattern, uint8_t width) {
+    static const uint8_t edges[4] = {
+        BWT_OPERAND_ZERO, BWT_OPERAND_ALL_ONES, BWT_OPERAND_MIN, BWT_OPERAND_MAX
+    };
+
+    switch (pattern) {
+        case BWT_PATTERN_SMALL:
+            return bwt_operand_from_class(BWT_OPERAND_SMALL, width);
+        case BWT_PATTERN_SIGN_SET:
+            return bwt_operand_from_class(BWT_OPERAND_MSB_SET, width);
+        case BWT_PATTERN_EDGE:
+            return bwt_operand_from_class(edges[bwt_rand32() % 4], width);
+        default:
+            return bwt_sample_operand(BWT_DIST_ADAPTIVE, width);
+    }
+}
+
+/**
+ * Generate a random question for a topic, width, signedness and pattern
+ *
+ * @param q The question to fill in
+ * @param topic The topic (enum bwt_topic)
+ * @param width Width in bits (8, 16 or 32)
+ * @param is_signed true for intN_t operands, false for uintN_t
+ * @param pattern Pattern class of the first operand (enum bwt_pattern)
+ */
+void bwt_question_generate(struct bwt_question* q, uint8_t topic, uint8_t width,
+                           bool is_signed, uint8_t pattern) {
+    q->topic = topic;
+    q->width = width;
+    q->is_signed = is_signed;
+    q->pattern = pattern;
+    q->format = bwt_sample_format();
+    q->a = random_operand(pattern, width);
+    q->b = 0;
+
+    if (bwt_topic_is_binary_op(topic)) {
+        q->b = bwt_sample_operand(BWT_DIST_ADAPTIVE, width);
+    } else if (topic == BWT_TOPIC_SHL || topic == BWT_TOPIC_SHR) {
+        // shift by 1-3 for 8-bit, up to 7 for 16-bit and 15 for 32-bit
+        q->b = 1 + bwt_rand32() % (width / 2u - 1u);
+    }
+    bwt_question_eval(q);
+}
+
+/**
+ * Render the text of a question
+ *
+ * @param q The question
+ * @param number Question number shown to the student
+ * @param buf Output buffer
+ * @param size Size of the output buffer
+ * @return Number of characters written, as for snprintf
+ */
+int bwt_question_render(const struct bwt_question* q, int number, char* buf, size_t size) {
+    static const char* const op_strs[] = { "&", "|", "^" };
+    const char* kind = bwt_msg_text(q->is_signed ? MSG_KIND_SIGNED : MSG_KIND_UNSIGNED);
+    const char* article = q->width == 8 ? "an" : "a";
+    const char* format = bwt_msg_text(MSG_FORMAT_BINARY + q->format);
+    // Operands are given in the answer's format, except binary answers to decimal operands
+    uint8_t operand_format = q->format == BWT_FORMAT_BINARY ? BWT_FORMAT_DECIMAL : q->format;
+    char a_str[BWT_ANSWER_SIZE];
+    char b_str[BWT_ANSWER_SIZE];
+    char num[BWT_MSG_INT_SIZE];
+    char width[BWT_MSG_INT_SIZE];
+    char amount[BWT_MSG_INT_SIZE];
+
+    bwt_format_value(a_str, sizeof(a_str), q->a, q->width, q->is_signed, operand_format);
+    bwt_format_value(b_str, sizeof(b_str), q->b, q->width, q->is_signed, operand_format);
+    bwt_msg_int(num, number);
+    bwt_msg_int(width, q->width);
+
+    switch (q->topic) {
+        case BWT_TOPIC_AND:
+        case BWT_TOPIC_OR:
+        case BWT_TOPIC_XOR:
+            return BWT_MSG(buf, size, MSG_QUESTION_BITWISE,
+                           kind, width, a_str, b_str, num, op_strs[q->topic - BWT_TOPIC_AND], format);
+        case BWT_TOPIC_NOT:
+            return BWT_MSG(buf, size, MSG_QUESTION_NOT, kind, width, a_str, num, format);
+        case BWT_TOPIC_SHL:
+        case BWT_TOPIC_SHR:
+            return BWT_MSG(buf, size, MSG_QUESTION_SHIFT, kind, width, a_str, num, format,
+                           q->topic == BWT_TOPIC_SHL ? "<<" : ">>", bwt_msg_int(amount, q->b));
+        case BWT_TOPIC_DEC2BIN:
+            bwt_format_value(a_str, sizeof(a_str), q->a, q->width, q->is_signed, BWT_FORMAT_DECIMAL);
+            return BWT_MSG(buf, size, MSG_QUESTION_DEC2BIN, num, kind, a_str, width, format);
+        case BWT_TOPIC_BIN2DEC:
+            bwt_format_value(a_str, sizeof(a_str), q->a, q->width, q->is_signed, q->format);
+            return BWT_MSG(buf, size, MSG_QUESTION_BIN2DEC, num, a_str, article, kind, width);
+        case BWT_TOPIC_BIN2HEX:
+            bwt_format_value(a_str, sizeof(a_str), q->a, q->width, false, BWT_FORMAT_BINARY);
+            return BWT_MSG(buf, size, MSG_QUESTION_BIN2HEX, num, width, a_str);
+        case BWT_TOPIC_HEX2BIN:
+            bwt_format_value(a_str, sizeof(a_str), q->a, q->width, false, BWT_FORMAT_HEX);
+            return BWT_MSG(buf, size, MSG_QUESTION_HEX2BIN, num, a_str, article, width);
+        default:
+            return BWT_MSG(buf, size, MSG_QUESTION_UNKNOWN, num);
+    }
+}
+
+/**
+ * Parse an answer in the form the question asks for
+ *
+ * @param q The question
+ * @param format Its answer format
+ * @param input The answer without trailing newline
+ * @param parsed Receives the answer masked to width
+ * @param in_range Set to whether it fits the question's type
+ * @return false if the answer is not a number of the right form
+ */
+static bool parse_answer(const struct bwt_question* q, uint8_t format, const char* input,
+                         uint32_t* parsed, bool* in_range) {
+    uint32_t mask = bwt_width_mask(q->width);
+
+    *in_range = true;
+    if (format == BWT_FORMAT_DECIMAL) {
+        char* end = NULL;
+        errno = 0;
+        long long value = strtoll(input, &end, 10);
+        if (end == input || *end != '\0' || errno == ERANGE) {
+            return false;
+        }
+        int64_t lo = q->is_signed ? -((int64_t)mask + 1) / 2 : 0;
+        int64_t hi = q->is_signed ? (int64_t)(mask >> 1) : (int64_t)mask;
+        *in_range = value >= lo && value <= hi;
+        *parsed = (uint32_t)value & mask;
+    } else if (format == BWT_FORMAT_HEX || format == BWT_FORMAT_OCTAL) {
+        if (format == BWT_FORMAT_HEX && input[0] == '0' && (input[1] == 'x' || input[1] == 'X')) {
+            input += 2;
+        }
+        size_t len = strlen(input);
+        if (!(format == BWT_FORMAT_HEX ? bwt_parse_hex(input, len, parsed) : bwt_parse_octal(input, len, parsed))) {
+            return false;
+        }
+        *in_range = *parsed <= mask;
+        *parsed &= mask;
+    } else {
+        if (strlen(input) != q->width || !bwt_parse_binary(input, q->width, parsed)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Parse and grade a student's answer to a question
+ *
+ * Binary answers must have exactly `width` digits. Hex and octal answers
+ * may omit leading zeros and the 0x or 0 prefix. Decimal answers must be
+ * whole numbers. Values outside the range of the question's type are
+ * parsed but graded as wrong, so that e.g. 253 is not accepted for a
+ * signed ~2, nor 0x1FF for an 8-bit result.
+ *
+ * @param q The question
+ * @param input The answer without trailing newline
+ * @param bits Receives the answer as a bit pattern masked to width
+ * @return BWT_VERDICT_INVALID, BWT_VERDICT_WRONG or BWT_VERDICT_CORRECT
+ */
+enum bwt_verdict bwt_question_grade(const struct bwt_question* q, const char* input, uint32_t* bits) {
+    uint8_t format = bwt_question_answer_format(q);
+    uint32_t parsed = 0;
+    bool in_range;
+    bool valid = parse_answer(q, format, input, &parsed, &in_range);
+
+    BWT_PROBE4(parse, q->topic, format, valid, parsed);
+    if (!valid) {
+        return BWT_VERDICT_INVALID;
+    }
+    *bits = parsed;
+    return (in_range && parsed == q->expected) ? BWT_VERDICT_CORRECT : BWT_VERDICT_WRONG;
+}
+
+/**
+ * Parse an answer to a question without grading it
+ *
+ * Accepts the same answers as bwt_question_grade, for graders that
+ * compare many parsed answers at once (see bwt_sheet.h).
+ *
+ * @param q The question
+ * @param input The answer without trailing newline
+ * @param bits Receives the answer as a bit pattern masked to width
+ * @return false if the answer is not a number of the right form, or is
+ *         outside the range of the question's type
+ */
+bool bwt_question_parse(const struct bwt_question* q, const char* input, uint32_t* bits) {
+    bool in_range;
+    return parse_answer(q, bwt_question_answer_format(q), input, bits, &in_range) && in_range;
+}
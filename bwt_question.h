@@ -0,0 +1,99 @@
+/*
+ * bwt_question.h - Question model for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * A question is a topic (AND, OR, NOT, shifts, conversions...) applied to
+ * one or two operands of a given width and signedness. Operands and the
+ * expected result are stored as raw bit patterns masked to the width, so
+ * grading is a single integer comparison instead of a strcmp. Answers are
+ * written in binary, hex or octal (decimal for bin2dec), as chosen by the
+ * question's format.
+ */
+
+#ifndef BWT_QUESTION_H
+#define BWT_QUESTION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+enum bwt_topic {
+    BWT_TOPIC_AND,
+    BWT_TOPIC_OR,
+    BWT_TOPIC_XOR,
+    BWT_TOPIC_NOT,
+    BWT_TOPIC_SHL,      // left-shift <<
+    BWT_TOPIC_SHR,      // right-shift >>
+    BWT_TOPIC_DEC2BIN,  // decimal to binary, hex or octal conversion
+    BWT_TOPIC_BIN2DEC,  // binary, hex or octal to decimal conversion
+    BWT_TOPIC_BIN2HEX,  // grouping binary digits into hex digits
+    BWT_TOPIC_HEX2BIN,  // expanding hex digits into binary digits
+    BWT_TOPIC_COUNT
+};
+
+// Operand pattern classes, so that questions can target tricky values
+enum bwt_pattern {
+    BWT_PATTERN_SMALL,     // 0..15, easy to work out by hand
+    BWT_PATTERN_SIGN_SET,  // most significant bit set
+    BWT_PATTERN_EDGE,      // 0, all ones, minimum or maximum
+    BWT_PATTERN_RANDOM,    // any bit pattern of the width
+    BWT_PATTERN_COUNT
+};
+
+// How a bit pattern is written down
+enum bwt_format {
+    BWT_FORMAT_BINARY,   // exactly `width` digits
+    BWT_FORMAT_HEX,      // 0x followed by up to width / 4 digits
+    BWT_FORMAT_OCTAL,    // 0 followed by up to (width + 2) / 3 digits
+    BWT_FORMAT_DECIMAL,  // value of the width and signedness
+    BWT_FORMAT_COUNT
+};
+
+#define BWT_WIDTH_COUNT 3      // 8, 16 and 32 bits
+#define BWT_MAX_WIDTH 32
+#define BWT_PROMPT_SIZE 512    // large enough for any rendered question
+#define BWT_ANSWER_SIZE 40     // large enough for any formatted answer
+
+enum bwt_verdict {
+    BWT_VERDICT_INVALID,  // not a well-formed answer for the question
+    BWT_VERDICT_WRONG,
+    BWT_VERDICT_CORRECT
+};
+
+struct bwt_question {
+    uint8_t topic;      // enum bwt_topic
+    uint8_t width;      // 8, 16 or 32
+    bool is_signed;
+    uint8_t pattern;    // enum bwt_pattern used to draw the operands
+    uint8_t format;     // enum bwt_format of the answer, or of `a` for bin2dec
+    uint32_t a;         // first operand as a bit pattern masked to width
+    uint32_t b;         // second operand, or the shift amount for SHL/SHR
+    uint32_t expected;  // expected result as a bit pattern masked to width
+};
+
+uint32_t bwt_width_mask(uint8_t width);
+uint8_t bwt_width_index(uint8_t width);
+uint8_t bwt_width_from_index(uint8_t index);
+int64_t bwt_value(uint32_t bits, uint8_t width, bool is_signed);
+const char* bwt_topic_name(uint8_t topic);
+bool bwt_topic_is_binary_op(uint8_t topic);
+const char* bwt_format_name(uint8_t format);
+uint8_t bwt_format_digits(uint8_t format, uint8_t width);
+int bwt_format_value(char* out, size_t size, uint32_t bits, uint8_t width, bool is_signed, uint8_t format);
+uint8_t bwt_question_answer_format(const struct bwt_question* q);
+bool bwt_question_wants_decimal(const struct bwt_question* q);
+int bwt_question_describe_answer(const struct bwt_question* q, char* buf, size_t size);
+int bwt_question_format_answer(const struct bwt_question* q, uint32_t bits, char* buf, size_t size);
+void bwt_question_eval(struct bwt_question* q);
+struct bwt_question bwt_question_make(uint8_t topic, uint8_t width, bool is_signed,
+                                      uint32_t a, uint32_t b);
+void bwt_question_generate(struct bwt_question* q, uint8_t topic, uint8_t width,
+                           bool is_signed, uint8_t pattern);
+void bwt_format_binary(char* out, uint32_t bits, uint8_t width);
+int bwt_question_render(const struct bwt_question* q, int number, char* buf, size_t size);
+enum bwt_verdict bwt_question_grade(const struct bwt_question* q, const char* input, uint32_t* bits);
+bool bwt_question_parse(const struct bwt_question* q, const char* input, uint32_t* bits);
+
+#endif // BWT_QUESTION_H
@@ -0,0 +1,631 @@
+/*
+ * bwt_replay.c - Session recording and replay for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ */
+
+#define _GNU_SOURCE  // fopencookie
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "bwt_replay.h"
+#include "bwt_catalog.h"
+#include "bwt_settings.h"
+
+#define RECORDING_VERSION 1
+
+struct buffer {
+    char* data;
+    size_t len;
+    size_t cap;
+};
+
+struct input_line {
+    const char* text;
+    size_t len;
+    uint32_t ms;  // since the start of the session
+    bool eol;     // ended with a newline
+};
+
+struct recording {
+    uint32_t seed;
+    char lang[32];
+    struct buffer settings;
+    struct buffer expected;  // output as recorded
+    struct input_line* inputs;
+    size_t ninputs;
+    size_t cap;
+};
+
+struct session {
+    FILE* log;                        // recording being written, or NULL
+    uint64_t start_us;
+    int in_fd;                        // terminal while recording, -1 while replaying
+    int out_fd;
+    struct buffer line;               // input read from the terminal, not yet served
+    bool in_eof;
+    const struct input_line* inputs;  // recorded input, while replaying
+    size_t ninputs;
+    size_t next_input;
+    size_t input_offset;              // bytes of inputs[next_input] already read
+    struct buffer out;                // output, not yet logged from out_logged on
+    size_t out_logged;
+    bool keep_output;                 // keep all of it to compare with the recording
+    FILE* in_stream;
+    FILE* out_stream;
+    FILE* saved_in;
+    FILE* saved_out;
+};
+
+static struct session recorder;  // of `bwt --record`
+
+static uint64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static bool buffer_reserve(struct buffer* b, size_t len) {
+    if (b->len + len + 1 > b->cap) {
+        size_t cap = b->cap ? b->cap : 4096;
+        while (cap < b->len + len + 1) {
+            cap *= 2;
+        }
+        char* grown = realloc(b->data, cap);
+        if (grown == NULL) {
+            return false;
+        }
+        b->data = grown;
+        b->cap = cap;
+    }
+    return true;
+}
+
+static bool buffer_append(struct buffer* b, const char* data, size_t len) {
+    if (!buffer_reserve(b, len)) {
+        return false;
+    }
+    memcpy(b->data + b->len, data, len);
+    b->len += len;
+    b->data[b->len] = '\0';
+    return true;
+}
+
+/**
+ * Read a whole file into a buffer, NUL-terminated
+ *
+ * @return 0 on success, -1 with errno set
+ */
+static int read_file(const char* path, struct buffer* b) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    ssize_t n;
+
+    b->len = 0;
+    if (fd < 0) {
+        return -1;
+    }
+    if (fstat(fd, &st) < 0 || !buffer_reserve(b, (size_t)st.st_size)) {
+        close(fd);
+        return -1;
+    }
+    // Read to the end rather than trusting st_size, which is 0 for pipes
+    while ((n = read(fd, b->data + b->len, b->cap - b->len - 1)) > 0) {
+        b->len += (size_t)n;
+        if (b->len + 1 == b->cap && !buffer_reserve(b, b->cap)) {
+            close(fd);
+            return -1;
+        }
+    }
+    close(fd);
+    b->data[b->len] = '\0';
+    return n == 0 ? 0 : -1;
+}
+
+static void write_escaped(FILE* f, const char* s, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)s[i];
+        switch (c) {
+            case '\\': fputs("\\\\", f); break;
+            case '\n': fputs("\\n", f); break;
+            case '\r': fputs("\\r", f); break;
+            case '\t': fputs("\\t", f); break;
+            default:
+                if (c < 0x20 || c == 0x7F) {
+                    fprintf(f, "\\x%02x", c);
+                } else {
+                    putc(c, f);
+                }
+        }
+    }
+}
+
+/**
+ * Decode the escapes written by write_escaped in place
+ *
+ * @return Length of the decoded text, or -1 on a bad escape
+ */
+static long unescape(char* s, size_t len) {
+    static const char hex[] = "0123456789abcdef";
+    char* out = s;
+
+    for (size_t i = 0; i < len; i++) {
+        if (s[i] != '\\') {
+            *out++ = s[i];
+            continue;
+        }
+        if (++i == len) {
+            return -1;
+        }
+        switch (s[i]) {
+            case '\\': *out++ = '\\'; break;
+            case 'n': *out++ = '\n'; break;
+            case 'r': *out++ = '\r'; break;
+            case 't': *out++ = '\t'; break;
+            case 'x': {
+                const char* hi = i + 2 < len ? memchr(hex, s[i + 1], 16) : NULL;
+                const char* lo = hi != NULL ? memchr(hex, s[i + 2], 16) : NULL;
+                if (lo == NULL) {
+                    return -1;
+                }
+                *out++ = (char)((hi - hex) << 4 | (lo - hex));
+                i += 2;
+                break;
+            }
+            default:
+                return -1;
+        }
+    }
+    return (long)(out - s);
+}
+
+static void write_header(FILE* log, uint32_t seed, const char* lang, const char* settings, size_t len) {
+    fprintf(log, "# bwt session recording, replay with `bwt --replay FILE`\n");
+    fprintf(log, "bwt-session %d\nseed %u\nlang %s\n", RECORDING_VERSION, seed, lang);
+    while (len > 0) {
+        const char* nl = memchr(settings, '\n', len);
+        size_t n = nl != NULL ? (size_t)(nl - settings) : len;
+        fputs("settings ", log);
+        write_escaped(log, settings, n);
+        putc('\n', log);
+        n += nl != NULL;
+        settings += n;
+        len -= n;
+    }
+}
+
+/**
+ * Log the output printed since the last input, as whole lines, and with
+ * `partial` also the unfinished last line
+ */
+static void log_output(struct session* s, bool partial) {
+    while (s->out_logged < s->out.len) {
+        const char* start = s->out.data + s->out_logged;
+        size_t rest = s->out.len - s->out_logged;
+        const char* nl = memchr(start, '\n', rest);
+        if (nl == NULL && !partial) {
+            break;
+        }
+        size_t n = nl != NULL ? (size_t)(nl - start) : rest;
+        fputs(nl != NULL ? "out " : "out-noeol ", s->log);
+        write_escaped(s->log, start, n);
+        putc('\n', s->log);
+        s->out_logged += n + (nl != NULL);
+    }
+}
+
+static void log_input(struct session* s, const char* text, size_t len, uint32_t ms, bool eol) {
+    log_output(s, true);
+    fprintf(s->log, "in%s %u ", eol ? "" : "-noeol", ms);
+    write_escaped(s->log, text, len);
+    putc('\n', s->log);
+}
+
+/**
+ * fopencookie read function of the session's stdin
+ */
+static ssize_t session_read(void* cookie, char* buf, size_t size) {
+    struct session* s = cookie;
+
+    // The prompt is printed (and logged) before the answer to it
+    fflush(s->out_stream);
+
+    if (s->in_fd < 0) {
+        if (s->next_input == s->ninputs) {
+            return 0;
+        }
+        const struct input_line* in = &s->inputs[s->next_input];
+        size_t off = s->input_offset;
+        size_t n = 0;
+        if (off == 0 && s->log != NULL) {
+            log_input(s, in->text, in->len, in->ms, in->eol);
+        }
+        if (off < in->len) {
+            n = in->len - off < size ? in->len - off : size;
+            memcpy(buf, in->text + off, n);
+            off += n;
+        }
+        if (n < size && off == in->len && in->eol) {
+            buf[n++] = '\n';
+            off++;
+        }
+        if (off == in->len + in->eol) {
+            s->next_input++;
+            off = 0;
+        }
+        s->input_offset = off;
+        return (ssize_t)n;
+    }
+
+    // Serve a line at a time, so each is logged after the output that asked for it
+    char* nl;
+    while ((nl = s->line.len > 0 ? memchr(s->line.data, '\n', s->line.len) : NULL) == NULL && !s->in_eof) {
+        if (!buffer_reserve(&s->line, 4096)) {
+            return -1;
+        }
+        ssize_t n = read(s->in_fd, s->line.data + s->line.len, s->line.cap - s->line.len - 1);
+        if (n < 0) {
+            return -1;
+        }
+        s->in_eof = n == 0;
+        s->line.len += (size_t)n;
+    }
+    size_t total = nl != NULL ? (size_t)(nl - s->line.data) + 1 : s->line.len;
+    if (total == 0) {
+        return 0;
+    }
+    if (s->input_offset == 0) {
+        log_input(s, s->line.data, total - (nl != NULL), (uint32_t)((now_us() - s->start_us) / 1000u), nl != NULL);
+        fflush(s->log);
+    }
+    size_t n = total - s->input_offset < size ? total - s->input_offset : size;
+    memcpy(buf, s->line.data + s->input_offset, n);
+    s->input_offset += n;
+    if (s->input_offset == total) {
+        memmove(s->line.data, s->line.data + total, s->line.len - total);
+        s->line.len -= total;
+        s->input_offset = 0;
+    }
+    return (ssize_t)n;
+}
+
+/**
+ * fopencookie write function of the session's stdout
+ */
+static ssize_t session_write(void* cookie, const char* buf, size_t size) {
+    struct session* s = cookie;
+
+    for (size_t done = 0; s->out_fd >= 0 && done < size; ) {
+        ssize_t n = write(s->out_fd, buf + done, size - done);
+        if (n < 0) {
+            return -1;
+        }
+        done += (size_t)n;
+    }
+    if (!buffer_append(&s->out, buf, size)) {
+        return -1;
+    }
+    if (s->log != NULL) {
+        log_output(s, false);
+        if (!s->keep_output) {
+            memmove(s->out.data, s->out.data + s->out_logged, s->out.len - s->out_logged);
+            s->out.len -= s->out_logged;
+            s->out_logged = 0;
+        }
+    }
+    return (ssize_t)size;
+}
+
+/**
+ * Point stdin and stdout at the session
+ *
+ * glibc lets stdin and stdout be assigned, so the scanf and printf calls
+ * of the quiz code go through the session unchanged.
+ */
+static int session_begin(struct session* s) {
+    cookie_io_functions_t io = { .read = session_read, .write = session_write };
+
+    s->in_stream = fopencookie(s, "r", io);
+    s->out_stream = fopencookie(s, "w", io);
+    if (s->in_stream == NULL || s->out_stream == NULL) {
+        if (s->in_stream != NULL) {
+            fclose(s->in_stream);
+        }
+        if (s->out_stream != NULL) {
+            fclose(s->out_stream);
+        }
+        return -1;
+    }
+    // A terminal shows every line as it is printed; replayed output only has to be complete
+    setvbuf(s->out_stream, NULL, s->out_fd >= 0 ? _IOLBF : _IOFBF, BUFSIZ);
+    fflush(stdout);
+    s->saved_in = stdin;
+    s->saved_out = stdout;
+    stdin = s->in_stream;
+    stdout = s->out_stream;
+    return 0;
+}
+
+static void session_end(struct session* s) {
+    fflush(s->out_stream);
+    stdin = s->saved_in;
+    stdout = s->saved_out;
+    fclose(s->in_stream);
+    fclose(s->out_stream);
+    if (s->log != NULL) {
+        log_output(s, true);
+    }
+}
+
+/**
+ * Start recording the session on stdin/stdout
+ *
+ * @param path Recording to write
+ * @param seed Seed the session's questions are drawn with
+ * @param settings_path Settings file the distributions were loaded from,
+ *                      saved in the recording if it exists
+ * @return 0 on success, -1 with errno set
+ */
+int bwt_record_start(const char* path, uint32_t seed, const char* settings_path) {
+    struct session* s = &recorder;
+    struct buffer settings = { 0 };
+
+    *s = (struct session){ .in_fd = STDIN_FILENO, .out_fd = STDOUT_FILENO, .start_us = now_us() };
+    s->log = fopen(path, "w");
+    if (s->log == NULL) {
+        return -1;
+    }
+    // Without a settings file the built-in distributions are used, and replayed
+    if (settings_path != NULL && read_file(settings_path, &settings) < 0) {
+        settings.len = 0;
+    }
+    write_header(s->log, seed, bwt_catalog_lang(), settings.data, settings.len);
+    free(settings.data);
+    fflush(s->log);
+
+    if (session_begin(s) < 0) {
+        fclose(s->log);
+        s->log = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Stop recording and close the recording
+ */
+void bwt_record_stop(void) {
+    struct session* s = &recorder;
+
+    if (s->log == NULL) {
+        return;
+    }
+    session_end(s);
+    if (fclose(s->log) != 0) {
+        perror("Could not write the session recording");
+    }
+    free(s->line.data);
+    free(s->out.data);
+    *s = (struct session){ 0 };
+}
+
+/**
+ * Parse a recording read into `file`, whose text it decodes in place
+ *
+ * @return 0 on success, -1 after printing an error
+ */
+static int parse_recording(const char* path, struct buffer* file, struct recording* r) {
+    char* p = file->data;
+    char* end = file->data + file->len;
+    bool header = false;
+    int lineno = 0;
+
+    r->seed = 0;
+    snprintf(r->lang, sizeof(r->lang), "en");
+    r->settings.len = 0;
+    r->expected.len = 0;
+    r->ninputs = 0;
+
+    while (p < end) {
+        char* nl = memchr(p, '\n', (size_t)(end - p));
+        char* eol = nl != NULL ? nl : end;
+        char* line = p;
+        p = nl != NULL ? nl + 1 : end;
+        lineno++;
+        *eol = '\0';
+        if (*line == '\0' || *line == '#') {
+            continue;
+        }
+        char* value = strchr(line, ' ');
+        if (value != NULL) {
+            *value++ = '\0';
+        } else {
+            value = eol;
+        }
+        long len = unescape(value, (size_t)(eol - value));
+        bool ok = len >= 0;
+
+        if (!header) {
+            ok = strcmp(line, "bwt-session") == 0 && atoi(value) == RECORDING_VERSION;
+            header = true;
+        } else if (!ok) {
+            // bad escape
+        } else if (strcmp(line, "seed") == 0) {
+            r->seed = (uint32_t)strtoul(value, NULL, 10);
+        } else if (strcmp(line, "lang") == 0) {
+            snprintf(r->lang, sizeof(r->lang), "%s", value);
+        } else if (strcmp(line, "settings") == 0) {
+            ok = buffer_append(&r->settings, value, (size_t)len) && buffer_append(&r->settings, "\n", 1);
+        } else if (strcmp(line, "out") == 0 || strcmp(line, "out-noeol") == 0) {
+            ok = buffer_append(&r->expected, value, (size_t)len)
+                 && (line[3] != '\0' || buffer_append(&r->expected, "\n", 1));
+        } else if (strcmp(line, "in") == 0 || strcmp(line, "in-noeol") == 0) {
+            char* text;
+            uint32_t ms = (uint32_t)strtoul(value, &text, 10);
+            text += *text == ' ';
+            if (r->ninputs == r->cap) {
+                size_t cap = r->cap ? r->cap * 2 : 64;
+                struct input_line* grown = realloc(r->inputs, cap * sizeof(*grown));
+                if (grown == NULL) {
+                    perror(path);
+                    return -1;
+                }
+                r->inputs = grown;
+                r->cap = cap;
+            }
+            r->inputs[r->ninputs++] = (struct input_line){
+                text, (size_t)(value + len - text), ms, line[2] == '\0'
+            };
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            fprintf(stderr, "%s:%d: not a bwt session recording\n", path, lineno);
+            return -1;
+        }
+    }
+    if (!header) {
+        fprintf(stderr, "%s: empty recording\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Print the first line where the replayed output differs from the
+ * recorded one
+ */
+static void report_difference(const char* path, const struct buffer* expected, const struct buffer* got) {
+    size_t i = 0;
+    while (i < expected->len && i < got->len && expected->data[i] == got->data[i]) {
+        i++;
+    }
+    size_t start = i;
+    while (start > 0 && expected->data[start - 1] != '\n') {
+        start--;
+    }
+    int line = 1;
+    for (const char* q = expected->data; (q = memchr(q, '\n', (size_t)(expected->data + start - q))) != NULL; q++) {
+        line++;
+    }
+
+    printf("%s: output differs at line %d\n", path, line);
+    const struct buffer* sides[2] = { expected, got };
+    for (int k = 0; k < 2; k++) {
+        const char* text = sides[k]->data + start;
+        size_t len = sides[k]->len - start;
+        const char* nl = memchr(text, '\n', len);
+        printf("  %-9s ", k == 0 ? "expected:" : "got:");
+        if (len == 0) {
+            printf("(end of output)\n");
+        } else {
+            write_escaped(stdout, text, nl != NULL ? (size_t)(nl - text) : len);
+            printf("\n");
+        }
+    }
+}
+
+/**
+ * Replay recorded sessions and compare their output with the recordings
+ *
+ * @param paths Recordings
+ * @param count Number of recordings
+ * @param update Rewrite the recordings with this build's output instead
+ * @param run Runs one session from a seed
+ * @return 0 if every replay matched (or was updated), 1 otherwise
+ */
+int bwt_replay_main(char* const* paths, int count, bool update, bwt_session_fn run) {
+    struct buffer file = { 0 };
+    struct buffer out = { 0 };
+    struct recording r = { 0 };
+    int failed = 0;
+    int changed = 0;
+    uint64_t start = now_us();
+
+    for (int i = 0; i < count; i++) {
+        if (read_file(paths[i], &file) < 0) {
+            perror(paths[i]);
+            failed++;
+            continue;
+        }
+        if (parse_recording(paths[i], &file, &r) < 0) {
+            failed++;
+            continue;
+        }
+
+        FILE* fp = r.settings.len > 0 ? fmemopen(r.settings.data, r.settings.len, "r") : NULL;
+        bwt_settings_load_stream(fp, paths[i]);
+        if (fp != NULL) {
+            fclose(fp);
+        }
+        if (strcmp(r.lang, bwt_catalog_lang()) != 0 && bwt_catalog_select(r.lang) < 0) {
+            fprintf(stderr, "%s: no message catalog for %s\n", paths[i], r.lang);
+        }
+
+        struct session s = {
+            .in_fd = -1, .out_fd = -1, .inputs = r.inputs, .ninputs = r.ninputs,
+            .out = out, .keep_output = true,
+        };
+        s.out.len = 0;
+        char tmp[4096];
+        if (update) {
+            snprintf(tmp, sizeof(tmp), "%s.tmp", paths[i]);
+            if ((s.log = fopen(tmp, "w")) == NULL) {
+                perror(tmp);
+                failed++;
+                continue;
+            }
+            write_header(s.log, r.seed, r.lang, r.settings.data, r.settings.len);
+        }
+        if (session_begin(&s) < 0) {
+            perror("fopencookie");
+            if (s.log != NULL) {
+                fclose(s.log);
+            }
+            failed++;
+            continue;
+        }
+        run(r.seed);
+        session_end(&s);
+        out = s.out;
+
+        bool same = out.len == r.expected.len && memcmp(out.data, r.expected.data, out.len) == 0;
+        if (update) {
+            if (fclose(s.log) != 0 || rename(tmp, paths[i]) < 0) {
+                perror(paths[i]);
+                failed++;
+            } else if (!same) {
+                printf("%s: updated\n", paths[i]);
+                changed++;
+            }
+        } else if (!same) {
+            report_difference(paths[i], &r.expected, &out);
+            failed++;
+        }
+    }
+
+    double seconds = (double)(now_us() - start) / 1e6;
+    printf("%d sessions replayed in %.3f s (%.0f sessions/s): ", count, seconds,
+           seconds > 0 ? count / seconds : 0.0);
+    if (update) {
+        printf("%d updated, %d failed\n", changed, failed);
+    } else {
+        printf("%d matched, %d failed\n", count - failed, failed);
+    }
+
+    free(file.data);
+    free(out.data);
+    free(r.settings.data);
+    free(r.expected.data);
+    free(r.inputs);
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,46 @@
+/*
+ * bwt_replay.h - Session recording and replay for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * `bwt --record FILE` saves everything needed to run a menu session again:
+ * the random seed, the message language, the settings and every line
+ * typed, with the milliseconds since the start, along with everything bwt
+ * printed. `bwt --replay FILE...` runs each recording through the same
+ * quiz code in-process, at full speed, and reports the first line where
+ * the output differs from the recorded one. `bwt --replay-update FILE...`
+ * rewrites the recordings with the output of this build instead.
+ *
+ * The quiz code reads stdin and writes stdout, so both are swapped for
+ * fopencookie streams: while recording they pass data through to the
+ * terminal and log it, while replaying they serve the recorded input and
+ * collect the output in memory. A recording is text, one event per line:
+ *
+ *   bwt-session 1
+ *   seed 1792339200
+ *   lang en
+ *   settings widths = 8:6, 16:3, 32:1
+ *   out Welcome to Bitwise Tutor (bwt)!
+ *   out-noeol Enter your choice (1-9):
+ *   in 2170 8
+ *
+ * Text is escaped with \\, \n, \r, \t and \xHH. `-noeol` marks the last
+ * piece of output before an input, or a last input line, that did not end
+ * with a newline.
+ */
+
+#ifndef BWT_REPLAY_H
+#define BWT_REPLAY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Runs one menu session on stdin/stdout from a given seed
+typedef void (*bwt_session_fn)(uint32_t seed);
+
+int bwt_record_start(const char* path, uint32_t seed, const char* settings_path);
+void bwt_record_stop(void);
+int bwt_replay_main(char* const* paths, int count, bool update, bwt_session_fn run);
+
+#endif // BWT_REPLAY_H
@@ -0,0 +1,415 @@
+/*
+ * bwt_report.c - Analytics over recorded results for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * Per-bit error counts are accumulated with bit-sliced counters: the XOR
+ * of a wrong answer and the expected value is added into eight bit planes
+ * with a ripple of ANDs and XORs, and the planes are only expanded into
+ * per-position totals every 255 answers. This keeps the inner loop free
+ * of per-bit branches.
+ */
+
+#define _POSIX_C_SOURCE 200809L  // clock_gettime
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "bwt_report.h"
+
+#define CHUNK_RECORDS (1u << 16)  // records claimed by a worker at a time
+#define PLANES 8                  // bit planes, so a plane set counts up to 255
+
+struct chunk {
+    const struct bwt_record* records;
+    size_t count;
+};
+
+// Bit-sliced per-position counters of one group
+struct bit_planes {
+    uint32_t plane[PLANES];
+    uint32_t pending;  // answers added since the last flush
+};
+
+struct worker {
+    pthread_t thread;
+    const struct chunk* chunks;
+    size_t nchunks;
+    atomic_size_t* next_chunk;
+    struct bwt_report* report;
+    struct bit_planes planes[BWT_REPORT_GROUPS];
+};
+
+/**
+ * Bucket of a value in the latency sketch
+ *
+ * Values below 16 get a bucket each; above that every power of two is
+ * split into 16 buckets using the four bits after the leading one.
+ */
+static uint32_t sketch_bucket(uint32_t value) {
+    if (value < (1u << BWT_SKETCH_SUB_BITS)) {
+        return value;
+    }
+    uint32_t exponent = 31u - (uint32_t)__builtin_clz(value);
+    uint32_t mantissa = (value >> (exponent - BWT_SKETCH_SUB_BITS)) & ((1u << BWT_SKETCH_SUB_BITS) - 1);
+    return ((exponent - BWT_SKETCH_SUB_BITS + 1) << BWT_SKETCH_SUB_BITS) + mantissa;
+}
+
+/**
+ * Representative value (midpoint) of a sketch bucket
+ */
+static uint32_t sketch_value(uint32_t bucket) {
+    if (bucket < (1u << BWT_SKETCH_SUB_BITS)) {
+        return bucket;
+    }
+    uint32_t exponent = (bucket >> BWT_SKETCH_SUB_BITS) + BWT_SKETCH_SUB_BITS - 1;
+    uint32_t mantissa = bucket & ((1u << BWT_SKETCH_SUB_BITS) - 1);
+    uint64_t low = (uint64_t)((1u << BWT_SKETCH_SUB_BITS) + mantissa) << (exponent - BWT_SKETCH_SUB_BITS);
+    uint64_t width = UINT64_C(1) << (exponent - BWT_SKETCH_SUB_BITS);
+    uint64_t mid = low + width / 2;
+    return mid < UINT32_MAX ? (uint32_t)mid : UINT32_MAX;
+}
+
+/**
+ * Add a value to a latency sketch
+ *
+ * @param s Sketch
+ * @param value Value, e.g. a latency in microseconds
+ */
+void bwt_sketch_add(struct bwt_sketch* s, uint32_t value) {
+    s->buckets[sketch_bucket(value)]++;
+    s->count++;
+}
+
+/**
+ * Add the contents of one sketch to another
+ *
+ * @param into Sketch to add to
+ * @param from Sketch to add
+ */
+void bwt_sketch_merge(struct bwt_sketch* into, const struct bwt_sketch* from) {
+    for (int i = 0; i < BWT_SKETCH_BUCKETS; i++) {
+        into->buckets[i] += from->buckets[i];
+    }
+    into->count += from->count;
+}
+
+/**
+ * Approximate quantile of the values in a sketch
+ *
+ * @param s Sketch
+ * @param q Quantile in [0, 1], e.g. 0.99
+ * @return Approximate value, or 0 for an empty sketch
+ */
+uint32_t bwt_sketch_quantile(const struct bwt_sketch* s, double q) {
+    if (s->count == 0) {
+        return 0;
+    }
+    uint64_t rank = (uint64_t)(q * (double)(s->count - 1));
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < BWT_SKETCH_BUCKETS; i++) {
+        seen += s->buckets[i];
+        if (seen > rank) {
+            return sketch_value(i);
+        }
+    }
+    return sketch_value(BWT_SKETCH_BUCKETS - 1);
+}
+
+/**
+ * Expand bit planes into per-position totals and clear them
+ */
+static void flush_planes(struct bit_planes* p, struct bwt_report_group* g) {
+    for (int j = 0; j < PLANES; j++) {
+        uint32_t plane = p->plane[j];
+        while (plane != 0) {
+            int pos = __builtin_ctz(plane);
+            g->bit_errors[pos] += UINT64_C(1) << j;
+            plane &= plane - 1;
+        }
+        p->plane[j] = 0;
+    }
+    p->pending = 0;
+}
+
+/**
+ * Add one wrong answer's differing bits to the bit planes
+ */
+static void add_planes(struct bit_planes* p, struct bwt_report_group* g, uint32_t diff) {
+    uint32_t carry = diff;
+    for (int j = 0; j < PLANES && carry != 0; j++) {
+        uint32_t next = p->plane[j] & carry;
+        p->plane[j] ^= carry;
+        carry = next;
+    }
+    if (++p->pending == (1u << PLANES) - 1) {
+        flush_planes(p, g);
+    }
+}
+
+/**
+ * Group index of a record, or -1 for a record that does not make sense
+ */
+static int group_of(const struct bwt_record* rec) {
+    if (rec->topic >= BWT_TOPIC_COUNT
+        || (rec->width != 8 && rec->width != 16 && rec->width != 32)) {
+        return -1;
+    }
+    return (rec->topic * BWT_WIDTH_COUNT + bwt_width_index(rec->width)) * 2
+           + ((rec->flags & BWT_RECORD_SIGNED) ? 1 : 0);
+}
+
+static void scan_chunk(struct worker* w, const struct chunk* c) {
+    struct bwt_report* r = w->report;
+
+    for (size_t i = 0; i < c->count; i++) {
+        const struct bwt_record* rec = &c->records[i];
+        int gi = group_of(rec);
+        if (gi < 0) {
+            continue;
+        }
+        struct bwt_report_group* g = &r->group[gi];
+
+        r->records++;
+        g->attempts++;
+        g->correct += (rec->flags & BWT_RECORD_CORRECT) ? 1 : 0;
+        g->gave_up += (rec->flags & BWT_RECORD_GAVE_UP) ? 1 : 0;
+        bwt_sketch_add(&g->latency, rec->latency_us);
+
+        if (rec->attempts == 0) {
+            continue;  // gave up without answering
+        }
+        uint32_t diff = (rec->first_answer ^ rec->expected) & bwt_width_mask(rec->width);
+        if (diff == 0) {
+            g->first_try++;
+        } else {
+            g->wrong_first++;
+            add_planes(&w->planes[gi], g, diff);
+        }
+    }
+}
+
+static void* worker_main(void* arg) {
+    struct worker* w = arg;
+
+    for (;;) {
+        size_t i = atomic_fetch_add(w->next_chunk, 1);
+        if (i >= w->nchunks) {
+            break;
+        }
+        scan_chunk(w, &w->chunks[i]);
+    }
+    for (int gi = 0; gi < BWT_REPORT_GROUPS; gi++) {
+        flush_planes(&w->planes[gi], &w->report->group[gi]);
+    }
+    return NULL;
+}
+
+/**
+ * Merge a partial report into a total
+ */
+static void merge_report(struct bwt_report* into, const struct bwt_report* from) {
+    into->records += from->records;
+    for (int gi = 0; gi < BWT_REPORT_GROUPS; gi++) {
+        struct bwt_report_group* a = &into->group[gi];
+        const struct bwt_report_group* b = &from->group[gi];
+        a->attempts += b->attempts;
+        a->first_try += b->first_try;
+        a->correct += b->correct;
+        a->gave_up += b->gave_up;
+        a->wrong_first += b->wrong_first;
+        for (int pos = 0; pos < BWT_MAX_WIDTH; pos++) {
+            a->bit_errors[pos] += b->bit_errors[pos];
+        }
+        bwt_sketch_merge(&a->latency, &b->latency);
+    }
+}
+
+/**
+ * Scan mapped results files with several threads
+ *
+ * @param maps Mapped results files
+ * @param nmaps Number of files
+ * @param threads Number of worker threads, at least 1
+ * @param out Report to fill in
+ * @return 0 on success, -1 if memory or threads could not be allocated
+ */
+int bwt_report_scan(const struct bwt_store_map* maps, size_t nmaps, int threads, struct bwt_report* out) {
+    size_t nchunks = 0;
+    for (size_t m = 0; m < nmaps; m++) {
+        nchunks += (maps[m].count + CHUNK_RECORDS - 1) / CHUNK_RECORDS;
+    }
+
+    struct chunk* chunks = malloc((nchunks > 0 ? nchunks : 1) * sizeof(*chunks));
+    struct worker* workers = calloc((size_t)threads, sizeof(*workers));
+    if (chunks == NULL || workers == NULL) {
+        free(chunks);
+        free(workers);
+        return -1;
+    }
+
+    size_t n = 0;
+    for (size_t m = 0; m < nmaps; m++) {
+        for (size_t start = 0; start < maps[m].count; start += CHUNK_RECORDS) {
+            size_t left = maps[m].count - start;
+            chunks[n].records = maps[m].records + start;
+            chunks[n].count = left < CHUNK_RECORDS ? left : CHUNK_RECORDS;
+            n++;
+        }
+    }
+
+    atomic_size_t next_chunk = 0;
+    int started = 0;
+    int rc = 0;
+    for (int t = 0; t < threads; t++) {
+        workers[t].chunks = chunks;
+        workers[t].nchunks = nchunks;
+        workers[t].next_chunk = &next_chunk;
+        workers[t].report = calloc(1, sizeof(struct bwt_report));
+        if (workers[t].report == NULL
+            || pthread_create(&workers[t].thread, NULL, worker_main, &workers[t]) != 0) {
+            free(workers[t].report);
+            rc = -1;
+            break;
+        }
+        started++;
+    }
+
+    memset(out, 0, sizeof(*out));
+    for (int t = 0; t < started; t++) {
+        pthread_join(workers[t].thread, NULL);
+        merge_report(out, workers[t].report);
+        free(workers[t].report);
+    }
+    // Threads that did start have claimed every chunk, so the report is whole
+    if (started > 0) {
+        rc = 0;
+    }
+
+    free(chunks);
+    free(workers);
+    return rc;
+}
+
+static void group_name(int gi, char* buf, size_t size) {
+    snprintf(buf, size, "%-7s %2u-bit %-8s",
+             bwt_topic_name((uint8_t)(gi / (BWT_WIDTH_COUNT * 2))),
+             bwt_width_from_index((uint8_t)(gi / 2 % BWT_WIDTH_COUNT)),
+             gi % 2 ? "signed" : "unsigned");
+}
+
+static double percent(uint64_t part, uint64_t whole) {
+    return whole > 0 ? 100.0 * (double)part / (double)whole : 0.0;
+}
+
+/**
+ * Print a report as text
+ *
+ * @param out Stream to print to
+ * @param r Report
+ */
+void bwt_report_print(FILE* out, const struct bwt_report* r) {
+    char name[64];
+
+    fprintf(out, "%-25s %9s %8s %8s %8s %9s %9s %9s\n", "group", "asked",
+            "1st-try", "correct", "gave-up", "p50 ms", "p90 ms", "p99 ms");
+    for (int gi = 0; gi < BWT_REPORT_GROUPS; gi++) {
+        const struct bwt_report_group* g = &r->group[gi];
+        if (g->attempts == 0) {
+            continue;
+        }
+        group_name(gi, name, sizeof(name));
+        fprintf(out, "%-25s %9llu %7.1f%% %7.1f%% %7.1f%% %9.1f %9.1f %9.1f\n",
+                name, (unsigned long long)g->attempts,
+                percent(g->first_try, g->attempts), percent(g->correct, g->attempts),
+                percent(g->gave_up, g->attempts),
+                bwt_sketch_quantile(&g->latency, 0.50) / 1000.0,
+                bwt_sketch_quantile(&g->latency, 0.90) / 1000.0,
+                bwt_sketch_quantile(&g->latency, 0.99) / 1000.0);
+    }
+
+    fprintf(out, "\nFirst-try accuracy by width:\n");
+    for (int wi = 0; wi < BWT_WIDTH_COUNT; wi++) {
+        uint64_t attempts = 0, first_try = 0;
+        for (int gi = 0; gi < BWT_REPORT_GROUPS; gi++) {
+            if (gi / 2 % BWT_WIDTH_COUNT == wi) {
+                attempts += r->group[gi].attempts;
+                first_try += r->group[gi].first_try;
+            }
+        }
+        fprintf(out, "  %2u-bit %6.1f%% of %llu\n", bwt_width_from_index((uint8_t)wi),
+                percent(first_try, attempts), (unsigned long long)attempts);
+    }
+
+    fprintf(out, "\nBit positions wrong in first answers (%% of wrong first answers, MSB first):\n");
+    for (int gi = 0; gi < BWT_REPORT_GROUPS; gi++) {
+        const struct bwt_report_group* g = &r->group[gi];
+        if (g->wrong_first == 0) {
+            continue;
+        }
+        int width = bwt_width_from_index((uint8_t)(gi / 2 % BWT_WIDTH_COUNT));
+        group_name(gi, name, sizeof(name));
+        fprintf(out, "%s", name);
+        for (int pos = width - 1; pos >= 0; pos--) {
+            fprintf(out, " %3.0f", percent(g->bit_errors[pos], g->wrong_first));
+        }
+        fprintf(out, "\n");
+    }
+}
+
+/**
+ * Entry point of `bwt --report`
+ *
+ * @param paths Results files to scan
+ * @param npaths Number of files
+ * @param threads Number of worker threads
+ * @return Exit status for main
+ */
+int bwt_report_main(char* const* paths, int npaths, int threads) {
+    struct bwt_store_map* maps = calloc((size_t)(npaths > 0 ? npaths : 1), sizeof(*maps));
+    struct bwt_report* report = malloc(sizeof(*report));
+    size_t nmaps = 0;
+    int status = 0;
+
+    if (maps == NULL || report == NULL) {
+        free(maps);
+        free(report);
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    for (int i = 0; i < npaths; i++) {
+        if (bwt_store_map_open(&maps[nmaps], paths[i]) < 0) {
+            perror(paths[i]);
+            status = 1;
+            continue;
+        }
+        nmaps++;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (bwt_report_scan(maps, nmaps, threads, report) < 0) {
+        fprintf(stderr, "Could not start report threads\n");
+        status = 1;
+    } else {
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double ms = (double)(end.tv_sec - start.tv_sec) * 1e3 + (double)(end.tv_nsec - start.tv_nsec) / 1e6;
+        printf("bwt report: %llu questions from %zu file(s), %d thread(s), %.1f ms\n\n",
+               (unsigned long long)report->records, nmaps, threads, ms);
+        bwt_report_print(stdout, report);
+    }
+
+    for (size_t m = 0; m < nmaps; m++) {
+        bwt_store_map_close(&maps[m]);
+    }
+    free(maps);
+    free(report);
+    return status;
+}
@@ -0,0 +1,59 @@
+/*
+ * bwt_report.h - Analytics over recorded results for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * `bwt --report FILE...` scans results files written with --results and
+ * prints, for every (topic, width, signedness) group, accuracy, latency
+ * percentiles and how often each bit position was wrong in first answers.
+ *
+ * Records are split into chunks that worker threads claim one at a time.
+ * Every thread fills its own partial report and the partials are merged at
+ * the end, which works because every statistic here is a sum: counters,
+ * per-bit error counts and log-bucketed latency histograms.
+ */
+
+#ifndef BWT_REPORT_H
+#define BWT_REPORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "bwt_question.h"
+#include "bwt_store.h"
+
+#define BWT_REPORT_GROUPS (BWT_TOPIC_COUNT * BWT_WIDTH_COUNT * 2)
+#define BWT_SKETCH_SUB_BITS 4  // 16 sub-buckets per power of two, ~6% error
+#define BWT_SKETCH_BUCKETS (33 << BWT_SKETCH_SUB_BITS)
+
+// Mergeable latency histogram with logarithmic buckets
+struct bwt_sketch {
+    uint64_t count;
+    uint64_t buckets[BWT_SKETCH_BUCKETS];
+};
+
+struct bwt_report_group {
+    uint64_t attempts;       // questions asked
+    uint64_t first_try;      // answered correctly on the first attempt
+    uint64_t correct;        // answered correctly eventually
+    uint64_t gave_up;
+    uint64_t wrong_first;    // questions whose first answer was wrong
+    uint64_t bit_errors[BWT_MAX_WIDTH];  // wrong first answers per bit position
+    struct bwt_sketch latency;
+};
+
+struct bwt_report {
+    uint64_t records;
+    struct bwt_report_group group[BWT_REPORT_GROUPS];
+};
+
+void bwt_sketch_add(struct bwt_sketch* s, uint32_t value);
+void bwt_sketch_merge(struct bwt_sketch* into, const struct bwt_sketch* from);
+uint32_t bwt_sketch_quantile(const struct bwt_sketch* s, double q);
+int bwt_report_scan(const struct bwt_store_map* maps, size_t nmaps, int threads, struct bwt_report* out);
+void bwt_report_print(FILE* out, const struct bwt_report* r);
+int bwt_report_main(char* const* paths, int npaths, int threads);
+
+#endif // BWT_REPORT_H
@@ -0,0 +1,192 @@
+/*
+ * bwt_sched.c - Adaptive question scheduler for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * Spaced repetition over buckets: a bucket answered right first time is
+ * pushed twice as far into the future as last time, while a bucket that
+ * needed retries comes back after a couple of other questions. Buckets
+ * with a history of mistakes never get pushed as far out as the rest.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "bwt_sched.h"
+
+#define FIRST_INTERVAL 2   // interval of a bucket that has never been asked
+#define RETRY_INTERVAL 3   // questions before a missed bucket is asked again
+#define MAX_INTERVAL (BWT_SCHED_SLOTS - 1)
+
+/**
+ * Append a bucket to the tail of the circular list of a slot
+ */
+static void link_bucket(struct bwt_sched* s, uint16_t id, uint8_t slot) {
+    struct bwt_sched_bucket* b = &s->bucket[id];
+    uint16_t head = s->head[slot];
+
+    b->slot = slot;
+    if (head == BWT_SCHED_NIL) {
+        b->prev = id;
+        b->next = id;
+        s->head[slot] = id;
+        s->nonempty |= UINT64_C(1) << slot;
+        return;
+    }
+    // Insert just before the head, i.e. at the tail of the list
+    uint16_t tail = s->bucket[head].prev;
+    b->prev = tail;
+    b->next = head;
+    s->bucket[tail].next = id;
+    s->bucket[head].prev = id;
+}
+
+/**
+ * Remove a bucket from the list of its slot
+ */
+static void unlink_bucket(struct bwt_sched* s, uint16_t id) {
+    struct bwt_sched_bucket* b = &s->bucket[id];
+
+    if (b->next == id) {
+        s->head[b->slot] = BWT_SCHED_NIL;
+        s->nonempty &= ~(UINT64_C(1) << b->slot);
+        return;
+    }
+    s->bucket[b->prev].next = b->next;
+    s->bucket[b->next].prev = b->prev;
+    if (s->head[b->slot] == id) {
+        s->head[b->slot] = b->next;
+    }
+}
+
+/**
+ * Number of questions before a bucket is first asked, lowest for the areas
+ * students find hard and for 8-bit questions
+ */
+static uint32_t initial_delay(uint16_t id, uint8_t topic, uint8_t width, bool is_signed, uint8_t pattern) {
+    // Spread buckets over the wheel so equal ones do not all fall due together
+    uint32_t delay = 4 + (id * 7u) % 24;
+
+    if ((topic == BWT_TOPIC_NOT && is_signed) || topic == BWT_TOPIC_SHR) {
+        delay = id % 4;  // ~x of a signed int and sign extension on >>
+    } else if (pattern == BWT_PATTERN_SIGN_SET && is_signed) {
+        delay /= 2;
+    }
+    // Mostly 8-bit, occasionally 16-bit and rarely 32-bit questions
+    if (width == 16) {
+        delay += 8;
+    } else if (width == 32) {
+        delay += 24;
+    }
+    return delay < MAX_INTERVAL ? delay : MAX_INTERVAL;
+}
+
+/**
+ * Dense bucket id of a (topic, width, signedness, pattern) combination
+ *
+ * @return Bucket id in the range [0, BWT_SCHED_BUCKETS)
+ */
+uint16_t bwt_sched_bucket_id(uint8_t topic, uint8_t width, bool is_signed, uint8_t pattern) {
+    return (uint16_t)(((topic * BWT_WIDTH_COUNT + bwt_width_index(width)) * 2
+                       + (is_signed ? 1 : 0)) * BWT_PATTERN_COUNT + pattern);
+}
+
+/**
+ * Split a bucket id back into its topic, width, signedness and pattern
+ */
+void bwt_sched_decode(uint16_t id, uint8_t* topic, uint8_t* width, bool* is_signed, uint8_t* pattern) {
+    *pattern = id % BWT_PATTERN_COUNT;
+    id /= BWT_PATTERN_COUNT;
+    *is_signed = (id % 2) != 0;
+    id /= 2;
+    *width = bwt_width_from_index(id % BWT_WIDTH_COUNT);
+    *topic = (uint8_t)(id / BWT_WIDTH_COUNT);
+}
+
+/**
+ * Initialise the scheduler state of a new learner
+ *
+ * @param s Scheduler state to initialise
+ */
+void bwt_sched_init(struct bwt_sched* s) {
+    bwt_history_init(&s->history);
+    s->nonempty = 0;
+    s->now = 0;
+    for (int i = 0; i < BWT_SCHED_SLOTS; i++) {
+        s->head[i] = BWT_SCHED_NIL;
+    }
+    for (uint16_t id = 0; id < BWT_SCHED_BUCKETS; id++) {
+        uint8_t topic, width, pattern;
+        bool is_signed;
+        bwt_sched_decode(id, &topic, &width, &is_signed, &pattern);
+
+        s->bucket[id].interval = FIRST_INTERVAL;
+        s->bucket[id].streak = 0;
+        s->bucket[id].misses = 0;
+        link_bucket(s, id, (uint8_t)(initial_delay(id, topic, width, is_signed, pattern)
+                                     % BWT_SCHED_SLOTS));
+    }
+}
+
+/**
+ * Pick the bucket for the next question
+ *
+ * Takes the first bucket of the earliest non-empty slot, moving the clock
+ * forward to it if nothing is due yet, and rotates that slot so buckets
+ * that fall due together take turns.
+ *
+ * @param s Scheduler state
+ * @return Bucket id of the next question
+ */
+uint16_t bwt_sched_select(struct bwt_sched* s) {
+    uint32_t now = s->now % BWT_SCHED_SLOTS;
+    // Rotate the bitmap so that bit 0 is the current slot
+    uint64_t due = (s->nonempty >> now) | (now ? s->nonempty << (BWT_SCHED_SLOTS - now) : 0);
+    uint32_t ahead = (uint32_t)__builtin_ctzll(due);
+
+    s->now += ahead;
+    uint8_t slot = (uint8_t)((now + ahead) % BWT_SCHED_SLOTS);
+    uint16_t id = s->head[slot];
+    s->head[slot] = s->bucket[id].next;
+    return id;
+}
+
+/**
+ * Record the outcome of a question asked from a bucket and reschedule it
+ *
+ * @param s Scheduler state
+ * @param id Bucket the question was drawn from
+ * @param correct true if the student eventually answered correctly
+ * @param attempts Number of answers given, including the correct one
+ */
+void bwt_sched_update(struct bwt_sched* s, uint16_t id, bool correct, uint32_t attempts) {
+    struct bwt_sched_bucket* b = &s->bucket[id];
+    uint32_t delay;
+    uint8_t topic, width, pattern;
+    bool is_signed;
+
+    bwt_sched_decode(id, &topic, &width, &is_signed, &pattern);
+    bwt_history_push(&s->history, topic, width, bwt_outcome_of(correct, attempts));
+
+    if (correct && attempts <= 1) {
+        if (b->streak < UINT8_MAX) {
+            b->streak++;
+        }
+        // Weak buckets are capped closer in: 63 questions, down to 15
+        uint32_t cap = MAX_INTERVAL >> (b->misses < 2 ? b->misses : 2);
+        uint32_t next = (uint32_t)b->interval * 2;
+        b->interval = (uint8_t)(next < cap ? next : cap);
+        delay = b->interval;
+    } else {
+        b->streak = 0;
+        if (b->misses < UINT8_MAX) {
+            b->misses++;
+        }
+        b->interval = FIRST_INTERVAL;
+        delay = correct ? RETRY_INTERVAL : RETRY_INTERVAL - 1;
+    }
+
+    unlink_bucket(s, id);
+    link_bucket(s, id, (uint8_t)((s->now + delay) % BWT_SCHED_SLOTS));
+}
@@ -0,0 +1,52 @@
+/*
+ * bwt_sched.h - Adaptive question scheduler for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * Every (topic, width, signedness, operand pattern) combination is a bucket.
+ * Buckets are kept in a bucketed priority queue keyed by the question number
+ * at which they are next due: a wheel of BWT_SCHED_SLOTS circular lists plus
+ * a 64-bit bitmap of non-empty slots, so selecting the next bucket and
+ * rescheduling it after an answer are both O(1). The whole state, with the
+ * learner's bit-packed answer history (see bwt_history.h), is a fixed-size
+ * struct with no pointers, one per learner.
+ */
+
+#ifndef BWT_SCHED_H
+#define BWT_SCHED_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bwt_history.h"
+#include "bwt_question.h"
+
+#define BWT_SCHED_SLOTS 64        // wheel size, also the longest possible interval + 1
+#define BWT_SCHED_BUCKETS (BWT_TOPIC_COUNT * BWT_WIDTH_COUNT * 2 * BWT_PATTERN_COUNT)
+#define BWT_SCHED_NIL UINT16_MAX
+
+struct bwt_sched_bucket {
+    uint16_t prev;      // neighbours in the circular list of its slot
+    uint16_t next;
+    uint8_t slot;       // wheel slot the bucket is due in
+    uint8_t interval;   // questions until it is due again after a good answer
+    uint8_t streak;     // consecutive first-try correct answers
+    uint8_t misses;     // answers that needed retries or were given up, saturating
+};
+
+struct bwt_sched {
+    uint64_t nonempty;  // bit i is set when slot i holds at least one bucket
+    uint32_t now;       // position of the wheel, advanced when nothing is due
+    uint16_t head[BWT_SCHED_SLOTS];
+    struct bwt_sched_bucket bucket[BWT_SCHED_BUCKETS];
+    struct bwt_history history;  // how the learner's questions ended, kept by bwt_sched_update
+};
+
+void bwt_sched_init(struct bwt_sched* s);
+uint16_t bwt_sched_select(struct bwt_sched* s);
+void bwt_sched_update(struct bwt_sched* s, uint16_t id, bool correct, uint32_t attempts);
+uint16_t bwt_sched_bucket_id(uint8_t topic, uint8_t width, bool is_signed, uint8_t pattern);
+void bwt_sched_decode(uint16_t id, uint8_t* topic, uint8_t* width, bool* is_signed, uint8_t* pattern);
+
+#endif // BWT_SCHED_H
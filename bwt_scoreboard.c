@@ -0,0 +1,225 @@
+/*
+ * bwt_scoreboard.c - Shared-memory class statistics for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "bwt_scoreboard.h"
+
+_Static_assert(sizeof(struct bwt_score_slot) % BWT_CACHE_LINE == 0,
+               "scoreboard slots must fill whole cache lines");
+
+/**
+ * Name of the shared-memory segment for a port
+ *
+ * @param buf Output buffer
+ * @param size Size of the output buffer
+ * @param port Port the workers listen on
+ */
+void bwt_scoreboard_name(char* buf, size_t size, uint16_t port) {
+    snprintf(buf, size, "/bwt-scoreboard-%u", port);
+}
+
+/**
+ * Create (or reset) a scoreboard segment
+ *
+ * @param name Segment name from bwt_scoreboard_name
+ * @param slots Number of worker slots in use
+ * @return The mapped scoreboard, or NULL on error (errno is set)
+ */
+struct bwt_scoreboard* bwt_scoreboard_create(const char* name, uint32_t slots) {
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return NULL;
+    }
+    if (ftruncate(fd, sizeof(struct bwt_scoreboard)) < 0) {
+        close(fd);
+        shm_unlink(name);
+        return NULL;
+    }
+    struct bwt_scoreboard* sb = mmap(NULL, sizeof(*sb), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (sb == MAP_FAILED) {
+        shm_unlink(name);
+        return NULL;
+    }
+
+    // The truncated segment reads as zeros, which is every counter at 0
+    memcpy(sb->magic, BWT_SCOREBOARD_MAGIC, sizeof(sb->magic));
+    sb->version = BWT_SCOREBOARD_VERSION;
+    sb->slots = slots;
+    return sb;
+}
+
+/**
+ * Map an existing scoreboard read-only
+ *
+ * @param name Segment name from bwt_scoreboard_name
+ * @return The scoreboard, or NULL if there is none or it is not valid
+ */
+const struct bwt_scoreboard* bwt_scoreboard_attach(const char* name) {
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(struct bwt_scoreboard)) {
+        close(fd);
+        return NULL;
+    }
+    const struct bwt_scoreboard* sb = mmap(NULL, sizeof(*sb), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (sb == MAP_FAILED) {
+        return NULL;
+    }
+    if (memcmp(sb->magic, BWT_SCOREBOARD_MAGIC, sizeof(sb->magic)) != 0
+        || sb->version != BWT_SCOREBOARD_VERSION || sb->slots > BWT_SCOREBOARD_SLOTS) {
+        bwt_scoreboard_unmap(sb);
+        return NULL;
+    }
+    return sb;
+}
+
+/**
+ * Unmap a scoreboard
+ *
+ * @param sb The scoreboard, or NULL
+ */
+void bwt_scoreboard_unmap(const struct bwt_scoreboard* sb) {
+    if (sb != NULL) {
+        munmap((void*)sb, sizeof(*sb));
+    }
+}
+
+/**
+ * Count a graded answer in a worker's slot
+ *
+ * Only the owning worker writes a slot, so relaxed ordering is enough: the
+ * adds are atomic for readers and never contend with another writer.
+ *
+ * @param slot The worker's slot
+ * @param topic Topic of the question (enum bwt_topic)
+ * @param correct Whether the answer was correct
+ * @param latency_us Time from question to answer, counted for correct answers
+ */
+void bwt_score_record(struct bwt_score_slot* slot, uint8_t topic, bool correct, uint64_t latency_us) {
+    struct bwt_score_topic* t = &slot->topic[topic];
+    atomic_fetch_add_explicit(&t->answers, 1, memory_order_relaxed);
+    if (correct) {
+        uint64_t ms = latency_us / 1000;
+        int bucket = ms == 0 ? 0 : 64 - __builtin_clzll(ms);
+        if (bucket >= BWT_SCORE_LATENCY_BUCKETS) {
+            bucket = BWT_SCORE_LATENCY_BUCKETS - 1;
+        }
+        atomic_fetch_add_explicit(&t->correct, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&t->latency[bucket], 1, memory_order_relaxed);
+    }
+}
+
+/**
+ * Add up every slot of a scoreboard
+ *
+ * Counters are read one by one while workers keep updating them, so the
+ * totals are a consistent-enough snapshot, not an atomic one.
+ *
+ * @param sb The scoreboard
+ * @param out Receives the totals
+ */
+void bwt_scoreboard_sum(const struct bwt_scoreboard* sb, struct bwt_score_totals* out) {
+    memset(out, 0, sizeof(*out));
+    for (uint32_t s = 0; s < sb->slots; s++) {
+        const struct bwt_score_slot* slot = &sb->slot[s];
+        if (atomic_load_explicit(&slot->pid, memory_order_relaxed) != 0) {
+            out->workers++;
+            out->learners += atomic_load_explicit(&slot->learners, memory_order_relaxed);
+        }
+        out->sessions += atomic_load_explicit(&slot->sessions, memory_order_relaxed);
+        for (int t = 0; t < BWT_TOPIC_COUNT; t++) {
+            out->answers[t] += atomic_load_explicit(&slot->topic[t].answers, memory_order_relaxed);
+            out->correct[t] += atomic_load_explicit(&slot->topic[t].correct, memory_order_relaxed);
+            for (int b = 0; b < BWT_SCORE_LATENCY_BUCKETS; b++) {
+                out->latency[t][b] += atomic_load_explicit(&slot->topic[t].latency[b],
+                                                           memory_order_relaxed);
+            }
+        }
+    }
+}
+
+/**
+ * Upper bound in ms of the latency bucket holding quantile q
+ */
+static uint64_t latency_quantile(const uint64_t* buckets, uint64_t count, double q) {
+    uint64_t rank = (uint64_t)(q * (double)(count - 1));
+    uint64_t seen = 0;
+    for (int b = 0; b < BWT_SCORE_LATENCY_BUCKETS; b++) {
+        seen += buckets[b];
+        if (seen > rank) {
+            return UINT64_C(1) << b;
+        }
+    }
+    return UINT64_C(1) << (BWT_SCORE_LATENCY_BUCKETS - 1);
+}
+
+/**
+ * Print scoreboard totals as a table
+ *
+ * @param out Stream to print to
+ * @param t The totals
+ */
+void bwt_scoreboard_print(FILE* out, const struct bwt_score_totals* t) {
+    fprintf(out, "%u workers, %llu learners connected, %llu sessions served\n\n",
+            t->workers, (unsigned long long)t->learners, (unsigned long long)t->sessions);
+    fprintf(out, "%-8s %10s %10s %7s %9s %9s\n", "topic", "answers", "correct", "acc%", "p50 ms", "p90 ms");
+    for (int i = 0; i < BWT_TOPIC_COUNT; i++) {
+        if (t->answers[i] == 0) {
+            continue;
+        }
+        fprintf(out, "%-8s %10llu %10llu %7.1f", bwt_topic_name(i),
+                (unsigned long long)t->answers[i], (unsigned long long)t->correct[i],
+                100.0 * (double)t->correct[i] / (double)t->answers[i]);
+        if (t->correct[i] > 0) {
+            char p50[24], p90[24];
+            snprintf(p50, sizeof(p50), "<%llu",
+                     (unsigned long long)latency_quantile(t->latency[i], t->correct[i], 0.5));
+            snprintf(p90, sizeof(p90), "<%llu",
+                     (unsigned long long)latency_quantile(t->latency[i], t->correct[i], 0.9));
+            fprintf(out, " %9s %9s\n", p50, p90);
+        } else {
+            fprintf(out, " %9s %9s\n", "-", "-");
+        }
+    }
+}
+
+/**
+ * Print the class view of the workers serving a port
+ *
+ * @param port Port given to --serve
+ * @return Exit status for main
+ */
+int bwt_scoreboard_main(uint16_t port) {
+    char name[64];
+    struct bwt_score_totals totals;
+
+    bwt_scoreboard_name(name, sizeof(name), port);
+    const struct bwt_scoreboard* sb = bwt_scoreboard_attach(name);
+    if (sb == NULL) {
+        fprintf(stderr, "No bwt --serve scoreboard for port %u\n", port);
+        return 1;
+    }
+    bwt_scoreboard_sum(sb, &totals);
+    bwt_scoreboard_print(stdout, &totals);
+    bwt_scoreboard_unmap(sb);
+    return 0;
+}
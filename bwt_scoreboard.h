@@ -0,0 +1,74 @@
+/*
+ * bwt_scoreboard.h - Shared-memory class statistics for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * `bwt --serve PORT` runs several worker processes on one port. Each
+ * worker owns one slot of a POSIX shared-memory segment and is the only
+ * writer of it: per-topic answer and correct counters and a log2 latency
+ * histogram, updated with relaxed atomic adds. Slots are aligned to cache
+ * lines so that workers never write to the same line. A reader such as
+ * `bwt --scoreboard PORT` sums the slots with atomic loads whenever it
+ * likes, without locks and without asking the workers anything.
+ */
+
+#ifndef BWT_SCOREBOARD_H
+#define BWT_SCOREBOARD_H
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "bwt_question.h"
+
+#define BWT_SCOREBOARD_MAGIC "BWTSCB1"
+#define BWT_SCOREBOARD_VERSION 1
+#define BWT_SCOREBOARD_SLOTS 64          // most worker processes per port
+#define BWT_SCORE_LATENCY_BUCKETS 16     // <1 ms, then [2^(k-1), 2^k) ms, last open-ended
+#define BWT_CACHE_LINE 64
+
+struct bwt_score_topic {
+    atomic_uint_least64_t answers;       // graded answers, right or wrong
+    atomic_uint_least64_t correct;
+    atomic_uint_least64_t latency[BWT_SCORE_LATENCY_BUCKETS];  // of correct answers
+};
+
+// One worker's counters; the alignment pads every slot to whole cache lines
+struct bwt_score_slot {
+    alignas(BWT_CACHE_LINE) atomic_int pid;  // 0 while no worker owns the slot
+    atomic_uint learners;                    // connected now
+    atomic_uint_least64_t sessions;          // connections served
+    struct bwt_score_topic topic[BWT_TOPIC_COUNT];
+};
+
+struct bwt_scoreboard {
+    char magic[8];
+    uint32_t version;
+    uint32_t slots;
+    struct bwt_score_slot slot[BWT_SCOREBOARD_SLOTS];
+};
+
+// Sum of all slots at one moment
+struct bwt_score_totals {
+    uint32_t workers;
+    uint64_t learners;
+    uint64_t sessions;
+    uint64_t answers[BWT_TOPIC_COUNT];
+    uint64_t correct[BWT_TOPIC_COUNT];
+    uint64_t latency[BWT_TOPIC_COUNT][BWT_SCORE_LATENCY_BUCKETS];
+};
+
+void bwt_scoreboard_name(char* buf, size_t size, uint16_t port);
+struct bwt_scoreboard* bwt_scoreboard_create(const char* name, uint32_t slots);
+const struct bwt_scoreboard* bwt_scoreboard_attach(const char* name);
+void bwt_scoreboard_unmap(const struct bwt_scoreboard* sb);
+void bwt_score_record(struct bwt_score_slot* slot, uint8_t topic, bool correct, uint64_t latency_us);
+void bwt_scoreboard_sum(const struct bwt_scoreboard* sb, struct bwt_score_totals* out);
+void bwt_scoreboard_print(FILE* out, const struct bwt_score_totals* t);
+int bwt_scoreboard_main(uint16_t port);
+
+#endif // BWT_SCOREBOARD_H
@@ -0,0 +1,344 @@
+/*
+ * bwt_serve.c - Multi-process network practice server for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#include "bwt_serve.h"
+#include "libbwt.h"
+#include "bwt_catalog.h"
+#include "bwt_net.h"
+#include "bwt_probe.h"
+#include "bwt_scoreboard.h"
+#include "bwt_settings.h"
+
+enum { FIRST_SESSION = 2 };
+
+struct worker {
+    struct pollfd* fds;  // [0] listener, [1] settings watch, [FIRST_SESSION + i] session i
+    struct bwt_session** sessions;
+    size_t count;
+    size_t capacity;
+    struct bwt_score_slot* slot;
+};
+
+static volatile sig_atomic_t stopping = 0;
+
+static void on_stop_signal(int sig) {
+    (void)sig;
+    stopping = 1;
+}
+
+/**
+ * Write a whole reply to a learner
+ *
+ * Replies are a few hundred bytes and the learner is waiting for them, so
+ * a socket that cannot take one at once belongs to a client that stopped
+ * reading, and the connection is dropped rather than buffered for.
+ *
+ * @return 0 on success, -1 if the connection should be closed
+ */
+static int send_all(int fd, const char* buf, size_t len) {
+    ssize_t n;
+    do {
+        n = write(fd, buf, len);
+    } while (n < 0 && errno == EINTR);
+    return n == (ssize_t)len ? 0 : -1;
+}
+
+/**
+ * Send a session's pending output to its learner
+ *
+ * @return 0 on success, -1 if the connection should be closed
+ */
+static int flush_session(struct worker* w, size_t i) {
+    char out[1024];
+    size_t n, sent = 0;
+    while ((n = bwt_session_read(w->sessions[i], out, sizeof(out))) > 0) {
+        if (send_all(w->fds[FIRST_SESSION + i].fd, out, n) < 0) {
+            return -1;
+        }
+        sent += n;
+    }
+    BWT_PROBE2(flush, w->fds[FIRST_SESSION + i].fd, sent);
+    return 0;
+}
+
+static void record_answer(void* slot, int topic, bool correct, uint64_t latency_us) {
+    bwt_score_record(slot, (uint8_t)topic, correct, latency_us);
+}
+
+/**
+ * Close a session, moving the last session into its place
+ */
+static void drop_session(struct worker* w, size_t i) {
+    close(w->fds[FIRST_SESSION + i].fd);
+    bwt_session_destroy(w->sessions[i]);
+    w->count--;
+    w->fds[FIRST_SESSION + i] = w->fds[FIRST_SESSION + w->count];
+    w->sessions[i] = w->sessions[w->count];
+    atomic_store_explicit(&w->slot->learners, (unsigned)w->count, memory_order_relaxed);
+}
+
+/**
+ * Read what a learner sent and answer every complete line
+ *
+ * @return 0 on success, -1 if the connection should be closed
+ */
+static int read_session(struct worker* w, size_t i) {
+    char chunk[256];
+    ssize_t n = read(w->fds[FIRST_SESSION + i].fd, chunk, sizeof(chunk));
+    if (n == 0) {
+        return -1;
+    }
+    if (n < 0) {
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ? 0 : -1;
+    }
+
+    int status = bwt_session_feed(w->sessions[i], chunk, (size_t)n);
+    if (flush_session(w, i) < 0 || status != BWT_OK) {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Accept every pending connection and ask each learner a first question
+ */
+static void accept_sessions(struct worker* w) {
+    for (;;) {
+        int fd = accept(w->fds[0].fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                perror("accept");
+            }
+            return;
+        }
+        if (bwt_set_nonblocking(fd) < 0) {
+            close(fd);
+            continue;
+        }
+
+        if (w->count == w->capacity) {
+            size_t capacity = w->capacity ? w->capacity * 2 : 64;
+            struct pollfd* fds = realloc(w->fds, (FIRST_SESSION + capacity) * sizeof(*fds));
+            if (fds != NULL) {
+                w->fds = fds;
+            }
+            struct bwt_session** sessions = fds ? realloc(w->sessions, capacity * sizeof(*sessions)) : NULL;
+            if (sessions == NULL) {
+                close(fd);
+                return;
+            }
+            w->sessions = sessions;
+            w->capacity = capacity;
+        }
+
+        struct bwt_session* s = bwt_session_create();
+        if (s == NULL) {
+            close(fd);
+            return;
+        }
+        bwt_session_on_answer(s, record_answer, w->slot);
+        size_t i = w->count++;
+        w->fds[FIRST_SESSION + i] = (struct pollfd){ .fd = fd, .events = POLLIN };
+        w->sessions[i] = s;
+        atomic_fetch_add_explicit(&w->slot->sessions, 1, memory_order_relaxed);
+        atomic_store_explicit(&w->slot->learners, (unsigned)w->count, memory_order_relaxed);
+
+        const char* welcome = bwt_msg_text(MSG_SERVE_WELCOME);
+        if (send_all(fd, welcome, strlen(welcome)) < 0 || flush_session(w, i) < 0) {
+            drop_session(w, i);
+        }
+    }
+}
+
+/**
+ * Serve learners in a worker process until it is told to stop
+ *
+ * @param port Port to listen on, shared with the other workers
+ * @param slot This worker's scoreboard slot
+ * @return Exit status for the worker
+ */
+static int run_worker(uint16_t port, struct bwt_score_slot* slot) {
+    struct worker w = { .slot = slot };
+
+    int listener = bwt_listen_tcp(port, true);
+    if (listener < 0) {
+        perror("listen");
+        return 1;
+    }
+    w.fds = malloc(FIRST_SESSION * sizeof(*w.fds));
+    if (w.fds == NULL) {
+        close(listener);
+        return 1;
+    }
+    w.fds[0] = (struct pollfd){ .fd = listener, .events = POLLIN };
+    // Each worker reloads the settings file itself; sessions pick the new
+    // settings up with their next question. poll() skips a negative fd.
+    w.fds[1] = (struct pollfd){ .fd = bwt_settings_watch(), .events = POLLIN };
+
+    while (!stopping) {
+        if (poll(w.fds, FIRST_SESSION + w.count, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("poll");
+            break;
+        }
+        for (size_t i = 0; i < w.count;) {
+            if ((w.fds[FIRST_SESSION + i].revents & (POLLIN | POLLHUP | POLLERR)) && read_session(&w, i) < 0) {
+                drop_session(&w, i);
+                w.fds[FIRST_SESSION + i].revents = 0;  // the moved session is handled next poll
+            } else {
+                i++;
+            }
+        }
+        if (w.fds[1].revents & POLLIN) {
+            bwt_settings_reload(w.fds[1].fd);
+        }
+        if (w.fds[0].revents & POLLIN) {
+            accept_sessions(&w);
+        }
+    }
+
+    while (w.count > 0) {
+        drop_session(&w, w.count - 1);
+    }
+    free(w.sessions);
+    if (w.fds[1].fd >= 0) {
+        close(w.fds[1].fd);
+    }
+    free(w.fds);
+    close(listener);
+    return 0;
+}
+
+/**
+ * Fork a worker into a scoreboard slot
+ *
+ * @return The worker's pid, or -1 on error
+ */
+static pid_t start_worker(uint16_t port, struct bwt_scoreboard* sb, int index) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        bwt_srand((uint64_t)time(NULL) ^ (uint64_t)getpid());  // not the parent's sequence
+        _exit(run_worker(port, &sb->slot[index]));
+    }
+    if (pid > 0) {
+        atomic_store_explicit(&sb->slot[index].pid, (int)pid, memory_order_relaxed);
+    }
+    return pid;
+}
+
+/**
+ * Run the worker processes for a port and restart any that crash
+ *
+ * @param port Port the workers listen on
+ * @param workers Number of worker processes
+ * @return Exit status for main
+ */
+int bwt_serve_main(uint16_t port, int workers) {
+    char name[64];
+    struct sigaction sa = { .sa_handler = on_stop_signal };
+    int running = 0;
+
+    if (workers < 1 || workers > BWT_SCOREBOARD_SLOTS) {
+        fprintf(stderr, "--workers must be between 1 and %d\n", BWT_SCOREBOARD_SLOTS);
+        return 1;
+    }
+
+    bwt_scoreboard_name(name, sizeof(name), port);
+    struct bwt_scoreboard* sb = bwt_scoreboard_create(name, (uint32_t)workers);
+    if (sb == NULL) {
+        perror(name);
+        return 1;
+    }
+
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+    bwt_raise_fd_limit();
+    fflush(stdout);  // or the children flush the parent's buffered output too
+
+    for (int i = 0; i < workers; i++) {
+        if (start_worker(port, sb, i) < 0) {
+            perror("fork");
+            stopping = 1;
+            break;
+        }
+        running++;
+    }
+    if (!stopping) {
+        char port_dec[BWT_MSG_INT_SIZE], workers_dec[BWT_MSG_INT_SIZE];
+        BWT_MSG_PRINT(MSG_SERVE_LISTENING, bwt_msg_int(port_dec, port), bwt_msg_int(workers_dec, workers));
+        fflush(stdout);
+    }
+
+    while (running > 0) {
+        int wstatus;
+        pid_t pid = waitpid(-1, &wstatus, 0);
+        if (pid < 0) {
+            if (errno != EINTR) {
+                break;
+            }
+            if (stopping) {
+                for (int i = 0; i < workers; i++) {
+                    pid_t worker = atomic_load_explicit(&sb->slot[i].pid, memory_order_relaxed);
+                    if (worker > 0) {
+                        kill(worker, SIGTERM);
+                    }
+                }
+            }
+            continue;
+        }
+
+        for (int i = 0; i < workers; i++) {
+            if (atomic_load_explicit(&sb->slot[i].pid, memory_order_relaxed) != pid) {
+                continue;
+            }
+            atomic_store_explicit(&sb->slot[i].pid, 0, memory_order_relaxed);
+            atomic_store_explicit(&sb->slot[i].learners, 0, memory_order_relaxed);
+            running--;
+
+            // Restart workers that crashed; ones that exited or were stopped stay down
+            int sig = WIFSIGNALED(wstatus) ? WTERMSIG(wstatus) : 0;
+            if (!stopping && sig != 0 && sig != SIGINT && sig != SIGTERM) {
+                char pid_dec[BWT_MSG_INT_SIZE], sig_dec[BWT_MSG_INT_SIZE];
+                bwt_msg_print(stderr, MSG_SERVE_WORKER_DIED,
+                              BWT_MSG_ARGS(bwt_msg_int(pid_dec, pid), bwt_msg_int(sig_dec, sig)));
+                if (start_worker(port, sb, i) > 0) {
+                    running++;
+                }
+            }
+        }
+    }
+
+    struct bwt_score_totals totals;
+    bwt_scoreboard_sum(sb, &totals);
+    bwt_scoreboard_print(stdout, &totals);
+    bwt_scoreboard_unmap(sb);
+    shm_unlink(name);
+    return 0;
+}
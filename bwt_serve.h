@@ -0,0 +1,22 @@
+/*
+ * bwt_serve.h - Multi-process network practice server for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * `bwt --serve PORT --workers N` forks N worker processes that each open
+ * their own SO_REUSEPORT socket on PORT, so the kernel spreads learners
+ * across them. Every worker runs adaptive practice for its learners in a
+ * poll loop. A crashed worker takes only its own learners down and is
+ * restarted. Class statistics go to a shared-memory scoreboard (see
+ * bwt_scoreboard.h).
+ */
+
+#ifndef BWT_SERVE_H
+#define BWT_SERVE_H
+
+#include <stdint.h>
+
+int bwt_serve_main(uint16_t port, int workers);
+
+#endif // BWT_SERVE_H
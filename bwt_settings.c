@@ -0,0 +1,276 @@
+/*
+ * bwt_settings.c - Reloadable settings snapshots for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ */
+
+#define _POSIX_C_SOURCE 200809L  // strdup
+
+#include "bwt_settings.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+_Thread_local const struct bwt_settings* bwt_settings_local;
+
+static _Atomic(struct bwt_settings*) published;
+// Taken to swap the published snapshot or to hold it, so a holder never
+// counts a reference on a snapshot another thread has just released
+static pthread_mutex_t publish_lock = PTHREAD_MUTEX_INITIALIZER;
+static char* settings_path;  // file bwt_settings_load read, for bwt_settings_watch
+
+/**
+ * Publish a new snapshot and drop the reference the old one had for being
+ * published; sessions still holding it keep it until they move on
+ */
+static void publish(struct bwt_settings* next) {
+    pthread_mutex_lock(&publish_lock);
+    struct bwt_settings* old = atomic_load_explicit(&published, memory_order_relaxed);
+    next->version = old != NULL ? old->version + 1 : 1;
+    atomic_init(&next->refs, 1);
+    atomic_store_explicit(&published, next, memory_order_release);
+    pthread_mutex_unlock(&publish_lock);
+    if (old != NULL) {
+        bwt_settings_release(old);
+    }
+}
+
+/**
+ * Settings now in effect, the built-in defaults if none were loaded
+ *
+ * Only valid until the next reload; sessions hold theirs instead.
+ */
+const struct bwt_settings* bwt_settings_current(void) {
+    struct bwt_settings* s = atomic_load_explicit(&published, memory_order_acquire);
+    if (s == NULL) {
+        bwt_settings_load(NULL);
+        s = atomic_load_explicit(&published, memory_order_acquire);
+    }
+    return s;
+}
+
+/**
+ * Distributions the calling thread's questions are drawn from
+ */
+const struct bwt_dist_config* bwt_dist_active(void) {
+    const struct bwt_settings* s = bwt_settings_local;
+    return s != NULL ? &s->dists : &bwt_settings_current()->dists;
+}
+
+/**
+ * Take a reference to the settings now in effect
+ *
+ * Safe while another thread publishes: the snapshot keeps its reference for
+ * being published until the count is taken.
+ *
+ * @return The snapshot, valid until bwt_settings_release
+ */
+const struct bwt_settings* bwt_settings_hold(void) {
+    (void)bwt_settings_current();  // publish the defaults if nothing was loaded
+    pthread_mutex_lock(&publish_lock);
+    struct bwt_settings* s = atomic_load_explicit(&published, memory_order_relaxed);
+    atomic_fetch_add_explicit(&s->refs, 1, memory_order_relaxed);
+    pthread_mutex_unlock(&publish_lock);
+    return s;
+}
+
+/**
+ * Drop a reference, freeing the snapshot if it was the last one
+ */
+void bwt_settings_release(const struct bwt_settings* s) {
+    if (s != NULL && atomic_fetch_sub_explicit(&((struct bwt_settings*)s)->refs, 1, memory_order_acq_rel) == 1) {
+        free((struct bwt_settings*)s);
+    }
+}
+
+/**
+ * Move a session to the newest settings, between questions, and have the
+ * calling thread's samplers read them
+ *
+ * When nothing changed this is one atomic load and a compare.
+ *
+ * @param held The session's reference, replaced if the settings changed
+ */
+void bwt_settings_use(const struct bwt_settings** held) {
+    const struct bwt_settings* now = atomic_load_explicit(&published, memory_order_acquire);
+    if (*held != now && now != NULL) {
+        bwt_settings_release(*held);
+        *held = bwt_settings_hold();
+    }
+    bwt_settings_local = *held;
+}
+
+/**
+ * Between questions, publish the settings file again if the watch
+ * descriptor saw it change, then move the session to the newest settings
+ *
+ * Without a change this costs one read() that finds nothing.
+ *
+ * @param fd Descriptor from bwt_settings_watch, or -1 to only move on
+ * @param held The session's reference, as for bwt_settings_use
+ */
+void bwt_settings_refresh(int fd, const struct bwt_settings** held) {
+    if (fd >= 0) {
+        bwt_settings_reload(fd);
+    }
+    bwt_settings_use(held);
+}
+
+/**
+ * Stop reading a session's settings on this thread, before it releases them
+ */
+void bwt_settings_leave(const struct bwt_settings* held) {
+    if (bwt_settings_local == held) {
+        bwt_settings_local = NULL;
+    }
+}
+
+/**
+ * Parse settings into a new snapshot and publish it
+ *
+ * @param fp Settings lines, or NULL for the built-in defaults only
+ * @param name Name of the settings shown in error messages
+ * @param strict Publish nothing if any line is bad
+ * @return Number of bad lines, or -1 if out of memory
+ */
+static int load(FILE* fp, const char* name, bool strict) {
+    struct bwt_settings* next = malloc(sizeof(*next));
+    int errors = 0;
+
+    if (next == NULL) {
+        return -1;
+    }
+    bwt_dist_defaults(&next->dists);
+    if (fp != NULL) {
+        errors = bwt_dist_load_stream(&next->dists, fp, name);
+    }
+    if (strict && errors > 0) {
+        free(next);
+        return errors;
+    }
+    publish(next);
+    return errors;
+}
+
+/**
+ * Load the settings file and publish it; bad lines are reported on stderr
+ * and leave those settings at their defaults
+ *
+ * @param path Settings file, or NULL for the built-in defaults
+ * @return Number of bad lines, or -1 if the file could not be opened (the
+ *         defaults are published), which bwt_settings_watch still watches
+ */
+int bwt_settings_load(const char* path) {
+    if (path == NULL) {
+        return load(NULL, NULL, false);
+    }
+    char* copy = strdup(path);
+    if (copy != NULL) {
+        free(settings_path);
+        settings_path = copy;
+    }
+    FILE* fp = fopen(path, "r");
+    int errors = load(fp, path, false);
+    if (fp == NULL) {
+        return -1;
+    }
+    fclose(fp);
+    return errors;
+}
+
+/**
+ * Publish settings read from a stream, such as those saved in a session
+ * recording
+ *
+ * @param fp Settings lines, or NULL for the built-in defaults
+ * @param name Name of the settings shown in error messages
+ * @return Number of bad lines
+ */
+int bwt_settings_load_stream(FILE* fp, const char* name) {
+    return load(fp, name, false);
+}
+
+/**
+ * Watch the settings file last loaded for changes
+ *
+ * The directory is watched rather than the file, so a file renamed over it
+ * or created after startup is noticed too.
+ *
+ * @return Non-blocking inotify descriptor, readable after a change, or -1
+ */
+int bwt_settings_watch(void) {
+    if (settings_path == NULL) {
+        return -1;
+    }
+    char dir[PATH_MAX];
+    const char* slash = strrchr(settings_path, '/');
+    if (slash == NULL || slash == settings_path) {
+        strcpy(dir, slash == NULL ? "." : "/");
+    } else if ((size_t)(slash - settings_path) < sizeof(dir)) {
+        memcpy(dir, settings_path, (size_t)(slash - settings_path));
+        dir[slash - settings_path] = '\0';
+    } else {
+        return -1;
+    }
+
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    if (inotify_add_watch(fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * Read the changes a watch descriptor reported and reload the settings if
+ * the file was among them
+ *
+ * @param fd Descriptor from bwt_settings_watch
+ * @return 1 if new settings were published, 0 if the file did not change,
+ *         -1 if it had errors (reported on stderr) or could not be read, in
+ *         which case the settings in effect are kept
+ */
+int bwt_settings_reload(int fd) {
+    alignas(struct inotify_event) char buf[4096];
+    const char* slash = strrchr(settings_path, '/');
+    const char* name = slash != NULL ? slash + 1 : settings_path;
+    bool changed = false;
+    ssize_t n;
+
+    while ((n = read(fd, buf, sizeof(buf))) > 0) {
+        for (char* p = buf; p < buf + n;) {
+            const struct inotify_event* e = (const struct inotify_event*)p;
+            if (e->len > 0 && strcmp(e->name, name) == 0) {
+                changed = true;
+            }
+            p += sizeof(*e) + e->len;
+        }
+    }
+    if (!changed) {
+        return 0;
+    }
+
+    FILE* fp = fopen(settings_path, "r");
+    if (fp == NULL) {
+        fprintf(stderr, "%s: %s; keeping the current settings\n", settings_path, strerror(errno));
+        return -1;
+    }
+    int errors = load(fp, settings_path, true);
+    fclose(fp);
+    if (errors != 0) {
+        fprintf(stderr, "%s: keeping the current settings\n", settings_path);
+        return -1;
+    }
+    return 1;
+}
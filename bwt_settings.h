@@ -0,0 +1,63 @@
+/*
+ * bwt_settings.h - Reloadable settings snapshots for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * The settings file is parsed once into a snapshot that is never changed
+ * afterwards, and the snapshot in effect is published through a single
+ * atomic pointer. Changing the settings means parsing the file into a new
+ * snapshot and swapping the pointer, RCU style, so nothing that reads
+ * settings ever takes a lock or sees a half-updated distribution.
+ *
+ * A session holds a reference to the snapshot it works with and moves to
+ * the newest one between questions (bwt_settings_use), so each question is
+ * drawn from one consistent set of settings; an old snapshot is freed when
+ * the last session holding it moves on or ends. The coverage filter size
+ * only applies to sessions started after a change.
+ *
+ * The distribution samplers read the snapshot the calling thread is using,
+ * bwt_settings_local, or the published one if it uses none. With
+ * bwt_settings_watch() a process gets an inotify descriptor that becomes
+ * readable when the file is rewritten or replaced (editors usually rename
+ * a new file over it); bwt_settings_reload() then publishes the new
+ * settings, unless the file has errors, in which case the current ones
+ * are kept. `bwt --serve` workers watch their settings file this way, and
+ * the menu, --serve-menu, --protocol, --tui and --broadcast reload it
+ * between questions with bwt_settings_refresh(), so it can be edited
+ * without dropping anyone.
+ *
+ * Publishing and taking references may happen on different threads: the
+ * swap and the reference count are taken under one lock, while reading
+ * settings and checking for a change stay lock-free.
+ */
+
+#ifndef BWT_SETTINGS_H
+#define BWT_SETTINGS_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "bwt_dist.h"
+
+struct bwt_settings {
+    struct bwt_dist_config dists;
+    uint32_t version;  // 1 for the first settings published, then counting up
+    atomic_uint refs;  // holders; being published counts as one
+};
+
+extern _Thread_local const struct bwt_settings* bwt_settings_local;
+
+const struct bwt_settings* bwt_settings_current(void);
+const struct bwt_settings* bwt_settings_hold(void);
+void bwt_settings_release(const struct bwt_settings* s);
+void bwt_settings_use(const struct bwt_settings** held);
+void bwt_settings_refresh(int fd, const struct bwt_settings** held);
+void bwt_settings_leave(const struct bwt_settings* held);
+int bwt_settings_load(const char* path);
+int bwt_settings_load_stream(FILE* fp, const char* name);
+int bwt_settings_watch(void);
+int bwt_settings_reload(int fd);
+
+#endif // BWT_SETTINGS_H
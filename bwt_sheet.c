@@ -0,0 +1,189 @@
+/*
+ * bwt_sheet.c - Answer sheets graded many at a time for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ */
+
+#include "bwt_sheet.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bwt_kernels.h"
+
+#define ALIGNMENT 32  // one AVX2 vector
+
+/**
+ * Allocate zeroed, vector-aligned memory
+ *
+ * @param size Bytes, a multiple of ALIGNMENT
+ */
+static void* alloc_aligned(size_t size) {
+    void* p = aligned_alloc(ALIGNMENT, size > 0 ? size : ALIGNMENT);
+    if (p != NULL) {
+        memset(p, 0, size);
+    }
+    return p;
+}
+
+/**
+ * Lay out and allocate a set of empty answer sheets
+ *
+ * Every answer starts out not valid and every key as zero.
+ *
+ * @param s The sheets
+ * @param widths Width of each question, 8, 16 or 32 bits
+ * @param questions Number of questions per sheet
+ * @param count Number of sheets
+ * @param shared_key true if every sheet has the same key, set with sheet 0
+ * @return 0 on success, -1 if memory could not be allocated
+ */
+int bwt_sheets_init(struct bwt_sheets* s, const uint8_t* widths, uint32_t questions, size_t count,
+                    bool shared_key) {
+    uint32_t per_width[BWT_WIDTH_COUNT] = { 0 };
+
+    memset(s, 0, sizeof(*s));
+    s->questions = questions;
+    s->count = count;
+    s->shared_key = shared_key;
+    s->slots = malloc((questions > 0 ? questions : 1) * sizeof(*s->slots));
+    if (s->slots == NULL) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < questions; i++) {
+        uint8_t w = bwt_width_index(widths[i]);
+        s->slots[i] = (struct bwt_sheet_slot){ w, per_width[w]++ };
+    }
+    for (uint8_t w = 0; w < BWT_WIDTH_COUNT; w++) {
+        s->blocks[w] = (per_width[w] + BWT_SHEET_LANES - 1) / BWT_SHEET_LANES;
+        s->offset[w] = s->row_bytes;
+        s->first_word[w] = s->words;
+        s->row_bytes += (size_t)s->blocks[w] * BWT_SHEET_LANES * bwt_width_from_index(w) / 8;
+        s->words += s->blocks[w];
+    }
+
+    s->keys = alloc_aligned((shared_key ? 1 : count) * s->row_bytes);
+    s->answers = alloc_aligned(count * s->row_bytes);
+    s->valid = calloc(count * s->words + 1, sizeof(uint32_t));
+    s->correct = calloc(count * s->words + 1, sizeof(uint32_t));
+    s->score = calloc(count + 1, sizeof(uint32_t));
+    if (s->keys == NULL || s->answers == NULL || s->valid == NULL || s->correct == NULL || s->score == NULL) {
+        bwt_sheets_free(s);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Free the memory of a set of sheets
+ */
+void bwt_sheets_free(struct bwt_sheets* s) {
+    free(s->slots);
+    free(s->keys);
+    free(s->answers);
+    free(s->valid);
+    free(s->correct);
+    free(s->score);
+    memset(s, 0, sizeof(*s));
+}
+
+/**
+ * Store a value of a question in a row, masked to the question's width
+ */
+static void store(const struct bwt_sheets* s, uint8_t* row, uint32_t question, uint32_t bits) {
+    const struct bwt_sheet_slot* slot = &s->slots[question];
+    uint8_t* values = row + s->offset[slot->width_index];
+    switch (slot->width_index) {
+        case 0:
+            ((uint8_t*)values)[slot->slot] = (uint8_t)bits;
+            break;
+        case 1:
+            ((uint16_t*)values)[slot->slot] = (uint16_t)bits;
+            break;
+        default:
+            ((uint32_t*)values)[slot->slot] = bits;
+            break;
+    }
+}
+
+// Bitmap word and bit of a question
+static inline size_t bitmap_word(const struct bwt_sheets* s, size_t sheet, uint32_t question) {
+    const struct bwt_sheet_slot* slot = &s->slots[question];
+    return sheet * s->words + s->first_word[slot->width_index] + slot->slot / BWT_SHEET_LANES;
+}
+
+static inline uint32_t bitmap_bit(const struct bwt_sheets* s, uint32_t question) {
+    return UINT32_C(1) << (s->slots[question].slot % BWT_SHEET_LANES);
+}
+
+/**
+ * Set the expected answer of a question
+ *
+ * @param s The sheets
+ * @param sheet The sheet, ignored if the key is shared
+ * @param question The question, from 0
+ * @param bits The expected bit pattern
+ */
+void bwt_sheets_set_key(struct bwt_sheets* s, size_t sheet, uint32_t question, uint32_t bits) {
+    store(s, s->keys + (s->shared_key ? 0 : sheet) * s->row_bytes, question, bits);
+}
+
+/**
+ * Set the parsed answer to a question of a sheet
+ *
+ * @param s The sheets
+ * @param sheet The sheet
+ * @param question The question, from 0
+ * @param bits The answer as a bit pattern
+ * @param valid false if the answer could not be parsed or is out of range
+ */
+void bwt_sheets_set_answer(struct bwt_sheets* s, size_t sheet, uint32_t question, uint32_t bits, bool valid) {
+    size_t word = bitmap_word(s, sheet, question);
+    store(s, s->answers + sheet * s->row_bytes, question, valid ? bits : 0);
+    if (valid) {
+        s->valid[word] |= bitmap_bit(s, question);
+    } else {
+        s->valid[word] &= ~bitmap_bit(s, question);
+    }
+}
+
+/**
+ * Grade a range of sheets, filling in their bitmaps and scores
+ *
+ * @param s The sheets
+ * @param first The first sheet
+ * @param n Number of sheets
+ */
+void bwt_sheets_grade(struct bwt_sheets* s, size_t first, size_t n) {
+    for (size_t sheet = first; sheet < first + n; sheet++) {
+        const uint8_t* key = s->keys + (s->shared_key ? 0 : sheet) * s->row_bytes;
+        const uint8_t* answer = s->answers + sheet * s->row_bytes;
+        uint32_t* correct = s->correct + sheet * s->words;
+        const uint32_t* valid = s->valid + sheet * s->words;
+        uint32_t score = 0;
+
+        for (uint8_t w = 0; w < BWT_WIDTH_COUNT; w++) {
+            if (s->blocks[w] > 0) {
+                bwt_match_array(correct + s->first_word[w], key + s->offset[w], answer + s->offset[w],
+                                s->blocks[w], bwt_width_from_index(w));
+            }
+        }
+        for (uint32_t i = 0; i < s->words; i++) {
+            correct[i] &= valid[i];
+            score += (uint32_t)__builtin_popcount(correct[i]);
+        }
+        s->score[sheet] = score;
+    }
+}
+
+/**
+ * Whether a graded sheet answered a question correctly
+ *
+ * @param s The sheets, graded
+ * @param sheet The sheet
+ * @param question The question, from 0
+ */
+bool bwt_sheets_correct(const struct bwt_sheets* s, size_t sheet, uint32_t question) {
+    return (s->correct[bitmap_word(s, sheet, question)] & bitmap_bit(s, question)) != 0;
+}
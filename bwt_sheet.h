@@ -0,0 +1,70 @@
+/*
+ * bwt_sheet.h - Answer sheets graded many at a time for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * A set of answer sheets holds, for every sheet, the parsed answer to
+ * each question of an exam, and the answer key: one row for all sheets
+ * when everyone sat the same questions, or one per sheet. Answers are
+ * parsed once, with bwt_question_parse() or bwt_choices_grade(), so
+ * grading is only comparing bit patterns.
+ *
+ * Rows are split by width: the 8-, 16- and 32-bit questions of a sheet
+ * are stored as three arrays of uint8_t, uint16_t and uint32_t, each
+ * padded to whole blocks of BWT_SHEET_LANES values and 32-byte aligned,
+ * so bwt_match_array() (bwt_kernels.h) compares a block with one to four
+ * vector compares and a movemask. Values are masked to their width when
+ * stored. Signedness needs no masking at compare time: an answer outside
+ * the range of the question's type is stored as not valid, and so are
+ * the padding lanes and questions left unanswered.
+ *
+ * Grading leaves a bitmap per sheet, in the same slot order, of the
+ * questions answered correctly (match and valid), and its popcount as
+ * the score. Sheets are independent, so callers may grade disjoint
+ * ranges of sheets on several threads.
+ */
+
+#ifndef BWT_SHEET_H
+#define BWT_SHEET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bwt_question.h"
+
+#define BWT_SHEET_LANES 32  // values compared per block, one bit of a bitmap word each
+
+// Where a question is stored in a row
+struct bwt_sheet_slot {
+    uint8_t width_index;  // bwt_width_index() of its width
+    uint32_t slot;        // position among the questions of that width
+};
+
+struct bwt_sheets {
+    uint32_t questions;
+    size_t count;                          // sheets
+    bool shared_key;                       // one key row for every sheet
+    struct bwt_sheet_slot* slots;          // per question
+    uint32_t blocks[BWT_WIDTH_COUNT];      // per width
+    size_t offset[BWT_WIDTH_COUNT];        // byte offset of each width's array in a row
+    uint32_t first_word[BWT_WIDTH_COUNT];  // its first word in a bitmap
+    size_t row_bytes;                      // a multiple of 32
+    uint32_t words;                        // bitmap words per sheet
+    uint8_t* keys;                         // rows of expected values
+    uint8_t* answers;                      // rows of answers
+    uint32_t* valid;                       // bitmaps of questions with a valid answer
+    uint32_t* correct;                     // bitmaps of questions answered correctly
+    uint32_t* score;                       // correct answers per sheet
+};
+
+int bwt_sheets_init(struct bwt_sheets* s, const uint8_t* widths, uint32_t questions, size_t count,
+                    bool shared_key);
+void bwt_sheets_free(struct bwt_sheets* s);
+void bwt_sheets_set_key(struct bwt_sheets* s, size_t sheet, uint32_t question, uint32_t bits);
+void bwt_sheets_set_answer(struct bwt_sheets* s, size_t sheet, uint32_t question, uint32_t bits, bool valid);
+void bwt_sheets_grade(struct bwt_sheets* s, size_t first, size_t n);
+bool bwt_sheets_correct(const struct bwt_sheets* s, size_t sheet, uint32_t question);
+
+#endif // BWT_SHEET_H
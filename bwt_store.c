@@ -0,0 +1,237 @@
+/*
+ * bwt_store.c - Append-only results store for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * The appender writes whole records with O_APPEND, so several bwt
+ * processes can share one results file without interleaving records.
+ * Opening takes an exclusive flock() while it writes the header of a new
+ * file or cuts off a torn record, and writes hold a shared one, so two
+ * processes starting together do not both write a header and a record
+ * still being written is not taken for a torn one.
+ */
+
+#define _DEFAULT_SOURCE  // madvise
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "bwt_store.h"
+
+/**
+ * Fill in the header written at the start of every results file
+ */
+static void make_header(struct bwt_store_header* h) {
+    memset(h, 0, sizeof(*h));
+    memcpy(h->magic, BWT_STORE_MAGIC, sizeof(h->magic));
+    h->version = BWT_STORE_VERSION;
+    h->record_size = sizeof(struct bwt_record);
+}
+
+/**
+ * Check that a header belongs to a results file this code can read
+ */
+static bool header_ok(const struct bwt_store_header* h) {
+    return memcmp(h->magic, BWT_STORE_MAGIC, sizeof(h->magic)) == 0
+           && h->version == BWT_STORE_VERSION
+           && h->record_size == sizeof(struct bwt_record);
+}
+
+/**
+ * Write all of a buffer, retrying short writes and interrupts
+ */
+static int write_all(int fd, const void* data, size_t size) {
+    const char* p = data;
+    while (size > 0) {
+        ssize_t n = write(fd, p, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        p += n;
+        size -= (size_t)n;
+    }
+    return 0;
+}
+
+/**
+ * Open a results file for appending, creating it if needed
+ *
+ * A record left incomplete by a crash is cut off so that new records
+ * stay aligned.
+ *
+ * @param ap Appender to initialise
+ * @param path Path of the results file
+ * @return 0 on success, -1 on error (errno is set)
+ */
+int bwt_appender_open(struct bwt_appender* ap, const char* path) {
+    struct bwt_store_header h;
+    struct stat st;
+    int rc;
+
+    ap->count = 0;
+    ap->fd = open(path, O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (ap->fd < 0) {
+        return -1;
+    }
+    // The size is only known once no other process is setting the file up
+    while ((rc = flock(ap->fd, LOCK_EX)) < 0 && errno == EINTR) {
+    }
+    if (rc < 0 || fstat(ap->fd, &st) < 0) {
+        goto fail;
+    }
+
+    if (st.st_size == 0) {
+        make_header(&h);
+        if (write_all(ap->fd, &h, sizeof(h)) < 0) {
+            goto fail;
+        }
+    } else {
+        if (pread(ap->fd, &h, sizeof(h), 0) != (ssize_t)sizeof(h) || !header_ok(&h)) {
+            errno = EINVAL;
+            goto fail;
+        }
+        off_t tail = (st.st_size - (off_t)sizeof(h)) % (off_t)sizeof(struct bwt_record);
+        if (tail != 0 && ftruncate(ap->fd, st.st_size - tail) < 0) {
+            goto fail;
+        }
+    }
+    flock(ap->fd, LOCK_UN);
+    return 0;
+
+fail:
+    close(ap->fd);  // which also drops the lock
+    ap->fd = -1;
+    return -1;
+}
+
+/**
+ * Write out buffered records
+ *
+ * On error the records stay buffered, so a later flush can try again.
+ *
+ * @param ap Appender
+ * @return 0 on success, -1 on error (errno is set)
+ */
+int bwt_appender_flush(struct bwt_appender* ap) {
+    if (ap->count == 0) {
+        return 0;
+    }
+    int rc;
+    while ((rc = flock(ap->fd, LOCK_SH)) < 0 && errno == EINTR) {
+    }
+    if (rc == 0) {
+        rc = write_all(ap->fd, ap->buf, ap->count * sizeof(struct bwt_record));
+        int saved = errno;
+        flock(ap->fd, LOCK_UN);
+        errno = saved;
+    }
+    if (rc == 0) {
+        ap->count = 0;
+    }
+    return rc;
+}
+
+/**
+ * Queue a record, writing the buffer out when it is full
+ *
+ * @param ap Appender
+ * @param rec Record to append
+ * @return 0 on success, -1 if the buffer could not be written out; the
+ *         record is dropped only if the buffer was still full from an
+ *         earlier failed flush
+ */
+int bwt_appender_append(struct bwt_appender* ap, const struct bwt_record* rec) {
+    if (ap->count == BWT_APPEND_BUFFER && bwt_appender_flush(ap) < 0) {
+        return -1;
+    }
+    ap->buf[ap->count++] = *rec;
+    if (ap->count == BWT_APPEND_BUFFER) {
+        return bwt_appender_flush(ap);
+    }
+    return 0;
+}
+
+/**
+ * Flush and close a results file
+ *
+ * @param ap Appender
+ * @return 0 on success, -1 if buffered records could not be written
+ */
+int bwt_appender_close(struct bwt_appender* ap) {
+    if (ap->fd < 0) {
+        return 0;
+    }
+    int rc = bwt_appender_flush(ap);
+    if (close(ap->fd) < 0) {
+        rc = -1;
+    }
+    ap->fd = -1;
+    return rc;
+}
+
+/**
+ * Map a results file read-only
+ *
+ * After this call `map->records` is an array of `map->count` records that
+ * can be scanned directly.
+ *
+ * @param map Mapping to initialise
+ * @param path Path of the results file
+ * @return 0 on success, -1 on error (errno is set)
+ */
+int bwt_store_map_open(struct bwt_store_map* map, const char* path) {
+    struct stat st;
+    struct bwt_store_header h;
+
+    memset(map, 0, sizeof(*map));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return -1;
+    }
+    if ((size_t)st.st_size < sizeof(h)
+        || pread(fd, &h, sizeof(h), 0) != (ssize_t)sizeof(h) || !header_ok(&h)) {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+
+    void* base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);  // the mapping keeps the file open
+    if (base == MAP_FAILED) {
+        return -1;
+    }
+    madvise(base, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    map->base = base;
+    map->length = (size_t)st.st_size;
+    map->records = (const struct bwt_record*)((const char*)base + sizeof(h));
+    map->count = (map->length - sizeof(h)) / sizeof(struct bwt_record);
+    return 0;
+}
+
+/**
+ * Unmap a results file
+ *
+ * @param map Mapping returned by bwt_store_map_open
+ */
+void bwt_store_map_close(struct bwt_store_map* map) {
+    if (map->base != NULL) {
+        munmap(map->base, map->length);
+    }
+    memset(map, 0, sizeof(*map));
+}
@@ -0,0 +1,80 @@
+/*
+ * bwt_store.h - Append-only results store for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * A results file is a 32-byte header followed by fixed-size 40-byte
+ * records, one per answered question, in host byte order. Records are only
+ * ever appended, through a buffered appender that callers flush at the end
+ * of a session and between batches of questions (a menu quiz, a protocol
+ * window), so an interrupted session loses at most the batch in progress.
+ * They are read back by mapping the file and using it as an
+ * array, so reports need no parsing at all. A record cut short by a crash
+ * is simply ignored by readers.
+ */
+
+#ifndef BWT_STORE_H
+#define BWT_STORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define BWT_STORE_MAGIC "BWTREC1"  // 8 bytes including the terminator
+#define BWT_STORE_VERSION 1
+#define BWT_APPEND_BUFFER 128      // records buffered before a write(2)
+
+// flags of a record
+#define BWT_RECORD_SIGNED  0x01
+#define BWT_RECORD_CORRECT 0x02    // eventually answered correctly
+#define BWT_RECORD_GAVE_UP 0x04    // asked for the answer
+#define BWT_RECORD_FORMAT_SHIFT 3  // bits 3-4: enum bwt_format of the question
+#define BWT_RECORD_FORMAT(format) ((uint8_t)((format) << BWT_RECORD_FORMAT_SHIFT))
+
+struct bwt_store_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint8_t reserved[16];
+};
+
+struct __attribute__((packed)) bwt_record {
+    uint64_t timestamp_us;   // wall clock when the question was asked
+    uint32_t learner;
+    uint32_t session;
+    uint32_t latency_us;     // from showing the question to the last answer
+    uint32_t a;              // operands as bit patterns masked to width
+    uint32_t b;
+    uint32_t expected;
+    uint32_t first_answer;   // first well-formed answer, as a bit pattern
+    uint8_t topic;           // enum bwt_topic
+    uint8_t width;
+    uint8_t flags;           // BWT_RECORD_*
+    uint8_t attempts;        // well-formed answers given, saturating
+};
+
+_Static_assert(sizeof(struct bwt_store_header) == 32, "results header must be 32 bytes");
+_Static_assert(sizeof(struct bwt_record) == 40, "results records must be 40 bytes");
+
+struct bwt_appender {
+    int fd;
+    size_t count;            // records waiting in buf
+    struct bwt_record buf[BWT_APPEND_BUFFER];
+};
+
+struct bwt_store_map {
+    void* base;
+    size_t length;
+    const struct bwt_record* records;
+    size_t count;
+};
+
+int bwt_appender_open(struct bwt_appender* ap, const char* path);
+int bwt_appender_append(struct bwt_appender* ap, const struct bwt_record* rec);
+int bwt_appender_flush(struct bwt_appender* ap);
+int bwt_appender_close(struct bwt_appender* ap);
+int bwt_store_map_open(struct bwt_store_map* map, const char* path);
+void bwt_store_map_close(struct bwt_store_map* map);
+
+#endif // BWT_STORE_H
@@ -0,0 +1,509 @@
+/*
+ * bwt_test.c - Self-checks for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * Build and run with `make test`. Each check asserts what the quiz engine
+ * and its kernels must do; the program aborts at the first one that fails
+ * and otherwise prints how many groups of checks passed. Asserts are kept
+ * even in builds with -DNDEBUG.
+ */
+
+#define _POSIX_C_SOURCE 200809L  // open_memstream
+
+#undef NDEBUG
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libbwt.h"
+#include "bwt_question.h"
+#include "bwt_dist.h"
+#include "bwt_feedback.h"
+#include "bwt_kernels.h"
+#include "bwt_catalog.h"
+#include "bwt_coverage.h"
+#include "bwt_history.h"
+#include "bwt_choice.h"
+#include "bwt_coro.h"
+#include "bwt_settings.h"
+#include "bwt_sheet.h"
+#include "bwt_exam.h"
+
+/**
+ * Binary conversion and the C operators the quizzes are about
+ */
+static void check_bits(void) {
+    // Test basic binary conversion
+    uint8_t test_u8 = 42;
+    char test_bin[BWT_BINARY_SIZE];
+    assert(strcmp(bwt_to_binary(test_bin, test_u8, 8), "00101010") == 0);
+
+    // Test signed integers
+    int8_t test_i8 = -42;
+    assert(strcmp(bwt_to_binary(test_bin, (uint32_t)test_i8, 8), "11010110") == 0);
+    assert(strcmp(bwt_to_binary(test_bin, (uint32_t)(int16_t)-2, 16), "1111111111111110") == 0);
+    assert(bwt_to_binary(test_bin, 1, 33) == NULL);
+    assert(bwt_api_version() == BWT_API_VERSION);
+
+    // Test bitwise operations
+    uint8_t a = 5;   // 00000101
+    uint8_t b = 9;   // 00001001
+
+    assert((a & b) == 1);      // 5 & 9 == 1
+    assert((a | b) == 13);     // 5 | 9 == 13
+    assert((a ^ b) == 12);     // 5 ^ 9 == 12
+
+    // Critical test cases for bitwise NOT
+    int8_t signed_2 = 2;
+    int8_t signed_not_2 = ~signed_2;
+    assert(signed_not_2 == -3); // ~2 == -3 for signed int
+
+    uint8_t unsigned_2 = 2;
+    uint8_t unsigned_not_2 = ~unsigned_2;
+    assert(unsigned_not_2 == 253); // ~2 == 253 for unsigned int
+
+    int8_t signed_5 = 5;
+    int8_t signed_not_5 = ~signed_5;
+    assert(signed_not_5 == -6); // ~5 == -6 for signed int
+
+    // Test shift operations
+    assert((a << 1) == 10);    // 5 << 1 == 10
+    assert((a >> 1) == 2);     // 5 >> 1 == 2
+}
+
+/**
+ * Format, parse, compare and array kernels against the portable ones
+ */
+static void check_kernels(void) {
+    // Every kernel the CPU supports formats and parses like the portable one
+    for (size_t k = 0; bwt_kernels_all[k] != NULL; k++) {
+        const struct bwt_kernels* kern = bwt_kernels_all[k];
+        if (!kern->supported()) {
+            continue;
+        }
+        static const uint32_t samples[] = { 0, 1, 0x80, 0xA5, 0x8001, 0xDEADBEEF, UINT32_MAX };
+        for (size_t j = 0; j < sizeof(samples) / sizeof(samples[0]); j++) {
+            for (uint8_t width = 8; width <= 32; width *= 2) {
+                char bin[BWT_MAX_WIDTH + 1];
+                uint32_t bits = 0;
+                kern->format(bin, samples[j], width);
+                assert(strlen(bin) == width && bin[width - 1] == '0' + (char)(samples[j] & 1)
+                       && bin[0] == '0' + (char)((samples[j] >> (width - 1)) & 1));
+                assert(kern->parse(bin, width, &bits) && bits == (samples[j] & bwt_width_mask(width)));
+                bin[width / 2] = '2';
+                assert(!kern->parse(bin, width, &bits));
+            }
+        }
+        // Compares find the equal lanes of every width, a differing bit anywhere in the width
+        _Alignas(32) uint32_t match_keys[64], match_answers[64];
+        for (uint8_t width = 8; width <= 32; width *= 2) {
+            uint32_t masks[2] = { 0 };
+            for (uint32_t lane = 0; lane < 64; lane++) {
+                uint32_t v = lane * 0x9E3779B1u;
+                uint32_t answer = lane % 3 == 0 ? v : v ^ (1u << lane % width);
+                if (width == 8) {
+                    ((uint8_t*)match_keys)[lane] = (uint8_t)v;
+                    ((uint8_t*)match_answers)[lane] = (uint8_t)answer;
+                } else if (width == 16) {
+                    ((uint16_t*)match_keys)[lane] = (uint16_t)v;
+                    ((uint16_t*)match_answers)[lane] = (uint16_t)answer;
+                } else {
+                    match_keys[lane] = v;
+                    match_answers[lane] = answer;
+                }
+            }
+            kern->match(masks, match_keys, match_answers, 2, width);
+            for (size_t lane = 0; lane < 64; lane++) {
+                assert(((masks[lane / 32] >> lane % 32) & 1) == (lane % 3 == 0));
+            }
+        }
+    }
+
+    // Arrays come out the same from every kernel, runs and tail alike
+    static const uint8_t key[] = { 0xA5, 0x01 };
+    char sheet[1700], expected_sheet[1700];
+    assert(bwt_to_binary_array(sheet, sizeof(sheet), key, 2, 8, ' ', '_') == 19
+           && strcmp(sheet, "1010_0101 0000_0001") == 0);
+    assert(bwt_to_binary_array(NULL, 0, key, 2, 8, 0, 0) == 16 && bwt_to_binary_array(sheet, 1, key, 0, 8, 0, 0) == 0);
+    uint32_t sheet_values[40];
+    for (size_t i = 0; i < 40; i++) {
+        sheet_values[i] = bwt_rand32();
+    }
+    static const struct bwt_binary_style styles[] = { { 0, 0 }, { '\n', 0 }, { 0, '_' }, { ' ', '_' } };
+    const struct bwt_kernels* portable = NULL;
+    for (size_t k = 0; bwt_kernels_all[k] != NULL; k++) {
+        portable = bwt_kernels_all[k];  // the list ends with the portable kernels
+    }
+    for (size_t k = 0; bwt_kernels_all[k] != NULL; k++) {
+        const struct bwt_kernels* kern = bwt_kernels_all[k];
+        if (!kern->supported()) {
+            continue;
+        }
+        for (size_t j = 0; j < sizeof(styles) / sizeof(styles[0]); j++) {
+            for (uint8_t width = 8; width <= 32; width *= 2) {
+                for (size_t n = 0; n <= 40; n += 3) {
+                    size_t len = bwt_binary_array_size(n, width, &styles[j]) - 1;
+                    size_t expected_len = portable->format_array(expected_sheet, sheet_values, n, width, &styles[j]);
+                    size_t sheet_len = kern->format_array(sheet, sheet_values, n, width, &styles[j]);
+                    assert(expected_len == len && sheet_len == len && memcmp(sheet, expected_sheet, len + 1) == 0);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Coroutine of check_coroutines: count to three, yielding after each step,
+ * with one more coroutine run to the end inside it
+ */
+static void count_in_coroutine(void* arg) {
+    int* count = arg;
+    struct bwt_coro* self = bwt_coro_current();
+    for (int i = 0; i < 3; i++) {
+        (*count)++;
+        bwt_coro_yield();
+    }
+    if (*count < 6) {
+        struct bwt_coro inner;
+        int inner_count = 6;
+        if (bwt_coro_init(&inner, 0, count_in_coroutine, &inner_count) < 0) {
+            return;
+        }
+        while (bwt_coro_resume(&inner)) {
+            assert(bwt_coro_current() == self);
+        }
+        assert(inner_count == 9);
+        bwt_coro_free(&inner);
+    }
+}
+
+/**
+ * Coroutines that the menu server runs sessions on
+ */
+static void check_coroutines(void) {
+    // Coroutines interleave, nest and return to whoever resumed them
+    struct bwt_coro coros[2];
+    int counts[2] = { 0, 3 };
+    int coro_rc[2];
+    for (int i = 0; i < 2; i++) {
+        coro_rc[i] = bwt_coro_init(&coros[i], 0, count_in_coroutine, &counts[i]);
+        assert(coro_rc[i] == 0);
+    }
+    if (coro_rc[0] == 0 && coro_rc[1] == 0) {
+        for (int step = 0; step < 4; step++) {
+            bool yielded[2] = { bwt_coro_resume(&coros[0]), bwt_coro_resume(&coros[1]) };
+            assert(yielded[0] == (step < 3) && yielded[1] == (step < 3));
+            assert(counts[0] == (step < 3 ? step + 1 : 3) && bwt_coro_current() == NULL);
+        }
+        assert(counts[1] == 6);
+        size_t resident = bwt_coro_stack_resident(&coros[0]);
+        assert(resident > 0 && resident < BWT_CORO_STACK);
+    }
+    for (int i = 0; i < 2; i++) {
+        if (coro_rc[i] == 0) {
+            bwt_coro_free(&coros[i]);
+        }
+    }
+}
+
+/**
+ * Bit-sliced grading of exam answer sheets
+ */
+static void check_sheets(void) {
+    uint32_t sheet_values[40];
+    for (size_t i = 0; i < 40; i++) {
+        sheet_values[i] = bwt_rand32();
+    }
+
+    // Answer sheets of mixed widths: a wrong bit in the width counts, the
+    // bits above it do not exist, and an out-of-range answer is wrong
+    uint8_t sheet_widths[40];
+    struct bwt_sheets sheets;
+    for (uint32_t i = 0; i < 40; i++) {
+        sheet_widths[i] = (uint8_t)(8u << i % 3);
+    }
+    int sheets_rc = bwt_sheets_init(&sheets, sheet_widths, 40, 3, true);
+    assert(sheets_rc == 0 && sheets.words == 3 && sheets.row_bytes == 32 + 64 + 128);
+    for (uint32_t i = 0; sheets_rc == 0 && i < 40; i++) {
+        uint32_t mask = bwt_width_mask(sheet_widths[i]);
+        bwt_sheets_set_key(&sheets, 0, i, sheet_values[i] & mask);
+        bwt_sheets_set_answer(&sheets, 0, i, sheet_values[i], true);
+        bwt_sheets_set_answer(&sheets, 1, i, sheet_values[i] ^ (i % 2 ? 1u << (sheet_widths[i] - 1) : ~mask), true);
+        bwt_sheets_set_answer(&sheets, 2, i, sheet_values[i], i != 5);
+    }
+    if (sheets_rc == 0) {
+        bwt_sheets_grade(&sheets, 0, 3);
+        assert(sheets.score[0] == 40 && sheets.score[1] == 20 && sheets.score[2] == 39);
+        for (uint32_t i = 0; i < 40; i++) {
+            assert(bwt_sheets_correct(&sheets, 1, i) == (i % 2 == 0)
+                   && bwt_sheets_correct(&sheets, 2, i) == (i != 5));
+        }
+        bwt_sheets_free(&sheets);
+    }
+}
+
+/**
+ * Question model, answer formats and feedback
+ */
+static void check_questions(void) {
+    struct bwt_question signed_not = { .topic = BWT_TOPIC_NOT, .width = 8, .is_signed = true, .a = 2,
+                                       .format = BWT_FORMAT_DECIMAL };
+    uint32_t parsed_bits;
+    bwt_question_eval(&signed_not);
+    assert(bwt_question_parse(&signed_not, "-3", &parsed_bits) && parsed_bits == signed_not.expected
+           && !bwt_question_parse(&signed_not, "253", &parsed_bits));
+
+    // Question model: signed ~2 == -3 and arithmetic >> on negatives
+    struct bwt_question q = { .topic = BWT_TOPIC_NOT, .width = 8, .is_signed = true, .a = 2 };
+    bwt_question_eval(&q);
+    assert(q.expected == 0xFD && bwt_value(q.expected, 8, true) == -3);
+    q = (struct bwt_question){ .topic = BWT_TOPIC_SHR, .width = 8, .is_signed = true, .a = 0xF0, .b = 2 };
+    bwt_question_eval(&q);
+    assert(q.expected == 0xFC);  // -16 >> 2 == -4
+
+    // Hex and octal: formatted with prefix, graded without it or leading zeros
+    char formatted[BWT_ANSWER_SIZE];
+    bwt_format_value(formatted, sizeof(formatted), 0xFB, 8, true, BWT_FORMAT_HEX);
+    assert(strcmp(formatted, "0xFB") == 0);
+    bwt_format_value(formatted, sizeof(formatted), 0xDEADBEEF, 32, false, BWT_FORMAT_OCTAL);
+    assert(strcmp(formatted, "033653337357") == 0);
+    bwt_format_value(formatted, sizeof(formatted), 0x1A5, 16, false, BWT_FORMAT_OCTAL);
+    assert(strcmp(formatted, "0000645") == 0);
+    uint32_t parsed;
+    q = bwt_question_make(BWT_TOPIC_NOT, 8, true, 4, 0);
+    q.format = BWT_FORMAT_HEX;
+    assert(bwt_question_grade(&q, "0xfb", &parsed) == BWT_VERDICT_CORRECT);
+    assert(bwt_question_grade(&q, "FB", &parsed) == BWT_VERDICT_CORRECT);
+    assert(bwt_question_grade(&q, "1FB", &parsed) == BWT_VERDICT_WRONG);
+    assert(bwt_question_grade(&q, "0xG", &parsed) == BWT_VERDICT_INVALID);
+    q.format = BWT_FORMAT_OCTAL;
+    assert(bwt_question_grade(&q, "373", &parsed) == BWT_VERDICT_CORRECT);
+    assert(bwt_question_grade(&q, "0373", &parsed) == BWT_VERDICT_CORRECT);
+    assert(bwt_question_grade(&q, "8", &parsed) == BWT_VERDICT_INVALID);
+    q = bwt_question_make(BWT_TOPIC_HEX2BIN, 8, false, 0x3C, 0);
+    assert(bwt_question_grade(&q, "00111100", &parsed) == BWT_VERDICT_CORRECT);
+
+    // Feedback: -3 written as one's complement, and >> without sign extension
+    struct bwt_feedback fb;
+    q = bwt_question_make(BWT_TOPIC_DEC2BIN, 8, true, (uint32_t)-3, 0);
+    bwt_feedback_analyze(&q, 0xFC, &fb);
+    assert(fb.mistake == BWT_MISTAKE_FORGOT_PLUS_ONE && fb.wrong_bits == 1 && fb.lowest == 0);
+    q = bwt_question_make(BWT_TOPIC_SHR, 8, true, 0xF0, 2);
+    bwt_feedback_analyze(&q, 0x3C, &fb);
+    assert(fb.mistake == BWT_MISTAKE_NO_SIGN_EXTENSION && fb.highest == 7);
+
+    // A shift by 0 has no smaller shift amount to mistake it for
+    struct bwt_choices shift_choices;
+    q = bwt_question_make(BWT_TOPIC_SHL, 32, false, 0x81, 0);
+    bwt_feedback_analyze(&q, 0x102, &fb);
+    assert(fb.mistake == BWT_MISTAKE_SHIFT_AMOUNT);
+    bwt_choices_make(&q, 0, &shift_choices);
+    q = bwt_question_make(BWT_TOPIC_SHR, 32, true, 0x81, 0);
+    bwt_feedback_analyze(&q, 0x40, &fb);
+    assert(fb.mistake == BWT_MISTAKE_SHIFT_AMOUNT);
+    bwt_choices_make(&q, 0, &shift_choices);
+}
+
+/**
+ * Message formatting with the built-in English
+ */
+static void check_messages(void) {
+    // Messages come from the built-in English until a catalog is selected
+    char msg[64];
+    char num_str[BWT_MSG_INT_SIZE];
+    assert(BWT_MSG(msg, sizeof(msg), MSG_RESULT_ANSWER, "0x2A") == 19);
+    assert(strcmp(msg, "The answer is 0x2A\n") == 0);
+    assert(BWT_MSG(msg, 8, MSG_RESULT_ANSWER, "0x2A") == 19 && strcmp(msg, "The ans") == 0);
+    assert(strcmp(bwt_msg_int(num_str, -128), "-128") == 0);
+    assert(bwt_msg_columns("\xEB\x8B\xB5: ") == 4);  // a Hangul syllable takes two columns
+}
+
+/**
+ * Alias-table sampling
+ */
+static void check_dist(void) {
+    // Alias tables never pick a category of weight zero
+    struct bwt_dist d;
+    const uint32_t weights[3] = { 0, 5, 1 };
+    bool dist_built = bwt_dist_build(&d, weights, 3);
+    assert(dist_built);
+    for (int i = 0; dist_built && i < 64; i++) {
+        uint8_t category = bwt_dist_sample(&d);
+        assert(category != 0);
+    }
+}
+
+/**
+ * Operand coverage
+ */
+static void check_coverage(void) {
+    // Coverage is exact for 8-bit questions of one topic and signedness,
+    // and remembers wider questions
+    struct bwt_coverage cov;
+    int cov_rc = bwt_coverage_init(&cov, 1);
+    assert(cov_rc == 0);
+    if (cov_rc == 0) {
+        bool added[6];
+        added[0] = bwt_coverage_add(&cov, BWT_TOPIC_AND, 8, true, 0x80, 0xFF);
+        added[1] = bwt_coverage_add(&cov, BWT_TOPIC_OR, 8, true, 0x80, 0xFF);
+        added[2] = bwt_coverage_add(&cov, BWT_TOPIC_AND, 8, false, 0x80, 0xFF);
+        added[3] = bwt_coverage_add(&cov, BWT_TOPIC_AND, 8, true, 0x80, 0xFF);
+        assert(added[0] && added[1] && added[2] && !added[3]);
+        assert(!bwt_coverage_seen(&cov, BWT_TOPIC_AND, 8, true, 0xFF, 0x80));
+        added[4] = bwt_coverage_add(&cov, BWT_TOPIC_NOT, 8, true, 0x2A, 0);
+        assert(added[4] && !bwt_coverage_seen(&cov, BWT_TOPIC_DEC2BIN, 8, true, 0x2A, 0));
+        added[5] = bwt_coverage_add(&cov, BWT_TOPIC_XOR, 32, false, 0xDEADBEEF, 7);
+        assert(added[5] && bwt_coverage_seen(&cov, BWT_TOPIC_XOR, 32, false, 0xDEADBEEF, 7));
+        bwt_coverage_free(&cov);
+    }
+}
+
+/**
+ * Answer history
+ */
+static void check_history(void) {
+    // Answer history keeps the newest 2-bit outcomes across word boundaries
+    struct bwt_history hist;
+    struct bwt_history_tally tally;
+    bwt_history_init(&hist);
+    assert(bwt_history_accuracy(&hist, BWT_TOPIC_SHR, 16, 20) == -1);
+    for (int i = 0; i < 44; i++) {
+        bwt_history_push(&hist, BWT_TOPIC_SHR, 16, i < 10 ? BWT_OUTCOME_RETRIED : i < 13 ? BWT_OUTCOME_FIRST_TRY
+                         : i < 14 ? BWT_OUTCOME_GAVE_UP : BWT_OUTCOME_TIMED_OUT);
+    }
+    bwt_history_tally(&hist, BWT_TOPIC_SHR, 16, 100, &tally);
+    assert(tally.total == 44 && tally.outcome[BWT_OUTCOME_RETRIED] == 10);
+    assert(tally.outcome[BWT_OUTCOME_FIRST_TRY] == 3 && tally.outcome[BWT_OUTCOME_GAVE_UP] == 1);
+    assert(tally.outcome[BWT_OUTCOME_TIMED_OUT] == 30);
+    for (int i = 0; i < BWT_HISTORY_CAPACITY - 1; i++) {
+        bwt_history_push(&hist, BWT_TOPIC_SHR, 16, bwt_outcome_of(true, 1));
+    }
+    bwt_history_push(&hist, BWT_TOPIC_SHR, 16, bwt_outcome_of(false, 3));
+    bwt_history_tally(&hist, BWT_TOPIC_SHR, 16, 1000, &tally);
+    assert(tally.total == BWT_HISTORY_CAPACITY && tally.outcome[BWT_OUTCOME_GAVE_UP] == 1);
+    assert(bwt_history_accuracy(&hist, BWT_TOPIC_SHR, 16, 4) == 75);
+}
+
+/**
+ * Settings snapshots
+ */
+static void check_settings(void) {
+    // A session reads its own snapshot until its next question, then moves
+    // to the published settings; the snapshot is a private one, with a
+    // reference kept back so releasing it never frees the stack
+    struct bwt_settings snapshot = { .version = 0 };
+    bwt_dist_defaults(&snapshot.dists);
+    atomic_init(&snapshot.refs, 2);
+    const struct bwt_settings* held = &snapshot;
+    bwt_settings_local = held;
+    assert(bwt_dist_active() == &snapshot.dists && snapshot.dists.widths.n > 0);
+    const struct bwt_settings* published = bwt_settings_current();
+    unsigned published_refs = atomic_load(&published->refs);
+    bwt_settings_use(&held);
+    assert(held == published && bwt_dist_active() == &published->dists && atomic_load(&snapshot.refs) == 1);
+    bwt_settings_use(&held);
+    assert(held == published && atomic_load(&published->refs) == published_refs + 1);
+    bwt_settings_leave(held);
+    bwt_settings_release(held);
+    assert(bwt_settings_local == NULL && atomic_load(&published->refs) == published_refs);
+}
+
+/**
+ * Exams: questions, multiple choice and scoring
+ */
+static void check_exam(void) {
+    // Exam questions depend on (seed, student, index) only and cover every topic
+    struct bwt_question exam_q, again_q;
+    bool exam_topics[BWT_TOPIC_COUNT] = { 0 };
+    for (uint32_t index = 0; index < BWT_TOPIC_COUNT; index++) {
+        bwt_exam_question(&exam_q, 0xB17, 42, index);
+        bwt_exam_question(&again_q, 0xB17, 42, index);
+        assert(memcmp(&exam_q, &again_q, sizeof(exam_q)) == 0 && !exam_topics[exam_q.topic]);
+        exam_topics[exam_q.topic] = true;
+    }
+    bwt_exam_question(&again_q, 0xB17, 43, BWT_TOPIC_COUNT - 1);
+    assert(memcmp(&exam_q, &again_q, sizeof(exam_q)) != 0);
+
+    // Answers of student 7 to the first 6 questions, every other one right,
+    // then a comment and a malformed line
+    char exam_answers[256], exam_expected[BWT_ANSWER_SIZE];
+    int exam_len = 0;
+    for (uint32_t index = 0; index < 6; index++) {
+        bwt_exam_question(&exam_q, 0xB17, 7, index);
+        bwt_question_format_answer(&exam_q, index % 2 ? exam_q.expected : ~exam_q.expected,
+                                   exam_expected, sizeof(exam_expected));
+        exam_len += snprintf(exam_answers + exam_len, sizeof(exam_answers) - (size_t)exam_len,
+                             "7 %u %s\n", index, exam_expected);
+    }
+    exam_len += snprintf(exam_answers + exam_len, sizeof(exam_answers) - (size_t)exam_len, "# done\n7 x");
+
+    // Multiple choice: the answer once, distinct options, and every modeled
+    // mistake is one feedback recognizes when typed in; two rounds of topics
+    for (uint32_t index = 0; index < 2 * BWT_TOPIC_COUNT; index++) {
+        struct bwt_choices choices;
+        char shown[BWT_CHOICES][BWT_ANSWER_SIZE];
+        uint8_t picked = BWT_CHOICES;
+        bwt_exam_question(&exam_q, 0xB17, 1, index);
+        bwt_exam_choices(&exam_q, 0xB17, 1, index, &choices);
+        for (uint8_t i = 0; i < BWT_CHOICES; i++) {
+            const struct bwt_choice* opt = &choices.option[i];
+            struct bwt_feedback fb;
+            bwt_format_value(shown[i], sizeof(shown[i]), opt->bits, exam_q.width, opt->is_signed,
+                             bwt_question_answer_format(&exam_q));
+            for (uint8_t j = 0; j < i; j++) {
+                assert(strcmp(shown[i], shown[j]) != 0);
+            }
+            uint32_t typed;
+            enum bwt_verdict verdict = bwt_question_grade(&exam_q, shown[i], &typed);
+            assert(verdict == (i == choices.correct ? BWT_VERDICT_CORRECT : BWT_VERDICT_WRONG));
+            if (opt->mistake != BWT_MISTAKE_NONE) {
+                bwt_feedback_analyze(&exam_q, typed, &fb);
+                assert(fb.mistake != BWT_MISTAKE_NONE);
+            }
+        }
+        enum bwt_verdict chosen = bwt_choices_grade(&choices, (char[]){ 'A' + choices.correct, '\0' }, &picked);
+        assert(chosen == BWT_VERDICT_CORRECT && picked == choices.correct);
+    }
+    uint8_t picked;
+    struct bwt_choices choices;
+    bwt_choices_make(&exam_q, 0, &choices);
+    assert(bwt_choices_grade(&choices, " e", &picked) == BWT_VERDICT_INVALID
+           && bwt_choices_grade(&choices, "ab", &picked) == BWT_VERDICT_INVALID
+           && bwt_choices_grade(&choices, "", &picked) == BWT_VERDICT_INVALID);
+
+    // Scoring the sheet of those answers: 3 right, 2 unanswered, 1 malformed line
+    struct bwt_exam_tally score_tally = { 0 };
+    char* scored;
+    size_t scored_len;
+    FILE* out = open_memstream(&scored, &scored_len);
+    assert(out != NULL);
+    if (out != NULL) {
+        long sheets_scored = bwt_exam_score(exam_answers, (size_t)exam_len, 0xB17, false, 8, out, &score_tally, NULL);
+        fclose(out);
+        assert(sheets_scored == 1 && strcmp(scored, "7 3 01010100\n") == 0
+               && score_tally.verdict[BWT_VERDICT_INVALID] == 2 && score_tally.malformed == 1);
+        free(scored);
+    }
+}
+
+int main(void) {
+    static void (*const checks[])(void) = {
+        check_bits, check_kernels, check_coroutines, check_sheets,
+        check_questions, check_messages, check_dist, check_coverage,
+        check_history, check_settings, check_exam,
+    };
+    size_t count = sizeof(checks) / sizeof(checks[0]);
+
+    bwt_srand(1);
+    for (size_t i = 0; i < count; i++) {
+        checks[i]();
+    }
+    printf("bwt_test: %zu groups of checks passed\n", count);
+    return 0;
+}
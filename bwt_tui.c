@@ -0,0 +1,678 @@
+/*
+ * bwt_tui.c - Full-screen terminal front end for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ */
+
+#define _DEFAULT_SOURCE  // TIOCGWINSZ
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#include "bwt_tui.h"
+#include "bwt_catalog.h"
+#include "bwt_feedback.h"
+#include "bwt_metrics.h"
+#include "bwt_question.h"
+#include "bwt_settings.h"
+
+#define STYLE_ATTRS (BWT_STYLE_BOLD | BWT_STYLE_REVERSE | BWT_STYLE_UNDERLINE)
+#define REPRINT_LIMIT 4  // gaps up to this many cells are rewritten instead of jumped
+#define HISTORY_WINDOW 20  // recent questions the status line's accuracy covers
+
+/* ---- Cell-grid renderer ---- */
+
+static void out_flush(struct bwt_screen* s) {
+    size_t done = 0;
+    while (done < s->out_len) {
+        ssize_t n = write(s->fd, s->out + done, s->out_len - done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        done += (size_t)n;
+    }
+    s->bytes += s->out_len;
+    s->out_len = 0;
+}
+
+static void out_bytes(struct bwt_screen* s, const char* data, size_t len) {
+    if (s->out_len + len > sizeof(s->out)) {
+        out_flush(s);
+    }
+    memcpy(s->out + s->out_len, data, len);
+    s->out_len += len;
+}
+
+// Bytes in a cell's character
+static size_t cell_len(const struct bwt_cell* cell) {
+    size_t len = 1;
+    while (len < sizeof(cell->ch) && cell->ch[len] != '\0') {
+        len++;
+    }
+    return len;
+}
+
+static int digits(int n) {
+    int d = 1;
+    while (n >= 10) {
+        n /= 10;
+        d++;
+    }
+    return d;
+}
+
+/**
+ * Set up a screen of the given size and clear the terminal
+ *
+ * @param s The screen
+ * @param fd Terminal to write to
+ * @param rows Number of rows
+ * @param cols Number of columns
+ * @return 0 on success, -1 if out of memory
+ */
+int bwt_screen_init(struct bwt_screen* s, int fd, int rows, int cols) {
+    size_t cells = (size_t)rows * (size_t)cols;
+
+    s->fd = fd;
+    s->rows = rows;
+    s->cols = cols;
+    s->front = malloc(cells * sizeof(*s->front));
+    s->back = malloc(cells * sizeof(*s->back));
+    if (s->front == NULL || s->back == NULL) {
+        bwt_screen_free(s);
+        return -1;
+    }
+    for (size_t i = 0; i < cells; i++) {
+        s->front[i] = (struct bwt_cell){ " ", BWT_STYLE_PLAIN };
+    }
+    bwt_screen_clear(s);
+
+    s->bytes = 0;
+    s->out_len = 0;
+    out_bytes(s, "\x1b[0m\x1b[H\x1b[2J", 11);  // matches the blank front grid
+    s->cur_row = 0;
+    s->cur_col = 0;
+    s->pen = BWT_STYLE_PLAIN;
+    return 0;
+}
+
+void bwt_screen_free(struct bwt_screen* s) {
+    free(s->front);
+    free(s->back);
+    s->front = NULL;
+    s->back = NULL;
+}
+
+/**
+ * Start a new frame: blank the back grid
+ */
+void bwt_screen_clear(struct bwt_screen* s) {
+    size_t cells = (size_t)s->rows * (size_t)s->cols;
+    for (size_t i = 0; i < cells; i++) {
+        s->back[i] = (struct bwt_cell){ " ", BWT_STYLE_PLAIN };
+    }
+}
+
+/**
+ * Draw text into the back grid, clipped to the row
+ *
+ * @param s The screen
+ * @param row Row, from 0
+ * @param col Column, from 0
+ * @param text UTF-8 text to draw, up to the end of the string or a newline
+ * @param style Style of every cell
+ * @return The column after the text
+ */
+int bwt_screen_put(struct bwt_screen* s, int row, int col, const char* text, uint8_t style) {
+    if (row < 0 || row >= s->rows) {
+        return col;
+    }
+    struct bwt_cell* line = &s->back[row * s->cols];
+    while (*text != '\0' && *text != '\n') {
+        int width;
+        int len = bwt_msg_char(text, &width);
+        if (col >= 0 && col + width <= s->cols) {
+            // Drawing over half of a wide character blanks the other half
+            if (line[col].ch[0] == '\0' && col > 0) {
+                line[col - 1] = (struct bwt_cell){ " ", line[col - 1].style };
+            }
+            if (col + width < s->cols && line[col + width].ch[0] == '\0') {
+                line[col + width] = (struct bwt_cell){ " ", line[col + width].style };
+            }
+            line[col] = (struct bwt_cell){ .style = style };
+            memcpy(line[col].ch, text, (size_t)len);
+            if (width == 2) {
+                line[col + 1] = (struct bwt_cell){ "", style };
+            }
+        }
+        text += len;
+        col += width;
+    }
+    return col;
+}
+
+/**
+ * Draw a binary string, such as one from bwt_format_binary, with its bits
+ * colored
+ *
+ * 1 bits are bold and 0 bits plain; the sign bit of a signed value is
+ * magenta; bits set in `highlight` get `highlight_style` instead.
+ *
+ * @param s The screen
+ * @param row Row, from 0
+ * @param col Column, from 0
+ * @param bits String of '0' and '1', most significant bit first
+ * @param is_signed Whether the first bit is a sign bit
+ * @param highlight Bits to highlight, bit 0 being the last character
+ * @param highlight_style Style of highlighted bits
+ * @return The column after the bits
+ */
+int bwt_screen_put_bits(struct bwt_screen* s, int row, int col, const char* bits, bool is_signed,
+                        uint32_t highlight, uint8_t highlight_style) {
+    int n = (int)strlen(bits);
+    for (int k = 0; k < n; k++) {
+        int position = n - 1 - k;
+        uint8_t style = bits[k] == '1' ? BWT_STYLE_BOLD | BWT_COLOR_DEFAULT : BWT_STYLE_PLAIN;
+        if (position < 32 && ((highlight >> position) & 1)) {
+            style = highlight_style;
+        } else if (is_signed && k == 0) {
+            style = (uint8_t)((style & STYLE_ATTRS) | BWT_COLOR_MAGENTA);
+        }
+        char cell[2] = { bits[k], '\0' };
+        bwt_screen_put(s, row, col + k, cell, style);
+    }
+    return col + n;
+}
+
+/**
+ * Move the terminal cursor with the shortest sequence available
+ */
+static void move_to(struct bwt_screen* s, int row, int col) {
+    char seq[32];
+    int len;
+
+    if (s->cur_row == row && s->cur_col == col) {
+        return;
+    }
+
+    // Absolute position always works
+    if (col == 0) {
+        len = row == 0 ? snprintf(seq, sizeof(seq), "\x1b[H") : snprintf(seq, sizeof(seq), "\x1b[%dH", row + 1);
+    } else {
+        len = snprintf(seq, sizeof(seq), "\x1b[%d;%dH", row + 1, col + 1);
+    }
+
+    if (s->cur_row == row) {
+        int gap = col - s->cur_col;
+        const struct bwt_cell* line = &s->front[row * s->cols];
+        bool reprint = gap > 0 && gap <= REPRINT_LIMIT;
+        for (int c = s->cur_col; reprint && c < col; c++) {
+            reprint = line[c].style == s->pen && line[c].ch[0] != '\0' && line[c].ch[1] == '\0';
+        }
+        if (reprint && gap < len) {
+            // Rewriting unchanged cells in the current style is cheapest
+            for (int c = s->cur_col; c < col; c++) {
+                out_bytes(s, line[c].ch, 1);
+            }
+            s->cur_col = col;
+            return;
+        }
+        if (col == 0) {
+            len = snprintf(seq, sizeof(seq), "\r");
+        } else if (gap > 0 && 3 + (gap > 1 ? digits(gap) : 0) < len) {
+            len = gap > 1 ? snprintf(seq, sizeof(seq), "\x1b[%dC", gap) : snprintf(seq, sizeof(seq), "\x1b[C");
+        } else if (gap < 0 && 3 + (gap < -1 ? digits(-gap) : 0) < len) {
+            len = gap < -1 ? snprintf(seq, sizeof(seq), "\x1b[%dD", -gap) : snprintf(seq, sizeof(seq), "\x1b[D");
+        }
+    } else if (s->cur_row >= 0 && s->cur_col == col) {
+        int gap = row - s->cur_row;
+        int n = gap < 0 ? -gap : gap;
+        if (3 + (n > 1 ? digits(n) : 0) < len) {
+            char dir = gap > 0 ? 'B' : 'A';
+            len = n > 1 ? snprintf(seq, sizeof(seq), "\x1b[%d%c", n, dir) : snprintf(seq, sizeof(seq), "\x1b[%c", dir);
+        }
+    }
+    out_bytes(s, seq, (size_t)len);
+    s->cur_row = row;
+    s->cur_col = col;
+}
+
+/**
+ * Switch the terminal to a style with the shortest SGR sequence
+ */
+static void set_pen(struct bwt_screen* s, uint8_t style) {
+    char seq[32] = "\x1b[";
+    int len = 2;
+    int pen = s->pen;
+
+    if (pen == style) {
+        return;
+    }
+    // Attributes can only be turned off all at once, with a reset
+    if (pen < 0 || (pen & STYLE_ATTRS & ~style)) {
+        seq[len++] = '0';
+        pen = BWT_STYLE_PLAIN;
+    }
+    static const struct { uint8_t flag; char code; } attrs[] = {
+        { BWT_STYLE_BOLD, '1' }, { BWT_STYLE_UNDERLINE, '4' }, { BWT_STYLE_REVERSE, '7' },
+    };
+    for (size_t i = 0; i < sizeof(attrs) / sizeof(attrs[0]); i++) {
+        if ((style & attrs[i].flag) && !(pen & attrs[i].flag)) {
+            if (len > 2) {
+                seq[len++] = ';';
+            }
+            seq[len++] = attrs[i].code;
+        }
+    }
+    if ((style & BWT_STYLE_COLOR) != (pen & BWT_STYLE_COLOR)) {
+        if (len > 2) {
+            seq[len++] = ';';
+        }
+        seq[len++] = '3';
+        seq[len++] = (char)('0' + ((style & BWT_STYLE_COLOR) == BWT_COLOR_DEFAULT ? 9 : style & BWT_STYLE_COLOR));
+    }
+    seq[len++] = 'm';
+    out_bytes(s, seq, (size_t)len);
+    s->pen = style;
+}
+
+/**
+ * Send the cells that differ between the back and front grids
+ *
+ * @param s The screen
+ * @return Number of bytes written to the terminal
+ */
+size_t bwt_screen_flush(struct bwt_screen* s) {
+    uint64_t before = s->bytes + s->out_len;
+
+    for (int row = 0; row < s->rows; row++) {
+        for (int col = 0; col < s->cols; col++) {
+            size_t i = (size_t)row * (size_t)s->cols + (size_t)col;
+            const struct bwt_cell* cell = &s->back[i];
+            int width = col + 1 < s->cols && cell[1].ch[0] == '\0' ? 2 : 1;
+            if (cell->ch[0] == '\0'  // sent with the wide character to its left
+                || (row == s->rows - 1 && col + width >= s->cols)  // writing here may scroll
+                || (memcmp(cell->ch, s->front[i].ch, sizeof(cell->ch)) == 0 && cell->style == s->front[i].style)) {
+                continue;
+            }
+            move_to(s, row, col);
+            set_pen(s, cell->style);
+            out_bytes(s, cell->ch, cell_len(cell));
+            s->front[i] = *cell;
+            if (width == 2) {
+                s->front[i + 1] = cell[1];
+            }
+            s->cur_col += width;
+            if (s->cur_col >= s->cols) {
+                s->cur_row = -1;  // terminals differ on where the cursor is now
+            }
+        }
+    }
+    out_flush(s);
+    return (size_t)(s->bytes - before);
+}
+
+/* ---- Adaptive practice front end ---- */
+
+enum outcome { OUTCOME_NONE, OUTCOME_CORRECT, OUTCOME_GAVE_UP, OUTCOME_WRONG, OUTCOME_INVALID };
+
+struct tui {
+    struct bwt_screen screen;
+    struct bwt_sched* sched;
+    struct bwt_coverage* coverage;
+    struct bwt_appender* results;
+    uint32_t learner;
+    uint32_t session;
+    int settings_watch;
+    const struct bwt_settings* settings;  // snapshot questions are drawn from
+
+    struct bwt_question q;       // the question being asked
+    struct bwt_record rec;
+    uint16_t bucket;
+    uint32_t number;
+    uint32_t attempts;
+    uint64_t asked_us;
+    char input[BWT_MAX_WIDTH + 2];
+    int input_len;
+
+    enum outcome outcome;        // of the last answer
+    struct bwt_question prev;    // last question closed, for OUTCOME_CORRECT/GAVE_UP
+    uint32_t prev_attempts;
+    uint32_t wrong_answer;       // for OUTCOME_WRONG
+    struct bwt_feedback fb;
+    char hint[256];
+
+    uint32_t closed;             // questions answered or given up
+    uint32_t correct;
+    uint64_t answer_us;          // total time to correct answers
+};
+
+static uint64_t now_us(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static void next_question(struct tui* t) {
+    uint8_t topic, width, pattern;
+    bool is_signed;
+
+    bwt_settings_refresh(t->settings_watch, &t->settings);
+    t->bucket = bwt_sched_select(t->sched);
+    bwt_sched_decode(t->bucket, &topic, &width, &is_signed, &pattern);
+    bwt_coverage_generate(t->coverage, &t->q, topic, width, is_signed, pattern);
+    t->number++;
+    t->attempts = 0;
+    t->input_len = 0;
+    t->rec = (struct bwt_record){
+        .timestamp_us = now_us(CLOCK_REALTIME),
+        .learner = t->learner,
+        .session = t->session,
+        .a = t->q.a,
+        .b = t->q.b,
+        .expected = t->q.expected,
+        .topic = t->q.topic,
+        .width = t->q.width,
+        .flags = (t->q.is_signed ? BWT_RECORD_SIGNED : 0) | BWT_RECORD_FORMAT(t->q.format),
+    };
+    bwt_metric_inc(BWT_METRIC_QUESTIONS);
+    t->asked_us = now_us(CLOCK_MONOTONIC);
+}
+
+static void close_question(struct tui* t, bool correct) {
+    uint64_t latency = now_us(CLOCK_MONOTONIC) - t->asked_us;
+
+    bwt_sched_update(t->sched, t->bucket, correct, t->attempts);
+    if (t->results != NULL && t->results->fd >= 0) {
+        t->rec.latency_us = latency < UINT32_MAX ? (uint32_t)latency : UINT32_MAX;
+        t->rec.attempts = t->attempts < UINT8_MAX ? (uint8_t)t->attempts : UINT8_MAX;
+        t->rec.flags |= correct ? BWT_RECORD_CORRECT : BWT_RECORD_GAVE_UP;
+        // Written out when the buffer fills and on quitting; Ctrl-C quits too
+        bwt_appender_append(t->results, &t->rec);
+    }
+    t->closed++;
+    if (correct) {
+        t->correct++;
+        t->answer_us += latency;
+        bwt_metric_observe_latency(latency);
+    }
+    t->prev = t->q;
+    t->prev_attempts = t->attempts;
+    t->outcome = correct ? OUTCOME_CORRECT : OUTCOME_GAVE_UP;
+    next_question(t);
+}
+
+static void submit(struct tui* t) {
+    uint32_t bits;
+    t->input[t->input_len] = '\0';
+
+    switch (bwt_question_grade(&t->q, t->input, &bits)) {
+        case BWT_VERDICT_CORRECT:
+            bwt_metric_inc(BWT_METRIC_CORRECT);
+            if (t->attempts++ == 0) {
+                t->rec.first_answer = bits;
+            }
+            close_question(t, true);
+            break;
+        case BWT_VERDICT_WRONG: {
+            bwt_metric_inc(BWT_METRIC_WRONG);
+            if (t->attempts++ == 0) {
+                t->rec.first_answer = bits;
+            }
+            t->outcome = OUTCOME_WRONG;
+            t->wrong_answer = bits;
+            bwt_feedback_analyze(&t->q, bits, &t->fb);
+            bwt_feedback_hint(&t->fb, t->hint, sizeof(t->hint));
+            t->hint[strcspn(t->hint, "\n")] = '\0';
+            t->input_len = 0;
+            break;
+        }
+        default:
+            bwt_metric_inc(BWT_METRIC_INVALID);
+            t->outcome = OUTCOME_INVALID;
+    }
+}
+
+/**
+ * Draw the worked result of the last closed question, highlighting the
+ * bits the operator changed
+ */
+static int draw_previous(struct tui* t, int row) {
+    static const char* const op_names[] = {
+        [BWT_TOPIC_AND] = "a&b", [BWT_TOPIC_OR] = "a|b", [BWT_TOPIC_XOR] = "a^b", [BWT_TOPIC_NOT] = "~a",
+        [BWT_TOPIC_SHL] = "a<<n", [BWT_TOPIC_SHR] = "a>>n",
+    };
+    const struct bwt_question* p = &t->prev;
+    struct bwt_screen* s = &t->screen;
+    char bits[BWT_MAX_WIDTH + 1];
+    char line[64];
+    uint32_t mask = bwt_width_mask(p->width);
+
+    char number[BWT_MSG_INT_SIZE];
+    bwt_msg_int(number, t->number - 1);
+    if (t->outcome == OUTCOME_CORRECT) {
+        BWT_MSG(line, sizeof(line), t->prev_attempts > 1 ? MSG_TUI_CORRECT_RETRIES : MSG_TUI_CORRECT, number);
+        bwt_screen_put(s, row++, 2, line, BWT_STYLE_BOLD | BWT_COLOR_GREEN);
+    } else {
+        BWT_MSG(line, sizeof(line), MSG_TUI_ANSWER, number);
+        bwt_screen_put(s, row++, 2, line, BWT_STYLE_BOLD | BWT_COLOR_YELLOW);
+    }
+
+    bwt_format_binary(bits, p->a, p->width);
+    bwt_screen_put(s, row, 4, "a", BWT_STYLE_PLAIN);
+    bwt_screen_put_bits(s, row++, 10, bits, p->is_signed, 0, 0);
+    if (bwt_topic_is_binary_op(p->topic)) {
+        bwt_format_binary(bits, p->b, p->width);
+        bwt_screen_put(s, row, 4, "b", BWT_STYLE_PLAIN);
+        bwt_screen_put_bits(s, row++, 10, bits, p->is_signed, 0, 0);
+    }
+    if (p->topic < BWT_TOPIC_DEC2BIN) {  // conversions have no separate result
+        bwt_format_binary(bits, p->expected, p->width);
+        snprintf(line, sizeof(line), "%s", op_names[p->topic]);
+        bwt_screen_put(s, row, 4, line, BWT_STYLE_PLAIN);
+        bwt_screen_put_bits(s, row++, 10, bits, p->is_signed, (p->expected ^ p->a) & mask,
+                            BWT_STYLE_BOLD | BWT_COLOR_YELLOW);
+    }
+    uint8_t format = bwt_question_answer_format(p);
+    int len = snprintf(line, sizeof(line), "= %lld", (long long)bwt_value(p->expected, p->width, p->is_signed));
+    if (format == BWT_FORMAT_HEX || format == BWT_FORMAT_OCTAL) {
+        len += snprintf(line + len, sizeof(line) - (size_t)len, " = ");
+        bwt_question_format_answer(p, p->expected, line + len, sizeof(line) - (size_t)len);
+    }
+    bwt_screen_put(s, row - 1, 12 + p->width, line, BWT_STYLE_PLAIN);
+    return row;
+}
+
+static void draw(struct tui* t) {
+    struct bwt_screen* s = &t->screen;
+    char text[BWT_PROMPT_SIZE];
+    char status[128];
+    char num[3][BWT_MSG_INT_SIZE];
+    char avg[16];
+    int row = 2;
+
+    bwt_screen_clear(s);
+    bwt_screen_put(s, 0, 0, " bitwise-tutor ", BWT_STYLE_REVERSE | BWT_STYLE_BOLD | BWT_COLOR_DEFAULT);
+    snprintf(avg, sizeof(avg), "%.1f", t->correct ? (double)t->answer_us / t->correct / 1e6 : 0.0);
+    int len = BWT_MSG(status, sizeof(status), MSG_TUI_STATUS, bwt_msg_int(num[0], t->correct),
+                      bwt_msg_int(num[1], t->closed), avg);
+    // First-try accuracy of the current topic and width over the learner's recent questions
+    int recent = bwt_history_accuracy(&t->sched->history, t->q.topic, t->q.width, HISTORY_WINDOW);
+    if (recent >= 0 && len < (int)sizeof(status)) {
+        BWT_MSG(status + len, sizeof(status) - (size_t)len, MSG_TUI_RECENT, bwt_topic_name(t->q.topic),
+                bwt_msg_int(num[0], t->q.width), bwt_msg_int(num[1], recent));
+    }
+    bwt_screen_put(s, 0, s->cols - bwt_msg_columns(status) - 1, status, BWT_STYLE_PLAIN);
+
+    // Question, without its blank lines
+    bwt_question_render(&t->q, (int)t->number, text, sizeof(text));
+    for (char* line = text; *line != '\0';) {
+        size_t len = strcspn(line, "\n");
+        if (len > 0) {
+            bwt_screen_put(s, row++, 2, line, BWT_STYLE_PLAIN);
+        }
+        line += len + (line[len] == '\n');
+    }
+
+    // Answer being typed, colored like any other bits
+    row++;
+    int col = bwt_screen_put(s, row, 2, "> ", BWT_STYLE_BOLD | BWT_COLOR_CYAN);
+    t->input[t->input_len] = '\0';
+    if (bwt_question_answer_format(&t->q) == BWT_FORMAT_BINARY) {
+        col = bwt_screen_put_bits(s, row, col, t->input, t->q.is_signed, 0, 0);
+    } else {
+        col = bwt_screen_put(s, row, col, t->input, BWT_STYLE_BOLD | BWT_COLOR_DEFAULT);
+    }
+    bwt_screen_put(s, row, col, " ", BWT_STYLE_REVERSE | BWT_COLOR_DEFAULT);  // the cursor
+    row += 2;
+
+    char bits[BWT_MAX_WIDTH + 1];
+    switch (t->outcome) {
+        case OUTCOME_WRONG:
+            BWT_MSG(text, sizeof(text), MSG_TUI_WRONG, bwt_msg_int(num[0], t->fb.wrong_bits),
+                    bwt_msg_int(num[1], t->q.width));
+            bwt_screen_put(s, row++, 2, text, BWT_STYLE_BOLD | BWT_COLOR_RED);
+            bwt_format_binary(bits, t->wrong_answer, t->q.width);
+            bwt_screen_put(s, row, 4, bwt_msg_text(MSG_TUI_YOURS), BWT_STYLE_PLAIN);
+            bwt_screen_put_bits(s, row++, 10, bits, t->q.is_signed, t->fb.diff,
+                                BWT_STYLE_REVERSE | BWT_STYLE_BOLD | BWT_COLOR_RED);
+            bwt_screen_put(s, row++, 4, t->hint, BWT_STYLE_PLAIN);
+            break;
+        case OUTCOME_INVALID:
+            bwt_question_describe_answer(&t->q, status, sizeof(status));
+            BWT_MSG(text, sizeof(text), MSG_RESULT_INVALID, status);  // drawn up to its newline
+            bwt_screen_put(s, row++, 2, text, BWT_STYLE_BOLD | BWT_COLOR_RED);
+            break;
+        case OUTCOME_CORRECT:
+        case OUTCOME_GAVE_UP:
+            draw_previous(t, row);
+            break;
+        default:
+            break;
+    }
+
+    bwt_screen_put(s, s->rows - 1, 0, bwt_msg_text(MSG_TUI_KEYS), BWT_COLOR_BLUE);
+    bwt_screen_flush(s);
+}
+
+/**
+ * Run adaptive practice as a full-screen program
+ *
+ * @param sched The learner's scheduler state
+ * @param coverage The learner's operand coverage
+ * @param results Results file to append to, or NULL
+ * @param learner Learner id for results
+ * @param session Session id for results
+ * @param settings_watch Descriptor from bwt_settings_watch, or -1
+ * @return Exit status for main
+ */
+int bwt_tui_run(struct bwt_sched* sched, struct bwt_coverage* coverage, struct bwt_appender* results,
+                uint32_t learner, uint32_t session, int settings_watch) {
+    static struct tui t;
+    struct termios saved;
+    struct winsize ws;
+    bool tty = isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &saved) == 0;
+    int rows = 24;
+    int cols = 80;
+
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_row >= 12 && ws.ws_col >= 40) {
+        rows = ws.ws_row;
+        cols = ws.ws_col;
+    }
+    t = (struct tui){ .sched = sched, .coverage = coverage, .results = results, .learner = learner, .session = session,
+                      .settings_watch = settings_watch };
+
+    if (tty) {
+        // Keys arrive one at a time, unechoed; Ctrl-C is read as a key so the terminal is restored
+        struct termios raw = saved;
+        raw.c_lflag &= ~(tcflag_t)(ICANON | ECHO | ISIG);
+        raw.c_cc[VMIN] = 1;
+        raw.c_cc[VTIME] = 0;
+        tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw);
+    }
+    fflush(stdout);
+    (void)!write(STDOUT_FILENO, "\x1b[?1049h\x1b[?25l", 14);  // alternate screen, no cursor
+    if (bwt_screen_init(&t.screen, STDOUT_FILENO, rows, cols) < 0) {
+        (void)!write(STDOUT_FILENO, "\x1b[?25h\x1b[?1049l", 14);
+        if (tty) {
+            tcsetattr(STDIN_FILENO, TCSAFLUSH, &saved);
+        }
+        return 1;
+    }
+
+    next_question(&t);
+    draw(&t);
+
+    bool running = true;
+    bool in_escape = false;
+    while (running) {
+        char keys[64];
+        ssize_t n = read(STDIN_FILENO, keys, sizeof(keys));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        for (ssize_t i = 0; i < n && running; i++) {
+            char k = keys[i];
+            if (in_escape) {
+                // Skip the rest of an escape sequence, e.g. an arrow key
+                in_escape = !((k >= 'A' && k <= 'Z') || (k >= 'a' && k <= 'z') || k == '~');
+            } else if (k == 0x1b) {
+                in_escape = true;
+            } else if (isxdigit((unsigned char)k) || k == '-' || k == 'x' || k == 'X') {
+                if (t.input_len < BWT_MAX_WIDTH + 1) {
+                    t.input[t.input_len++] = k;
+                }
+            } else if (k == 0x7f || k == '\b') {
+                if (t.input_len > 0) {
+                    t.input_len--;
+                }
+            } else if (k == '\r' || k == '\n') {
+                if (t.input_len > 0) {
+                    submit(&t);
+                }
+            } else if (k == '?') {
+                bwt_metric_inc(BWT_METRIC_GAVE_UP);
+                close_question(&t, false);
+            } else if (k == 'q' || k == 0x03 || k == 0x04) {
+                running = false;
+            }
+        }
+        draw(&t);
+    }
+
+    uint64_t bytes = t.screen.bytes;
+    bwt_screen_free(&t.screen);
+    bwt_settings_leave(t.settings);
+    bwt_settings_release(t.settings);
+    (void)!write(STDOUT_FILENO, "\x1b[0m\x1b[?25h\x1b[?1049l", 18);
+    if (tty) {
+        tcsetattr(STDIN_FILENO, TCSAFLUSH, &saved);
+    }
+    char num[4][BWT_MSG_INT_SIZE];
+    bwt_msg_int(num[0], t.correct);
+    bwt_msg_int(num[1], t.closed);
+    bwt_msg_int(num[2], (long long)bytes);
+    if (t.closed > 0) {
+        BWT_MSG_PRINT(MSG_TUI_SUMMARY_PER_QUESTION, num[0], num[1], num[2],
+                      bwt_msg_int(num[3], (long long)(bytes / t.closed)));
+    } else {
+        BWT_MSG_PRINT(MSG_TUI_SUMMARY, num[0], num[1], num[2]);
+    }
+    return 0;
+}
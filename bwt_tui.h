@@ -0,0 +1,74 @@
+/*
+ * bwt_tui.h - Full-screen terminal front end for bitwise-tutor
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * The screen is a grid of cells (character plus style). Characters are
+ * UTF-8, so translated text can be drawn; a wide one, such as Hangul,
+ * takes two cells, the second left empty. A frame is drawn
+ * into the back grid, then compared cell by cell with the front grid,
+ * which holds what the terminal shows. Only cells that changed are sent,
+ * using the shortest of the possible cursor movements and emitting SGR
+ * color sequences only when the style changes. A keystroke therefore
+ * costs a few bytes, and a whole answered question a few hundred, which
+ * keeps the TUI usable over slow SSH links. Only ANSI escape sequences
+ * are used, so no curses library is needed.
+ */
+
+#ifndef BWT_TUI_H
+#define BWT_TUI_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bwt_coverage.h"
+#include "bwt_sched.h"
+#include "bwt_store.h"
+
+// Cell styles: a color in the low bits plus attribute flags
+enum bwt_color {
+    BWT_COLOR_BLACK, BWT_COLOR_RED, BWT_COLOR_GREEN, BWT_COLOR_YELLOW,
+    BWT_COLOR_BLUE, BWT_COLOR_MAGENTA, BWT_COLOR_CYAN, BWT_COLOR_WHITE,
+    BWT_COLOR_DEFAULT
+};
+
+#define BWT_STYLE_COLOR 0x0F
+#define BWT_STYLE_BOLD 0x10
+#define BWT_STYLE_REVERSE 0x20
+#define BWT_STYLE_UNDERLINE 0x40
+#define BWT_STYLE_PLAIN BWT_COLOR_DEFAULT
+#define BWT_SCREEN_OUT_SIZE 8192
+
+struct bwt_cell {
+    char ch[4];     // UTF-8 character, NUL-padded; "" in the right half of a wide one
+    uint8_t style;
+};
+
+struct bwt_screen {
+    int fd;
+    int rows;
+    int cols;
+    struct bwt_cell* front;  // what the terminal shows
+    struct bwt_cell* back;   // the frame being drawn
+    int cur_row;             // terminal cursor, -1 when unknown
+    int cur_col;
+    int pen;                 // current terminal style, -1 when unknown
+    uint64_t bytes;          // bytes written since init
+    size_t out_len;
+    char out[BWT_SCREEN_OUT_SIZE];
+};
+
+int bwt_screen_init(struct bwt_screen* s, int fd, int rows, int cols);
+void bwt_screen_free(struct bwt_screen* s);
+void bwt_screen_clear(struct bwt_screen* s);
+int bwt_screen_put(struct bwt_screen* s, int row, int col, const char* text, uint8_t style);
+int bwt_screen_put_bits(struct bwt_screen* s, int row, int col, const char* bits, bool is_signed,
+                        uint32_t highlight, uint8_t highlight_style);
+size_t bwt_screen_flush(struct bwt_screen* s);
+
+int bwt_tui_run(struct bwt_sched* sched, struct bwt_coverage* coverage, struct bwt_appender* results,
+                uint32_t learner, uint32_t session, int settings_watch);
+
+#endif // BWT_TUI_H
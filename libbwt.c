@@ -0,0 +1,354 @@
+/*
+ * libbwt.c - C API of the bitwise-tutor quiz engine
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ */
+
+#define _POSIX_C_SOURCE 200809L  // clock_gettime
+
+#include "libbwt.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bwt_catalog.h"
+#include "bwt_coverage.h"
+#include "bwt_feedback.h"
+#include "bwt_kernels.h"
+#include "bwt_net.h"
+#include "bwt_probe.h"
+#include "bwt_question.h"
+#include "bwt_sched.h"
+#include "bwt_settings.h"
+
+#define PROMPT "> "
+#define REPLY_SIZE (BWT_PROMPT_SIZE + BWT_FEEDBACK_SIZE + 128)
+
+_Static_assert(BWT_TOPIC_HEX2BIN == 9, "topic numbers are part of the API");
+
+#ifdef BWT_PROBES
+// Kept even though only the probes' notes refer to them, where tracers find them
+#define BWT_PROBE_SEMAPHORE_DEF(name) __attribute__((used, section(".probes"))) BWT_PROBE_SEMAPHORE(name)
+BWT_PROBE_SEMAPHORE_DEF(question);
+BWT_PROBE_SEMAPHORE_DEF(input);
+BWT_PROBE_SEMAPHORE_DEF(parse);
+BWT_PROBE_SEMAPHORE_DEF(grade);
+BWT_PROBE_SEMAPHORE_DEF(flush);
+BWT_PROBE_SEMAPHORE_DEF(session_end);
+#endif
+_Static_assert(BWT_BINARY_SIZE == BWT_MAX_WIDTH + 1, "BWT_BINARY_SIZE must fit any width");
+
+struct bwt_session {
+    struct bwt_sched sched;
+    struct bwt_coverage coverage;
+    struct bwt_question q;
+    struct bwt_line_reader in;
+    const struct bwt_settings* settings;  // held; renewed before each question
+    uint16_t bucket;
+    uint32_t attempts;
+    uint32_t number;
+    uint64_t asked_us;
+    uint64_t started_us;
+    bool ended;
+    bwt_answer_fn on_answer;
+    void* ctx;
+    char* out;          // output not read yet
+    size_t out_len;
+    size_t out_capacity;
+};
+
+static uint64_t monotonic_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+/**
+ * Version of the API this library implements
+ *
+ * @return BWT_API_VERSION of the library, to compare with the header's
+ */
+int bwt_api_version(void) {
+    return BWT_API_VERSION;
+}
+
+/**
+ * Load settings and pick the message language for every session
+ *
+ * @param settings_path Settings file (see bwt_dist.h), or NULL for the defaults
+ * @param lang Language such as "ko", or NULL for the locale's
+ * @return 0 on success, -1 if the settings file could not be read or had
+ *         errors (the defaults are kept for what it got wrong), or if there
+ *         is no catalog for the language (English is used)
+ */
+int bwt_configure(const char* settings_path, const char* lang) {
+    int status = 0;
+
+    if (bwt_settings_load(settings_path) != 0) {
+        status = -1;
+    }
+    if (bwt_catalog_select(lang) < 0 && lang != NULL) {
+        status = -1;
+    }
+    return status;
+}
+
+/**
+ * Append text to the output of a session
+ *
+ * @return 0 on success, -1 if out of memory
+ */
+static int queue(struct bwt_session* s, const char* text, int len) {
+    size_t n = len < REPLY_SIZE ? (size_t)len : REPLY_SIZE - 1;
+    if (s->out_len + n > s->out_capacity) {
+        size_t capacity = s->out_capacity ? s->out_capacity : REPLY_SIZE;
+        while (capacity < s->out_len + n) {
+            capacity *= 2;
+        }
+        char* out = realloc(s->out, capacity);
+        if (out == NULL) {
+            return -1;
+        }
+        s->out = out;
+        s->out_capacity = capacity;
+    }
+    memcpy(s->out + s->out_len, text, n);
+    s->out_len += n;
+    return 0;
+}
+
+/**
+ * Pick the next question and append it to a reply
+ *
+ * @return New length of the reply
+ */
+static int next_question(struct bwt_session* s, char* out, int len) {
+    uint8_t topic, width, pattern;
+    bool is_signed;
+
+    bwt_settings_use(&s->settings);
+    s->bucket = bwt_sched_select(&s->sched);
+    bwt_sched_decode(s->bucket, &topic, &width, &is_signed, &pattern);
+    bwt_coverage_generate(&s->coverage, &s->q, topic, width, is_signed, pattern);
+    s->attempts = 0;
+    s->number++;
+    BWT_PROBE4(question, topic, width, pattern, s->number);
+
+    len += snprintf(out + len, REPLY_SIZE - (size_t)len, "\n");
+    len += bwt_question_render(&s->q, (int)s->number, out + len, REPLY_SIZE - (size_t)len);
+    len += snprintf(out + len, REPLY_SIZE - (size_t)len, PROMPT);
+    s->asked_us = monotonic_us();
+    return len;
+}
+
+/**
+ * Start a learner's practice with the first question, ready to read
+ *
+ * @return The session, or NULL if out of memory
+ */
+struct bwt_session* bwt_session_create(void) {
+    struct bwt_session* s = calloc(1, sizeof(*s));
+    char out[REPLY_SIZE];
+
+    if (s == NULL) {
+        return NULL;
+    }
+    // Embedders that skip bwt_configure get the built-in settings
+    s->settings = bwt_settings_hold();
+    bwt_sched_init(&s->sched);
+    s->started_us = monotonic_us();
+    if (bwt_coverage_init(&s->coverage, s->settings->dists.coverage_kb) < 0
+        || queue(s, out, next_question(s, out, 0)) < 0) {
+        bwt_session_destroy(s);
+        return NULL;
+    }
+    return s;
+}
+
+/**
+ * End a session and free everything it holds
+ */
+void bwt_session_destroy(struct bwt_session* s) {
+    if (s == NULL) {
+        return;
+    }
+    if (BWT_PROBE_ENABLED(session_end)) {
+        BWT_PROBE3(session_end, (uintptr_t)s, s->number, monotonic_us() - s->started_us);
+    }
+    bwt_coverage_free(&s->coverage);
+    bwt_settings_leave(s->settings);
+    bwt_settings_release(s->settings);
+    free(s->out);
+    free(s);
+}
+
+/**
+ * Handle one answer line from the learner
+ *
+ * @return BWT_OK, BWT_ENDED if the learner left or BWT_ERROR
+ */
+static int handle_line(struct bwt_session* s, const char* line) {
+    const struct bwt_question* q = &s->q;
+    char out[REPLY_SIZE];
+    int len = 0;
+    uint32_t bits = 0;
+
+    if (strcmp(line, "q") == 0) {
+        s->ended = true;
+        return BWT_ENDED;
+    }
+    if (strcmp(line, "?") == 0) {
+        char expected[BWT_ANSWER_SIZE];
+        bwt_question_format_answer(q, q->expected, expected, sizeof(expected));
+        len = BWT_MSG(out, sizeof(out), MSG_RESULT_ANSWER, expected);
+        bwt_sched_update(&s->sched, s->bucket, false, s->attempts);
+        len = next_question(s, out, len);
+        return queue(s, out, len) < 0 ? BWT_ERROR : BWT_OK;
+    }
+
+    enum bwt_verdict verdict = bwt_question_grade(q, line, &bits);
+    uint64_t latency_us = monotonic_us() - s->asked_us;
+    BWT_PROBE5(grade, q->topic, q->width, verdict, s->attempts + (verdict != BWT_VERDICT_INVALID), latency_us);
+    switch (verdict) {
+        case BWT_VERDICT_CORRECT:
+            s->attempts++;
+            if (s->on_answer != NULL) {
+                s->on_answer(s->ctx, q->topic, true, latency_us);
+            }
+            bwt_sched_update(&s->sched, s->bucket, true, s->attempts);
+            len = snprintf(out, sizeof(out), "%s", bwt_msg_text(MSG_RESULT_CORRECT));
+            len = next_question(s, out, len);
+            break;
+        case BWT_VERDICT_WRONG: {
+            struct bwt_feedback fb;
+            s->attempts++;
+            if (s->on_answer != NULL) {
+                s->on_answer(s->ctx, q->topic, false, 0);
+            }
+            bwt_feedback_analyze(q, bits, &fb);
+            len = snprintf(out, sizeof(out), "%s", bwt_msg_text(MSG_RESULT_WRONG));
+            len += bwt_feedback_render(q, bits, &fb, out + len, sizeof(out) - (size_t)len);
+            len += snprintf(out + len, sizeof(out) - (size_t)len, "\n" PROMPT);
+            break;
+        }
+        default: {
+            char form[64];
+            bwt_question_describe_answer(q, form, sizeof(form));
+            len = BWT_MSG(out, sizeof(out), MSG_RESULT_INVALID, form);
+            len += snprintf(out + len, sizeof(out) - (size_t)len, PROMPT);
+        }
+    }
+    return queue(s, out, len) < 0 ? BWT_ERROR : BWT_OK;
+}
+
+/**
+ * Give a session what the learner typed; every complete line is answered
+ *
+ * @param s The session
+ * @param data Input, not necessarily whole lines
+ * @param len Length of the input
+ * @return BWT_OK, BWT_ENDED once the learner entered `q`, or BWT_ERROR
+ */
+int bwt_session_feed(struct bwt_session* s, const char* data, size_t len) {
+    if (s->ended) {
+        return BWT_ENDED;
+    }
+    BWT_PROBE2(input, (uintptr_t)s, len);
+    for (size_t k = 0; k < len;) {
+        bool complete;
+        k += bwt_line_feed(&s->in, data + k, len - k, &complete);
+        if (complete) {
+            int status = handle_line(s, s->in.line);
+            if (status != BWT_OK) {
+                return status;
+            }
+        }
+    }
+    return BWT_OK;
+}
+
+/**
+ * Number of bytes of output waiting to be read
+ */
+size_t bwt_session_pending(const struct bwt_session* s) {
+    return s->out_len;
+}
+
+/**
+ * Take output of a session: questions, feedback and prompts
+ *
+ * @param s The session
+ * @param buf Buffer to copy the output to, not NUL-terminated
+ * @param size Size of the buffer
+ * @return Number of bytes copied, 0 once everything was read
+ */
+size_t bwt_session_read(struct bwt_session* s, char* buf, size_t size) {
+    size_t n = s->out_len < size ? s->out_len : size;
+    if (n == 0) {
+        return 0;
+    }
+    memcpy(buf, s->out, n);
+    memmove(s->out, s->out + n, s->out_len - n);
+    s->out_len -= n;
+    return n;
+}
+
+/**
+ * Have a function called with every graded answer of a session
+ *
+ * @param s The session
+ * @param fn Function to call, or NULL to stop
+ * @param ctx Passed to fn as is
+ */
+void bwt_session_on_answer(struct bwt_session* s, bwt_answer_fn fn, void* ctx) {
+    s->on_answer = fn;
+    s->ctx = ctx;
+}
+
+/**
+ * Write the two's complement bit pattern of a value, most significant bit
+ * first
+ *
+ * @param out Buffer of at least width + 1 (BWT_BINARY_SIZE) bytes
+ * @param bits Value; bits above width are ignored, so signed values can be
+ *             passed as they are
+ * @param width Number of digits, 1 to 32
+ * @return out, or NULL if the width is out of range
+ */
+char* bwt_to_binary(char* out, uint32_t bits, unsigned width) {
+    if (width < 1 || width > BWT_MAX_WIDTH) {
+        return NULL;
+    }
+    bwt_format_binary(out, bits, (uint8_t)width);
+    return out;
+}
+
+/**
+ * Write the bit patterns of a whole array as one string, such as an answer
+ * key with a value per line
+ *
+ * @param out Buffer for the string, or NULL to only measure it
+ * @param size Size of the buffer
+ * @param values uint8_t, uint16_t or uint32_t values, as given by width
+ * @param count Number of values
+ * @param width 8, 16 or 32
+ * @param separator Written between values, such as '\n', or '\0' for none
+ * @param group Written between nibbles, such as '_', or '\0' for none
+ * @return Length of the string, which is written only if size is more than
+ *         that; 0 if the width is not supported
+ */
+size_t bwt_to_binary_array(char* out, size_t size, const void* values, size_t count,
+                           unsigned width, char separator, char group) {
+    struct bwt_binary_style style = { separator, group };
+    if (width != 8 && width != 16 && width != 32) {
+        return 0;
+    }
+    size_t needed = bwt_binary_array_size(count, (uint8_t)width, &style);
+    if (out != NULL && size >= needed) {
+        bwt_format_binary_array(out, values, count, (uint8_t)width, &style);
+    }
+    return needed - 1;
+}
@@ -0,0 +1,74 @@
+/*
+ * libbwt.h - C API of the bitwise-tutor quiz engine
+ * Created on: Sun 18 Oct 2026
+ * Last Updated: Sun 18 Oct 2026
+ * Author: gopeterjun@naver.com
+ *
+ * libbwt holds the quiz engine (questions, grading, feedback, the adaptive
+ * scheduler, operand distributions and coverage, message catalogs) and the
+ * binary format/parse kernels, so other programs can run practice sessions
+ * in-process instead of spawning bwt. `make` builds bin/debug/libbwt.a with
+ * AddressSanitizer, which bwt, bitwise_operators and bwt-bits link;
+ * `make release` builds bin/release/libbwt.a and libbwt.so with LTO and no
+ * sanitizers. This header is the stable API: the shared library exports
+ * only the functions below, and BWT_API_VERSION changes whenever one of
+ * them does. The bwt_*.h headers are internal.
+ *
+ * A session is one learner's adaptive practice, text in and text out, as
+ * served by `bwt --serve`:
+ *
+ *     bwt_configure("bwt.conf", NULL);
+ *     struct bwt_session* s = bwt_session_create();
+ *     bwt_session_feed(s, "0x2A\n", 5);   // answer the first question
+ *     char out[1024];
+ *     size_t n = bwt_session_read(s, out, sizeof(out));
+ *     bwt_session_destroy(s);
+ *
+ * Settings, the message catalog and the random number generator
+ * are shared by every session in the process, so configure once before
+ * creating sessions and call into the library from one thread at a time.
+ */
+
+#ifndef LIBBWT_H
+#define LIBBWT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define BWT_API_VERSION 2
+#define BWT_BINARY_SIZE 33  // 32 digits and the terminator
+
+#if defined(__GNUC__)
+#define BWT_API __attribute__((visibility("default")))
+#else
+#define BWT_API
+#endif
+
+// Results of bwt_session_feed
+enum bwt_status {
+    BWT_ERROR = -1,  // out of memory
+    BWT_OK = 0,
+    BWT_ENDED = 1    // the learner entered `q`; input after it is ignored
+};
+
+struct bwt_session;
+
+// Called for every graded answer. Topics are numbered 0 and, 1 or, 2 xor,
+// 3 not, 4 shl, 5 shr, 6 dec2bin, 7 bin2dec, 8 bin2hex, 9 hex2bin, and
+// latency_us is the time from the question to a correct answer, 0 if wrong.
+typedef void (*bwt_answer_fn)(void* ctx, int topic, bool correct, uint64_t latency_us);
+
+BWT_API int bwt_api_version(void);
+BWT_API int bwt_configure(const char* settings_path, const char* lang);
+BWT_API struct bwt_session* bwt_session_create(void);
+BWT_API void bwt_session_destroy(struct bwt_session* s);
+BWT_API int bwt_session_feed(struct bwt_session* s, const char* data, size_t len);
+BWT_API size_t bwt_session_pending(const struct bwt_session* s);
+BWT_API size_t bwt_session_read(struct bwt_session* s, char* buf, size_t size);
+BWT_API void bwt_session_on_answer(struct bwt_session* s, bwt_answer_fn fn, void* ctx);
+BWT_API char* bwt_to_binary(char* out, uint32_t bits, unsigned width);
+BWT_API size_t bwt_to_binary_array(char* out, size_t size, const void* values, size_t count,
+                                   unsigned width, char separator, char group);
+
+#endif // LIBBWT_H